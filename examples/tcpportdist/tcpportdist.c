@@ -20,13 +20,14 @@
 
 #include <libnfdump/libnfdump.h>
 #define TCP 6
+#define BATCH_SIZE 1024
 
 int main (int argc, char* argv[])
 {
     libnfstates_t* states;
-    master_record_t* rec;
+    libnf_columns_t* columns;
     int port_dist[0xFFFF]; /* Port distribution array */
-    int i,numflows;
+    int i,j,n,numflows;
 
     
     
@@ -41,21 +42,27 @@ int main (int argc, char* argv[])
     states = initlib(NULL, argv[1],NULL);
     numflows = 0;
  
-    if (states) {
-        do {
-            rec = get_next_record(states);
-            if (rec) {
+    /* Records are fetched in batches of columns, only the needed fields 
+     * are accessed */
+    columns = new_columns(BATCH_SIZE);
+ 
+    if (states && columns) {
+        /* Protocol and ports are in the common block, which is always
+         * decoded. Addresses, counters and extensions are skipped */
+        set_projection(states, 0);
+        while ((n = get_next_columns(states, columns)) > 0) {
+            for (j=0; j<n; j++) {
                 /* Count only TCP ports */
-                if (rec->prot == TCP){
+                if (columns->prot[j] == TCP){
                     /* Count the frequency of source ports */
-                    port_dist[rec->srcport]++;
+                    port_dist[columns->srcport[j]]++;
                     /* Count the frequency of destination ports */
-                    port_dist[rec->dstport]++;
-                    /* Count the number of flows */
+                    port_dist[columns->dstport[j]]++;
                 }
-                numflows++;
             }
-        } while (rec);
+            /* Count the number of flows */
+            numflows += n;
+        }
         
         /* Print the frequency of source ports */
         printf("Port Frequency\n");
@@ -67,5 +74,6 @@ int main (int argc, char* argv[])
         /* Close the nfcapd file and free up internal states */
         libcleanup(states);
     }
+    free_columns(columns);
     return(EXIT_SUCCESS);
 } 
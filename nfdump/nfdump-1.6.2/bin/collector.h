@@ -141,7 +141,7 @@ void InsertSampler( FlowSource_t *fs, uint8_t sampler_id, sampler_t *sampler);
 
 int HasOptionTable(FlowSource_t *fs, uint16_t id );
 
-void launcher (char *commbuff, FlowSource_t *FlowSource, char *process, int expire);
+void launcher (char *commbuff, FlowSource_t *FlowSource, char *process, int expire, int build_index, uint32_t rollup_keys);
 
 /* Default time window in seconds to rotate files */
 #define TIME_WINDOW	  	300
@@ -42,6 +42,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/param.h>
 #include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -65,6 +66,8 @@
 #endif
 
 #include "util.h"
+#include "nffile.h"
+#include "nfrollup.h"
 #include "bookkeeper.h"
 #include "nfstatfile.h"
 #include "expire.h"
@@ -89,6 +92,26 @@ static int unlink_debug (const char *path) {
 } // End of unlink_debug
 #endif
 
+/*
+ * Remove the block index, address filter and rollup of an expired data file, if any
+ */
+void UnlinkIndex(char *path) {
+char index_path[MAXPATHLEN];
+
+	snprintf(index_path, MAXPATHLEN, "%s%s", path, INDEX_SUFFIX);
+	index_path[MAXPATHLEN-1] = 0;
+	unlink(index_path);
+
+	snprintf(index_path, MAXPATHLEN, "%s%s", path, BLOOM_SUFFIX);
+	index_path[MAXPATHLEN-1] = 0;
+	unlink(index_path);
+
+	snprintf(index_path, MAXPATHLEN, "%s%s", path, ROLLUP_SUFFIX);
+	index_path[MAXPATHLEN-1] = 0;
+	unlink(index_path);
+
+} // End of UnlinkIndex
+
 uint64_t ParseSizeDef(char *s, uint64_t *value) {
 char *p;
 uint64_t fac;
@@ -402,6 +425,7 @@ time_t 		now = time(NULL);
 				if ( !size_done ) {
 					if ( dirstat->filesize > sizelimit ) {
 						if ( unlink(ftsent->fts_path) == 0 ) {
+							UnlinkIndex(ftsent->fts_path);
 							dirstat->filesize -= 512 * ftsent->fts_statp->st_blocks;
 							num_expired++;
 							dir_files--;
@@ -420,6 +444,7 @@ time_t 		now = time(NULL);
 				if ( !lifetime_done ) {
 					if ( expire_timelimit && strcmp(p, expire_timelimit) < 0  ) {
 						if ( unlink(ftsent->fts_path) == 0 ) {
+							UnlinkIndex(ftsent->fts_path);
 							dirstat->filesize -= 512 * ftsent->fts_statp->st_blocks;
 							num_expired++;
 							dir_files--;
@@ -624,6 +649,7 @@ uint64_t	sizelimit, num_expired;
 			if ( current_stat->filesize > sizelimit ) {
 				// need to delete this file
 				if ( unlink(expire_channel->ftsent->fts_path) == 0 ) {
+					UnlinkIndex(expire_channel->ftsent->fts_path);
 					// Update profile stat
 					current_stat->filesize 			  -= 512 * expire_channel->ftsent->fts_statp->st_blocks;
 					current_stat->numfiles--;
@@ -653,6 +679,7 @@ uint64_t	sizelimit, num_expired;
 			if ( strcmp(p, expire_timelimit) < 0  ) {
 				// need to delete this file
 				if ( unlink(expire_channel->ftsent->fts_path) == 0 ) {
+					UnlinkIndex(expire_channel->ftsent->fts_path);
 					// Update profile stat
 					current_stat->filesize -= 512 * expire_channel->ftsent->fts_statp->st_blocks;
 					current_stat->numfiles--;
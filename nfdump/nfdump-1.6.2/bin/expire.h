@@ -64,4 +64,6 @@ void ExpireProfile(channel_t *channel, dirstat_t *current_stat, uint64_t maxsize
 
 void UpdateBookStat(dirstat_t *dirstat, bookkeeper_t *books);
 
+void UnlinkIndex(char *path);
+
 #endif //_EXPIRE_H
@@ -68,6 +68,7 @@
 #endif
 
 #include "nffile.h"
+#include "nfrollup.h"
 #include "util.h"
 #include "flist.h"
 
@@ -215,26 +216,44 @@ static const char *subdir_def[] = {
 static mode_t mode, dir_mode;
 static const char *subdir_format;
 
-static struct entry_filter_s {
+struct entry_filter_s {
 	char	*first_entry;
 	char	*last_entry;
 	int		list_files;
-} *dir_entry_filter;
+};
 
 #define NUM_PTR 16
 
-static char		*first_file, *last_file, current_file[255];
-static uint32_t	twin_first, twin_last;
-static stringlist_t source_dirs, file_list;
+/*
+ * All states of an input file sequence. Each sequence set up by
+ * SetupInputFileSequence_r() has its own instance, therefore multiple
+ * sequences may be processed in parallel.
+ */
+struct flist_s {
+	stringlist_t			source_dirs;
+	stringlist_t			file_list;
+	struct entry_filter_s	*dir_entry_filter;
+	int						dir_entry_levels;
+	char					*first_file, *last_file;
+	char					*current_file;
+	uint32_t				twin_first, twin_last;
+	uint32_t				cnt;
+	file_filter_t			file_filter;		// skips files without matching records
+	void					*file_filter_data;
+	uint32_t				skipped_files;		// files skipped by the file filter
+};
+
+// file sequence used by the non reentrant functions
+static flist_t *default_flist = NULL;
 
 /* Function prototypes */
 static inline int CheckTimeWindow(uint32_t t_start, uint32_t t_end, stat_record_t *stat_record);
 
-static void GetFileList(char *path);
+static void GetFileList(flist_t *flist, char *path);
 
 static void CleanPath(char *entry);
 
-static void Getsource_dirs(char *dirs);
+static void Getsource_dirs(flist_t *flist, char *dirs);
 
 static int mkpath(char *path, char *p, mode_t mode, mode_t dir_mode, char *error, size_t errlen);
 
@@ -242,6 +261,8 @@ static char *GuessSubDir(char *channeldir, char *filename);
 
 static char *VerifyFileRange(char *path, char *last_file);
 
+static int OpenNextFile(flist_t *flist, rfile_t *rfile, time_t twin_start, time_t twin_end, stat_record_t **stat_record);
+
 /* Functions */
 
 static int compare(const FTSENT **f1, const FTSENT **f2) {
@@ -334,12 +355,12 @@ int num;
 
 } // End of dirlevels
 
-static void CreateDirListFilter(char *first_path, char *last_path, int file_list_level) {
+static void CreateDirListFilter(flist_t *flist, char *first_path, char *last_path, int file_list_level) {
 int i;
 char *p, *q, *first_mark, *last_mark;
 
 //	printf("First Dir: '%s', first_path: '%s', last_path '%s', first_file '%s', last_file '%s', list_level: %i\n", 
-//			source_dirs.list[0], first_path, last_path, first_file, last_file, file_list_level);
+//			flist->source_dirs.list[0], first_path, last_path, flist->first_file, flist->last_file, file_list_level);
 
 	if ( file_list_level == 0 )
 		return;
@@ -349,16 +370,17 @@ char *p, *q, *first_mark, *last_mark;
 		exit(250);
 	}
 
-	dir_entry_filter = (struct entry_filter_s *)malloc((file_list_level+1) * sizeof(struct entry_filter_s));
-	if ( !dir_entry_filter ) {
+	flist->dir_entry_filter = (struct entry_filter_s *)malloc((file_list_level+1) * sizeof(struct entry_filter_s));
+	if ( !flist->dir_entry_filter ) {
 		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
 		exit(250);
 	}
+	flist->dir_entry_levels = file_list_level;
 
 	// first default entry - the directory itself
-	dir_entry_filter[0].first_entry = NULL;
-	dir_entry_filter[0].last_entry  = NULL;
-	dir_entry_filter[0].list_files  = 0;
+	flist->dir_entry_filter[0].first_entry = NULL;
+	flist->dir_entry_filter[0].last_entry  = NULL;
+	flist->dir_entry_filter[0].list_files  = 0;
 
 	first_mark = first_path;
 	last_mark  = last_path;
@@ -368,57 +390,57 @@ char *p, *q, *first_mark, *last_mark;
 			p = strchr(first_mark, '/');
 			if ( p ) {
 				*p = '\0';
-				dir_entry_filter[i].first_entry = strdup(first_path);
+				flist->dir_entry_filter[i].first_entry = strdup(first_path);
 				*p++ = '/';
 				first_mark = p;
 			} else {
-				dir_entry_filter[i].first_entry = strdup(first_path);
+				flist->dir_entry_filter[i].first_entry = strdup(first_path);
 				first_mark = NULL;
 			}
 		} else {
-			dir_entry_filter[i].first_entry = NULL;
+			flist->dir_entry_filter[i].first_entry = NULL;
 		}
-		dir_entry_filter[i].list_files  = 0;
+		flist->dir_entry_filter[i].list_files  = 0;
 
 		if ( last_mark ) {
 			q = strchr(last_mark, '/');
 			if ( q ) {
 				*q = '\0';
-				dir_entry_filter[i].last_entry = strdup(last_path);
+				flist->dir_entry_filter[i].last_entry = strdup(last_path);
 				*q++ = '/';
 				last_mark = q;
 			} else {
-				dir_entry_filter[i].last_entry = strdup(last_path);
+				flist->dir_entry_filter[i].last_entry = strdup(last_path);
 				last_mark = NULL;
 			}
 		} else {
-			dir_entry_filter[i].last_entry = NULL;
+			flist->dir_entry_filter[i].last_entry = NULL;
 		}
-		if ( dir_entry_filter[i].first_entry && dir_entry_filter[i].last_entry &&
-			 strcmp(dir_entry_filter[i].first_entry, dir_entry_filter[i].last_entry) > 0 )
+		if ( flist->dir_entry_filter[i].first_entry && flist->dir_entry_filter[i].last_entry &&
+			 strcmp(flist->dir_entry_filter[i].first_entry, flist->dir_entry_filter[i].last_entry) > 0 )
 			fprintf(stderr, "WARNING: Entry '%s' > '%s'. Will not match anything!\n",
-					dir_entry_filter[i].first_entry, dir_entry_filter[i].last_entry);
+					flist->dir_entry_filter[i].first_entry, flist->dir_entry_filter[i].last_entry);
 
 //		printf("%i first: '%s', last: '%s'\n", 
-//			i, dir_entry_filter[i].first_entry, dir_entry_filter[i].last_entry);
+//			i, flist->dir_entry_filter[i].first_entry, flist->dir_entry_filter[i].last_entry);
 	}
 
 	// the last level - files are listed here
-	dir_entry_filter[file_list_level].first_entry = first_file;
-	dir_entry_filter[file_list_level].last_entry  = last_file;
-	dir_entry_filter[file_list_level].list_files  = 1;
+	flist->dir_entry_filter[file_list_level].first_entry = flist->first_file;
+	flist->dir_entry_filter[file_list_level].last_entry  = flist->last_file;
+	flist->dir_entry_filter[file_list_level].list_files  = 1;
 
-	if ( dir_entry_filter[file_list_level].first_entry && dir_entry_filter[file_list_level].last_entry &&
-		 strcmp(dir_entry_filter[file_list_level].first_entry, dir_entry_filter[file_list_level].last_entry) > 0 )
+	if ( flist->dir_entry_filter[file_list_level].first_entry && flist->dir_entry_filter[file_list_level].last_entry &&
+		 strcmp(flist->dir_entry_filter[file_list_level].first_entry, flist->dir_entry_filter[file_list_level].last_entry) > 0 )
 		fprintf(stderr, "WARNING: File '%s' > '%s'. Will not match anything!\n",
-				dir_entry_filter[file_list_level].first_entry, dir_entry_filter[file_list_level].last_entry);
+				flist->dir_entry_filter[file_list_level].first_entry, flist->dir_entry_filter[file_list_level].last_entry);
 
 //	printf("%i first: '%s', last: '%s'\n", 
-//		file_list_level, dir_entry_filter[file_list_level].first_entry, dir_entry_filter[file_list_level].last_entry);
+//		file_list_level, flist->dir_entry_filter[file_list_level].first_entry, flist->dir_entry_filter[file_list_level].last_entry);
 
 } // End of CreateDirListFilter
 
-static void GetFileList(char *path) {
+static void GetFileList(flist_t *flist, char *path) {
 struct stat stat_buf;
 char *last_file_ptr, *first_path, *last_path;
 int levels_first_file, levels_last_file, file_list_level;
@@ -474,7 +496,7 @@ FTSENT *ftsent;
 
 	levels_first_file = dirlevels(path);
 
-	if ( source_dirs.num_strings == 0 ) {
+	if ( flist->source_dirs.num_strings == 0 ) {
 		// No multiple sources option -M
 
 		// path contains the path to a file/directory
@@ -513,10 +535,10 @@ FTSENT *ftsent;
 					// path = [/]sub1[/..]/first_file:sub1[/...]/last_file
 					if ( path[0] == '/' ) {
 						// this is rather strange, but strctly spoken, valid anyway
-						InsertString(&source_dirs, "/");
+						InsertString(&flist->source_dirs, "/");
 						path++;
 					} else {
-						InsertString(&source_dirs, ".");
+						InsertString(&flist->source_dirs, ".");
 					}
 
 					// path = sub_first[/..]/first_file:sub_last[/...]/last_file
@@ -529,8 +551,8 @@ FTSENT *ftsent;
 					}
 					*p++ = '\0';
 					*q++ = '\0';
-					first_file = strdup(p);
-					last_file = strdup(q);
+					flist->first_file = strdup(p);
+					flist->last_file = strdup(q);
 					file_list_level = levels_last_file + 1;
 					first_path = path;
 					last_path  = last_file_ptr;
@@ -551,7 +573,7 @@ FTSENT *ftsent;
 					}
 					*p++ = '\0';
 					
-					InsertString(&source_dirs, path);
+					InsertString(&flist->source_dirs, path);
 
 					r = strrchr(p, '/');
 					s = strrchr(last_file_ptr, '/');
@@ -562,8 +584,8 @@ FTSENT *ftsent;
 					}
 					*r++ = '\0';
 					*s++ = '\0';
-					first_file = strdup(r);
-					last_file = strdup(s);
+					flist->first_file = strdup(r);
+					flist->last_file = strdup(s);
 					// files are listed at this sub dir level
 					file_list_level = levels_last_file + 1;
 					first_path = p;
@@ -581,15 +603,15 @@ FTSENT *ftsent;
 					// path is [/]path/to/any/first_file:last_file
 					*p++ = '\0';
 					// path is the direcory containing all the files
-					InsertString(&source_dirs, path);
-					first_file = strdup(p);
+					InsertString(&flist->source_dirs, path);
+					flist->first_file = strdup(p);
 				} else {
 					// path is first_file:last_file
-					InsertString(&source_dirs, ".");
-					first_file = strdup(path);
+					InsertString(&flist->source_dirs, ".");
+					flist->first_file = strdup(path);
 				}
 				// set last_file filter
-				last_file  = strdup(last_file_ptr);
+				flist->last_file  = strdup(last_file_ptr);
 				// in any case we list the files of directory level 1
 				file_list_level = 1;
 			}
@@ -598,8 +620,8 @@ FTSENT *ftsent;
 			if ( S_ISDIR(stat_buf.st_mode) ) {
 				// path is [/]path/to/any/dir
 				// list all files in this directory
-				InsertString(&source_dirs, path);
-				first_file = NULL;
+				InsertString(&flist->source_dirs, path);
+				flist->first_file = NULL;
 				file_list_level = 0;
 			} else {
 				// path is [/]path/to/any/file
@@ -608,18 +630,18 @@ FTSENT *ftsent;
 					// path is [/]path/to/any/file
 					*p++ = '\0';
 					// path is the direcory containing all the files
-					InsertString(&source_dirs, path);
-					first_file = strdup(p);
+					InsertString(&flist->source_dirs, path);
+					flist->first_file = strdup(p);
 				} else {
 					// path is file
-					InsertString(&source_dirs, ".");
-					first_file = strdup(path);
+					InsertString(&flist->source_dirs, ".");
+					flist->first_file = strdup(path);
 				}
 				// in any case we list the files of directory level 1
 				file_list_level = 1;
 			}
 			// in any case, no last_file filter
-			last_file  = NULL;
+			flist->last_file  = NULL;
 		}
 
 	} else {
@@ -632,20 +654,20 @@ FTSENT *ftsent;
 
 		// special case for all files in directory
 		if ( strcmp(path, ".") == 0 ) {
-			first_file = NULL;
-			last_file  = NULL;
+			flist->first_file = NULL;
+			flist->last_file  = NULL;
 			file_list_level = 0;
 		} else {
 			// pathbuff contains the path to a file/directory, compiled using the first entry
 			// in the source_dirs
-			snprintf(pathbuff, MAXPATHLEN-1, "%s/%s", source_dirs.list[0], path);
+			snprintf(pathbuff, MAXPATHLEN-1, "%s/%s", flist->source_dirs.list[0], path);
 			pathbuff[MAXPATHLEN-1] = '\0';
 	
 			// pathbuff must point to a file
 			if ( stat(pathbuff, &stat_buf) ) {
 				if ( errno == ENOENT ) {
 					// file not found - try to guess a possible subdir
-					char *sub_dir = GuessSubDir(source_dirs.list[0], path);
+					char *sub_dir = GuessSubDir(flist->source_dirs.list[0], path);
 					if ( sub_dir ) {	// subdir found
 						snprintf(pathbuff, MAXPATHLEN-1, "%s/%s", sub_dir, path);
 						pathbuff[MAXPATHLEN-1] = '\0';
@@ -655,7 +677,7 @@ FTSENT *ftsent;
 	
 						// need guessing subdir with last_file too
 						if ( last_file_ptr ) {
-							sub_dir = GuessSubDir(source_dirs.list[0], last_file_ptr);
+							sub_dir = GuessSubDir(flist->source_dirs.list[0], last_file_ptr);
 							if ( sub_dir ) {	// subdir found
 								snprintf(pathbuff, MAXPATHLEN-1, "%s/%s", sub_dir, last_file_ptr);
 								pathbuff[MAXPATHLEN-1] = '\0';
@@ -702,21 +724,21 @@ FTSENT *ftsent;
 					// recursive all files in sub dirs
 					file_list_level = dirlevels(path) + 1;
 					*p++ = '\0';
-					first_file = strdup(p);
+					flist->first_file = strdup(p);
 					first_path = path;
 				} else {
 					// path is first_file
-					first_file = strdup(path);
+					flist->first_file = strdup(path);
 					file_list_level = 1;
 				}
 
 				q = strrchr(last_file_ptr, '/');
 				if ( q ) {
 					*q++ = '\0';
-					last_file = strdup(q);
+					flist->last_file = strdup(q);
 					last_path  = last_file_ptr;
 				} else {
-					last_file = strdup(last_file_ptr);
+					flist->last_file = strdup(last_file_ptr);
 				}
 	
 			} else {
@@ -727,30 +749,30 @@ FTSENT *ftsent;
 					// recursive all files in sub dirs
 					file_list_level = dirlevels(path) + 1;
 					*p++ = '\0';
-					first_file = strdup(p);
+					flist->first_file = strdup(p);
 					first_path = path;
 				} else {
 					// path is first_file
-					first_file = strdup(path);
+					flist->first_file = strdup(path);
 					file_list_level = 1;
 				}
-				last_file  = NULL;
+				flist->last_file  = NULL;
 			}
 		}
 	}
 
 /*
-printf("first_file %s\n", first_file ? first_file : "<none>");
-printf("last_file %s\n", last_file ? last_file : "<none>");
+printf("first_file %s\n", flist->first_file ? flist->first_file : "<none>");
+printf("last_file %s\n", flist->last_file ? flist->last_file : "<none>");
 printf("first_path %s\n", first_path ? first_path : "<none>");
 printf("last_path %s\n", last_path ? last_path : "<none>");
 printf("file_list_level: %i\n", file_list_level);
 */
-	CreateDirListFilter(first_path, last_path, file_list_level );
+	CreateDirListFilter(flist, first_path, last_path, file_list_level );
 
 	// last entry must be NULL
-	InsertString(&source_dirs, NULL);
-	fts = fts_open(source_dirs.list, FTS_LOGICAL,  compare);
+	InsertString(&flist->source_dirs, NULL);
+	fts = fts_open(flist->source_dirs.list, FTS_LOGICAL,  compare);
 	sub_index = 0;
 	while ( (ftsent = fts_read(fts)) != NULL) {
 		int fts_level = ftsent->fts_level;
@@ -772,16 +794,21 @@ printf("file_list_level: %i\n", file_list_level);
 /*
 if ( file_list_level ) 
 printf("DGB: short fts: '%s', filer_first: '%s', filter_last: '%s'\n", 
-					fts_path, dir_entry_filter[fts_level].first_entry , dir_entry_filter[fts_level].last_entry);
+					fts_path, flist->dir_entry_filter[fts_level].first_entry , flist->dir_entry_filter[fts_level].last_entry);
 */
 		switch (ftsent->fts_info) {
 			case FTS_D:
+				// skip the address index
+				if ( strcmp(ftsent->fts_name, IPINDEX_DIR) == 0 ) {
+					fts_set(fts, ftsent, FTS_SKIP );
+					break;
+				}
 				// dir entry pre descend
 				if ( file_list_level && file_list_level && (
-					( dir_entry_filter[fts_level].first_entry &&
-						( strcmp(fts_path, dir_entry_filter[fts_level].first_entry ) < 0 ) ) ||
-					( dir_entry_filter[fts_level].last_entry && 
-					  	( strcmp(fts_path, dir_entry_filter[fts_level].last_entry ) > 0 ) ) 
+					( flist->dir_entry_filter[fts_level].first_entry &&
+						( strcmp(fts_path, flist->dir_entry_filter[fts_level].first_entry ) < 0 ) ) ||
+					( flist->dir_entry_filter[fts_level].last_entry && 
+					  	( strcmp(fts_path, flist->dir_entry_filter[fts_level].last_entry ) > 0 ) ) 
 				   ))
 					fts_set(fts, ftsent, FTS_SKIP );
 
@@ -798,18 +825,22 @@ printf("DGB: short fts: '%s', filer_first: '%s', filter_last: '%s'\n",
 					continue;
 				if ( strstr(ftsent->fts_name, ".stat") != NULL )
 					continue;
+				// skip block index, address filter and rollup
+				if ( strstr(ftsent->fts_name, INDEX_SUFFIX) != NULL || strstr(ftsent->fts_name, BLOOM_SUFFIX) != NULL ||
+					 strstr(ftsent->fts_name, ROLLUP_SUFFIX) != NULL )
+					continue;
 
 				if ( file_list_level && (
 					( fts_level != file_list_level ) ||
-					( dir_entry_filter[fts_level].first_entry && 
-						( strcmp(ftsent->fts_name, dir_entry_filter[fts_level].first_entry) < 0 ) ) ||
-					( dir_entry_filter[fts_level].last_entry &&
-					  	( strcmp(ftsent->fts_name, dir_entry_filter[fts_level].last_entry) > 0 ) )
+					( flist->dir_entry_filter[fts_level].first_entry && 
+						( strcmp(ftsent->fts_name, flist->dir_entry_filter[fts_level].first_entry) < 0 ) ) ||
+					( flist->dir_entry_filter[fts_level].last_entry &&
+					  	( strcmp(ftsent->fts_name, flist->dir_entry_filter[fts_level].last_entry) > 0 ) )
 				   ) )
 					continue;
 
 // printf("==> Listed: %s\n", ftsent->fts_path);
-				InsertString(&file_list, ftsent->fts_path);
+				InsertString(&flist->file_list, ftsent->fts_path);
 
 				break;
 		}
@@ -829,7 +860,7 @@ printf("DGB: short fts: '%s', filer_first: '%s', filter_last: '%s'\n",
  * 	/any/path is dir prefix, which may be NULL e.g. dir1:dir2:dir3:...
  * 	dir1, dir2 etc entrys
  */
-void Getsource_dirs(char *dirs) {
+static void Getsource_dirs(flist_t *flist, char *dirs) {
 struct stat stat_buf;
 char	*p, *q, *dirprefix;
 char	path[MAXPATHLEN];
@@ -865,7 +896,7 @@ char	path[MAXPATHLEN];
 			}
 
 			// save path into source_dirs
-			InsertString(&source_dirs, path);
+			InsertString(&flist->source_dirs, path);
 
 			p = q ? q + 1 : NULL;
 		}
@@ -881,56 +912,69 @@ char	path[MAXPATHLEN];
 		}
 
 		// save the path into source_dirs
-		InsertString(&source_dirs, dirs);
+		InsertString(&flist->source_dirs, dirs);
 	}
 
 } // End of Getsource_dirs
 
-void SetupInputFileSequence(char *multiple_dirs, char *single_file, char *multiple_files) {
+flist_t *SetupInputFileSequence_r(char *multiple_dirs, char *single_file, char *multiple_files) {
+flist_t	*flist;
+rfile_t	rfile;
 char *error;
 int	fd;
 
-	twin_first  = 0;
-	twin_last   = 0xffffffff;
+	flist = (flist_t *)calloc(1, sizeof(flist_t));
+	if ( !flist ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		exit(250);
+	}
+
+	flist->twin_first  = 0;
+	flist->twin_last   = 0xffffffff;
 
-	first_file 	= NULL;
-	last_file  	= NULL;
+	flist->first_file 	= NULL;
+	flist->last_file  	= NULL;
+	flist->current_file	= "";
+	flist->cnt			= 0;
 
-	InitStringlist(&source_dirs, NUM_PTR);
-	InitStringlist(&file_list, 64);
+	InitStringlist(&flist->source_dirs, NUM_PTR);
+	InitStringlist(&flist->file_list, 64);
 
 	if ( multiple_dirs ) 
-		Getsource_dirs(multiple_dirs);
+		Getsource_dirs(flist, multiple_dirs);
 
 	if ( multiple_files ) {
 		// use multiple files
-		GetFileList(multiple_files);
+		GetFileList(flist, multiple_files);
 
 		// get time window spanning all the files 
-		if ( file_list.num_strings ) {
+		if ( flist->file_list.num_strings ) {
 			stat_record_t *stat_ptr;
 
-			fd = OpenFile(file_list.list[0], &stat_ptr, &error);	// read the stat record
+			memset((void *)&rfile, 0, sizeof(rfile_t));
+			fd = OpenFile_r(&rfile, flist->file_list.list[0], &stat_ptr, &error);	// read the stat record
 			if ( error != NULL ) {
 				fprintf(stderr, "%s\n", error);
 				exit(250);
 			}
 			close(fd);
-			twin_first = stat_ptr->first_seen;
-			fd = OpenFile(file_list.list[file_list.num_strings-1], &stat_ptr, &error);	// read the stat record of last file
+			flist->twin_first = stat_ptr->first_seen;
+			fd = OpenFile_r(&rfile, flist->file_list.list[flist->file_list.num_strings-1], &stat_ptr, &error);	// read the stat record of last file
 			if ( error != NULL ) {
 				fprintf(stderr, "%s\n", error);
 				exit(250);
 			}
 			close(fd);
-			twin_last  = stat_ptr->last_seen;
+			flist->twin_last  = stat_ptr->last_seen;
+			if ( rfile.lzo_buff )
+				free(rfile.lzo_buff);
 		}
 
 	} else if ( single_file ) {
 		CleanPath(single_file);
 
-		if ( source_dirs.num_strings == 0 ) {
-				InsertString(&file_list, single_file);
+		if ( flist->source_dirs.num_strings == 0 ) {
+				InsertString(&flist->file_list, single_file);
 		} else {
 			int i;
 
@@ -939,20 +983,20 @@ int	fd;
 				exit(250);
 			}
 
-			for ( i=0; i<source_dirs.num_strings; i++ ) {
+			for ( i=0; i<flist->source_dirs.num_strings; i++ ) {
 				char s[MAXPATHLEN];
 				struct stat stat_buf;
 
-				snprintf(s, MAXPATHLEN-1, "%s/%s", source_dirs.list[i], single_file);
+				snprintf(s, MAXPATHLEN-1, "%s/%s", flist->source_dirs.list[i], single_file);
 				s[MAXPATHLEN-1] = '\0';
 				if ( stat(s, &stat_buf) ) {
 					if ( errno == ENOENT ) {
 						// file not found - try to guess subdir
-						char *sub_dir = GuessSubDir(source_dirs.list[i], single_file);
+						char *sub_dir = GuessSubDir(flist->source_dirs.list[i], single_file);
 						if ( sub_dir ) {	// subdir found
-							snprintf(s, MAXPATHLEN-1, "%s/%s/%s", source_dirs.list[i], sub_dir, single_file);
+							snprintf(s, MAXPATHLEN-1, "%s/%s/%s", flist->source_dirs.list[i], sub_dir, single_file);
 							s[MAXPATHLEN-1] = '\0';
-							InsertString(&file_list, s);
+							InsertString(&flist->file_list, s);
 						} else {	// no subdir found
 							fprintf(stderr, "stat() error '%s': %s\n", s, "File not found!");
 						}
@@ -964,71 +1008,171 @@ int	fd;
 					if ( !S_ISREG(stat_buf.st_mode) ) {
 						fprintf(stderr, "Skip non file entry: '%s'\n", s);
 					} else {
-						InsertString(&file_list, s);
+						InsertString(&flist->file_list, s);
 					}
 				}
 			}
 		}
 
 	} else // else use stdin
-		InsertString(&file_list, NULL);
+		InsertString(&flist->file_list, NULL);
+
+	return flist;
+
+} // End of SetupInputFileSequence_r
+
+void SetupInputFileSequence(char *multiple_dirs, char *single_file, char *multiple_files) {
+
+	if ( default_flist )
+		DisposeFileSequence(default_flist);
+
+	default_flist = SetupInputFileSequence_r(multiple_dirs, single_file, multiple_files);
 
 } // End of SetupInputFileSequence
 
-char *GetCurrentFilename(void) {
-	return current_file;
-} // End of GetCurrentFilename
+void DisposeFileSequence(flist_t *flist) {
+int i;
 
-int GetNextFile(int current, time_t twin_start, time_t twin_end, stat_record_t **stat_record) {
-stat_record_t *stat_ptr;
-char *error;
-int fd;
-static int cnt;
+	if ( !flist )
+		return;
 
-	// is it first time init ?
-	if ( current < 0 ) {
-		cnt  = 0;
+	for ( i=0; i<flist->file_list.num_strings; i++ ) {
+		if ( flist->file_list.list[i] )
+			free(flist->file_list.list[i]);
 	}
+	if ( flist->file_list.list )
+		free(flist->file_list.list);
 
-	// close current file before open the next one
-	// stdin ( current = 0 ) is not closed
-	if ( current > 0 ) {
-		close(current);
-		current_file[0] = '\0';
+	for ( i=0; i<flist->source_dirs.num_strings; i++ ) {
+		if ( flist->source_dirs.list[i] )
+			free(flist->source_dirs.list[i]);
 	}
+	if ( flist->source_dirs.list )
+		free(flist->source_dirs.list);
+
+	if ( flist->dir_entry_filter ) {
+		// the last level points to first_file and last_file
+		for ( i=1; i<flist->dir_entry_levels; i++ ) {
+			if ( flist->dir_entry_filter[i].first_entry )
+				free(flist->dir_entry_filter[i].first_entry);
+			if ( flist->dir_entry_filter[i].last_entry )
+				free(flist->dir_entry_filter[i].last_entry);
+		}
+		free(flist->dir_entry_filter);
+	}
+
+	if ( flist->first_file )
+		free(flist->first_file);
+	if ( flist->last_file )
+		free(flist->last_file);
+
+	if ( flist == default_flist )
+		default_flist = NULL;
+
+	free(flist);
+
+} // End of DisposeFileSequence
+
+void SetFileFilter(file_filter_t file_filter, void *data) {
+
+	if ( default_flist ) 
+		SetFileFilter_r(default_flist, file_filter, data);
+
+} // End of SetFileFilter
+
+void SetFileFilter_r(flist_t *flist, file_filter_t file_filter, void *data) {
+
+	if ( !flist ) 
+		return;
+
+	flist->file_filter		= file_filter;
+	flist->file_filter_data = data;
+
+} // End of SetFileFilter_r
+
+char *GetCurrentFilename(void) {
+	return default_flist ? default_flist->current_file : "";
+} // End of GetCurrentFilename
+
+char *GetCurrentFilename_r(flist_t *flist) {
+	return flist->current_file;
+} // End of GetCurrentFilename_r
+
+// file sequence of the non reentrant functions
+flist_t *GetFileSequence(void) {
+	return default_flist;
+} // End of GetFileSequence
+
+// start the sequence over with the first file
+void RewindFileSequence_r(flist_t *flist) {
+
+	flist->cnt			 = 0;
+	flist->current_file	 = "";
+	flist->skipped_files = 0;
+
+} // End of RewindFileSequence_r
+
+uint32_t GetSkippedFiles(void) {
+	return default_flist ? default_flist->skipped_files : 0;
+} // End of GetSkippedFiles
+
+/*
+ * Opens the next file of the sequence, which matches the time window.
+ * Uses the handle rfile, or the non reentrant OpenFile() if rfile is NULL
+ */
+static int OpenNextFile(flist_t *flist, rfile_t *rfile, time_t twin_start, time_t twin_end, stat_record_t **stat_record) {
+stat_record_t *stat_ptr;
+char *error, *filename;
+int fd;
 
 	// no or no more files available
-	if ( file_list.num_strings == cnt ) {
+	if ( flist == NULL || flist->file_list.num_strings == flist->cnt ) {
 		if ( stat_record )
 			*stat_record = NULL;
 		return EMPTY_LIST;
 	}
 	
 /*
-	while ( cnt < file_list.num_strings ) {
-		printf("Process: '%s'\n", file_list.list[cnt++]);
+	while ( flist->cnt < flist->file_list.num_strings ) {
+		printf("Process: '%s'\n", flist->file_list.list[flist->cnt++]);
 	}
 */
 
-	while ( cnt < file_list.num_strings ) {
-		fd = OpenFile(file_list.list[cnt], &stat_ptr, &error);	// Open the file
-		cnt++;
+	while ( flist->cnt < flist->file_list.num_strings ) {
+		filename = flist->file_list.list[flist->cnt];
+		if ( rfile ) 
+			fd = OpenFile_r(rfile, filename, &stat_ptr, &error);	// Open the file
+		else
+			fd = OpenFile(filename, &stat_ptr, &error);	// Open the file
+		flist->cnt++;
 
 		// stdin
 		if ( fd == STDIN_FILENO ) {
 			if ( stat_record )
 				*stat_record = NULL;
-			CurrentIdent = "none";
+			if ( !rfile ) 
+				CurrentIdent = "none";
+			flist->current_file = "<stdin>";
 			return fd;
 		}
 
 		if ( fd > 0 && CheckTimeWindow(twin_start, twin_end, stat_ptr) ) {
-			// printf("Return file: %s\n", string);
-			if ( stat_record ) 
-				*stat_record = stat_ptr;
-			return fd;
+			if ( !flist->file_filter || flist->file_filter(filename, rfile ? rfile : GetRFile(), flist->file_filter_data) ) {
+				// printf("Return file: %s\n", string);
+				if ( stat_record ) 
+					*stat_record = stat_ptr;
+				flist->current_file = filename;
+				// skip the blocks outside the time window, if the file is indexed
+				if ( twin_start ) 
+					OpenIndex_r(rfile ? rfile : GetRFile(), filename, twin_start, twin_end);
+				return fd;
+			}
+			flist->skipped_files++;
 		} 
-		close(fd);
+		if ( fd > 0 ) 
+			close(fd);
+		if ( rfile ) 
+			rfile->rfd = -1;
 		if ( error != NULL ) 
 			fprintf(stderr, "%s\n", error);
 	}
@@ -1038,8 +1182,44 @@ static int cnt;
 
 	return EMPTY_LIST;
 
+} // End of OpenNextFile
+
+int GetNextFile(int current, time_t twin_start, time_t twin_end, stat_record_t **stat_record) {
+
+	// is it first time init ?
+	if ( current < 0 && default_flist ) {
+		default_flist->cnt  = 0;
+	}
+
+	// close current file before open the next one
+	// stdin ( current = 0 ) is not closed
+	if ( current > 0 ) {
+		close(current);
+	}
+	if ( default_flist )
+		default_flist->current_file = "";
+
+	return OpenNextFile(default_flist, NULL, twin_start, twin_end, stat_record);
+
 } // End of GetNextFile
 
+int GetNextFile_r(flist_t *flist, rfile_t *rfile, time_t twin_start, time_t twin_end, stat_record_t **stat_record) {
+
+	// close current file before open the next one
+	CloseFile_r(rfile);
+	flist->current_file = "";
+
+	return OpenNextFile(flist, rfile, twin_start, twin_end, stat_record);
+
+} // End of GetNextFile_r
+
+void InitFileCnt(void) {
+
+	if ( default_flist )
+		default_flist->cnt = 0;
+
+} // End of InitFileCnt
+
 
 int InitHierPath(int num) {
 int i;
@@ -38,6 +38,13 @@
 #ifndef _FLIST_H
 #define _FLIST_H 1
 
+// opaque handle of an input file sequence
+typedef struct flist_s flist_t;
+
+// returns 0, if no record of file filename is needed. May select the blocks
+// to be read with rfile, the handle of the file just opened
+typedef int (*file_filter_t)(char *filename, rfile_t *rfile, void *data);
+
 int InitHierPath(int num);
 
 char *GetSubDir(struct  tm *now);
@@ -47,4 +54,23 @@ int SetupSubDir(char *dir, char *subdir, char *error, size_t errlen );
 int GetNextFile(int current, time_t twin_start, time_t twin_end, stat_record_t **stat_record);
 
 void InitFileCnt(void);
+
+flist_t *SetupInputFileSequence_r(char *multiple_dirs, char *single_file, char *multiple_files);
+
+int GetNextFile_r(flist_t *flist, rfile_t *rfile, time_t twin_start, time_t twin_end, stat_record_t **stat_record);
+
+char *GetCurrentFilename_r(flist_t *flist);
+
+void DisposeFileSequence(flist_t *flist);
+
+flist_t *GetFileSequence(void);
+
+void RewindFileSequence_r(flist_t *flist);
+
+void SetFileFilter(file_filter_t file_filter, void *data);
+
+uint32_t GetSkippedFiles(void);
+
+void SetFileFilter_r(flist_t *flist, file_filter_t file_filter, void *data);
+
 #endif //_FLIST_H
@@ -207,6 +207,7 @@ size_t				len;
 	nffile.file_blocks  = 0;
 	nffile.compress	 = 0;
 	nffile.wfd		  = 0;
+	nffile.writer	   = NULL;
 
 
 	nffile.block_header = (data_block_header_t *)malloc(sizeof(data_block_header_t) + BUFFSIZE);
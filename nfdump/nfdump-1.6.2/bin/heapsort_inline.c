@@ -39,6 +39,8 @@ static void heapSort(SortElement_t *SortElement, uint32_t array_size, int topN);
 
 static inline void siftDown(SortElement_t *SortElement, uint32_t root, uint32_t bottom);
 
+static inline uint32_t topNInsert(SortElement_t *SortElement, uint32_t num, uint32_t topN, void *record, uint64_t count);
+
 static void heapSort(SortElement_t *SortElement, uint32_t array_size, int topN) {
 int32_t	i, maxindex;
 
@@ -88,3 +90,49 @@ uint32_t i, parent, child;
         }
     }
 } // End of siftDown
+
+/*
+ * Bounded top N selection: SortElement holds the num largest elements seen so far as min heap
+ * with the smallest element at the root, num <= topN. A new element replaces the root, if it is
+ * larger. Returns the new number of elements. heapSort() sorts the elements afterwards.
+ */
+static inline uint32_t topNInsert(SortElement_t *SortElement, uint32_t num, uint32_t topN, void *record, uint64_t count) {
+uint32_t i, parent, child;
+
+	if ( num < topN ) {
+		// heap not yet full - sift up the new element
+		i = num;
+		while ( i > 0 ) {
+			parent = (i - 1) >> 1;
+			if ( SortElement[parent].count <= count )
+				break;
+			SortElement[i] = SortElement[parent];
+			i = parent;
+		}
+		SortElement[i].record = record;
+		SortElement[i].count  = count;
+		return num + 1;
+	}
+
+	if ( count <= SortElement[0].count )
+		return num;
+
+	// replace the smallest element and sift it down
+	i = 0;
+	while ( 1 ) {
+		child = 2*i+1;
+		if ( child >= num )
+			break;
+		if ( (child + 1) < num && SortElement[child+1].count < SortElement[child].count )
+			child++;
+		if ( SortElement[child].count >= count )
+			break;
+		SortElement[i] = SortElement[child];
+		i = child;
+	}
+	SortElement[i].record = record;
+	SortElement[i].count  = count;
+
+	return num;
+
+} // End of topNInsert
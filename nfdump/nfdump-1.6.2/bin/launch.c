@@ -40,6 +40,8 @@
 
 #include <signal.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/wait.h>
@@ -72,6 +74,7 @@
 #include "expire.h"
 #include "nffile.h"
 #include "collector.h"
+#include "nfrollup.h"
 
 static int done, launch, child_exit;
 
@@ -321,7 +324,7 @@ int				ret, bookkeeper_stat, do_rescan;
 
 } // End of do_expire
 
-void launcher (char *commbuff, FlowSource_t *FlowSource, char *process, int expire) {
+void launcher (char *commbuff, FlowSource_t *FlowSource, char *process, int expire, int build_index, uint32_t rollup_keys) {
 FlowSource_t	*fs;
 struct sigaction act;
 char 		*args[MAXARGS];
@@ -330,9 +333,24 @@ srecord_t	*InfoRecord;
 
 	InfoRecord = (srecord_t *)commbuff;
 
-	syslog(LOG_INFO, "Launcher: Startup. auto-expire %s", expire ? "enabled" : "off" );
+	syslog(LOG_INFO, "Launcher: Startup. auto-expire %s, index %s, rollup %s", expire ? "enabled" : "off", 
+		build_index ? "enabled" : "off", rollup_keys ? "enabled" : "off" );
 	done = launch = child_exit = 0;
 
+	// the address index of each flow source is updated with the new files
+	if ( build_index ) {
+		char path[MAXPATHLEN];
+
+		fs = FlowSource;
+		while ( fs ) {
+			snprintf(path, MAXPATHLEN, "%s/%s", fs->datadir, IPINDEX_DIR);
+			path[MAXPATHLEN-1] = 0;
+			if ( mkdir(path, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) < 0 && errno != EEXIST ) 
+				syslog(LOG_ERR, "Launcher: ident: %s, Failed to create address index '%s': %s", fs->Ident, path, strerror(errno));
+			fs = fs->next;
+		}
+	}
+
 	// process may be NULL, if we only expire data files
 	if ( process ) {
 		char 		*cmd = NULL;
@@ -374,6 +392,28 @@ srecord_t	*InfoRecord;
 		if ( launch ) {	// SIGHUP
 			launch = 0;
 
+			// index and rollup the new files first, so the launched processes may use them
+			if ( build_index || rollup_keys ) {
+				char path[MAXPATHLEN];
+
+				fs = FlowSource;
+				while ( fs ) {
+					snprintf(path, MAXPATHLEN, "%s/%s", fs->datadir, InfoRecord->fname);
+					path[MAXPATHLEN-1] = 0;
+					if ( build_index ) {
+						syslog(LOG_DEBUG, "Launcher: ident: %s index file: '%s'", fs->Ident, path);
+						if ( !IndexFile(path) ) 
+							syslog(LOG_ERR, "Launcher: ident: %s, Failed to index file: '%s'", fs->Ident, path);
+					}
+					if ( rollup_keys ) {
+						syslog(LOG_DEBUG, "Launcher: ident: %s rollup file: '%s'", fs->Ident, path);
+						if ( !RollupFile(path, rollup_keys) ) 
+							syslog(LOG_ERR, "Launcher: ident: %s, Failed to rollup file: '%s'", fs->Ident, path);
+					}
+					fs = fs->next;
+				}
+			}
+
 			if ( process ) {
 				char 		*cmd = NULL;
 
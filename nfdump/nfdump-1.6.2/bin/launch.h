@@ -50,6 +50,6 @@ typedef struct srecord_s {
 	time_t	tstamp;					// UNIX time stamp
 } srecord_t;
 
-void launcher (char *commbuff, char *datadir, char *process, int expire);
+void launcher (char *commbuff, char *datadir, char *process, int expire, int build_index, uint32_t rollup_keys);
 
 #endif //_LAUNCH_H
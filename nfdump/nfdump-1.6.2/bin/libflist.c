@@ -0,0 +1 @@
+flist.c
\ No newline at end of file
@@ -0,0 +1 @@
+grammar.y
\ No newline at end of file
@@ -0,0 +1 @@
+ipconv.c
\ No newline at end of file
@@ -0,0 +1 @@
+minilzo.c
\ No newline at end of file
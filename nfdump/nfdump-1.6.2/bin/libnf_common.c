@@ -0,0 +1 @@
+nf_common.c
\ No newline at end of file
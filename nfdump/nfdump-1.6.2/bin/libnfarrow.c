@@ -0,0 +1 @@
+nfarrow.c
\ No newline at end of file
@@ -64,6 +64,7 @@
 #include <arpa/inet.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <pthread.h>
 
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
@@ -73,6 +74,11 @@
 #include "nfx.h"
 #include "util.h"
 #include "flist.h"
+#include "rbtree.h"
+#include "nftree.h"
+#include "readahead.h"
+#include "nfarrow.h"
+#include "nfmerge.h"
 #include "libnfdump.h"
 #define BUFFSIZE 1048576
 #define MAX_BUFFER_SIZE 104857600
@@ -83,17 +89,74 @@ typedef uint64_t    pointer_addr_t;
 typedef uint32_t    pointer_addr_t;
 #endif
 
-// module limited globals
-extension_map_list_t extension_map_list;
+// number of records passed to the callback at once in parallel mode
+#define PARALLEL_BATCH_SIZE 1024
+
+/* file sequence shared by all workers of a parallel scan */
+typedef struct libnfshared_s {
+	flist_t			*flist;
+	pthread_mutex_t	lock;
+	libnf_callback_t	callback;
+	void			*data;
+	FilterEngine_data_t	*engine;
+} libnfshared_t;
+
+/* 
+ * decoder of an extension map for a projection: offsets of the projected 
+ * optional extensions relative to the end of the required extensions
+ */
+typedef struct libnf_decoder_s {
+	uint32_t	num_ops;
+	struct {
+		uint16_t	id;
+		uint16_t	offset;
+	} op[1];
+} libnf_decoder_t;
+
+// decoders cached as expansion plans of the extension maps, see nfx.h
+#define PLAN_PROJECTION	0
+#define PLAN_COLUMNS	1
+
+extern extension_descriptor_t extension_descriptor[];
+
+/* the filter parser uses global state - compile one filter at a time */
+static pthread_mutex_t filter_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /* Function Prototypes */
 static int try_next_block(libnfstates_t* states);
 
+static int read_next_block(libnfstates_t* states, int columns);
+
+static libnfstates_t *new_states(void);
+
+static int next_file(libnfstates_t* states);
+
+static FilterEngine_data_t *compile_filter(char *filter);
+
+static libnf_decoder_t *build_decoder(extension_map_t *map, uint32_t projection);
+
+static inline libnf_decoder_t *get_decoder(extension_info_t *extension_info, int plan, uint32_t projection);
+
+static inline void ExpandExtensions_columns(void *p, libnf_decoder_t *decoder, libnf_columns_t *columns);
+
+static void *parallel_worker(void *arg);
+
+static int next_merged_record(libnfstates_t* states, master_record_t *master_record);
+
 /* Exported functions of the library*/
 void print_record(void *record);
 libnfstates_t* initlib(char* Mdirs, char* rfile, char* Rfile);
 void libcleanup(libnfstates_t* states);
 master_record_t* get_next_record(libnfstates_t* states);
+int get_next_records(libnfstates_t* states, master_record_t* records, int max);
+int set_filter(libnfstates_t* states, char *filter);
+int set_projection(libnfstates_t* states, uint32_t fields);
+int set_readahead(libnfstates_t* states, int num_blocks);
+int set_time_order(libnfstates_t* states, int window);
+libnf_columns_t* new_columns(int max_records);
+void free_columns(libnf_columns_t* columns);
+int get_next_columns(libnfstates_t* states, libnf_columns_t* columns);
+long process_parallel(char* Mdirs, char* rfile, char* Rfile, char *filter, int num_workers, libnf_callback_t callback, void *data);
 
 /* Functions */
 
@@ -152,9 +215,10 @@ master_record_t *r = (master_record_t *)record;
 } // End of print_record
 
 
-libnfstates_t* initlib(char* Mdirs, char* rfile, char* Rfile)
-{
-	libnfstates_t *states;
+// Allocates an instance with its own extension maps, file handle and read buffer
+static libnfstates_t *new_states(void) {
+libnfstates_t *states;
+
     states = malloc(sizeof(libnfstates_t));
     if (!states) {
         perror("Memory allocation error");
@@ -168,166 +232,1039 @@ libnfstates_t* initlib(char* Mdirs, char* rfile, char* Rfile)
     states->v1_map_done = 0;
     #endif
 
-    InitExtensionMaps(&extension_map_list);
-   	SetupInputFileSequence(Mdirs, rfile, Rfile);
-
-    InitFileCnt(); 
-	states->rfd = GetNextFile(0, 0, 0, NULL);
-	if ( states->rfd < 0 ) {
-		if ( states->rfd == FILE_ERROR )
-			perror("Can't open input file for reading");
-		return NULL;
-	}
+	/* Each instance has its own extension maps, file handle and buffer */
+	states->extension_map_list = malloc(sizeof(extension_map_list_t));
+	states->rfile = NewRFile();
 
 	// allocate buffer suitable for netflow version
 	states->buffer_size = BUFFSIZE;
 	states->in_buff = (common_record_t *) malloc(states->buffer_size);
 
-	if ( !states->in_buff ) {
+	if ( !states->extension_map_list || !states->rfile || !states->in_buff ) {
 		perror("Memory allocation error");
-		close(states->rfd);
+		libcleanup(states);
 		return NULL;
 	}
+	// columnar blocks are decoded by read_next_block, only the columns needed
+	states->rfile->keep_columns = 1;
+    InitExtensionMaps(states->extension_map_list);
 
+	states->rfd = -1;
+	states->filename = "";
+	states->projection = LIBNF_FIELD_ALL;
 	states->done = 0;
 	states->inblock = 0;
 	states->records_present = 0;
+
+	return states;
+
+} // End of new_states
+
+libnfstates_t* initlib(char* Mdirs, char* rfile, char* Rfile)
+{
+	libnfstates_t *states;
+
+	states = new_states();
+	if ( !states ) 
+		return NULL;
+
+   	states->flist = SetupInputFileSequence_r(Mdirs, rfile, Rfile);
+
+	if ( next_file(states) < 0 ) {
+		if ( states->rfd == FILE_ERROR )
+			perror("Can't open input file for reading");
+		libcleanup(states);
+		return NULL;
+	}
+
     return states;
 }
 
 
 void libcleanup(libnfstates_t* states)
 { 
-	if ( states->rfd > 0 ) 
-		close(states->rfd);
+	if ( !states )
+		return;
+
+	// stop the reader thread before the file is closed
+	DisposeReadAhead(states->readahead);
+
+	if ( states->rfile ) 
+		DisposeRFile(states->rfile);
+
+	if ( states->flist ) 
+		DisposeFileSequence(states->flist);
+
+	if ( states->extension_map_list ) {
+		FreeExtensionMaps(states->extension_map_list);
+		free(states->extension_map_list);
+	}
+
+	if ( states->in_buff ) 
+		free(states->in_buff);
 
-	free(states->in_buff);
+	DisposeColumnReader(states->column_reader);
 
-	PackExtensionMapList(&extension_map_list);
+	if ( states->column_buff ) 
+		free(states->column_buff);
+
+	if ( states->engine ) 
+		DisposeFilterEngine(states->engine);
+
+	CloseMergeReader(states->merge);
+
+	free(states);
 }
 
+// Opens the next file of the sequence. The sequence is locked, if it is shared
+// with other workers
+static int next_file(libnfstates_t* states) {
+libnfshared_t *shared = states->shared;
 
+	if ( states->readahead ) 
+		StopReadAhead(states->readahead);
 
-// Returns 0 if there are more records
-// Returns 1 if there are no records
-// The master record is returned via argument
-static int try_next_block(libnfstates_t* states) {
-	/* By default no blocks are assumed */
-	states->records_present = 0;
-	// Get the first file handle
-	if ( !states->done ) {
-		if (!states->inblock){
-		// get next data block from file
-		states->ret = ReadBlock(states->rfd, &(states->block_header), (void *)states->in_buff, &(states->string));
-
-		switch (states->ret) {
-			case NF_CORRUPT:
-			case NF_ERROR:
-				if ( states->ret == NF_CORRUPT )
-					fprintf(stderr, "Skip corrupt data file '%s': '%s'\n",GetCurrentFilename(), states->string);
-				else 
-					fprintf(stderr, "Read error in file '%s': %s\n",GetCurrentFilename(), strerror(errno) );
-				// fall through - get next file in chain
-			case NF_EOF:
-				states->rfd = GetNextFile(states->rfd, 0, 0, NULL);
-				if ( states->rfd < 0 ) {
-					if ( states->rfd == NF_ERROR )
-						fprintf(stderr, "Read error in file '%s': %s\n",GetCurrentFilename(), strerror(errno) );
-
-					// rfd == EMPTY_LIST
-					states->done = 1;
-				} // else continue with next file
-				return 0;	
+	if ( shared ) {
+		pthread_mutex_lock(&shared->lock);
+		states->rfd = GetNextFile_r(shared->flist, states->rfile, 0, 0, NULL);
+		states->filename = GetCurrentFilename_r(shared->flist);
+		pthread_mutex_unlock(&shared->lock);
+	} else {
+		states->rfd = GetNextFile_r(states->flist, states->rfile, 0, 0, NULL);
+		states->filename = GetCurrentFilename_r(states->flist);
+	}
+
+	if ( states->readahead && states->rfd >= 0 ) 
+		StartReadAhead(states->readahead, states->rfile);
+
+	return states->rfd;
+
+} // End of next_file
+
+// Compiles an nfdump filter expression. Returns NULL on syntax errors
+static FilterEngine_data_t *compile_filter(char *filter) {
+FilterEngine_data_t *engine;
+
+	pthread_mutex_lock(&filter_lock);
+	engine = CompileFilter(filter);
+	pthread_mutex_unlock(&filter_lock);
+
+	return engine;
+
+} // End of compile_filter
+
+int set_filter(libnfstates_t* states, char *filter)
+{
+FilterEngine_data_t *engine;
+
+	if ( !states || states->shared ) 
+		return 0;
+
+	// no filter - return all records
+	if ( !filter ) {
+		if ( states->engine ) 
+			DisposeFilterEngine(states->engine);
+		states->engine = NULL;
+		SetFileFilter_r(states->flist, NULL, NULL);
+		return 1;
+	}
+
+	engine = compile_filter(filter);
+	if ( !engine ) {
+		fprintf(stderr, "Filter syntax error: '%s'\n", filter);
+		return 0;
+	}
+
+	// ident filters match against the file read by this instance
+	engine->ident = states->rfile->file_header.ident;
+
+	if ( states->engine ) 
+		DisposeFilterEngine(states->engine);
+	states->engine = engine;
+
+	// skip the files, which cannot match according to their address filter
+	SetFileFilter_r(states->flist, FileMayMatch, engine);
+
+	// no remaining record of the current file can match either
+	if ( !states->inblock && states->rfd > 0 && !FileMayMatch(states->filename, NULL, engine) ) {
+		if ( next_file(states) < 0 ) 
+			states->done = 1;
+	}
+
+	return 1;
+
+} // End of set_filter
+
+int set_readahead(libnfstates_t* states, int num_blocks)
+{
+	// blocks already read ahead would be lost, if the reader was replaced
+	if ( !states || states->shared || states->readahead ) 
+		return 0;
+
+	if ( num_blocks <= 0 ) 
+		return 1;
+
+	states->readahead = NewReadAhead(num_blocks);
+	if ( !states->readahead ) 
+		return 0;
+
+	if ( states->rfd >= 0 && !states->done ) 
+		StartReadAhead(states->readahead, states->rfile);
+
+	return 1;
+
+} // End of set_readahead
+
+int set_time_order(libnfstates_t* states, int window)
+{
+	// records already read can not be ordered any more
+	if ( !states || states->shared || states->merge || states->inblock || window < 0 ) 
+		return 0;
+
+	if ( states->readahead ) 
+		StopReadAhead(states->readahead);
+
+	// the merge reader opens the files of the sequence itself
+	CloseFile_r(states->rfile);
+	states->rfd = -1;
+	RewindFileSequence_r(states->flist);
+
+	states->merge = OpenMergeSequence(states->flist, 0, 0);
+	if ( !states->merge || !SetMergeWindow(states->merge, window) ) {
+		CloseMergeReader(states->merge);
+		states->merge = NULL;
+		states->done  = 1;
+		return 0;
+	}
+	states->done = 0;
+
+	return 1;
+
+} // End of set_time_order
+
+// Expands the next record of the time ordered merge, which matches the filter
+// Returns 1 if a record was expanded into master_record, 0 if there are no more records
+static int next_merged_record(libnfstates_t* states, master_record_t *master_record) {
+common_record_t *flow_record;
+extension_info_t *extension_info;
+
+	while ( (flow_record = NextMergeRecord(states->merge, &extension_info, NULL)) != NULL ) {
+		ExpandRecord_v2( flow_record, extension_info, master_record);
+		if ( !states->engine ) 
+			return 1;
+
+		states->engine->nfrecord = (uint64_t *)master_record;
+		if ( (*states->engine->FilterEngine)(states->engine) ) 
+			return 1;
+	}
+	states->done = 1;
+
+	return 0;
+
+} // End of next_merged_record
+
+// Builds the decoder of an extension map for the projection of the instance
+static libnf_decoder_t *build_decoder(extension_map_t *map, uint32_t projection) {
+libnf_decoder_t *decoder;
+uint32_t	i, num_ext;
+uint16_t	id, offset;
+
+	num_ext = 0;
+	while ( map->ex_id[num_ext] ) 
+		num_ext++;
+
+	decoder = (libnf_decoder_t *)malloc(sizeof(libnf_decoder_t) + num_ext * sizeof(decoder->op[0]));
+	if ( !decoder ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		exit(255);
+	}
+
+	// the optional extensions have a fixed size - so the offset of each extension
+	// after the required extensions is known per map
+	decoder->num_ops = 0;
+	offset = 0;
+	for ( i=0; i<num_ext; i++ ) {
+		id = map->ex_id[i];
+		// 0 - 3 should never be in an extension table, unknown ids are ignored as in ExpandRecord_v2
+		if ( id < EX_IO_SNMP_2 || id > EX_ROUTER_ID ) 
+			continue;
+		if ( projection & (1 << extension_descriptor[id].user_index) ) {
+			decoder->op[decoder->num_ops].id	 = id;
+			decoder->op[decoder->num_ops].offset = offset;
+			decoder->num_ops++;
 		}
+		offset += extension_descriptor[id].size;
+	}
 
-#ifdef COMPAT15
-		if ( states->block_header.id == DATA_BLOCK_TYPE_1 ) {
-			common_record_v1_t *v1_record = (common_record_v1_t *)states->in_buff;
-			// create an extension map for v1 blocks
-			if ( states->v1_map_done == 0 ) {
-				extension_map_t *map = malloc(sizeof(extension_map_t) + 2 * sizeof(uint16_t) );
-				if ( ! map ) {
-					perror("Memory allocation error");
-					exit(255);
+	return decoder;
+
+} // End of build_decoder
+
+/*
+ * The decoders are kept with the extension maps, which are known by content across the 
+ * files of the instance. A map seen again in a later file reuses its decoder.
+ */
+static inline libnf_decoder_t *get_decoder(extension_info_t *extension_info, int plan, uint32_t projection) {
+
+	if ( !extension_info->plan[plan] ) 
+		extension_info->plan[plan] = build_decoder(extension_info->map, projection);
+
+	return (libnf_decoder_t *)extension_info->plan[plan];
+
+} // End of get_decoder
+
+int set_projection(libnfstates_t* states, uint32_t fields)
+{
+	if ( !states ) 
+		return 0;
+
+	// drop all decoders of the previous projection
+	FreeExtensionPlans(states->extension_map_list, PLAN_PROJECTION);
+	states->projection = fields;
+
+	return 1;
+
+} // End of set_projection
+
+/*
+ * Expand only the projected fields of a file record into the master record.
+ * Fields not projected are left unchanged. The required extensions are 
+ * skipped according to the record flags, the optional extensions are 
+ * accessed directly at the offsets of the decoder.
+ */
+static inline void ExpandRecord_projected(common_record_t *input_record, extension_map_t *extension_map, 
+	libnf_decoder_t *decoder, uint32_t projection, master_record_t *output_record ) {
+uint32_t	i, *u;
+void		*p = (void *)input_record;
+
+	// set map ref
+	output_record->map_ref = extension_map;
+
+	// Copy common data block
+	memcpy((void *)output_record, p, COMMON_RECORD_DATA_SIZE);
+	p = (void *)input_record->data;
+
+	// Required extension 1 - IP addresses
+	if ( (input_record->flags & FLAG_IPV6_ADDR) != 0 )	{ // IPv6
+		if ( projection & LIBNF_FIELD_ADDR ) 
+			memcpy((void *)output_record->v6.srcaddr, p, 4 * sizeof(uint64_t));	
+		p = (void *)((pointer_addr_t)p + 4 * sizeof(uint64_t));
+	} else { 	
+		if ( projection & LIBNF_FIELD_ADDR ) {
+			u = (uint32_t *)p;
+			output_record->v6.srcaddr[0] = 0;
+			output_record->v6.srcaddr[1] = 0;
+			output_record->v4.srcaddr 	 = u[0];
+
+			output_record->v6.dstaddr[0] = 0;
+			output_record->v6.dstaddr[1] = 0;
+			output_record->v4.dstaddr 	 = u[1];
+		}
+		p = (void *)((pointer_addr_t)p + 2 * sizeof(uint32_t));
+	}
+
+	// Required extension 2 - packet counter
+	if ( (input_record->flags & FLAG_PKG_64 ) != 0 ) { 
+		if ( projection & LIBNF_FIELD_COUNTERS ) {
+			value64_t	l, *v = (value64_t *)p;
+			l.val.val32[0] = v->val.val32[0];
+			l.val.val32[1] = v->val.val32[1];
+			output_record->dPkts = l.val.val64;
+		}
+		p = (void *)((pointer_addr_t)p + sizeof(uint64_t));
+	} else {	
+		if ( projection & LIBNF_FIELD_COUNTERS ) 
+			output_record->dPkts = *((uint32_t *)p);
+		p = (void *)((pointer_addr_t)p + sizeof(uint32_t));
+	}
+
+	// Required extension 3 - byte counter
+	if ( (input_record->flags & FLAG_BYTES_64 ) != 0 ) { 
+		if ( projection & LIBNF_FIELD_COUNTERS ) {
+			value64_t	l, *v = (value64_t *)p;
+			l.val.val32[0] = v->val.val32[0];
+			l.val.val32[1] = v->val.val32[1];
+			output_record->dOctets = l.val.val64;
+		}
+		p = (void *)((pointer_addr_t)p + sizeof(uint64_t));
+	} else {	
+		if ( projection & LIBNF_FIELD_COUNTERS ) 
+			output_record->dOctets = *((uint32_t *)p);
+		p = (void *)((pointer_addr_t)p + sizeof(uint32_t));
+	}
+
+	// preset one single flow
+	output_record->aggr_flows = 1;
+
+	// Process the projected optional extensions only
+	for ( i=0; i<decoder->num_ops; i++ ) {
+		void *ext = (void *)((pointer_addr_t)p + decoder->op[i].offset);
+		switch (decoder->op[i].id) {
+			case EX_IO_SNMP_2: {
+				tpl_ext_4_t *tpl = (tpl_ext_4_t *)ext;
+				output_record->input  = tpl->input;
+				output_record->output = tpl->output;
+				} break;
+			case EX_IO_SNMP_4: {
+				tpl_ext_5_t *tpl = (tpl_ext_5_t *)ext;
+				output_record->input  = tpl->input;
+				output_record->output = tpl->output;
+				} break;
+			case EX_AS_2: {
+				tpl_ext_6_t *tpl = (tpl_ext_6_t *)ext;
+				output_record->srcas = tpl->src_as;
+				output_record->dstas = tpl->dst_as;
+				} break;
+			case EX_AS_4: {
+				tpl_ext_7_t *tpl = (tpl_ext_7_t *)ext;
+				output_record->srcas = tpl->src_as;
+				output_record->dstas = tpl->dst_as;
+				} break;
+			case EX_MULIPLE: {
+				tpl_ext_8_t *tpl = (tpl_ext_8_t *)ext;
+				output_record->any = tpl->any;
+				} break;
+			case EX_NEXT_HOP_v4: {
+				tpl_ext_9_t *tpl = (tpl_ext_9_t *)ext;
+				output_record->ip_nexthop.v6[0] = 0;
+				output_record->ip_nexthop.v6[1] = 0;
+				output_record->ip_nexthop.v4	= tpl->nexthop;
+				ClearFlag(output_record->flags, FLAG_IPV6_NH);
+				} break;
+			case EX_NEXT_HOP_v6: {
+				tpl_ext_10_t *tpl = (tpl_ext_10_t *)ext;
+				output_record->ip_nexthop.v6[0] = tpl->nexthop[0];
+				output_record->ip_nexthop.v6[1] = tpl->nexthop[1];
+				SetFlag(output_record->flags, FLAG_IPV6_NH);
+				} break;
+			case EX_NEXT_HOP_BGP_v4: {
+				tpl_ext_11_t *tpl = (tpl_ext_11_t *)ext;
+				output_record->bgp_nexthop.v6[0] = 0;
+				output_record->bgp_nexthop.v6[1] = 0;
+				output_record->bgp_nexthop.v4	= tpl->bgp_nexthop;
+				ClearFlag(output_record->flags, FLAG_IPV6_NHB);
+				} break;
+			case EX_NEXT_HOP_BGP_v6: {
+				tpl_ext_12_t *tpl = (tpl_ext_12_t *)ext;
+				output_record->bgp_nexthop.v6[0] = tpl->bgp_nexthop[0];
+				output_record->bgp_nexthop.v6[1] = tpl->bgp_nexthop[1];
+				SetFlag(output_record->flags, FLAG_IPV6_NHB);
+				} break;
+			case EX_VLAN: {
+				tpl_ext_13_t *tpl = (tpl_ext_13_t *)ext;
+				output_record->src_vlan = tpl->src_vlan;
+				output_record->dst_vlan = tpl->dst_vlan;
+				} break;
+			case EX_OUT_PKG_4: {
+				tpl_ext_14_t *tpl = (tpl_ext_14_t *)ext;
+				output_record->out_pkts = tpl->out_pkts;
+				} break;
+			case EX_OUT_PKG_8: {
+				tpl_ext_15_t v, *tpl = (tpl_ext_15_t *)ext;
+				v.v[0] = tpl->v[0];
+				v.v[1] = tpl->v[1];
+				output_record->out_pkts = v.out_pkts;
+				} break;
+			case EX_OUT_BYTES_4: {
+				tpl_ext_16_t *tpl = (tpl_ext_16_t *)ext;
+				output_record->out_bytes = tpl->out_bytes;
+				} break;
+			case EX_OUT_BYTES_8: {
+				tpl_ext_17_t v,*tpl = (tpl_ext_17_t *)ext;
+				v.v[0] = tpl->v[0];
+				v.v[1] = tpl->v[1];
+				output_record->out_bytes = v.out_bytes;
+				} break;
+			case EX_AGGR_FLOWS_4: {
+				tpl_ext_18_t *tpl = (tpl_ext_18_t *)ext;
+				output_record->aggr_flows = tpl->aggr_flows;
+				} break;
+			case EX_AGGR_FLOWS_8: {
+				tpl_ext_19_t v, *tpl = (tpl_ext_19_t *)ext;
+				v.v[0] = tpl->v[0];
+				v.v[1] = tpl->v[1];
+				output_record->aggr_flows = v.aggr_flows;
+				} break;
+			case EX_MAC_1: {
+				tpl_ext_20_t v, *tpl = (tpl_ext_20_t *)ext;
+				v.v1[0] = tpl->v1[0];
+				v.v1[1] = tpl->v1[1];
+				output_record->in_src_mac = v.in_src_mac;
+				v.v2[0] = tpl->v2[0];
+				v.v2[1] = tpl->v2[1];
+				output_record->out_dst_mac = v.out_dst_mac;
+				} break;
+			case EX_MAC_2: {
+				tpl_ext_21_t v, *tpl = (tpl_ext_21_t *)ext;
+				v.v1[0] = tpl->v1[0];
+				v.v1[1] = tpl->v1[1];
+				output_record->in_dst_mac = v.in_dst_mac;
+				v.v2[0] = tpl->v2[0];
+				v.v2[1] = tpl->v2[1];
+				output_record->out_src_mac = v.out_src_mac;
+				} break;
+			case EX_MPLS: {
+				tpl_ext_22_t *tpl = (tpl_ext_22_t *)ext;
+				int j;
+				for (j=0; j<10; j++ ) {
+					output_record->mpls_label[j] = tpl->mpls_label[j];
 				}
-				map->type 	= ExtensionMapType;
-				map->size 	= sizeof(extension_map_t) + 2 * sizeof(uint16_t);
-				map->map_id = 0;
-				map->ex_id[0]  = EX_IO_SNMP_2;
-				map->ex_id[1]  = EX_AS_2;
-				map->ex_id[2]  = 0;
+				} break;
+			case EX_ROUTER_IP_v4: {
+				tpl_ext_23_t *tpl = (tpl_ext_23_t *)ext;
+				output_record->ip_router.v6[0] = 0;
+				output_record->ip_router.v6[1] = 0;
+				output_record->ip_router.v4	= tpl->router_ip;
+				ClearFlag(output_record->flags, FLAG_IPV6_EXP);
+				} break;
+			case EX_ROUTER_IP_v6: {
+				tpl_ext_24_t *tpl = (tpl_ext_24_t *)ext;
+				output_record->ip_router.v6[0] = tpl->router_ip[0];
+				output_record->ip_router.v6[1] = tpl->router_ip[1];
+				SetFlag(output_record->flags, FLAG_IPV6_EXP);
+				} break;
+			case EX_ROUTER_ID: {
+				tpl_ext_25_t *tpl = (tpl_ext_25_t *)ext;
+				output_record->engine_type = tpl->engine_type;
+				output_record->engine_id   = tpl->engine_id;
+				} break;
+		}
+	}
 
-				Insert_Extension_Map(&extension_map_list, map);
+} // End of ExpandRecord_projected
 
-				states->v1_map_done = 1;
-			}
+/*
+ * Decode a file record directly into the next row of columns
+ */
+static inline void ExpandRecord_columns(common_record_t *input_record, libnf_decoder_t *decoder, libnf_columns_t *columns) {
+uint32_t	n, *u;
+void		*p;
+
+	n = columns->num_records;
+
+	// common block
+	columns->flags[n]	   = input_record->flags;
+	columns->first[n]	   = input_record->first;
+	columns->last[n]	   = input_record->last;
+	columns->msec_first[n] = input_record->msec_first;
+	columns->msec_last[n]  = input_record->msec_last;
+	columns->prot[n]	   = input_record->prot;
+	columns->tcp_flags[n]  = input_record->tcp_flags;
+	columns->tos[n]		   = input_record->tos;
+	columns->srcport[n]	   = input_record->srcport;
+	columns->dstport[n]	   = input_record->dstport;
+	p = (void *)input_record->data;
+
+	// Required extension 1 - IP addresses
+	if ( (input_record->flags & FLAG_IPV6_ADDR) != 0 )	{ // IPv6
+		memcpy((void *)&columns->srcaddr6[2*n], p, 2 * sizeof(uint64_t));	
+		memcpy((void *)&columns->dstaddr6[2*n], (void *)((pointer_addr_t)p + 2 * sizeof(uint64_t)), 2 * sizeof(uint64_t));	
+		columns->srcaddr4[n] = 0;
+		columns->dstaddr4[n] = 0;
+		p = (void *)((pointer_addr_t)p + 4 * sizeof(uint64_t));
+	} else { 	
+		u = (uint32_t *)p;
+		columns->srcaddr4[n]	   = u[0];
+		columns->dstaddr4[n]	   = u[1];
+		columns->srcaddr6[2*n]	   = 0;
+		columns->srcaddr6[2*n + 1] = u[0];
+		columns->dstaddr6[2*n]	   = 0;
+		columns->dstaddr6[2*n + 1] = u[1];
+		p = (void *)((pointer_addr_t)p + 2 * sizeof(uint32_t));
+	}
+
+	// Required extension 2 - packet counter
+	if ( (input_record->flags & FLAG_PKG_64 ) != 0 ) { 
+		value64_t	l, *v = (value64_t *)p;
+		l.val.val32[0] = v->val.val32[0];
+		l.val.val32[1] = v->val.val32[1];
+		columns->dPkts[n] = l.val.val64;
+		p = (void *)((pointer_addr_t)p + sizeof(uint64_t));
+	} else {	
+		columns->dPkts[n] = *((uint32_t *)p);
+		p = (void *)((pointer_addr_t)p + sizeof(uint32_t));
+	}
+
+	// Required extension 3 - byte counter
+	if ( (input_record->flags & FLAG_BYTES_64 ) != 0 ) { 
+		value64_t	l, *v = (value64_t *)p;
+		l.val.val32[0] = v->val.val32[0];
+		l.val.val32[1] = v->val.val32[1];
+		columns->dOctets[n] = l.val.val64;
+		p = (void *)((pointer_addr_t)p + sizeof(uint64_t));
+	} else {	
+		columns->dOctets[n] = *((uint32_t *)p);
+		p = (void *)((pointer_addr_t)p + sizeof(uint32_t));
+	}
+
+	ExpandExtensions_columns(p, decoder, columns);
+
+} // End of ExpandRecord_columns
+
+/*
+ * Decode the AS and interface extensions at p into the next row of columns
+ */
+static inline void ExpandExtensions_columns(void *p, libnf_decoder_t *decoder, libnf_columns_t *columns) {
+uint32_t	i, n;
+
+	n = columns->num_records;
+
+	// optional extensions - 0 if not in the map
+	columns->srcas[n]  = 0;
+	columns->dstas[n]  = 0;
+	columns->input[n]  = 0;
+	columns->output[n] = 0;
+	for ( i=0; i<decoder->num_ops; i++ ) {
+		void *ext = (void *)((pointer_addr_t)p + decoder->op[i].offset);
+		switch (decoder->op[i].id) {
+			case EX_IO_SNMP_2: {
+				tpl_ext_4_t *tpl = (tpl_ext_4_t *)ext;
+				columns->input[n]  = tpl->input;
+				columns->output[n] = tpl->output;
+				} break;
+			case EX_IO_SNMP_4: {
+				tpl_ext_5_t *tpl = (tpl_ext_5_t *)ext;
+				columns->input[n]  = tpl->input;
+				columns->output[n] = tpl->output;
+				} break;
+			case EX_AS_2: {
+				tpl_ext_6_t *tpl = (tpl_ext_6_t *)ext;
+				columns->srcas[n] = tpl->src_as;
+				columns->dstas[n] = tpl->dst_as;
+				} break;
+			case EX_AS_4: {
+				tpl_ext_7_t *tpl = (tpl_ext_7_t *)ext;
+				columns->srcas[n] = tpl->src_as;
+				columns->dstas[n] = tpl->dst_as;
+				} break;
+		}
+	}
+
+} // End of ExpandExtensions_columns
+
+/*
+ * Store an expanded master record into the next row of columns
+ */
+static void MasterToColumns(master_record_t *r, libnf_columns_t *columns) {
+uint32_t n = columns->num_records;
+
+	columns->flags[n]	   = r->flags;
+	columns->first[n]	   = r->first;
+	columns->last[n]	   = r->last;
+	columns->msec_first[n] = r->msec_first;
+	columns->msec_last[n]  = r->msec_last;
+	columns->prot[n]	   = r->prot;
+	columns->tcp_flags[n]  = r->tcp_flags;
+	columns->tos[n]		   = r->tos;
+	columns->srcport[n]	   = r->srcport;
+	columns->dstport[n]	   = r->dstport;
+	columns->srcaddr6[2*n]	   = r->v6.srcaddr[0];
+	columns->srcaddr6[2*n + 1] = r->v6.srcaddr[1];
+	columns->dstaddr6[2*n]	   = r->v6.dstaddr[0];
+	columns->dstaddr6[2*n + 1] = r->v6.dstaddr[1];
+	if ( (r->flags & FLAG_IPV6_ADDR) != 0 ) {
+		columns->srcaddr4[n] = 0;
+		columns->dstaddr4[n] = 0;
+	} else {
+		columns->srcaddr4[n] = r->v4.srcaddr;
+		columns->dstaddr4[n] = r->v4.dstaddr;
+	}
+	columns->dPkts[n]	= r->dPkts;
+	columns->dOctets[n]	= r->dOctets;
+	columns->srcas[n]	= r->srcas;
+	columns->dstas[n]	= r->dstas;
+	columns->input[n]	= r->input;
+	columns->output[n]	= r->output;
+
+} // End of MasterToColumns
+
+
+
+// Decodes the columnar block data into the records of states->column_buff
+// Returns 1 on success, 0 if the block is corrupt
+static int decode_columnar_block(libnfstates_t* states, void *data) {
+
+	if ( !states->column_buff ) {
+		states->column_buff = malloc(BUFFSIZE);
+		if ( !states->column_buff ) {
+			perror("Memory allocation error");
+			exit(255);
+		}
+	}
+	if ( !states->column_reader ) {
+		states->column_reader = NewColumnReader();
+		if ( !states->column_reader ) 
+			exit(255);
+	}
+	if ( DecodeColumnBlock(states->column_reader, &(states->block_header), data, states->column_buff) < 0 ) {
+		fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+		return 0;
+	}
+
+	return 1;
+
+} // End of decode_columnar_block
+
+// Continues the columnar block read by get_next_columns with records,
+// if records are requested or a filter was set in between
+static void expand_columnar_block(libnfstates_t* states) {
+common_record_t *record;
+int i;
+
+	states->columnar = 0;
+	if ( !decode_columnar_block(states, (void *)states->flow_record) ) {
+		states->inblock = 0;
+		return;
+	}
 
-			// convert the records to v2
-			for ( states->i=0; states->i < states->block_header.NumRecords; states->i++ ) {
-				common_record_t *v2_record = (common_record_t *)v1_record;
-				Convert_v1_to_v2((void *)v1_record);
-				// now we have a v2 record -> use size of v2_record->size
-				v1_record = (common_record_v1_t *)((pointer_addr_t)v1_record + v2_record->size);
+	// skip the records already returned as columns
+	record = (common_record_t *)states->column_buff;
+	for ( i=0; i < states->i; i++ ) 
+		record = (common_record_t *)((pointer_addr_t)record + record->size);
+	states->flow_record = record;
+
+} // End of expand_columnar_block
+
+// Columns of a columnar block needed for the projection of the instance
+static uint32_t column_selection(uint32_t projection) {
+uint32_t selection = COLUMNS_COMMON;
+
+	if ( projection & LIBNF_FIELD_ADDR ) 
+		selection |= COLUMNS_ADDR;
+	if ( projection & LIBNF_FIELD_COUNTERS ) 
+		selection |= COLUMNS_COUNTERS;
+	if ( projection & (LIBNF_FIELD_IO_SNMP | LIBNF_FIELD_AS) ) 
+		selection |= COLUMN(COL_EXTENSIONS);
+
+	return selection;
+
+} // End of column_selection
+
+// Reads the next data block of the file sequence into states->in_buff
+// Columnar blocks are read column by column, if columns are requested,
+// otherwise they are decoded into records.
+// Returns 1 if a data block is ready to be processed
+// Returns 0 if no block could be read. states->done is set at the end of the sequence
+static int read_next_block(libnfstates_t* states, int columns) {
+void *data = (void *)states->in_buff;
+
+	// get next data block from file - uncompressed files are used in place
+	if ( states->readahead ) 
+		states->ret = ReadAheadBlock(states->readahead, &(states->block_header), &data, &(states->string));
+	else
+		states->ret = ReadBlockPtr_r(states->rfile, &(states->block_header), &data, &(states->string));
+
+	switch (states->ret) {
+		case NF_CORRUPT:
+		case NF_ERROR:
+			if ( states->ret == NF_CORRUPT )
+				fprintf(stderr, "Skip corrupt data file '%s': '%s'\n",states->filename, states->string);
+			else
+				fprintf(stderr, "Read error in file '%s': %s\n",states->filename, strerror(errno) );
+			// fall through - get next file in chain
+		case NF_EOF:
+			if ( next_file(states) < 0 ) {
+				if ( states->rfd == NF_ERROR )
+					fprintf(stderr, "Read error in file '%s': %s\n",states->filename, strerror(errno) );
+
+				// rfd == EMPTY_LIST
+				states->done = 1;
+			} // else continue with next file
+			return 0;
+	}
+
+#ifdef COMPAT15
+	if ( states->block_header.id == DATA_BLOCK_TYPE_1 ) {
+		common_record_v1_t *v1_record = (common_record_v1_t *)data;
+		// create an extension map for v1 blocks
+		if ( states->v1_map_done == 0 ) {
+			extension_map_t *map = malloc(sizeof(extension_map_t) + 2 * sizeof(uint16_t) );
+			if ( ! map ) {
+				perror("Memory allocation error");
+				exit(255);
 			}
-			states->block_header.id = DATA_BLOCK_TYPE_2;
+			map->type 	= ExtensionMapType;
+			map->size 	= sizeof(extension_map_t) + 2 * sizeof(uint16_t);
+			map->map_id = 0;
+			map->ex_id[0]  = EX_IO_SNMP_2;
+			map->ex_id[1]  = EX_AS_2;
+			map->ex_id[2]  = 0;
+
+			Insert_Extension_Map(states->extension_map_list, map);
+
+			states->v1_map_done = 1;
 		}
+
+		// convert the records to v2
+		for ( states->i=0; states->i < states->block_header.NumRecords; states->i++ ) {
+			common_record_t *v2_record = (common_record_t *)v1_record;
+			Convert_v1_to_v2((void *)v1_record);
+			// now we have a v2 record -> use size of v2_record->size
+			v1_record = (common_record_v1_t *)((pointer_addr_t)v1_record + v2_record->size);
+		}
+		states->block_header.id = DATA_BLOCK_TYPE_2;
+	}
 #endif
 
-		if ( states->block_header.id != DATA_BLOCK_TYPE_2 ) {
-			fprintf(stderr, "Can't process block type %u. Skip block.\n", states->block_header.id);
+	states->columnar = 0;
+	if ( states->block_header.id == DATA_BLOCK_TYPE_3 ) {
+		if ( columns ) {
+			if ( !states->column_reader ) {
+				states->column_reader = NewColumnReader();
+				if ( !states->column_reader ) 
+					exit(255);
+			}
+			if ( !OpenColumnBlock(states->column_reader, &(states->block_header), data, column_selection(states->projection)) ) {
+				fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+				return 0;
+			}
+			// the block data is kept for expand_columnar_block
+			states->flow_record = (common_record_t *)data;
+			states->columnar = 1;
+			states->inblock = 1;
+			states->i = 0;
+			return 1;
+		}
+
+		if ( !decode_columnar_block(states, data) ) 
 			return 0;
+		data = states->column_buff;
+	}
+
+	if ( states->block_header.id != DATA_BLOCK_TYPE_2 ) {
+		fprintf(stderr, "Can't process block type %u. Skip block.\n", states->block_header.id);
+		return 0;
+	}
+
+	states->flow_record = (common_record_t *)data;
+	states->inblock = 1;
+	states->i = 0;
+
+	return 1;
+
+} // End of read_next_block
+
+// Processes the current record of the block and advances to the next one
+// Returns 1 if a flow record was expanded into master_record, or into the
+// next row of columns, if columns is not NULL
+// Returns 0 for extension maps or skipped records
+static inline int process_record(libnfstates_t* states, master_record_t *master_record, libnf_columns_t *columns) {
+int found = 0;
+
+	if ( states->flow_record->type == CommonRecordType ) {
+		uint32_t map_id = states->flow_record->ext_map;
+		if ( states->extension_map_list->slot[map_id] == NULL ) {
+			fprintf(stderr, "Corrupt data file! No such extension map id: %u. Skip record", states->flow_record->ext_map );
+		} else {
+			extension_info_t *extension_info = states->extension_map_list->slot[map_id];
+
+			// a filter may use any field - decode columns or projected records only without filter
+			if ( columns && !states->engine ) {
+				ExpandRecord_columns(states->flow_record, 
+					get_decoder(extension_info, PLAN_COLUMNS, LIBNF_FIELD_IO_SNMP | LIBNF_FIELD_AS), columns);
+			} else if ( states->projection != LIBNF_FIELD_ALL && !states->engine ) {
+				ExpandRecord_projected(states->flow_record, extension_info->map, 
+					get_decoder(extension_info, PLAN_PROJECTION, states->projection), states->projection, master_record);
+			} else 
+				ExpandRecord_v2( states->flow_record, extension_info, master_record);
+
+			// drop records not matching the filter
+			if ( states->engine ) {
+				states->engine->nfrecord = (uint64_t *)master_record;
+				found = (*states->engine->FilterEngine)(states->engine);
+			} else 
+				found = 1;
+
+			if ( found && columns && states->engine ) 
+				MasterToColumns(master_record, columns);
+
+			// update number of flows matching a given map
+			if ( found )
+				extension_info->ref_count++;
 		}
 
-		states->flow_record = states->in_buff;
-		states->inblock =1;
-		states->i = 0;
-		} // End if not inblock 
+	} else if ( states->flow_record->type == ExtensionMapType ) {
+		extension_map_t *map = (extension_map_t *)states->flow_record;
 
+		// a map known from a previous file keeps its decoders
+		Insert_Extension_Map(states->extension_map_list, map);
 
-		if (states->inblock){
-			if ( states->i < states->block_header.NumRecords){  
+	} else {
+		fprintf(stderr, "Skip unknown record type %i\n", states->flow_record->type);
+	}
 
-			if ( states->flow_record->type == CommonRecordType ) {
-				uint32_t map_id = states->flow_record->ext_map;
-				if ( extension_map_list.slot[map_id] == NULL ) {
-					fprintf(stderr, "Corrupt data file! No such extension map id: %u. Skip record", states->flow_record->ext_map );
-				} else {
-					ExpandRecord_v2( states->flow_record, extension_map_list.slot[states->flow_record->ext_map], &(states->master_record));
+	// Advance pointer by number of bytes for netflow record
+	states->flow_record = (common_record_t *)((pointer_addr_t)states->flow_record + states->flow_record->size);
+	states->i++; /* Increase the record counter */
 
-					// update number of flows matching a given map
-					extension_map_list.slot[map_id]->ref_count++;
-			
-					states->records_present = 1;
+	return found;
 
-				}
+} // End of process_record
+
+// Decodes the next records of the current columnar block column by column into the next rows of columns
+// Returns the number of flow records stored
+// Returns 0 for extension maps or skipped records
+static inline int process_column_records(libnfstates_t* states, libnf_columns_t *columns) {
+column_reader_t	*reader = states->column_reader;
+void			*record;
+uint16_t		ext_map[COLUMN_CHUNK];
+uint32_t		i, n, start, map_id;
+int				ret;
 
-			} else if ( states->flow_record->type == ExtensionMapType ) {
-				extension_map_t *map = (extension_map_t *)states->flow_record;
+	ret = NextColumnRecords(reader, columns->max_records - columns->num_records, &record);
+	if ( ret <= 0 ) {
+		if ( ret < 0 ) 
+			fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+		states->i = states->block_header.NumRecords;
+		return 0;
+	}
+	states->i += ret;
+
+	if ( record ) {
+		record_header_t *header = (record_header_t *)record;
+		if ( header->type == ExtensionMapType ) {
+			extension_map_t *map = (extension_map_t *)record;
+			// a map known from a previous file keeps its decoders
+			Insert_Extension_Map(states->extension_map_list, map);
+		} else {
+			fprintf(stderr, "Skip unknown record type %i\n", header->type);
+		}
+		return 0;
+	}
+
+	n	  = ret;
+	start = columns->num_records;
+	if ( !DecodeColumn(reader, COL_FLAGS, &columns->flags[start], sizeof(uint8_t), n) ||
+		 !DecodeColumn(reader, COL_EXT_MAP, ext_map, sizeof(uint16_t), n) ||
+		 !DecodeColumn(reader, COL_MSEC_FIRST, &columns->msec_first[start], sizeof(uint16_t), n) ||
+		 !DecodeColumn(reader, COL_MSEC_LAST, &columns->msec_last[start], sizeof(uint16_t), n) ||
+		 !DecodeColumn(reader, COL_FIRST, &columns->first[start], sizeof(uint32_t), n) ||
+		 !DecodeColumn(reader, COL_LAST, &columns->last[start], sizeof(uint32_t), n) ||
+		 !DecodeColumn(reader, COL_TCP_FLAGS, &columns->tcp_flags[start], sizeof(uint8_t), n) ||
+		 !DecodeColumn(reader, COL_PROT, &columns->prot[start], sizeof(uint8_t), n) ||
+		 !DecodeColumn(reader, COL_TOS, &columns->tos[start], sizeof(uint8_t), n) ||
+		 !DecodeColumn(reader, COL_SRCPORT, &columns->srcport[start], sizeof(uint16_t), n) ||
+		 !DecodeColumn(reader, COL_DSTPORT, &columns->dstport[start], sizeof(uint16_t), n) ) {
+		fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+		states->i = states->block_header.NumRecords;
+		return 0;
+	}
 
-				if ( Insert_Extension_Map(&extension_map_list, map) ) {
-					 // flush new map
-				} // else map already known and flushed
+	// columns not selected by the projection are 0
+	if ( reader->columns & COLUMN(COL_PACKETS) ) {
+		if ( !DecodeColumn(reader, COL_PACKETS, &columns->dPkts[start], sizeof(uint64_t), n) ||
+			 !DecodeColumn(reader, COL_BYTES, &columns->dOctets[start], sizeof(uint64_t), n) ) {
+			fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+			states->i = states->block_header.NumRecords;
+			return 0;
+		}
+	} else {
+		memset((void *)&columns->dPkts[start], 0, n * sizeof(uint64_t));
+		memset((void *)&columns->dOctets[start], 0, n * sizeof(uint64_t));
+	}
 
+	if ( reader->columns & COLUMN(COL_SRCADDR) ) {
+		for ( i=0; i < n; i++ ) {
+			uint32_t size = (columns->flags[start + i] & FLAG_IPV6_ADDR) ? 2 * sizeof(uint64_t) : sizeof(uint32_t);
+			void *src = ColumnBytes(reader, COL_SRCADDR, size);
+			void *dst = ColumnBytes(reader, COL_DSTADDR, size);
+			if ( !src || !dst ) {
+				fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+				states->i = states->block_header.NumRecords;
+				return 0;
+			}
+			if ( size == sizeof(uint32_t) ) {
+				memcpy((void *)&columns->srcaddr4[start + i], src, sizeof(uint32_t));
+				memcpy((void *)&columns->dstaddr4[start + i], dst, sizeof(uint32_t));
+				columns->srcaddr6[2*(start + i)]	 = 0;
+				columns->srcaddr6[2*(start + i) + 1] = columns->srcaddr4[start + i];
+				columns->dstaddr6[2*(start + i)]	 = 0;
+				columns->dstaddr6[2*(start + i) + 1] = columns->dstaddr4[start + i];
 			} else {
-				fprintf(stderr, "Skip unknown record type %i\n", states->flow_record->type);
+				memcpy((void *)&columns->srcaddr6[2*(start + i)], src, 2 * sizeof(uint64_t));
+				memcpy((void *)&columns->dstaddr6[2*(start + i)], dst, 2 * sizeof(uint64_t));
+				columns->srcaddr4[start + i] = 0;
+				columns->dstaddr4[start + i] = 0;
+			}
+		}
+	} else {
+		memset((void *)&columns->srcaddr4[start], 0, n * sizeof(uint32_t));
+		memset((void *)&columns->dstaddr4[start], 0, n * sizeof(uint32_t));
+		memset((void *)&columns->srcaddr6[2*start], 0, 2 * n * sizeof(uint64_t));
+		memset((void *)&columns->dstaddr6[2*start], 0, 2 * n * sizeof(uint64_t));
+	}
+
+	for ( i=0; i < n; i++ ) {
+		columns->num_records = start + i;
+		map_id = ext_map[i];
+		if ( states->extension_map_list->slot[map_id] == NULL ) {
+			fprintf(stderr, "Corrupt data file! No such extension map id: %u. Skip block", map_id);
+			states->i = states->block_header.NumRecords;
+			columns->num_records = start;
+			return 0;
+		}
+
+		if ( reader->columns & COLUMN(COL_EXTENSIONS) ) {
+			uint16_t size = reader->sizes[i] - COMMON_RECORD_FIXED_SIZE(columns->flags[start + i]);
+			void *p = ColumnBytes(reader, COL_EXTENSIONS, size);
+			if ( reader->sizes[i] < COMMON_RECORD_FIXED_SIZE(columns->flags[start + i]) || !p ) {
+				fprintf(stderr, "Skip corrupt columnar data block in file '%s'\n", states->filename);
+				states->i = states->block_header.NumRecords;
+				columns->num_records = start;
+				return 0;
 			}
+			ExpandExtensions_columns(p, get_decoder(states->extension_map_list->slot[map_id], PLAN_COLUMNS, 
+				LIBNF_FIELD_IO_SNMP | LIBNF_FIELD_AS), columns);
+		} else {
+			columns->srcas[start + i]  = 0;
+			columns->dstas[start + i]  = 0;
+			columns->input[start + i]  = 0;
+			columns->output[start + i] = 0;
+		}
 
-			// Advance pointer by number of bytes for netflow record
-			states->flow_record = (common_record_t *)((pointer_addr_t)states->flow_record + states->flow_record->size);	
-			states->i++; /* Increase the record counter */
+		states->extension_map_list->slot[map_id]->ref_count++;
+	}
+	columns->num_records = start;
+
+	return n;
+
+} // End of process_column_records
+
+// Returns 0 if there are more records
+// Returns 1 if there are no records
+// The master record is returned via argument
+static int try_next_block(libnfstates_t* states) {
+	/* By default no blocks are assumed */
+	states->records_present = 0;
+	// Get the first file handle
+	if ( !states->done ) {
+		if (!states->inblock){
+			if ( !read_next_block(states, 0) )
+				return 0;
+		} // End if not inblock
+
+		if ( states->columnar ) 
+			expand_columnar_block(states);
+
+		if (states->inblock){
+			if ( states->i < states->block_header.NumRecords){
+				states->records_present = process_record(states, &(states->master_record), NULL);
 			}else{
 			//The block has been processed, it's time to get a new one
 				states->inblock = 0;
 			}
-		} // end in block 
+		} // end in block
 
 	} //End if done
-	return states->done; 
+	return states->done;
 } // End of process_data
 
 
 master_record_t* get_next_record(libnfstates_t* states)
 {
+	if ( states->merge ) 
+		return !states->done && next_merged_record(states, &(states->master_record)) ? &(states->master_record) : NULL;
+
 	//Go though the stream until a record is found
 	do {
 		if (states->done){
@@ -338,3 +1275,373 @@ master_record_t* get_next_record(libnfstates_t* states)
 	}while(!states->records_present);
 	return &(states->master_record);
 }
+
+int get_next_records(libnfstates_t* states, master_record_t* records, int max)
+{
+int num_records = 0;
+
+	if ( max <= 0 || !records )
+		return 0;
+
+	if ( states->merge ) {
+		while ( num_records < max && !states->done && next_merged_record(states, &records[num_records]) ) 
+			num_records++;
+		return num_records;
+	}
+
+	// Expand records until the array is full or the current block is finished
+	while ( num_records < max && !states->done ) {
+		if ( !states->inblock ) {
+			read_next_block(states, 0);
+			continue;
+		}
+
+		if ( states->columnar ) 
+			expand_columnar_block(states);
+
+		while ( num_records < max && states->i < states->block_header.NumRecords ) {
+			num_records += process_record(states, &records[num_records], NULL);
+		}
+
+		if ( states->i >= states->block_header.NumRecords ) {
+			states->inblock = 0;
+			// return at the block boundary, if we already have some records
+			if ( num_records )
+				break;
+		}
+	}
+
+	return num_records;
+
+} // End of get_next_records
+
+// Allocates an aligned column array of num elements of size bytes
+static void *new_column(int num, size_t size) {
+void *column;
+
+	// round up to a multiple of the alignment, so vector loops may read whole vectors
+	size = ((num * size + LIBNF_COLUMN_ALIGN - 1) / LIBNF_COLUMN_ALIGN) * LIBNF_COLUMN_ALIGN;
+	if ( posix_memalign(&column, LIBNF_COLUMN_ALIGN, size) != 0 ) 
+		return NULL;
+	memset(column, 0, size);
+
+	return column;
+
+} // End of new_column
+
+libnf_columns_t* new_columns(int max_records)
+{
+libnf_columns_t *columns;
+
+	if ( max_records <= 0 ) 
+		return NULL;
+
+	columns = (libnf_columns_t *)calloc(1, sizeof(libnf_columns_t));
+	if ( !columns ) {
+		perror("Memory allocation error");
+		return NULL;
+	}
+	columns->max_records = max_records;
+
+	columns->flags		= new_column(max_records, sizeof(uint8_t));
+	columns->first		= new_column(max_records, sizeof(uint32_t));
+	columns->last		= new_column(max_records, sizeof(uint32_t));
+	columns->msec_first	= new_column(max_records, sizeof(uint16_t));
+	columns->msec_last	= new_column(max_records, sizeof(uint16_t));
+	columns->prot		= new_column(max_records, sizeof(uint8_t));
+	columns->tcp_flags	= new_column(max_records, sizeof(uint8_t));
+	columns->tos		= new_column(max_records, sizeof(uint8_t));
+	columns->srcport	= new_column(max_records, sizeof(uint16_t));
+	columns->dstport	= new_column(max_records, sizeof(uint16_t));
+	columns->srcaddr4	= new_column(max_records, sizeof(uint32_t));
+	columns->dstaddr4	= new_column(max_records, sizeof(uint32_t));
+	columns->srcaddr6	= new_column(max_records, 2 * sizeof(uint64_t));
+	columns->dstaddr6	= new_column(max_records, 2 * sizeof(uint64_t));
+	columns->dPkts		= new_column(max_records, sizeof(uint64_t));
+	columns->dOctets	= new_column(max_records, sizeof(uint64_t));
+	columns->srcas		= new_column(max_records, sizeof(uint32_t));
+	columns->dstas		= new_column(max_records, sizeof(uint32_t));
+	columns->input		= new_column(max_records, sizeof(uint32_t));
+	columns->output		= new_column(max_records, sizeof(uint32_t));
+
+	if ( !columns->flags || !columns->first || !columns->last || !columns->msec_first || 
+		 !columns->msec_last || !columns->prot || !columns->tcp_flags || !columns->tos || 
+		 !columns->srcport || !columns->dstport || !columns->srcaddr4 || !columns->dstaddr4 || 
+		 !columns->srcaddr6 || !columns->dstaddr6 || !columns->dPkts || !columns->dOctets || 
+		 !columns->srcas || !columns->dstas || !columns->input || !columns->output ) {
+		perror("Memory allocation error");
+		free_columns(columns);
+		return NULL;
+	}
+
+	return columns;
+
+} // End of new_columns
+
+void free_columns(libnf_columns_t* columns)
+{
+	if ( !columns ) 
+		return;
+
+	// free(NULL) is fine for columns not allocated
+	free(columns->flags);
+	free(columns->first);
+	free(columns->last);
+	free(columns->msec_first);
+	free(columns->msec_last);
+	free(columns->prot);
+	free(columns->tcp_flags);
+	free(columns->tos);
+	free(columns->srcport);
+	free(columns->dstport);
+	free(columns->srcaddr4);
+	free(columns->dstaddr4);
+	free(columns->srcaddr6);
+	free(columns->dstaddr6);
+	free(columns->dPkts);
+	free(columns->dOctets);
+	free(columns->srcas);
+	free(columns->dstas);
+	free(columns->input);
+	free(columns->output);
+	free(columns);
+
+} // End of free_columns
+
+int get_next_columns(libnfstates_t* states, libnf_columns_t* columns)
+{
+	if ( !columns ) 
+		return 0;
+
+	columns->num_records = 0;
+
+	if ( states->merge ) {
+		while ( columns->num_records < columns->max_records && !states->done && 
+				next_merged_record(states, &(states->master_record)) ) {
+			MasterToColumns(&(states->master_record), columns);
+			columns->num_records++;
+		}
+		return columns->num_records;
+	}
+
+	// Decode records until the arrays are full or the current block is finished
+	while ( columns->num_records < columns->max_records && !states->done ) {
+		if ( !states->inblock ) {
+			// a filter needs the expanded records
+			read_next_block(states, states->engine == NULL);
+			continue;
+		}
+
+		if ( states->columnar && states->engine ) 
+			expand_columnar_block(states);
+
+		if ( states->columnar ) {
+			while ( columns->num_records < columns->max_records && states->i < states->block_header.NumRecords ) 
+				columns->num_records += process_column_records(states, columns);
+		} else {
+			while ( columns->num_records < columns->max_records && states->i < states->block_header.NumRecords ) 
+				columns->num_records += process_record(states, &(states->master_record), columns);
+		}
+
+		if ( states->i >= states->block_header.NumRecords ) {
+			states->inblock = 0;
+			// return at the block boundary, if we already have some records
+			if ( columns->num_records )
+				break;
+		}
+	}
+
+	return columns->num_records;
+
+} // End of get_next_columns
+
+long export_arrow(libnfstates_t* states, char *filename)
+{
+FILE *fp;
+arrow_writer_t *writer;
+libnf_columns_t *columns;
+void *column[ARROW_NUM_COLUMNS];
+long num_records = 0;
+int n, ok = 1;
+
+	if ( !filename ) 
+		return -1;
+
+	if ( strcmp(filename, "-") == 0 ) {
+		fp = stdout;
+	} else {
+		fp = fopen(filename, "w");
+		if ( !fp ) {
+			fprintf(stderr, "Can't open file '%s' for writing: %s\n", filename, strerror(errno));
+			return -1;
+		}
+	}
+
+	columns = new_columns(ARROW_BATCH_SIZE);
+	writer  = columns ? OpenArrowStream(fp, ARROW_BATCH_SIZE) : NULL;
+	if ( !writer ) {
+		free_columns(columns);
+		if ( fp != stdout ) 
+			fclose(fp);
+		return -1;
+	}
+
+	// the arrays of the columns are passed in the order of the arrow schema
+	column[ARROW_FLAGS]		 = columns->flags;
+	column[ARROW_FIRST]		 = columns->first;
+	column[ARROW_LAST]		 = columns->last;
+	column[ARROW_MSEC_FIRST] = columns->msec_first;
+	column[ARROW_MSEC_LAST]	 = columns->msec_last;
+	column[ARROW_PROT]		 = columns->prot;
+	column[ARROW_TCP_FLAGS]	 = columns->tcp_flags;
+	column[ARROW_TOS]		 = columns->tos;
+	column[ARROW_SRCPORT]	 = columns->srcport;
+	column[ARROW_DSTPORT]	 = columns->dstport;
+	column[ARROW_SRCADDR4]	 = columns->srcaddr4;
+	column[ARROW_DSTADDR4]	 = columns->dstaddr4;
+	column[ARROW_SRCADDR6]	 = columns->srcaddr6;
+	column[ARROW_DSTADDR6]	 = columns->dstaddr6;
+	column[ARROW_DPKTS]		 = columns->dPkts;
+	column[ARROW_DOCTETS]	 = columns->dOctets;
+	column[ARROW_SRCAS]		 = columns->srcas;
+	column[ARROW_DSTAS]		 = columns->dstas;
+	column[ARROW_INPUT]		 = columns->input;
+	column[ARROW_OUTPUT]	 = columns->output;
+
+	// each batch of columns becomes a record batch
+	while ( ok && (n = get_next_columns(states, columns)) > 0 ) {
+		ok = WriteArrowBatch(writer, n, column);
+		num_records += n;
+	}
+
+	ok = CloseArrowStream(writer) && ok;
+	free_columns(columns);
+
+	if ( fp != stdout && fclose(fp) != 0 ) {
+		fprintf(stderr, "Failed to close file '%s': %s\n", filename, strerror(errno));
+		ok = 0;
+	}
+
+	return ok ? num_records : -1;
+
+} // End of export_arrow
+
+static void *parallel_worker(void *arg) {
+libnfstates_t	*states = (libnfstates_t *)arg;
+libnfshared_t	*shared = states->shared;
+master_record_t	*records;
+int num_records;
+
+	records = (master_record_t *)malloc(PARALLEL_BATCH_SIZE * sizeof(master_record_t));
+	if ( !records ) {
+		perror("Memory allocation error");
+		return NULL;
+	}
+
+	if ( next_file(states) < 0 ) 
+		states->done = 1;
+
+	// each worker evaluates its own copy of the engine - the filter tree is shared read only
+	if ( shared->engine ) {
+		states->engine = (FilterEngine_data_t *)malloc(sizeof(FilterEngine_data_t));
+		if ( !states->engine ) {
+			perror("Memory allocation error");
+			free(records);
+			return NULL;
+		}
+		CopyFilterEngine(states->engine, shared->engine);
+		states->engine->ident = states->rfile->file_header.ident;
+	}
+
+	while ( (num_records = get_next_records(states, records, PARALLEL_BATCH_SIZE)) > 0 ) {
+		shared->callback(records, num_records, states->thread_id, shared->data);
+		states->num_records += num_records;
+	}
+
+	free(records);
+	if ( states->engine ) 
+		free(states->engine);
+	states->engine = NULL;
+
+	return NULL;
+
+} // End of parallel_worker
+
+long process_parallel(char* Mdirs, char* rfile, char* Rfile, char *filter, int num_workers, libnf_callback_t callback, void *data)
+{
+libnfshared_t	shared;
+libnfstates_t	**workers;
+pthread_t		*tid;
+long			num_records;
+int				i, started;
+
+	if ( !callback ) 
+		return -1;
+
+	if ( num_workers <= 0 ) {
+		num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+		if ( num_workers <= 0 ) 
+			num_workers = 1;
+	}
+
+	shared.engine = NULL;
+	if ( filter ) {
+		shared.engine = compile_filter(filter);
+		if ( !shared.engine ) {
+			fprintf(stderr, "Filter syntax error: '%s'\n", filter);
+			return -1;
+		}
+	}
+
+	shared.flist	= SetupInputFileSequence_r(Mdirs, rfile, Rfile);
+	if ( shared.engine ) 
+		SetFileFilter_r(shared.flist, FileMayMatch, shared.engine);
+	shared.callback = callback;
+	shared.data		= data;
+	pthread_mutex_init(&shared.lock, NULL);
+
+	workers = (libnfstates_t **)calloc(num_workers, sizeof(libnfstates_t *));
+	tid		= (pthread_t *)calloc(num_workers, sizeof(pthread_t));
+	if ( !workers || !tid ) {
+		perror("Memory allocation error");
+		num_records = -1;
+		goto out;
+	}
+
+	// each worker reads whole files of the sequence with its own states
+	started = 0;
+	for ( i=0; i<num_workers; i++ ) {
+		workers[i] = new_states();
+		if ( !workers[i] ) 
+			break;
+		workers[i]->shared	  = &shared;
+		workers[i]->thread_id = i;
+		if ( pthread_create(&tid[i], NULL, parallel_worker, (void *)workers[i]) != 0 ) {
+			perror("Can't create worker thread");
+			libcleanup(workers[i]);
+			workers[i] = NULL;
+			break;
+		}
+		started++;
+	}
+
+	num_records = started ? 0 : -1;
+	for ( i=0; i<started; i++ ) {
+		pthread_join(tid[i], NULL);
+		num_records += workers[i]->num_records;
+		libcleanup(workers[i]);
+	}
+
+out:
+	if ( workers ) 
+		free(workers);
+	if ( tid ) 
+		free(tid);
+	pthread_mutex_destroy(&shared.lock);
+	DisposeFileSequence(shared.flist);
+	if ( shared.engine ) 
+		DisposeFilterEngine(shared.engine);
+
+	return num_records;
+
+} // End of process_parallel
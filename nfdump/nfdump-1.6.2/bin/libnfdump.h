@@ -36,6 +36,77 @@ extern "C" {
 
 #include <stdint.h>
 #include <libnfdump/nffile.h>
+struct flist_s;
+struct extension_map_list_s;
+struct libnfshared_s;
+struct FilterEngine_data_s;
+struct libnf_decoder_s;
+struct readahead_s;
+struct merge_reader_s;
+
+/* 
+ * Field groups for set_projection(). The common block ( timestamps, ports,
+ * protocol, tcp flags, tos, fwd status, exporter ) is always expanded.
+ * The bits of the optional extensions correspond to the extension index
+ * of nfdump -T ( see nfdump -T -M ... )
+ */
+#define LIBNF_FIELD_IO_SNMP			(1 << 1)	// input/output interface index
+#define LIBNF_FIELD_AS				(1 << 2)	// src/dst AS number
+#define LIBNF_FIELD_MULTIPLE		(1 << 3)	// dst tos, direction, src/dst mask
+#define LIBNF_FIELD_NEXT_HOP		(1 << 4)	// next hop IP
+#define LIBNF_FIELD_BGP_NEXT_HOP	(1 << 5)	// BGP next hop IP
+#define LIBNF_FIELD_VLAN			(1 << 6)	// src/dst vlan id
+#define LIBNF_FIELD_OUT_PKTS		(1 << 7)	// output packets
+#define LIBNF_FIELD_OUT_BYTES		(1 << 8)	// output bytes
+#define LIBNF_FIELD_AGGR_FLOWS		(1 << 9)	// aggregated flows
+#define LIBNF_FIELD_MAC_1			(1 << 10)	// in src/out dst mac address
+#define LIBNF_FIELD_MAC_2			(1 << 11)	// in dst/out src mac address
+#define LIBNF_FIELD_MPLS			(1 << 12)	// MPLS labels
+#define LIBNF_FIELD_ROUTER_IP		(1 << 13)	// router IP
+#define LIBNF_FIELD_ROUTER_ID		(1 << 14)	// engine type/id
+#define LIBNF_FIELD_ADDR			(1 << 16)	// src/dst IP address
+#define LIBNF_FIELD_COUNTERS		(1 << 17)	// packets and bytes
+#define LIBNF_FIELD_ALL				0xffffffff
+
+/* alignment of the column arrays in bytes */
+#define LIBNF_COLUMN_ALIGN 64
+
+/* 
+ * Records of a data block decoded into one array per field, see 
+ * get_next_columns(). Record i is stored at index i of each array. 
+ * The addresses are stored as in master_record_t: srcaddr6[2*i] and 
+ * srcaddr6[2*i+1] hold an IPv6 address. For IPv4 they hold 0 and the 
+ * IPv4 address, which is also found in srcaddr4[i]. IPv4 columns are 0 
+ * for IPv6 flows. Missing extensions are 0.
+ */
+typedef struct libnf_columns_s {
+    int num_records; /* Number of records in the arrays */
+    int max_records; /* Capacity of the arrays */
+    uint8_t  *flags; /* FLAG_IPV6_ADDR etc. */
+    uint32_t *first;
+    uint32_t *last;
+    uint16_t *msec_first;
+    uint16_t *msec_last;
+    uint8_t  *prot;
+    uint8_t  *tcp_flags;
+    uint8_t  *tos;
+    uint16_t *srcport;
+    uint16_t *dstport;
+    uint32_t *srcaddr4;
+    uint32_t *dstaddr4;
+    uint64_t *srcaddr6;
+    uint64_t *dstaddr6;
+    uint64_t *dPkts;
+    uint64_t *dOctets;
+    uint32_t *srcas;
+    uint32_t *dstas;
+    uint32_t *input;
+    uint32_t *output;
+} libnf_columns_t;
+
+/* callback receiving the records of a parallel scan */
+typedef void (*libnf_callback_t)(master_record_t *records, int num_records, int thread_id, void *data);
+
 typedef struct libnfstates {
     master_record_t master_record;
     data_block_header_t block_header;
@@ -48,10 +119,24 @@ typedef struct libnfstates {
     int         ret;
     char		*string;
     #ifdef COMPAT15
-    int	v1_map_done = 0;
+    int	v1_map_done;
     #endif
     int inblock; /* Marker to determine if in netflow block */
     int records_present; /* State if records are present */
+    rfile_t *rfile; /* Handle of the file currently read */
+    struct flist_s *flist; /* Sequence of files to read */
+    struct extension_map_list_s *extension_map_list; /* Extension maps of this instance */
+    char *filename; /* Name of the file currently read */
+    struct libnfshared_s *shared; /* File sequence shared with other workers */
+    int thread_id; /* Id of the worker in parallel mode */
+    long num_records; /* Records processed by the worker in parallel mode */
+    struct FilterEngine_data_s *engine; /* Compiled filter or NULL */
+    uint32_t projection; /* LIBNF_FIELD_* bits to expand */
+    struct readahead_s *readahead; /* Reader thread of the current file or NULL */
+    struct column_reader_s *column_reader; /* Reader of the current columnar block */
+    int columnar; /* Current block is read by column_reader */
+    void *column_buff; /* Records of a decoded columnar block */
+    struct merge_reader_s *merge; /* Time ordered merge of the files or NULL */
 } libnfstates_t;
 
 void print_record(void *record);
@@ -62,6 +147,25 @@ void libcleanup(libnfstates_t* states);
 
 master_record_t* get_next_record(libnfstates_t* states);
 
+int get_next_records(libnfstates_t* states, master_record_t* records, int max);
+
+int set_filter(libnfstates_t* states, char *filter);
+
+int set_projection(libnfstates_t* states, uint32_t fields);
+
+int set_readahead(libnfstates_t* states, int num_blocks);
+int set_time_order(libnfstates_t* states, int window);
+
+libnf_columns_t* new_columns(int max_records);
+
+void free_columns(libnf_columns_t* columns);
+
+int get_next_columns(libnfstates_t* states, libnf_columns_t* columns);
+
+long export_arrow(libnfstates_t* states, char *filename);
+
+long process_parallel(char* Mdirs, char* rfile, char* Rfile, char *filter, int num_workers, libnf_callback_t callback, void *data);
+
 #ifdef __cplusplus
 }
 #endif
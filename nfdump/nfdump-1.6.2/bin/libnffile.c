@@ -0,0 +1 @@
+nffile.c
\ No newline at end of file
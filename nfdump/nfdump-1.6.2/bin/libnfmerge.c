@@ -0,0 +1 @@
+nfmerge.c
\ No newline at end of file
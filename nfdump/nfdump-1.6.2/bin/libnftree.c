@@ -0,0 +1 @@
+nftree.c
\ No newline at end of file
@@ -0,0 +1 @@
+nfx.c
\ No newline at end of file
@@ -0,0 +1 @@
+panonymizer.c
\ No newline at end of file
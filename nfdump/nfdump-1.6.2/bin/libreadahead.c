@@ -0,0 +1 @@
+readahead.c
\ No newline at end of file
@@ -0,0 +1 @@
+rijndael.c
\ No newline at end of file
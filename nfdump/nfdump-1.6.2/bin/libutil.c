@@ -0,0 +1 @@
+util.c
\ No newline at end of file
@@ -0,0 +1,590 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+/*
+ * Export of flow records as Apache Arrow IPC stream. Each message of the
+ * stream consists of a flatbuffer encoded metadata header and a body:
+ *
+ *   0xFFFFFFFF, int32 metadata length, metadata, padding, body
+ *
+ * The metadata follows Schema.fbs and Message.fbs of the Arrow columnar
+ * format, metadata version V5. As the schema is fixed, the few tables are
+ * encoded directly, without the flatbuffers library. The column data is
+ * written as is, only IPv6 addresses are converted to network byte order.
+ */
+
+#include "config.h"
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "nffile.h"
+#include "util.h"
+#include "nfarrow.h"
+
+// Arrow format constants
+#define ARROW_CONTINUATION				0xFFFFFFFF
+#define ARROW_METADATA_V5				4
+#define ARROW_HEADER_SCHEMA				1
+#define ARROW_HEADER_RECORD_BATCH		3
+#define ARROW_TYPE_INT					2
+#define ARROW_TYPE_FIXED_SIZE_BINARY	15
+
+// max size of the metadata of a message
+#define ARROW_METADATA_SIZE 16384
+
+#define ALIGN(n, a) (((n) + (a) - 1) & ~((uint64_t)(a) - 1))
+
+// the schema - in the order of the ARROW_* column index
+static struct arrow_field_s {
+	char	*name;
+	int		width;	// bytes per value
+	int		type;	// unsigned Int or FixedSizeBinary
+} arrow_field[ARROW_NUM_COLUMNS] = {
+	{ "flags",		1,	ARROW_TYPE_INT },
+	{ "first",		4,	ARROW_TYPE_INT },
+	{ "last",		4,	ARROW_TYPE_INT },
+	{ "msec_first",	2,	ARROW_TYPE_INT },
+	{ "msec_last",	2,	ARROW_TYPE_INT },
+	{ "prot",		1,	ARROW_TYPE_INT },
+	{ "tcp_flags",	1,	ARROW_TYPE_INT },
+	{ "tos",		1,	ARROW_TYPE_INT },
+	{ "srcport",	2,	ARROW_TYPE_INT },
+	{ "dstport",	2,	ARROW_TYPE_INT },
+	{ "srcaddr4",	4,	ARROW_TYPE_INT },
+	{ "dstaddr4",	4,	ARROW_TYPE_INT },
+	{ "srcaddr6",	16,	ARROW_TYPE_FIXED_SIZE_BINARY },
+	{ "dstaddr6",	16,	ARROW_TYPE_FIXED_SIZE_BINARY },
+	{ "dPkts",		8,	ARROW_TYPE_INT },
+	{ "dOctets",	8,	ARROW_TYPE_INT },
+	{ "srcas",		4,	ARROW_TYPE_INT },
+	{ "dstas",		4,	ARROW_TYPE_INT },
+	{ "input",		4,	ARROW_TYPE_INT },
+	{ "output",		4,	ARROW_TYPE_INT }
+};
+
+// flatbuffer, built front to back: all offsets point to later positions
+typedef struct flatbuffer_s {
+	uint8_t		*buff;
+	uint32_t	size;		// bytes used
+	int			overflow;	// ARROW_METADATA_SIZE exceeded
+} flatbuffer_t;
+
+// scalar or offset field of a flatbuffer table, size 0 if not present
+typedef struct fb_field_s {
+	int			size;
+	uint64_t	value;
+} fb_field_t;
+
+struct arrow_writer_s {
+	FILE			*fp;
+	int				batch_size;		// records per batch of AppendArrowRecord
+	int				num_records;	// records appended to the current batch
+	void			*column[ARROW_NUM_COLUMNS];	// current batch of AppendArrowRecord
+	uint64_t		*ipv6;			// addresses in network byte order
+	int				ipv6_records;	// capacity of ipv6
+	flatbuffer_t	fb;				// metadata of the current message
+	int				error;
+};
+
+static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+/* function prototypes */
+static void put_le(uint8_t *p, uint64_t value, int len);
+
+static uint32_t fb_alloc(flatbuffer_t *fb, uint32_t len, uint32_t align);
+
+static void fb_put(flatbuffer_t *fb, uint32_t pos, uint64_t value, int len);
+
+static void fb_offset(flatbuffer_t *fb, uint32_t pos, uint32_t target);
+
+static void fb_field(fb_field_t *field, int size, uint64_t value);
+
+static uint32_t fb_table(flatbuffer_t *fb, int num_fields, fb_field_t *field, uint32_t *pos);
+
+static uint32_t fb_vector(flatbuffer_t *fb, uint32_t num, uint32_t elem_size, uint32_t align);
+
+static uint32_t fb_string(flatbuffer_t *fb, char *s);
+
+static uint32_t fb_message(flatbuffer_t *fb, int header_type, uint64_t body_length);
+
+static int WriteData(arrow_writer_t *writer, const void *data, size_t len);
+
+static int WriteMetadata(arrow_writer_t *writer);
+
+static int WriteSchema(arrow_writer_t *writer);
+
+static void *IPv6NetworkOrder(arrow_writer_t *writer, uint64_t *addr, int num_records);
+
+static void DisposeArrowWriter(arrow_writer_t *writer);
+
+/* function definitions */
+
+// flatbuffers and the Arrow message framing are little endian
+static void put_le(uint8_t *p, uint64_t value, int len) {
+int i;
+
+	for ( i=0; i<len; i++ ) {
+		p[i] = value & 0xff;
+		value >>= 8;
+	}
+
+} // End of put_le
+
+// appends len zero bytes at the given alignment and returns their position
+static uint32_t fb_alloc(flatbuffer_t *fb, uint32_t len, uint32_t align) {
+uint32_t pos = ALIGN(fb->size, align);
+
+	if ( (pos + len) > ARROW_METADATA_SIZE ) {
+		fb->overflow = 1;
+		return 0;
+	}
+	memset(fb->buff + fb->size, 0, pos + len - fb->size);
+	fb->size = pos + len;
+
+	return pos;
+
+} // End of fb_alloc
+
+static void fb_put(flatbuffer_t *fb, uint32_t pos, uint64_t value, int len) {
+
+	if ( (pos + len) <= fb->size ) 
+		put_le(fb->buff + pos, value, len);
+
+} // End of fb_put
+
+// sets the uoffset at pos, which points to target
+static void fb_offset(flatbuffer_t *fb, uint32_t pos, uint32_t target) {
+
+	if ( target > pos ) 
+		fb_put(fb, pos, target - pos, 4);
+
+} // End of fb_offset
+
+static void fb_field(fb_field_t *field, int size, uint64_t value) {
+	field->size  = size;
+	field->value = value;
+} // End of fb_field
+
+/*
+ * Appends the vtable and the table. Offset fields are 4 bytes and set later
+ * with fb_offset at the position returned in pos. Returns the table position.
+ */
+static uint32_t fb_table(flatbuffer_t *fb, int num_fields, fb_field_t *field, uint32_t *pos) {
+uint32_t vtable, table, offset;
+int i, size;
+
+	vtable = fb_alloc(fb, 4 + 2 * num_fields, 2);
+	table  = ALIGN(fb->size, 4);
+
+	// place the fields by decreasing size, so they are aligned
+	offset = table + 4;
+	for ( i=0; i<num_fields; i++ ) 
+		pos[i] = 0;
+	for ( size=8; size; size >>= 1 ) {
+		for ( i=0; i<num_fields; i++ ) {
+			if ( field[i].size == size ) {
+				offset = ALIGN(offset, size);
+				pos[i] = offset;
+				offset += size;
+			}
+		}
+	}
+	fb_alloc(fb, offset - table, 4);
+	if ( fb->overflow ) 
+		return 0;
+
+	fb_put(fb, vtable, 4 + 2 * num_fields, 2);
+	fb_put(fb, vtable + 2, offset - table, 2);
+	for ( i=0; i<num_fields; i++ ) {
+		if ( field[i].size ) {
+			fb_put(fb, vtable + 4 + 2 * i, pos[i] - table, 2);
+			fb_put(fb, pos[i], field[i].value, field[i].size);
+		}
+	}
+	// soffset from the table back to its vtable
+	fb_put(fb, table, table - vtable, 4);
+
+	return table;
+
+} // End of fb_table
+
+// appends a vector of num elements, returns the position of its length
+static uint32_t fb_vector(flatbuffer_t *fb, uint32_t num, uint32_t elem_size, uint32_t align) {
+uint32_t pos;
+
+	if ( align < 4 ) 
+		align = 4;
+
+	// the elements following the length must be aligned
+	pos = ALIGN(fb->size + 4, align) - 4;
+	fb_alloc(fb, pos + 4 + num * elem_size - fb->size, 1);
+	fb_put(fb, pos, num, 4);
+
+	return pos;
+
+} // End of fb_vector
+
+static uint32_t fb_string(flatbuffer_t *fb, char *s) {
+uint32_t len = strlen(s);
+uint32_t pos = fb_alloc(fb, 4 + len + 1, 4);
+
+	if ( !fb->overflow ) {
+		fb_put(fb, pos, len, 4);
+		memcpy(fb->buff + pos + 4, s, len);
+	}
+
+	return pos;
+
+} // End of fb_string
+
+// starts the metadata of a message, returns the position of the header offset
+static uint32_t fb_message(flatbuffer_t *fb, int header_type, uint64_t body_length) {
+fb_field_t	field[4];
+uint32_t	root, message, pos[4];
+
+	fb->size	 = 0;
+	fb->overflow = 0;
+	root = fb_alloc(fb, 4, 4);
+
+	// table Message: version, header_type, header, bodyLength
+	fb_field(&field[0], 2, ARROW_METADATA_V5);
+	fb_field(&field[1], 1, header_type);
+	fb_field(&field[2], 4, 0);
+	fb_field(&field[3], 8, body_length);
+	message = fb_table(fb, 4, field, pos);
+	fb_offset(fb, root, message);
+
+	return pos[2];
+
+} // End of fb_message
+
+static int WriteData(arrow_writer_t *writer, const void *data, size_t len) {
+
+	if ( writer->error ) 
+		return 0;
+
+	if ( len && fwrite(data, 1, len, writer->fp) != len ) {
+		fprintf(stderr, "Failed to write arrow stream: %s\n", strerror(errno));
+		writer->error = 1;
+		return 0;
+	}
+
+	return 1;
+
+} // End of WriteData
+
+static int WriteMetadata(arrow_writer_t *writer) {
+flatbuffer_t *fb = &writer->fb;
+uint8_t prefix[8];
+
+	// pad the metadata, such that the body is 8 byte aligned
+	fb_alloc(fb, ALIGN(fb->size, 8) - fb->size, 1);
+	if ( fb->overflow ) {
+		fprintf(stderr, "Arrow metadata exceeds %u bytes\n", ARROW_METADATA_SIZE);
+		writer->error = 1;
+		return 0;
+	}
+
+	put_le(prefix, ARROW_CONTINUATION, 4);
+	put_le(prefix + 4, fb->size, 4);
+
+	return WriteData(writer, prefix, 8) && WriteData(writer, fb->buff, fb->size);
+
+} // End of WriteMetadata
+
+static int WriteSchema(arrow_writer_t *writer) {
+flatbuffer_t	*fb = &writer->fb;
+fb_field_t		field[6];
+uint32_t		header, schema, fields, pos[6];
+int i;
+
+	header = fb_message(fb, ARROW_HEADER_SCHEMA, 0);
+
+	// table Schema: endianness, fields
+#ifdef WORDS_BIGENDIAN
+	fb_field(&field[0], 2, 1);
+#else
+	fb_field(&field[0], 2, 0);
+#endif
+	fb_field(&field[1], 4, 0);
+	schema = fb_table(fb, 2, field, pos);
+	fb_offset(fb, header, schema);
+
+	fields = fb_vector(fb, ARROW_NUM_COLUMNS, 4, 4);
+	fb_offset(fb, pos[1], fields);
+
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) {
+		uint32_t f, type, type_pos[2];
+
+		// table Field: name, nullable, type_type, type, dictionary, children
+		fb_field(&field[0], 4, 0);
+		fb_field(&field[1], 1, 0);
+		fb_field(&field[2], 1, arrow_field[i].type);
+		fb_field(&field[3], 4, 0);
+		fb_field(&field[4], 0, 0);
+		fb_field(&field[5], 4, 0);
+		f = fb_table(fb, 6, field, pos);
+		fb_offset(fb, fields + 4 + 4 * i, f);
+
+		fb_offset(fb, pos[0], fb_string(fb, arrow_field[i].name));
+
+		if ( arrow_field[i].type == ARROW_TYPE_INT ) {
+			// table Int: bitWidth, is_signed
+			fb_field(&field[0], 4, 8 * arrow_field[i].width);
+			fb_field(&field[1], 1, 0);
+			type = fb_table(fb, 2, field, type_pos);
+		} else {
+			// table FixedSizeBinary: byteWidth
+			fb_field(&field[0], 4, arrow_field[i].width);
+			type = fb_table(fb, 1, field, type_pos);
+		}
+		fb_offset(fb, pos[3], type);
+
+		fb_offset(fb, pos[5], fb_vector(fb, 0, 4, 4));
+	}
+
+	return WriteMetadata(writer);
+
+} // End of WriteSchema
+
+static void *IPv6NetworkOrder(arrow_writer_t *writer, uint64_t *addr, int num_records) {
+int i;
+
+	if ( num_records > writer->ipv6_records ) {
+		free(writer->ipv6);
+		writer->ipv6 = (uint64_t *)malloc(2 * num_records * sizeof(uint64_t));
+		if ( !writer->ipv6 ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			writer->ipv6_records = 0;
+			writer->error = 1;
+			return NULL;
+		}
+		writer->ipv6_records = num_records;
+	}
+
+	for ( i=0; i<2*num_records; i++ ) 
+		writer->ipv6[i] = htonll(addr[i]);
+
+	return writer->ipv6;
+
+} // End of IPv6NetworkOrder
+
+static void DisposeArrowWriter(arrow_writer_t *writer) {
+int i;
+
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) 
+		free(writer->column[i]);
+	free(writer->ipv6);
+	free(writer->fb.buff);
+	free(writer);
+
+} // End of DisposeArrowWriter
+
+arrow_writer_t *OpenArrowStream(FILE *fp, int batch_size) {
+arrow_writer_t *writer;
+
+	writer = (arrow_writer_t *)calloc(1, sizeof(arrow_writer_t));
+	if ( !writer ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	writer->fb.buff = (uint8_t *)malloc(ARROW_METADATA_SIZE);
+	if ( !writer->fb.buff ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		free(writer);
+		return NULL;
+	}
+
+	writer->fp = fp;
+	writer->batch_size = batch_size > 0 ? batch_size : ARROW_BATCH_SIZE;
+
+	if ( !WriteSchema(writer) ) {
+		DisposeArrowWriter(writer);
+		return NULL;
+	}
+
+	return writer;
+
+} // End of OpenArrowStream
+
+int AppendArrowRecord(arrow_writer_t *writer, master_record_t *master_record) {
+int i, n;
+
+	if ( writer->error ) 
+		return 0;
+
+	// the batch is allocated with the first record
+	if ( !writer->column[0] ) {
+		for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) {
+			writer->column[i] = malloc((size_t)writer->batch_size * arrow_field[i].width);
+			if ( !writer->column[i] ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				writer->error = 1;
+				return 0;
+			}
+		}
+	}
+
+	n = writer->num_records;
+	((uint8_t *)writer->column[ARROW_FLAGS])[n]		  = master_record->flags;
+	((uint32_t *)writer->column[ARROW_FIRST])[n]	  = master_record->first;
+	((uint32_t *)writer->column[ARROW_LAST])[n]		  = master_record->last;
+	((uint16_t *)writer->column[ARROW_MSEC_FIRST])[n] = master_record->msec_first;
+	((uint16_t *)writer->column[ARROW_MSEC_LAST])[n]  = master_record->msec_last;
+	((uint8_t *)writer->column[ARROW_PROT])[n]		  = master_record->prot;
+	((uint8_t *)writer->column[ARROW_TCP_FLAGS])[n]	  = master_record->tcp_flags;
+	((uint8_t *)writer->column[ARROW_TOS])[n]		  = master_record->tos;
+	((uint16_t *)writer->column[ARROW_SRCPORT])[n]	  = master_record->srcport;
+	((uint16_t *)writer->column[ARROW_DSTPORT])[n]	  = master_record->dstport;
+	if ( (master_record->flags & FLAG_IPV6_ADDR) != 0 ) {
+		((uint32_t *)writer->column[ARROW_SRCADDR4])[n] = 0;
+		((uint32_t *)writer->column[ARROW_DSTADDR4])[n] = 0;
+	} else {
+		((uint32_t *)writer->column[ARROW_SRCADDR4])[n] = master_record->v4.srcaddr;
+		((uint32_t *)writer->column[ARROW_DSTADDR4])[n] = master_record->v4.dstaddr;
+	}
+	((uint64_t *)writer->column[ARROW_SRCADDR6])[2*n]	  = master_record->v6.srcaddr[0];
+	((uint64_t *)writer->column[ARROW_SRCADDR6])[2*n + 1] = master_record->v6.srcaddr[1];
+	((uint64_t *)writer->column[ARROW_DSTADDR6])[2*n]	  = master_record->v6.dstaddr[0];
+	((uint64_t *)writer->column[ARROW_DSTADDR6])[2*n + 1] = master_record->v6.dstaddr[1];
+	((uint64_t *)writer->column[ARROW_DPKTS])[n]	= master_record->dPkts;
+	((uint64_t *)writer->column[ARROW_DOCTETS])[n]	= master_record->dOctets;
+	((uint32_t *)writer->column[ARROW_SRCAS])[n]	= master_record->srcas;
+	((uint32_t *)writer->column[ARROW_DSTAS])[n]	= master_record->dstas;
+	((uint32_t *)writer->column[ARROW_INPUT])[n]	= master_record->input;
+	((uint32_t *)writer->column[ARROW_OUTPUT])[n]	= master_record->output;
+	writer->num_records++;
+
+	if ( writer->num_records == writer->batch_size ) {
+		writer->num_records = 0;
+		return WriteArrowBatch(writer, writer->batch_size, writer->column);
+	}
+
+	return 1;
+
+} // End of AppendArrowRecord
+
+int WriteArrowBatch(arrow_writer_t *writer, int num_records, void **columns) {
+flatbuffer_t	*fb = &writer->fb;
+fb_field_t		field[3];
+uint32_t		header, batch, nodes, buffers, pos[3];
+uint64_t		body_length, offset, length;
+int i;
+
+	if ( writer->error ) 
+		return 0;
+
+	if ( num_records <= 0 ) 
+		return 1;
+
+	// the body holds the values of each column 8 byte aligned, no validity bitmaps
+	body_length = 0;
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) 
+		body_length += ALIGN((uint64_t)num_records * arrow_field[i].width, 8);
+
+	header = fb_message(fb, ARROW_HEADER_RECORD_BATCH, body_length);
+
+	// table RecordBatch: length, nodes, buffers
+	fb_field(&field[0], 8, num_records);
+	fb_field(&field[1], 4, 0);
+	fb_field(&field[2], 4, 0);
+	batch = fb_table(fb, 3, field, pos);
+	fb_offset(fb, header, batch);
+
+	// struct FieldNode: length, null_count
+	nodes = fb_vector(fb, ARROW_NUM_COLUMNS, 16, 8);
+	fb_offset(fb, pos[1], nodes);
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) 
+		fb_put(fb, nodes + 4 + 16 * i, num_records, 8);
+
+	// struct Buffer: offset, length - an empty validity bitmap and the values per column
+	buffers = fb_vector(fb, 2 * ARROW_NUM_COLUMNS, 16, 8);
+	fb_offset(fb, pos[2], buffers);
+	offset = 0;
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) {
+		length = (uint64_t)num_records * arrow_field[i].width;
+		fb_put(fb, buffers + 4 + 32 * i, offset, 8);
+		fb_put(fb, buffers + 4 + 32 * i + 16, offset, 8);
+		fb_put(fb, buffers + 4 + 32 * i + 24, length, 8);
+		offset += ALIGN(length, 8);
+	}
+
+	if ( !WriteMetadata(writer) ) 
+		return 0;
+
+	for ( i=0; i<ARROW_NUM_COLUMNS; i++ ) {
+		void *data = columns[i];
+
+		if ( i == ARROW_SRCADDR6 || i == ARROW_DSTADDR6 ) {
+			data = IPv6NetworkOrder(writer, (uint64_t *)columns[i], num_records);
+			if ( !data ) 
+				return 0;
+		}
+		length = (uint64_t)num_records * arrow_field[i].width;
+		if ( !WriteData(writer, data, length) || !WriteData(writer, padding, ALIGN(length, 8) - length) ) 
+			return 0;
+	}
+
+	return 1;
+
+} // End of WriteArrowBatch
+
+int CloseArrowStream(arrow_writer_t *writer) {
+uint8_t eos[8];
+int ok;
+
+	// flush the current batch of AppendArrowRecord
+	ok = WriteArrowBatch(writer, writer->num_records, writer->column);
+
+	// end of stream marker
+	put_le(eos, ARROW_CONTINUATION, 4);
+	put_le(eos + 4, 0, 4);
+	ok = ok && WriteData(writer, eos, 8);
+
+	if ( ok && fflush(writer->fp) != 0 ) {
+		fprintf(stderr, "Failed to write arrow stream: %s\n", strerror(errno));
+		ok = 0;
+	}
+
+	DisposeArrowWriter(writer);
+
+	return ok;
+
+} // End of CloseArrowStream
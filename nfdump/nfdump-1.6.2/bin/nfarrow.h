@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+#ifndef _NFARROW_H
+#define _NFARROW_H 1
+
+// number of records per record batch of AppendArrowRecord
+#define ARROW_BATCH_SIZE 65536
+
+/*
+ * Columns of the exported schema. WriteArrowBatch expects an array per
+ * column in this order. Addresses are stored as in master_record_t:
+ * two uint64_t per IPv6 address, srcaddr4/dstaddr4 are 0 for IPv6.
+ */
+enum {
+	ARROW_FLAGS = 0,	// uint8_t
+	ARROW_FIRST,		// uint32_t
+	ARROW_LAST,			// uint32_t
+	ARROW_MSEC_FIRST,	// uint16_t
+	ARROW_MSEC_LAST,	// uint16_t
+	ARROW_PROT,			// uint8_t
+	ARROW_TCP_FLAGS,	// uint8_t
+	ARROW_TOS,			// uint8_t
+	ARROW_SRCPORT,		// uint16_t
+	ARROW_DSTPORT,		// uint16_t
+	ARROW_SRCADDR4,		// uint32_t
+	ARROW_DSTADDR4,		// uint32_t
+	ARROW_SRCADDR6,		// uint64_t[2]
+	ARROW_DSTADDR6,		// uint64_t[2]
+	ARROW_DPKTS,		// uint64_t
+	ARROW_DOCTETS,		// uint64_t
+	ARROW_SRCAS,		// uint32_t
+	ARROW_DSTAS,		// uint32_t
+	ARROW_INPUT,		// uint32_t
+	ARROW_OUTPUT,		// uint32_t
+	ARROW_NUM_COLUMNS
+};
+
+/*
+ * Writer of an Apache Arrow IPC stream: a schema message, followed by one
+ * record batch message per batch and an end of stream marker.
+ */
+typedef struct arrow_writer_s arrow_writer_t;
+
+arrow_writer_t *OpenArrowStream(FILE *fp, int batch_size);
+
+int AppendArrowRecord(arrow_writer_t *writer, master_record_t *master_record);
+
+int WriteArrowBatch(arrow_writer_t *writer, int num_records, void **columns);
+
+int CloseArrowStream(arrow_writer_t *writer);
+
+#endif //_NFARROW_H
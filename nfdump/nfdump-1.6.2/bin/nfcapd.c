@@ -106,6 +106,7 @@
 #endif
 
 #include "expire.h"
+#include "nfrollup.h"
 
 #define DEFAULTCISCOPORT "9995"
 #define DEFAULTHOSTNAME "127.0.0.1"
@@ -148,7 +149,7 @@ static void daemonize(void);
 static void SetPriv(char *userid, char *groupid );
 
 static void run(packet_function_t receive_packet, int socket, send_peer_t peer, 
-	time_t twin, time_t t_begin, int report_seq, int use_subdirs, int compress);
+	time_t twin, time_t t_begin, int report_seq, int use_subdirs, int compress, int workers);
 
 /* Functions */
 static void usage(char *name) {
@@ -169,9 +170,15 @@ static void usage(char *name) {
 					"-R IP[/port]\tRepeat incoming packets to IP address/port\n"
 					"-s rate\tset default sampling rate (default 1)\n"
 					"-x process\tlaunch process after a new file becomes available\n"
-					"-z\t\tCompress flows in output file.\n"
+					"-z\t\tCompress flows in output file with LZO1X-1.\n"
+					"-y\t\tCompress flows in output file with LZ4.\n"
+					"-Y level\tCompress flows in output file with Zstandard at level 1..19.\n"
+					"-W num\t\tCompress and write data blocks in background using num worker threads.\n"
+					"-C\t\tWrite columnar data blocks.\n"
 					"-B bufflen\tSet socket buffer to bufflen bytes\n"
 					"-e\t\tExpire data at each cycle.\n"
+					"-k\t\tCreate block index and address filter of each new file.\n"
+					"-G keys\t\tCreate rollup of the ',' separated -s keys of each new file: srcip, dstip, port, as ... or all.\n"
 					"-D\t\tFork to background\n"
 					"-E\t\tPrint extended format of netflow data. for debugging purpose only.\n"
 					"-T\t\tInclude extension tags in records.\n"
@@ -356,7 +363,7 @@ int		err;
 #include "collector_inline.c"
 
 static void run(packet_function_t receive_packet, int socket, send_peer_t peer, 
-	time_t twin, time_t t_begin, int report_seq, int use_subdirs, int compress) {
+	time_t twin, time_t t_begin, int report_seq, int use_subdirs, int compress, int workers) {
 common_flow_header_t	*nf_header;
 FlowSource_t			*fs;
 struct sockaddr_storage nf_sender;
@@ -404,6 +411,12 @@ srecord_t	*commbuff;
 			return;
 		}
 
+		// compress and write the data blocks in the background
+		if ( !StartBlockWriter(&fs->nffile, workers) ) {
+			syslog(LOG_ERR, "Ident: %s, failed to start block writer", fs->Ident);
+			return;
+		}
+
 		// init stat vars
 		memset((void *)&fs->stat_record, 0, sizeof(stat_record_t));
 		fs->bad_packets		= 0;
@@ -525,6 +538,10 @@ srecord_t	*commbuff;
 				fs->stat_record.last_seen 	= fs->last_seen/1000;
 				fs->stat_record.msec_last	= fs->last_seen - fs->stat_record.last_seen*1000;
 	
+				// all queued blocks must be on disk, before the file is closed
+				if ( !FlushBlockWriter(&fs->nffile) ) 
+					syslog(LOG_ERR, "Ident: %s, failed to write output buffer to disk: '%s'" , fs->Ident, strerror(errno));
+
 				// Write Stat record and close file
 				CloseUpdateFile(fs->nffile.wfd, &fs->stat_record, fs->nffile.file_blocks, fs->Ident, compress, &string );
 				if ( string != NULL ) {
@@ -740,6 +757,7 @@ srecord_t	*commbuff;
 
 	fs = FlowSource;
 	while ( fs ) {
+		StopBlockWriter(&fs->nffile);
 		free((void *)fs->nffile.block_header);
 		fs = fs->next;
 	}
@@ -759,8 +777,9 @@ FlowSource_t *fs;
 struct sigaction act;
 int		family, bufflen;
 time_t 	twin, t_start;
-int		sock, err, synctime, do_daemonize, expire, report_sequence;
-int		subdir_index, sampling_rate, compress;
+int		sock, err, synctime, do_daemonize, expire, build_index, report_sequence;
+uint32_t	rollup_keys;
+int		subdir_index, sampling_rate, compress, workers, columnar;
 int		c;
 
 	receive_packet 	= recvfrom;
@@ -781,8 +800,12 @@ int		c;
 	datadir	 		= NULL;
 	subdir_index	= 0;
 	expire			= 0;
+	build_index		= 0;
+	rollup_keys		= 0;
 	sampling_rate	= 1;
 	compress		= 0;
+	workers			= 0;
+	columnar		= 0;
 	memset((void *)&peer, 0, sizeof(send_peer_t));
 	peer.family		= AF_UNSPEC;
 	Ident			= "none";
@@ -790,7 +813,7 @@ int		c;
 	extension_tags	= DefaultExtensions;
 	pcap_file		= NULL;
 
-	while ((c = getopt(argc, argv, "46ef:whEVI:DB:b:j:l:n:p:P:R:S:s:T:t:x:ru:g:z")) != EOF) {
+	while ((c = getopt(argc, argv, "46ef:whEVI:DB:b:j:l:n:p:P:R:S:s:T:t:x:ru:g:G:zkyY:W:C")) != EOF) {
 		switch (c) {
 			case 'h':
 				usage(argv[0]);
@@ -805,6 +828,13 @@ int		c;
 			case 'e':
 				expire = 1;
 				break;
+			case 'k':
+				build_index = 1;
+				break;
+			case 'G':
+				if ( !ParseRollupKeys(optarg, &rollup_keys) ) 
+					exit(255);
+				break;
 			case 'f': {
 #ifdef PCAP
 				struct stat	fstat;
@@ -930,8 +960,29 @@ int		c;
 				launch_process = optarg;
 				break;
 			case 'z':
-				compress = 1;
+				compress = LZO_COMPRESSED;
+				break;
+			case 'C':
+				columnar = 1;
 				break;
+			case 'W':
+				workers = strtol(optarg, &checkptr, 10);
+				if ( (checkptr != NULL && *checkptr == 0) && workers > 0 && workers <= MAXWORKERS )
+					break;
+				fprintf(stderr,"Argument error for -W. Number of workers 1..%d expected\n", MAXWORKERS);
+				exit(255);
+			case 'y':
+				compress = LZ4_COMPRESSED;
+				break;
+			case 'Y': {
+				long level = strtol(optarg, &checkptr, 10);
+				if ( (checkptr != NULL && *checkptr == 0) && level > 0 && level <= ZSTD_MAX_LEVEL ) {
+					compress = ZSTD_COMPRESSION(level);
+					break;
+				}
+				fprintf(stderr,"Argument error for -Y. Level 1..%d expected\n", ZSTD_MAX_LEVEL);
+				exit(255);
+				}
 			case '4':
 				if ( family == AF_UNSPEC )
 					family = AF_INET;
@@ -953,6 +1004,9 @@ int		c;
 				exit(255);
 		}
 	}
+
+	if ( columnar )
+		compress |= COLUMNAR_BLOCKS;
 	
 	if ( FlowSource == NULL && datadir == NULL ) {
 		fprintf(stderr, "ERROR, Missing -n (-l/-I) source definitions\n");
@@ -1084,7 +1138,7 @@ int		c;
 	}
 
 	done = 0;
-	if ( launch_process || expire ) {
+	if ( launch_process || expire || build_index || rollup_keys ) {
 		// for efficiency reason, the process collecting the data
 		// and the process launching processes, when a new file becomes
 		// available are separated. Communication is done using signals
@@ -1104,7 +1158,7 @@ int		c;
 			case 0:
 				// child
 				close(sock);
-				launcher((char *)shmem, FlowSource, launch_process, expire);
+				launcher((char *)shmem, FlowSource, launch_process, expire, build_index, rollup_keys);
 				_exit(0);
 				break;
 			case -1:
@@ -1167,7 +1221,7 @@ int		c;
 	sigaction(SIGCHLD, &act, NULL);
 
 	syslog(LOG_INFO, "Startup.");
-	run(receive_packet, sock, peer, twin, t_start, report_sequence, subdir_index, compress);
+	run(receive_packet, sock, peer, twin, t_start, report_sequence, subdir_index, compress, workers);
 	close(sock);
 	kill_launcher(launcher_pid);
 
@@ -0,0 +1,804 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+
+/*
+ * nfcompact merges the nfcapd files of each hour or day of a data directory
+ * into one file, which is sorted by the flow start time, marked FLAG_SORTED and
+ * has a block index.
+ * Unsorted files are sorted in memory one by one and written to a temporary
+ * run file. All files of the interval are then merged with a merge reader, so
+ * memory is bounded by the largest input file. The compacted file replaces 
+ * the input files and is named after the start of the interval, so nfdump -R
+ * and nfexpire see it as any other file. The directory stat and the books of 
+ * a running collector are updated as nfexpire does.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#ifdef HAVE_FTS_H
+#   include <fts.h>
+#else
+#   include "fts_compat.h"
+#define fts_children fts_children_compat
+#define fts_close fts_close_compat
+#define fts_open  fts_open_compat
+#define fts_read  fts_read_compat
+#define fts_set   fts_set_compat
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "nf_common.h"
+#include "nffile.h"
+#include "nfx.h"
+#include "bookkeeper.h"
+#include "nfstatfile.h"
+#include "expire.h"
+#include "util.h"
+#include "flist.h"
+#include "nfmerge.h"
+#include "nfrollup.h"
+
+#if ( SIZEOF_VOID_P == 8 )
+typedef uint64_t	pointer_addr_t;
+#else
+typedef uint32_t	pointer_addr_t;
+#endif
+
+// intervals of the compacted files
+enum { COMPACT_HOUR = 0, COMPACT_DAY };
+
+// length of the time string prefix of the file names in an interval
+#define HOUR_KEY_LEN	10
+#define DAY_KEY_LEN		8
+
+// cached map id of the compacted file for a map id of an input file
+typedef struct map_cache_s {
+	extension_map_t	*map;		// map of the input file
+	uint32_t		out_id;		// map id in the compacted file
+} map_cache_t;
+
+typedef struct map_table_s {
+	map_cache_t		*cache;		// indexed by the map id of the input file
+	uint32_t		size;
+} map_table_t;
+
+// sort entry of a flow record of an input file
+typedef struct sort_record_s {
+	uint64_t		time;
+	uint32_t		num;		// record number, keeps the order of records with the same time
+	common_record_t	*record;
+} sort_record_t;
+
+// memory for the records of an input file
+typedef struct record_buff_s {
+	struct record_buff_s	*next;
+	uint32_t				used;
+	uint8_t					data[BUFFSIZE];
+} record_buff_t;
+
+// extension maps of the compacted file, the map id is the index
+static extension_map_t	*out_maps[MAX_EXTENSION_MAPS];
+static uint8_t			out_map_written[MAX_EXTENSION_MAPS];
+static uint32_t			num_out_maps;
+
+/* Function Prototypes */
+static void usage(char *name);
+
+static int CompareRecords(const void *p1, const void *p2);
+
+static int OutMapId(map_table_t *table, extension_map_t *map);
+
+static void ClearOutMaps(void);
+
+static int SortFile(char *filename, char *runfile, stat_record_t *stat_record, char *ident, int *sorted);
+
+static int MergeFiles(char **files, uint32_t num_files, char *outfile, stat_record_t *stat_record, char *ident, 
+	int compress, int workers);
+
+static int CompactFiles(char *dir, char *key, int key_len, char **files, uint32_t num_files, int compress, 
+	int workers, uint32_t rollup_keys, dirstat_t *dirstat);
+
+#include "nffile_inline.c"
+
+static void usage(char *name) {
+		printf("usage %s [options] \n"
+					"-h\t\tthis text you see right here\n"
+					"-l datadir\tCompact the files in directory datadir and its sub directories.\n"
+					"-i interval\tInterval of the compacted files: hour ( default ) or day.\n"
+					"-a age\t\tCompact only intervals, which ended age ago.\n"
+					"\t\tscales: w week, d day, H hour, M minute\n"
+					"-n\t\tList the files, which would be compacted, only.\n"
+					"-z\t\tCompress flows in output file with LZO.\n"
+					"-y\t\tCompress flows in output file with LZ4.\n"
+					"-Y level\tCompress flows in output file with Zstandard at level 1..19.\n"
+					"-C\t\tWrite columnar data blocks.\n"
+					"-W num\t\tCompress and write data blocks in background using num worker threads.\n"
+					"-G keys\t\tCreate rollup of the ',' separated -s keys of each compacted file: srcip, dstip, port, as ... or all.\n"
+					, name);
+} /* usage */
+
+/*
+ * Map id in the compacted file of the map of an input file. Equal maps of all 
+ * input files get the same id. Returns the id or -1 on errors.
+ */
+static int OutMapId(map_table_t *table, extension_map_t *map) {
+uint32_t i, map_id = map->map_id;
+
+	if ( map_id >= table->size ) {
+		uint32_t size = map_id + 16;
+		map_cache_t *cache = realloc(table->cache, size * sizeof(map_cache_t));
+		if ( !cache ) {
+			fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return -1;
+		}
+		memset((void *)&cache[table->size], 0, (size - table->size) * sizeof(map_cache_t));
+		table->cache = cache;
+		table->size  = size;
+	}
+
+	// the merge reader replaces the map pointer, if a file redefines a map id
+	if ( table->cache[map_id].map == map ) 
+		return table->cache[map_id].out_id;
+
+	for ( i=0; i < num_out_maps; i++ ) {
+		if ( out_maps[i]->size == map->size && 
+			 memcmp((void *)out_maps[i]->ex_id, (void *)map->ex_id, map->size - sizeof(extension_map_t)) == 0 )
+			break;
+	}
+
+	if ( i == num_out_maps ) {
+		if ( num_out_maps == MAX_EXTENSION_MAPS ) {
+			fprintf(stderr, "Extension map list exhausted - too many extension maps ( > %d ) to process;\n", MAX_EXTENSION_MAPS);
+			return -1;
+		}
+		out_maps[i] = malloc(map->size);
+		if ( !out_maps[i] ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return -1;
+		}
+		memcpy((void *)out_maps[i], (void *)map, map->size);
+		out_maps[i]->map_id = i;
+		out_map_written[i] = 0;
+		num_out_maps++;
+	}
+
+	table->cache[map_id].map	= map;
+	table->cache[map_id].out_id = i;
+
+	return i;
+
+} // End of OutMapId
+
+static void ClearOutMaps(void) {
+uint32_t i;
+
+	for ( i=0; i < num_out_maps; i++ ) {
+		free(out_maps[i]);
+		out_maps[i] = NULL;
+		out_map_written[i] = 0;
+	}
+	num_out_maps = 0;
+
+} // End of ClearOutMaps
+
+static int CompareRecords(const void *p1, const void *p2) {
+const sort_record_t *r1 = (const sort_record_t *)p1;
+const sort_record_t *r2 = (const sort_record_t *)p2;
+
+	if ( r1->time != r2->time ) 
+		return r1->time < r2->time ? -1 : 1;
+
+	return r1->num < r2->num ? -1 : ( r1->num > r2->num ? 1 : 0 );
+
+} // End of CompareRecords
+
+/*
+ * Read the input file into memory and write its records sorted by time with the map ids of 
+ * the compacted file to the uncompressed run file. If the file is already sorted, *sorted is
+ * set and no run file is written. The stat record of the file is added to stat_record, 
+ * its ident is copied to ident, if still empty. Returns 1 on success, 0 on errors.
+ */
+static int SortFile(char *filename, char *runfile, stat_record_t *stat_record, char *ident, int *sorted) {
+merge_reader_t		*reader;
+extension_info_t	*extension_info;
+common_record_t		*record;
+record_buff_t		*buff, *first_buff;
+sort_record_t		*records;
+map_table_t			table;
+nffile_t			nffile;
+stat_record_t		file_stat;
+uint64_t			last_time;
+uint32_t			i, num_records, max_records;
+char				*string;
+int					ok;
+
+	reader = OpenMergeReader(&filename, 1);
+	if ( !reader ) 
+		return 0;
+
+	memset((void *)&table, 0, sizeof(table));
+	first_buff	= NULL;
+	records		= NULL;
+	num_records = max_records = 0;
+	last_time	= 0;
+	*sorted		= 1;
+	ok			= 1;
+
+	while ( ok && (record = NextMergeRecord(reader, &extension_info, NULL)) != NULL ) {
+		sort_record_t *r;
+		int out_id = OutMapId(&table, extension_info->map);
+
+		if ( out_id < 0 ) {
+			ok = 0;
+			break;
+		}
+		if ( RECORD_TIME(record) < last_time ) 
+			*sorted = 0;
+		last_time = RECORD_TIME(record);
+
+		if ( !first_buff || (BUFFSIZE - first_buff->used) < record->size ) {
+			buff = malloc(sizeof(record_buff_t));
+			if ( !buff ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				ok = 0;
+				break;
+			}
+			buff->next = first_buff;
+			buff->used = 0;
+			first_buff = buff;
+		}
+		if ( num_records == max_records ) {
+			max_records += 1024 * 1024;
+			r = realloc(records, max_records * sizeof(sort_record_t));
+			if ( !r ) {
+				fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				ok = 0;
+				break;
+			}
+			records = r;
+		}
+
+		r = &records[num_records];
+		r->time	  = RECORD_TIME(record);
+		r->num	  = num_records;
+		r->record = (common_record_t *)&first_buff->data[first_buff->used];
+		memcpy((void *)r->record, (void *)record, record->size);
+		r->record->ext_map = out_id;
+		first_buff->used += record->size;
+		num_records++;
+	}
+
+	if ( ok && MergeErrors(reader) ) 
+		ok = 0;
+
+	if ( ok ) {
+		file_stat = *MergeStatRecord(reader, 0);
+		SumStatRecords(stat_record, &file_stat);
+		if ( ident[0] == '\0' ) {
+			strncpy(ident, MergeIdent(reader, 0), IdentLen-1);
+			ident[IdentLen-1] = '\0';
+		}
+	}
+	CloseMergeReader(reader);
+
+	if ( ok && !*sorted ) {
+		qsort((void *)records, num_records, sizeof(sort_record_t), CompareRecords);
+
+		memset((void *)&nffile, 0, sizeof(nffile));
+		if ( !InitExportFile(runfile, NOT_COMPRESSED, &nffile) ) {
+			ok = 0;
+		} else {
+			// the run knows all maps so far, as the records were translated
+			for ( i=0; i < num_out_maps; i++ ) 
+				AppendToBuffer(&nffile, (void *)out_maps[i], out_maps[i]->size);
+			for ( i=0; i < num_records; i++ ) 
+				AppendToBuffer(&nffile, (void *)records[i].record, records[i].record->size);
+			if ( nffile.block_header->NumRecords ) {
+				if ( WriteBlock(&nffile) <= 0 ) {
+					fprintf(stderr, "Failed to write output buffer to disk: '%s'\n", strerror(errno));
+					ok = 0;
+				} else 
+					nffile.file_blocks++;
+			}
+			CloseUpdateFile(nffile.wfd, &file_stat, nffile.file_blocks, ident, NOT_COMPRESSED, &string);
+			if ( string != NULL ) {
+				fprintf(stderr, "%s\n", string);
+				ok = 0;
+			}
+			free(nffile.block_header);
+		}
+	}
+
+	while ( first_buff ) {
+		buff = first_buff->next;
+		free(first_buff);
+		first_buff = buff;
+	}
+	if ( records ) 
+		free(records);
+	if ( table.cache ) 
+		free(table.cache);
+
+	return ok;
+
+} // End of SortFile
+
+/*
+ * Merge the sorted files by time into outfile with the maps of the compacted file.
+ * Returns 1 on success, 0 on errors.
+ */
+static int MergeFiles(char **files, uint32_t num_files, char *outfile, stat_record_t *stat_record, char *ident, 
+	int compress, int workers) {
+merge_reader_t		*reader;
+extension_info_t	*extension_info;
+common_record_t		*record;
+map_table_t			*tables;
+nffile_t			nffile;
+uint32_t			i, file, record_buff[65536 / sizeof(uint32_t)];
+char				*string;
+int					fd, ok;
+
+	tables = calloc(num_files, sizeof(map_table_t));
+	if ( !tables ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+
+	reader = OpenMergeReader(files, num_files);
+	if ( !reader ) {
+		free(tables);
+		return 0;
+	}
+
+	memset((void *)&nffile, 0, sizeof(nffile));
+	if ( !InitExportFile(outfile, compress, &nffile) || !StartBlockWriter(&nffile, workers) ) {
+		CloseMergeReader(reader);
+		free(tables);
+		return 0;
+	}
+
+	ok = 1;
+	while ( (record = NextMergeRecord(reader, &extension_info, &file)) != NULL ) {
+		int out_id = OutMapId(&tables[file], extension_info->map);
+		if ( out_id < 0 ) {
+			ok = 0;
+			break;
+		}
+
+		if ( !out_map_written[out_id] ) {
+			AppendToBuffer(&nffile, (void *)out_maps[out_id], out_maps[out_id]->size);
+			out_map_written[out_id] = 1;
+		}
+
+		memcpy((void *)record_buff, (void *)record, record->size);
+		((common_record_t *)record_buff)->ext_map = out_id;
+		AppendToBuffer(&nffile, (void *)record_buff, record->size);
+	}
+
+	if ( MergeErrors(reader) ) 
+		ok = 0;
+	CloseMergeReader(reader);
+
+	for ( i=0; i < num_files; i++ ) {
+		if ( tables[i].cache ) 
+			free(tables[i].cache);
+	}
+	free(tables);
+
+	// flush current buffer to disc
+	if ( nffile.block_header->NumRecords ) {
+		if ( WriteBlock(&nffile) <= 0 ) {
+			fprintf(stderr, "Failed to write output buffer to disk: '%s'\n", strerror(errno));
+			ok = 0;
+		} else {
+			nffile.file_blocks++;
+		}
+	}
+	if ( !StopBlockWriter(&nffile) ) {
+		fprintf(stderr, "Failed to write output buffer to disk: '%s'\n", strerror(errno));
+		ok = 0;
+	}
+	CloseUpdateFile(nffile.wfd, stat_record, nffile.file_blocks, ident, nffile.compress | SORTED_RECORDS, &string);
+	if ( string != NULL ) {
+		fprintf(stderr, "%s\n", string);
+		ok = 0;
+	}
+	free(nffile.block_header);
+
+	// the input files are removed next - the compacted file must be on disk
+	fd = open(outfile, O_RDONLY);
+	if ( fd < 0 || fsync(fd) < 0 ) {
+		fprintf(stderr, "Failed to sync file '%s': %s\n", outfile, strerror(errno));
+		ok = 0;
+	}
+	if ( fd >= 0 ) 
+		close(fd);
+
+	return ok;
+
+} // End of MergeFiles
+
+/*
+ * Compact the files of one interval in directory dir. key is the time string prefix of the interval.
+ * Returns 1 on success, 0 on errors. The input files are only removed on success.
+ */
+static int CompactFiles(char *dir, char *key, int key_len, char **files, uint32_t num_files, int compress, 
+	int workers, uint32_t rollup_keys, dirstat_t *dirstat) {
+stat_record_t	stat_record;
+struct stat		stat_buf;
+char			**sources, **runs, outfile[MAXPATHLEN], tmpfile[MAXPATHLEN], ident[IdentLen];
+char			timestring[16];
+uint64_t		old_size;
+uint32_t		i;
+int				ok, sorted;
+
+	snprintf(timestring, 16, "%.*s%s", key_len, key, key_len == HOUR_KEY_LEN ? "00" : "0000");
+	snprintf(outfile, MAXPATHLEN, "%s/nfcapd.%s", dir, timestring);
+	snprintf(tmpfile, MAXPATHLEN, "%s/.nfcompact.%lu", dir, (unsigned long)getpid());
+	outfile[MAXPATHLEN-1] = '\0';
+	tmpfile[MAXPATHLEN-1] = '\0';
+
+	sources = calloc(num_files, sizeof(char *));
+	runs	= calloc(num_files, sizeof(char *));
+	if ( !sources || !runs ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		exit(255);
+	}
+
+	memset((void *)&stat_record, 0, sizeof(stat_record_t));
+	stat_record.first_seen = 0x7fffffff;
+	stat_record.msec_first = 999;
+	ident[0] = '\0';
+	old_size = 0;
+	ok = 1;
+
+	// sort the files not yet sorted into runs
+	for ( i=0; ok && i < num_files; i++ ) {
+		char runfile[MAXPATHLEN];
+
+		if ( stat(files[i], &stat_buf) == 0 ) 
+			old_size += 512 * stat_buf.st_blocks;
+
+		snprintf(runfile, MAXPATHLEN, "%s/.nfcompact.%lu.%u", dir, (unsigned long)getpid(), i);
+		runfile[MAXPATHLEN-1] = '\0';
+		ok = SortFile(files[i], runfile, &stat_record, ident, &sorted);
+		if ( ok && !sorted ) {
+			runs[i] = strdup(runfile);
+			if ( !runs[i] ) {
+				fprintf(stderr, "strdup() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				exit(255);
+			}
+			sources[i] = runs[i];
+		} else 
+			sources[i] = files[i];
+	}
+
+	if ( ok ) 
+		ok = MergeFiles(sources, num_files, tmpfile, &stat_record, ident, compress, workers);
+
+	for ( i=0; i < num_files; i++ ) {
+		if ( runs[i] ) {
+			unlink(runs[i]);
+			free(runs[i]);
+		}
+	}
+	free(runs);
+	free(sources);
+	ClearOutMaps();
+
+	if ( !ok ) {
+		fprintf(stderr, "Failed to compact files of %s in %s. Files left unchanged.\n", timestring, dir);
+		unlink(tmpfile);
+		return 0;
+	}
+
+	/* 
+	 * Replace the inputs by the compacted file: the file with the name of the interval is 
+	 * replaced atomically, so a crash leaves duplicate flows, but never looses flows
+	 */
+	UnlinkIndex(outfile);
+	if ( rename(tmpfile, outfile) < 0 ) {
+		fprintf(stderr, "Failed to rename '%s' to '%s': %s\n", tmpfile, outfile, strerror(errno));
+		unlink(tmpfile);
+		return 0;
+	}
+	for ( i=0; i < num_files; i++ ) {
+		if ( strcmp(files[i], outfile) == 0 ) 
+			continue;
+		if ( unlink(files[i]) < 0 ) 
+			fprintf(stderr, "Failed to remove '%s': %s\n", files[i], strerror(errno));
+		UnlinkIndex(files[i]);
+	}
+
+	// the block index allows nfdump to seek to a time window
+	if ( !IndexFile(outfile) ) 
+		fprintf(stderr, "Failed to create the block index of '%s'\n", outfile);
+
+	// the rollup answers nfdump -s of the whole interval without reading the flows
+	if ( rollup_keys && !RollupFile(outfile, rollup_keys) ) 
+		fprintf(stderr, "Failed to create the rollup of '%s'\n", outfile);
+
+	if ( dirstat ) {
+		dirstat->numfiles -= num_files - 1;
+		dirstat->filesize -= old_size;
+		if ( stat(outfile, &stat_buf) == 0 ) 
+			dirstat->filesize += 512 * stat_buf.st_blocks;
+		if ( (uint64_t)ISO2UNIX(timestring) < dirstat->first ) 
+			dirstat->first = ISO2UNIX(timestring);
+	}
+
+	printf("Compacted %u files into %s: %s", num_files, outfile, ScaleValue(old_size));
+	if ( stat(outfile, &stat_buf) == 0 ) 
+		printf(" -> %s", ScaleValue(512 * stat_buf.st_blocks));
+	printf("\n");
+
+	return 1;
+
+} // End of CompactFiles
+
+static int compare(const FTSENT **f1, const FTSENT **f2) {
+	return strcmp( (*f1)->fts_name, (*f2)->fts_name);
+} // End of compare
+
+int main( int argc, char **argv ) {
+FTS				*fts;
+FTSENT			*ftsent;
+stringlist_t	filelist;
+dirstat_t		*dirstat;
+bookkeeper_t	*books;
+struct stat		stat_buf;
+char			*datadir, *checkptr, *dirs[2];
+uint64_t		age;
+time_t			now;
+uint32_t		i, first, rollup_keys;
+int				c, ret, compress, columnar, workers, interval, key_len, list_only, books_stat, do_rescan, failed;
+
+	datadir	  = NULL;
+	age		  = 0;
+	compress  = NOT_COMPRESSED;
+	columnar  = 0;
+	workers	  = 0;
+	interval  = COMPACT_HOUR;
+	list_only = 0;
+	rollup_keys = 0;
+
+	while ((c = getopt(argc, argv, "a:hi:l:nzyY:CW:G:")) != EOF) {
+		switch (c) {
+			case 'h':
+				usage(argv[0]);
+				exit(0);
+				break;
+			case 'a':
+				if ( ParseTimeDef(optarg, &age ) == 0 )
+					exit(250);
+				break;
+			case 'i':
+				if ( strcmp(optarg, "hour") == 0 ) 
+					interval = COMPACT_HOUR;
+				else if ( strcmp(optarg, "day") == 0 ) 
+					interval = COMPACT_DAY;
+				else {
+					fprintf(stderr, "Unknown interval '%s'. Use hour or day\n", optarg);
+					exit(250);
+				}
+				break;
+			case 'l':
+				datadir = optarg;
+				break;
+			case 'n':
+				list_only = 1;
+				break;
+			case 'z':
+				compress = LZO_COMPRESSED;
+				break;
+			case 'y':
+#ifdef HAVE_LIBLZ4
+				compress = LZ4_COMPRESSED;
+#else
+				fprintf(stderr, "LZ4 compression not available. Rebuild nfdump with --enable-lz4\n");
+				exit(255);
+#endif
+				break;
+			case 'Y': {
+#ifdef HAVE_LIBZSTD
+				int level = strtol(optarg, &checkptr, 10);
+				if ( (checkptr != NULL && *checkptr == 0) && level >= 1 && level <= ZSTD_MAX_LEVEL ) 
+					compress = ZSTD_COMPRESSION(level);
+				else {
+					fprintf(stderr, "Zstandard level must be 1..%d\n", ZSTD_MAX_LEVEL);
+					exit(255);
+				}
+#else
+				fprintf(stderr, "Zstandard compression not available. Rebuild nfdump with --enable-zstd\n");
+				exit(255);
+#endif
+				} break;
+			case 'C':
+				columnar = 1;
+				break;
+			case 'W':
+				workers = strtol(optarg, &checkptr, 10);
+				if ( (checkptr == NULL || *checkptr != 0) || workers <= 0 || workers > MAXWORKERS ) {
+					fprintf(stderr, "Number of workers must be 1..%d\n", MAXWORKERS);
+					exit(255);
+				}
+				break;
+			case 'G':
+				if ( !ParseRollupKeys(optarg, &rollup_keys) ) 
+					exit(250);
+				break;
+			default:
+				usage(argv[0]);
+				exit(250);
+		}
+	}
+
+	if ( columnar )
+		compress |= COLUMNAR_BLOCKS;
+
+	if ( !datadir ) {
+		fprintf(stderr, "Missing data directory\n");
+		usage(argv[0]);
+		exit(250);
+	}
+	if ( stat(datadir, &stat_buf) || !S_ISDIR(stat_buf.st_mode) ) {
+		fprintf(stderr, "No such directory: %s\n", datadir);
+		exit(250);
+	}
+
+	// collect all data files - the sort order groups the files of an interval
+	InitStringlist(&filelist, 1024);
+	dirs[0] = datadir;
+	dirs[1] = NULL;
+	fts = fts_open(dirs, FTS_LOGICAL, compare);
+	if ( !fts ) {
+		fprintf(stderr, "fts_open() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		exit(250);
+	}
+	while ( (ftsent = fts_read(fts)) != NULL) {
+		if ( ftsent->fts_info == FTS_F && ftsent->fts_namelen == 19 && strncmp(ftsent->fts_name, "nfcapd.", 7) == 0 ) {
+			// nfcapd.200604301200 strlen = 19
+			char *s = &(ftsent->fts_name[7]);
+			while ( *s >= '0' && *s <= '9' ) 
+				s++;
+			if ( *s == '\0' ) 
+				InsertString(&filelist, ftsent->fts_path);
+		} else if ( ftsent->fts_info == FTS_D && ftsent->fts_level > 0 && ftsent->fts_name[0] == '.' ) {
+			// skip hidden directories such as the address index
+			fts_set(fts, ftsent, FTS_SKIP);
+		}
+	}
+	fts_close(fts);
+
+	dirstat	   = NULL;
+	books	   = NULL;
+	books_stat = ERR_NOTEXISTS;
+	do_rescan  = 0;
+	if ( !list_only ) {
+		// lock the directory stat against nfexpire and take over the books of a running collector
+		ret = ReadStatInfo(datadir, &dirstat, CRETAE_AND_LOCK);
+		switch (ret) {
+			case STATFILE_OK:
+				break;
+			case FORCE_REBUILD:
+			case ERR_NOSTATFILE:
+				do_rescan = 1;
+				break;
+			default:
+				exit(250);
+		}
+		books_stat = AccessBookkeeper(&books, datadir);
+		if ( books_stat == ERR_FAILED ) {
+			fprintf(stderr, "Failed to access bookkeeping record.\n");
+			exit(250);
+		}
+		if ( books_stat == BOOKKEEPER_OK ) {
+			bookkeeper_t tmp_books;
+			ClearBooks(books, &tmp_books);
+			UpdateBookStat(dirstat, &tmp_books);
+			if ( dirstat->status == FORCE_REBUILD ) 
+				do_rescan = 1;
+		}
+	}
+
+	key_len = interval == COMPACT_HOUR ? HOUR_KEY_LEN : DAY_KEY_LEN;
+	now		= time(NULL);
+	failed	= 0;
+	first	= 0;
+	for ( i=1; i <= filelist.num_strings; i++ ) {
+		char *name, *first_name, *p, timestring[16];
+		time_t interval_end;
+		size_t dir_len;
+
+		first_name = filelist.list[first];
+		p = strrchr(first_name, '/');
+		dir_len = p ? p - first_name : 0;
+
+		// extend the group with files in the same directory and interval
+		if ( i < filelist.num_strings ) {
+			name = filelist.list[i];
+			if ( strncmp(name, first_name, dir_len + 8 + key_len) == 0 && name[dir_len] == '/' ) 
+				continue;
+		}
+
+		// interval [first, i)
+		snprintf(timestring, 16, "%.*s%s", key_len, first_name + dir_len + 8, 
+			key_len == HOUR_KEY_LEN ? "00" : "0000");
+		interval_end = ISO2UNIX(timestring) + (interval == COMPACT_HOUR ? 3600 : 86400);
+		if ( (i - first) > 1 && (uint64_t)interval_end + age <= (uint64_t)now ) {
+			if ( list_only ) {
+				uint32_t j;
+				printf("nfcapd.%s:", timestring);
+				for ( j=first; j < i; j++ ) 
+					printf(" %s", filelist.list[j] + dir_len + 1);
+				printf("\n");
+			} else {
+				char dir[MAXPATHLEN];
+				snprintf(dir, MAXPATHLEN, "%.*s", (int)dir_len, first_name);
+				dir[MAXPATHLEN-1] = '\0';
+				if ( !CompactFiles(dir, first_name + dir_len + 8, key_len, &filelist.list[first], i - first, 
+						compress, workers, rollup_keys, do_rescan ? NULL : dirstat) ) 
+					failed = 1;
+			}
+		}
+		first = i;
+	}
+
+	if ( !list_only ) {
+		if ( do_rescan ) {
+			printf("Scanning files in %s .. ", datadir);
+			RescanDir(datadir, dirstat);
+			printf("done.\n");
+			if ( books_stat == BOOKKEEPER_OK ) 
+				ClearBooks(books, NULL);
+		}
+		if ( books_stat == BOOKKEEPER_OK ) 
+			ReleaseBookkeeper(books, DETACH_ONLY);
+		WriteStatInfo(dirstat);
+	}
+
+	return failed ? 250 : 0;
+
+} // End of main
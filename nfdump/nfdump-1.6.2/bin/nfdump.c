@@ -52,6 +52,7 @@
 #include <fcntl.h>
 #include <sys/resource.h>
 #include <netinet/in.h>
+#include <pthread.h>
 
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
@@ -67,14 +68,18 @@
 #include "rbtree.h"
 #include "nftree.h"
 #include "nfprof.h"
+#include "readahead.h"
+#include "nfarrow.h"
 #include "nfdump.h"
 #include "nflowcache.h"
+#include "nfrollup.h"
 #include "nfstat.h"
 #include "nfexport.h"
 #include "ipconv.h"
 #include "version.h"
 #include "util.h"
 #include "flist.h"
+#include "nfmerge.h"
 #include "panonymizer.h"
 
 /* hash parameters */
@@ -95,12 +100,51 @@ static uint64_t total_bytes;
 static uint32_t total_flows;
 static uint32_t skipped_blocks;
 static time_t t_first_flow, t_last_flow;
+static arrow_writer_t *arrow_writer;
 
 int hash_hit = 0; 
 int hash_miss = 0;
 int hash_skip = 0;
 
 extension_map_list_t extension_map_list;
+
+/*
+ * Query plan of -s statistics: a file completely inside the time window is answered from its
+ * rollup, the files at the edges of the time window and files without rollup are read as usual
+ */
+typedef struct rollup_plan_s {
+	stat_record_t	stat_record;	// sum of the files answered by their rollups
+	time_t			twin_start;
+	time_t			twin_end;
+	time_t			first_flow;		// time window of the flows of these files
+	time_t			last_flow;
+	uint64_t		bytes;			// bytes read from the rollups
+	uint32_t		num_rollups;
+} rollup_plan_t;
+
+/*
+ * Worker of the parallel aggregation: reads the next files of the sequence and aggregates
+ * the flows into its private flow and stat tables. The tables are merged, when all files 
+ * are processed.
+ */
+typedef struct aggr_worker_s {
+	pthread_t				tid;
+	pthread_mutex_t			*lock;			// protects the file sequence
+	uint32_t				*file_seq;		// sequence number of the next file
+	rfile_t					*rfile;
+	hash_FlowTable			*flow_table;	// aggregation and -s record
+	hash_StatTable			*stat_table;	// -s element statistics
+	extension_map_list_t	extension_map_list;
+	FilterEngine_data_t		engine;			// CopyFilterEngine() of the global engine
+	time_t					twin_start;
+	time_t					twin_end;
+	stat_record_t			stat_record;	// matched flows
+	uint64_t				total_bytes;
+	uint32_t				total_flows;
+	uint32_t				skipped_blocks;
+	time_t					first_flow;		// time window of the processed flows
+	time_t					last_flow;
+} aggr_worker_t;
 /*
  * Output Formats:
  * User defined output formats can be compiled into nfdump, for easy access
@@ -194,6 +238,9 @@ extension_map_list_t extension_map_list;
  * 5. Recompile nfdump
  */
 
+// -o arrow writes the records to an Arrow IPC stream on stdout
+static void flow_record_to_arrow(void *record, char ** s, int anon, int tag);
+
 // Assign print functions for all output options -o
 // Teminated with a NULL record
 struct printmap_s {
@@ -209,6 +256,7 @@ struct printmap_s {
 	{ "bilong", 	format_special,      		FORMAT_bilong 	},
 	{ "pipe", 		flow_record_to_pipe,      	NULL 			},
 	{ "csv", 		flow_record_to_csv,      	NULL 			},
+	{ "arrow", 		flow_record_to_arrow,      	NULL 			},
 // add your formats here
 
 // This is always the last line
@@ -234,7 +282,16 @@ static void PrintSummary(stat_record_t *stat_record, int plain_numbers, int csv_
 
 static stat_record_t process_data(char *wfile, int element_stat, int flow_stat, int sort_flows,
 	printer_t print_header, printer_t print_record, time_t twin_start, time_t twin_end, 
-	uint64_t limitflows, int anon, int tag, int compress);
+	uint64_t limitflows, int anon, int tag, int compress, int workers);
+
+static stat_record_t process_merged(char *wfile, printer_t print_record, time_t twin_start, time_t twin_end, 
+	uint64_t limitflows, uint32_t window, int anon, int tag, int compress, int workers);
+
+static stat_record_t process_parallel(int num_threads, int element_stat, int flow_stat, time_t twin_start, time_t twin_end);
+
+static void *aggregate_worker(void *arg);
+
+static int RollupFilter(char *filename, rfile_t *rfile, void *data);
 
 /* Functions */
 
@@ -259,19 +316,28 @@ static void usage(char *name) {
 					"-N\t\tPrint plain numbers\n"
 					"-s <expr>[/<order>]\tGenerate statistics for <expr> any valid record element.\n"
 					"\t\tand ordered by <order>: packets, bytes, flows, bps pps and bpp.\n"
+					"-H <num>|<err>%%\tApproximate -s statistics in num records per stat or with max error err%% of the total.\n"
 					"-q\t\tQuiet: Do not print the header and bottom stat lines.\n"
 					"-i <ident>\tChange Ident to <ident> in file given by -r.\n"
 					"-j <file>\tCompress/Uncompress file.\n"
-					"-z\t\tCompress flows in output file. Used in combination with -w.\n"
+					"-z\t\tCompress flows in output file with LZO1X-1. Used in combination with -w.\n"
+					"-y\t\tCompress flows in output file with LZ4. Used in combination with -w.\n"
+					"-Y <level>\tCompress flows in output file with Zstandard at level 1..19. Used in combination with -w.\n"
+					"-W <num>\tCompress and write data blocks in background using num worker threads. Used with -w.\n"
+					"-P <num>\tAggregate the files with num threads. Used with -a, -A, -b, -B and -s.\n"
+					"-C\t\tWrite columnar data blocks. Used in combination with -w.\n"
 					"-l <expr>\tSet limit on packets for line and packed output format.\n"
 					"-K <key>\tAnonymize IP addressses using CryptoPAn with key <key>.\n"
 					"\t\tkey: 32 character string or 64 digit hex string starting with 0x.\n"
 					"-L <expr>\tSet limit on bytes for line and packed output format.\n"
 					"-I \t\tPrint netflow summary statistics info from file, specified by -r.\n"
+					"-k \t\tCreate block index and address filter for files specified by -r, -R or -M.\n"
+					"-G <keys>\tCreate rollups of the ',' separated -s keys or 'all' for files specified by -r, -R or -M.\n"
 					"-M <expr>\tRead input from multiple directories.\n"
 					"\t\t/dir/dir1:dir2:dir3 Read the same files from '/dir/dir1' '/dir/dir2' and '/dir/dir3'.\n"
 					"\t\trequests either -r filename or -R firstfile:lastfile without pathnames\n"
 					"-m\t\tPrint netflow data date sorted. Only useful with -M\n"
+					"-J <num>\tMerge the files of -m with a reorder window of num flows. 0 if the files are sorted by time.\n"
 					"-R <expr>\tRead input from sequence of files.\n"
 					"\t\t/any/dir  Read all files in that directory.\n"
 					"\t\t/dir/file Read all files beginning with 'file'.\n"
@@ -283,6 +349,7 @@ static void usage(char *name) {
 					"\t\t extended Even more information.\n"
 					"\t\t csv      ',' separated, machine parseable output format.\n"
 					"\t\t pipe     '|' separated legacy machine parseable output format.\n"
+					"\t\t arrow    Apache Arrow IPC stream for columnar analysis tools.\n"
 					"\t\t\tmode may be extended by '6' for full IPv6 listing. e.g.long6, extended6.\n"
 					"-v <file>\tverify netflow data file. Print version and blocks.\n"
 					"-x <file>\tverify extension records in netflow data file.\n"
@@ -358,11 +425,38 @@ char 		byte_str[32], packet_str[32], bps_str[32], pps_str[32], bpp_str[32];
 
 } // End of PrintSummary
 
+static void flow_record_to_arrow(void *record, char ** s, int anon, int tag) {
+master_record_t *r = (master_record_t *)record;
+uint64_t	anon_ip[2];
+
+	// nothing to print - the record goes into the current record batch
+	*s = NULL;
+
+	if ( anon ) {
+		if ( (r->flags & FLAG_IPV6_ADDR ) != 0 ) {
+			anonymize_v6(r->v6.srcaddr, anon_ip);
+			r->v6.srcaddr[0] = anon_ip[0];
+			r->v6.srcaddr[1] = anon_ip[1];
+
+			anonymize_v6(r->v6.dstaddr, anon_ip);
+			r->v6.dstaddr[0] = anon_ip[0];
+			r->v6.dstaddr[1] = anon_ip[1];
+		} else {
+			r->v4.srcaddr = anonymize(r->v4.srcaddr);
+			r->v4.dstaddr = anonymize(r->v4.dstaddr);
+		}
+	}
+
+	AppendArrowRecord(arrow_writer, r);
+
+} // End of flow_record_to_arrow
+
 stat_record_t process_data(char *wfile, int element_stat, int flow_stat, int sort_flows,
 	printer_t print_header, printer_t print_record, time_t twin_start, time_t twin_end, 
-	uint64_t limitflows, int anon, int tag, int compress) {
+	uint64_t limitflows, int anon, int tag, int compress, int workers) {
 data_block_header_t in_block_header;					
-common_record_t 	*flow_record, *in_buff;
+common_record_t 	*flow_record, *in_buff, *block_data;
+readahead_t			*readahead;
 master_record_t		*master_record;
 nffile_t			nffile;
 stat_record_t 		stat_record;
@@ -410,19 +504,31 @@ int	v1_map_done = 0;
 		return stat_record;
 	}
 
+	// read and decompress the next blocks, while processing the current one
+	readahead = NewReadAhead(READAHEAD_BLOCKS);
+	if ( !readahead ) {
+		free(in_buff);
+		return stat_record;
+	}
+
 	// Get the first file handle
 	rfd = GetNextFile(0, twin_start, twin_end, NULL);
-	if ( rfd < 0 ) {
+	// files skipped by the address filters are processed as files without matching flows
+	if ( rfd < 0 && ( rfd == FILE_ERROR || GetSkippedFiles() == 0 ) ) {
 		if ( rfd == FILE_ERROR )
 			fprintf(stderr, "GetNextFile() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
 		free(in_buff);
+		DisposeReadAhead(readahead);
 		return stat_record;
 	}
+	if ( rfd >= 0 ) 
+		StartReadAhead(readahead, GetRFile());
 
 	memset((void *)&nffile, 0, sizeof(nffile));
 	// prepare file is requested
-	if ( write_file && !InitExportFile(wfile, compress, &nffile) ) {
-		if ( rfd ) 
+	if ( write_file && ( !InitExportFile(wfile, compress, &nffile) || !StartBlockWriter(&nffile, workers) ) ) {
+		DisposeReadAhead(readahead);
+		if ( rfd > 0 ) 
 			close(rfd);
 		free(in_buff);
 		return stat_record;
@@ -432,12 +538,13 @@ int	v1_map_done = 0;
 	// is expanded into this record
 	// Engine->nfrecord = (uint64_t *)master_record;
 
-	done = 0;
+	done = rfd < 0;
 	while ( !done ) {
 	int i, ret;
 
-		// get next data block from file
-		ret = ReadBlock(rfd, &in_block_header, (void *)in_buff, &string);
+		// get next data block from file - uncompressed files are used in place
+		block_data = in_buff;
+		ret = ReadAheadBlock(readahead, &in_block_header, (void **)&block_data, &string);
 
 		switch (ret) {
 			case NF_CORRUPT:
@@ -448,6 +555,7 @@ int	v1_map_done = 0;
 					fprintf(stderr, "Read error in file '%s': %s\n",GetCurrentFilename(), strerror(errno) );
 				// fall through - get next file in chain
 			case NF_EOF:
+				StopReadAhead(readahead);
 				rfd = GetNextFile(rfd, twin_start, twin_end, NULL);
 				if ( rfd < 0 ) {
 					if ( rfd == NF_ERROR )
@@ -455,7 +563,8 @@ int	v1_map_done = 0;
 
 					// rfd == EMPTY_LIST
 					done = 1;
-				} // else continue with next file
+				} else 
+					StartReadAhead(readahead, GetRFile());
 				continue;
 	
 				break; // not really needed
@@ -467,7 +576,7 @@ int	v1_map_done = 0;
 
 #ifdef COMPAT15
 		if ( in_block_header.id == DATA_BLOCK_TYPE_1 ) {
-			common_record_v1_t *v1_record = (common_record_v1_t *)in_buff;
+			common_record_v1_t *v1_record = (common_record_v1_t *)block_data;
 			// create an extension map for v1 blocks
 			if ( v1_map_done == 0 ) {
 				extension_map_t *map = malloc(sizeof(extension_map_t) + 2 * sizeof(uint16_t) );
@@ -520,7 +629,7 @@ int	v1_map_done = 0;
 			continue;
 		}
 
-		flow_record = in_buff;
+		flow_record = block_data;
 		for ( i=0; i < in_block_header.NumRecords; i++ ) {
 
 			if ( flow_record->type == CommonRecordType ) {
@@ -643,6 +752,7 @@ int	v1_map_done = 0;
 
 	} // while
 
+	DisposeReadAhead(readahead);
 	if ( rfd > 0 ) 
 		close(rfd);
 
@@ -657,6 +767,10 @@ int	v1_map_done = 0;
 			}
 		}
 
+		// all queued blocks must be on disk, before the file is closed
+		if ( !StopBlockWriter(&nffile) ) 
+			fprintf(stderr, "Failed to write output buffer to disk: '%s'" , strerror(errno));
+
 		/* Stat info */
 		if ( write_file ) {
 			/* Write stat info and close file */
@@ -673,10 +787,488 @@ int	v1_map_done = 0;
 
 } // End of process_data
 
+/*
+ * Print or write the flows of all files sorted by their start time. The files are merged as 
+ * streams, so memory is bounded by the open files and the reorder window ( see nfmerge.h ),
+ * and does not grow with the number of flows.
+ */
+static stat_record_t process_merged(char *wfile, printer_t print_record, time_t twin_start, time_t twin_end, 
+	uint64_t limitflows, uint32_t window, int anon, int tag, int compress, int workers) {
+merge_reader_t		*reader;
+extension_info_t	*extension_info;
+extension_map_t		**written_maps;
+common_record_t		*flow_record;
+master_record_t		master_record;
+nffile_t			nffile;
+stat_record_t 		stat_record;
+uint32_t			i, record_buff[65536 / sizeof(uint32_t)];
+char 				*string, *ident;
+
+	// time window of all matched flows
+	memset((void *)&stat_record, 0, sizeof(stat_record_t));
+	stat_record.first_seen = 0x7fffffff;
+	stat_record.msec_first = 999;
+
+	// time window of all processed flows
+	t_first_flow = 0x7fffffff;
+	t_last_flow  = 0;
+
+	reader = OpenMergeSequence(GetFileSequence(), twin_start, twin_end);
+	if ( !reader ) 
+		return stat_record;
+	if ( !SetMergeWindow(reader, window) ) {
+		CloseMergeReader(reader);
+		return stat_record;
+	}
+
+	// map id of the output file -> map last written with this id
+	written_maps = NULL;
+	memset((void *)&nffile, 0, sizeof(nffile));
+	if ( wfile ) {
+		written_maps = calloc(MAX_EXTENSION_MAPS, sizeof(extension_map_t *));
+		if ( !written_maps ) {
+			fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			CloseMergeReader(reader);
+			return stat_record;
+		}
+		if ( !InitExportFile(wfile, compress, &nffile) || !StartBlockWriter(&nffile, workers) ) {
+			free(written_maps);
+			CloseMergeReader(reader);
+			return stat_record;
+		}
+	}
+
+	Engine->nfrecord = (uint64_t *)&master_record;
+	while ( (flow_record = NextMergeRecord(reader, &extension_info, NULL)) != NULL ) {
+		int match;
+
+		total_flows++;
+		total_bytes += flow_record->size;
+		ExpandRecord_v2( flow_record, extension_info, &master_record);
+
+		// Time based filter
+		// if no time filter is given, the result is always true
+		match  = twin_start && (master_record.first < twin_start || master_record.last > twin_end) ? 0 : 1;
+
+		// filter netflow record with user supplied filter
+		if ( match ) 
+			match = (*Engine->FilterEngine)(Engine);
+
+		if ( match == 0 ) 
+			continue;
+
+		// Update statistics
+		UpdateStat(&stat_record, &master_record);
+
+		// Update global time span window
+		if ( master_record.first < t_first_flow )
+			t_first_flow = master_record.first;
+		if ( master_record.last > t_last_flow ) 
+			t_last_flow = master_record.last;
+
+		if ( nffile.wfd != 0 ) {
+			extension_map_t *map = extension_info->map;
+			common_record_t *out_record = flow_record;
+
+			// the files may use the same map id for different maps - a record refers to the last map with its id
+			if ( written_maps[map->map_id] != map ) {
+				extension_map_t *last = written_maps[map->map_id];
+				if ( !last || last->size != map->size || 
+					 memcmp((void *)last->ex_id, (void *)map->ex_id, map->size - sizeof(extension_map_t)) != 0 ) 
+					AppendToBuffer(&nffile, (void *)map, map->size);
+				written_maps[map->map_id] = map;
+			}
+
+			if ( anon ) {
+				pointer_addr_t size = COMMON_RECORD_DATA_SIZE;
+				memcpy((void *)record_buff, (void *)flow_record, flow_record->size);
+				out_record = (common_record_t *)record_buff;
+				if ( (out_record->flags & FLAG_IPV6_ADDR ) == 0 ) {
+					uint32_t	*ip = (uint32_t *)((pointer_addr_t)out_record + size);
+					ip[0] = anonymize(ip[0]);
+					ip[1] = anonymize(ip[1]);
+				} else {
+					ipv6_block_t *ip = (ipv6_block_t *)((pointer_addr_t)out_record + size);
+					uint64_t	anon_ip[2];
+					anonymize_v6(ip->srcaddr, anon_ip);
+					ip->srcaddr[0] = anon_ip[0];
+					ip->srcaddr[1] = anon_ip[1];
+
+					anonymize_v6(ip->dstaddr, anon_ip);
+					ip->dstaddr[0] = anon_ip[0];
+					ip->dstaddr[1] = anon_ip[1];
+				}
+			}
+			AppendToBuffer(&nffile, (void *)out_record, out_record->size);
+		} else if ( print_record ) {
+			print_record(&master_record, &string, anon, tag);
+			if ( string ) 
+				printf("%s\n", string);
+		}
+
+		// check if we are done, due to -c option 
+		if ( limitflows && stat_record.numflows >= limitflows ) 
+			break;
+	}
+
+	if ( MergeLateRecords(reader) ) 
+		fprintf(stderr, "%llu flows out of time order. Increase the reorder window with -J\n", 
+			(unsigned long long)MergeLateRecords(reader));
+
+	// flush output file
+	if ( nffile.wfd ) {
+		// flush current buffer to disc
+		if ( nffile.block_header->NumRecords ) {
+			if ( WriteBlock(&nffile) <= 0 ) {
+				fprintf(stderr, "Failed to write output buffer to disk: '%s'" , strerror(errno));
+			} else {
+				nffile.file_blocks++;
+			}
+		}
+
+		// all queued blocks must be on disk, before the file is closed
+		if ( !StopBlockWriter(&nffile) ) 
+			fprintf(stderr, "Failed to write output buffer to disk: '%s'" , strerror(errno));
+
+		if ( strcmp(wfile, "-") != 0 ) {
+			// ident of the first file, which has one
+			ident = GetIdent();
+			for ( i=0; i < MergeNumFiles(reader); i++ ) {
+				if ( MergeIdent(reader, i)[0] ) {
+					ident = MergeIdent(reader, i);
+					break;
+				}
+			}
+			CloseUpdateFile(nffile.wfd, &stat_record, nffile.file_blocks, ident, nffile.compress, &string );
+			if ( string != NULL )
+				fprintf(stderr, "%s\n", string);
+		} 
+		free(nffile.block_header);
+	}	 
+
+	if ( written_maps ) 
+		free(written_maps);
+	CloseMergeReader(reader);
+
+	return stat_record;
+
+} // End of process_merged
+
+/*
+ * Aggregate the flows of all files with num_threads worker threads. Each worker reads whole files 
+ * into its private flow and stat tables. The tables are merged into the global tables at the end.
+ */
+static stat_record_t process_parallel(int num_threads, int element_stat, int flow_stat, time_t twin_start, time_t twin_end) {
+aggr_worker_t		*workers, *worker;
+hash_FlowTable		**tables;
+pthread_mutex_t		lock;
+stat_record_t 		stat_record;
+uint32_t			file_seq;
+int					i, started;
+
+	// time window of all matched flows
+	memset((void *)&stat_record, 0, sizeof(stat_record_t));
+	stat_record.first_seen = 0x7fffffff;
+	stat_record.msec_first = 999;
+
+	// time window of all processed flows
+	t_first_flow = 0x7fffffff;
+	t_last_flow  = 0;
+
+	workers = (aggr_worker_t *)calloc(num_threads, sizeof(aggr_worker_t));
+	if ( !workers ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return stat_record;
+	}
+	pthread_mutex_init(&lock, NULL);
+	file_seq = 0;
+
+	started = 0;
+	for ( i=0; i < num_threads; i++ ) {
+		worker = &workers[i];
+		worker->rfile	   = NewRFile();
+		worker->flow_table = flow_stat ? New_FlowTable() : NULL;
+		worker->stat_table = element_stat ? New_StatTable() : NULL;
+		if ( !worker->rfile || (flow_stat && !worker->flow_table) || (element_stat && !worker->stat_table) ) 
+			break;
+
+		worker->lock	   = &lock;
+		worker->file_seq   = &file_seq;
+		worker->twin_start = twin_start;
+		worker->twin_end   = twin_end;
+		InitExtensionMaps(&worker->extension_map_list);
+
+		// each worker evaluates its own copy of the engine - the filter tree is shared read only
+		CopyFilterEngine(&worker->engine, Engine);
+		worker->engine.ident = worker->rfile->file_header.ident;
+
+		worker->stat_record.first_seen = 0x7fffffff;
+		worker->stat_record.msec_first = 999;
+		worker->first_flow = 0x7fffffff;
+		worker->last_flow  = 0;
+
+		if ( pthread_create(&worker->tid, NULL, aggregate_worker, (void *)worker) != 0 ) {
+			fprintf(stderr, "pthread_create() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			break;
+		}
+		started++;
+	}
+
+	for ( i=0; i < started; i++ ) 
+		pthread_join(workers[i].tid, NULL);
+
+	// merge the results of the workers - the flow records refer to the maps of the worker 
+	// until they are merged, so the maps are freed afterwards
+	if ( flow_stat && started ) {
+		tables = (hash_FlowTable **)calloc(started, sizeof(hash_FlowTable *));
+		if ( !tables ) {
+			fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			exit(250);
+		}
+		for ( i=0; i < started; i++ ) 
+			tables[i] = workers[i].flow_table;
+		Merge_FlowTables(tables, started, &extension_map_list);
+		free((void *)tables);
+	}
+	for ( i=0; i < num_threads; i++ ) {
+		worker = &workers[i];
+		if ( i < started ) {
+			if ( worker->stat_table ) 
+				Merge_StatTable(worker->stat_table);
+			SumStatRecords(&stat_record, &worker->stat_record);
+			total_bytes	   += worker->total_bytes;
+			total_flows	   += worker->total_flows;
+			skipped_blocks += worker->skipped_blocks;
+			if ( worker->first_flow < t_first_flow )
+				t_first_flow = worker->first_flow;
+			if ( worker->last_flow > t_last_flow ) 
+				t_last_flow = worker->last_flow;
+			FreeExtensionMaps(&worker->extension_map_list);
+		}
+		Dispose_FlowTable_r(worker->flow_table);
+		Dispose_StatTable_r(worker->stat_table);
+		DisposeRFile(worker->rfile);
+	}
+
+	pthread_mutex_destroy(&lock);
+	free((void *)workers);
+
+	PackExtensionMapList(&extension_map_list);
+
+	return stat_record;
+
+} // End of process_parallel
+
+static void *aggregate_worker(void *arg) {
+aggr_worker_t		*worker = (aggr_worker_t *)arg;
+data_block_header_t	block_header;
+common_record_t		*flow_record, *in_buff, *block_data;
+master_record_t		*master_record;
+char				*filename, *string;
+int					i, rfd, ret, done;
+
+#ifdef COMPAT15
+int	v1_map_done = 0;
+#endif
+
+	in_buff = (common_record_t *)malloc(BUFFSIZE);
+	if ( !in_buff ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	while ( 1 ) {
+		// get the next file of the sequence
+		pthread_mutex_lock(worker->lock);
+		rfd		 = GetNextFile_r(GetFileSequence(), worker->rfile, worker->twin_start, worker->twin_end, NULL);
+		filename = GetCurrentFilename_r(GetFileSequence());
+		// the flows of the files are merged in the order of the sequence
+		if ( worker->flow_table ) 
+			worker->flow_table->file = (*worker->file_seq)++;
+		pthread_mutex_unlock(worker->lock);
+
+		// EMPTY_LIST
+		if ( rfd < 0 ) 
+			break;
+
+		done = 0;
+		while ( !done ) {
+
+			// get next data block from file - uncompressed files are used in place
+			block_data = in_buff;
+			ret = ReadBlockPtr_r(worker->rfile, &block_header, (void **)&block_data, &string);
+
+			switch (ret) {
+				case NF_CORRUPT:
+				case NF_ERROR:
+					if ( ret == NF_CORRUPT ) 
+						fprintf(stderr, "Skip corrupt data file '%s': '%s'\n", filename, string);
+					else 
+						fprintf(stderr, "Read error in file '%s': %s\n", filename, strerror(errno) );
+					// fall through - get next file in chain
+				case NF_EOF:
+					done = 1;
+					continue;
+				default:
+					// successfully read block
+					worker->total_bytes += ret;
+			}
+
+#ifdef COMPAT15
+			if ( block_header.id == DATA_BLOCK_TYPE_1 ) {
+				common_record_v1_t *v1_record = (common_record_v1_t *)block_data;
+				// create an extension map for v1 blocks
+				if ( v1_map_done == 0 ) {
+					extension_map_t *map = malloc(sizeof(extension_map_t) + 2 * sizeof(uint16_t) );
+					if ( ! map ) {
+						perror("Memory allocation error");
+						exit(255);
+					}
+					map->type 	= ExtensionMapType;
+					map->size 	= sizeof(extension_map_t) + 2 * sizeof(uint16_t);
+					if (( map->size & 0x3 ) != 0 ) {
+						map->size += 4 - ( map->size & 0x3 );
+					}
+
+					map->map_id = INIT_ID;
+
+					map->ex_id[0]  = EX_IO_SNMP_2;
+					map->ex_id[1]  = EX_AS_2;
+					map->ex_id[2]  = 0;
+				
+					map->extension_size  = 0;
+					map->extension_size += extension_descriptor[EX_IO_SNMP_2].size;
+					map->extension_size += extension_descriptor[EX_AS_2].size;
+
+					Insert_Extension_Map(&worker->extension_map_list, map);
+					v1_map_done = 1;
+				}
+
+				// convert the records to v2
+				for ( i=0; i < block_header.NumRecords; i++ ) {
+					common_record_t *v2_record = (common_record_t *)v1_record;
+					Convert_v1_to_v2((void *)v1_record);
+					// now we have a v2 record -> use size of v2_record->size
+					v1_record = (common_record_v1_t *)((pointer_addr_t)v1_record + v2_record->size);
+				}
+				block_header.id = DATA_BLOCK_TYPE_2;
+			}
+#endif
+
+			if ( block_header.id != DATA_BLOCK_TYPE_2 ) {
+				if ( block_header.id == DATA_BLOCK_TYPE_1 ) {
+					fprintf(stderr, "Can't process nfdump 1.5.x block type 1. Add --enable-compat15 to compile compatibility code. Skip block.\n");
+				} else {
+					fprintf(stderr, "Can't process block type %u. Skip block.\n", block_header.id);
+				}
+				worker->skipped_blocks++;
+				continue;
+			}
+
+			flow_record = block_data;
+			for ( i=0; i < block_header.NumRecords; i++ ) {
+
+				if ( flow_record->type == CommonRecordType ) {
+					int match;
+					uint32_t map_id = flow_record->ext_map;
+					if ( map_id >= MAX_EXTENSION_MAPS ) {
+						fprintf(stderr, "Corrupt data file. Extension map id %u too big.\n", flow_record->ext_map);
+						exit(255);
+					}
+					if ( worker->extension_map_list.slot[map_id] == NULL ) {
+						fprintf(stderr, "Corrupt data file. Missing extension map %u. Skip record.\n", flow_record->ext_map);
+						flow_record = (common_record_t *)((pointer_addr_t)flow_record + flow_record->size);	
+						continue;
+					} 
+
+					worker->total_flows++;
+					master_record = &(worker->extension_map_list.slot[map_id]->master_record);
+					worker->engine.nfrecord = (uint64_t *)master_record;
+					ExpandRecord_v2( flow_record, worker->extension_map_list.slot[map_id], master_record);
+
+					// Time based filter
+					// if no time filter is given, the result is always true
+					match = worker->twin_start && 
+						(master_record->first < worker->twin_start || master_record->last > worker->twin_end) ? 0 : 1;
+
+					// filter netflow record with user supplied filter
+					if ( match ) 
+						match = (*worker->engine.FilterEngine)(&worker->engine);
+
+					if ( match ) {
+						UpdateStat(&worker->stat_record, master_record);
+
+						if ( master_record->first < worker->first_flow )
+							worker->first_flow = master_record->first;
+						if ( master_record->last > worker->last_flow ) 
+							worker->last_flow = master_record->last;
+
+						if ( worker->flow_table ) 
+							AddFlow_r(worker->flow_table, flow_record, master_record);
+						if ( worker->stat_table ) 
+							AddStat_r(worker->stat_table, flow_record, master_record);
+					}
+
+				} else if ( flow_record->type == ExtensionMapType ) {
+					Insert_Extension_Map(&worker->extension_map_list, (extension_map_t *)flow_record);
+				} else {
+					fprintf(stderr, "Skip unknown record type %i\n", flow_record->type);
+				}
+
+				// Advance pointer by number of bytes for netflow record
+				flow_record = (common_record_t *)((pointer_addr_t)flow_record + flow_record->size);	
+
+			} // for all records
+		} // while blocks of file
+	} // while files
+
+	free((void *)in_buff);
+	return NULL;
+
+} // End of aggregate_worker
+
+/*
+ * File filter of the -s query plan. Merges the statistics of the file from its rollup and returns 0,
+ * so the file is not read, if the rollup holds the requested statistics and all flows of the file
+ * are inside the time window. Otherwise 1 is returned and the flows of the file are processed.
+ */
+static int RollupFilter(char *filename, rfile_t *rfile, void *data) {
+rollup_plan_t	*plan = (rollup_plan_t *)data;
+stat_record_t	*stat_record;
+rollup_t		*rollup;
+
+	rollup = OpenRollup(filename);
+	if ( !rollup ) 
+		return 1;
+
+	stat_record = rollup->stat_record;
+	if ( !RollupHasStats(rollup) || ( plan->twin_start && stat_record->numflows && 
+		 ( stat_record->first_seen < plan->twin_start || stat_record->last_seen > plan->twin_end ) ) ) {
+		CloseRollup(rollup);
+		return 1;
+	}
+
+	AddRollupStat(rollup);
+	SumStatRecords(&plan->stat_record, stat_record);
+	if ( stat_record->numflows ) {
+		if ( stat_record->first_seen < plan->first_flow )
+			plan->first_flow = stat_record->first_seen;
+		if ( stat_record->last_seen > plan->last_flow ) 
+			plan->last_flow = stat_record->last_seen;
+	}
+	plan->bytes += rollup->map_size;
+	plan->num_rollups++;
+	CloseRollup(rollup);
+
+	return 0;
+
+} // End of RollupFilter
+
 
 int main( int argc, char **argv ) {
 struct stat stat_buff;
 stat_record_t	sum_stat, *sr;
+rollup_plan_t	rollup_plan;
 printer_t 	print_header, print_record;
 nfprof_t 	profile_data;
 char 		*rfile, *Rfile, *Mdirs, *wfile, *ffile, *filter, *tstring, *stat_type;
@@ -684,11 +1276,13 @@ char		*byte_limit_string, *packet_limit_string, *print_mode, *record_header;
 char		*order_by, *query_file, *UnCompress_file, *nameserver, *aggr_fmt;
 int 		c, ffd, ret, element_stat, fdump;
 int 		i, user_format, quiet, flow_stat, topN, aggregate, aggregate_mask, bidir;
-int 		print_stat, syntax_only, date_sorted, do_anonymize, do_tag, compress;
+int 		print_stat, build_index, use_rollups, syntax_only, date_sorted, merge_flows, do_anonymize, do_tag, compress, workers, columnar;
+int			num_threads, parallel;
 int			plain_numbers, GuessDir, pipe_output, csv_output;
 time_t 		t_start, t_end;
 uint16_t	Aggregate_Bits;
-uint32_t	limitflows;
+uint32_t	limitflows, merge_window, rollup_keys;
+int			reorder;
 uint64_t	AggregateMasks[AGGR_SIZE];
 char 		Ident[IdentLen];
 char		CryptoPAnKey[32];
@@ -703,9 +1297,13 @@ char		CryptoPAnKey[32];
 	topN	        = 10;
 	flow_stat       = 0;
 	print_stat      = 0;
+	build_index     = 0;
+	rollup_keys		= 0;
 	element_stat  	= 0;
 	limitflows		= 0;
 	date_sorted		= 0;
+	merge_window	= 0;
+	reorder			= 0;
 	total_bytes		= 0;
 	total_flows		= 0;
 	skipped_blocks	= 0;
@@ -714,6 +1312,9 @@ char		CryptoPAnKey[32];
 	quiet			= 0;
 	user_format		= 0;
 	compress		= 0;
+	workers			= 0;
+	num_threads		= 0;
+	columnar		= 0;
 	plain_numbers   = 0;
 	pipe_output		= 0;
 	csv_output		= 0;
@@ -735,7 +1336,7 @@ char		CryptoPAnKey[32];
 
 	for ( i=0; i<AGGR_SIZE; AggregateMasks[i++] = 0 ) ;
 
-	while ((c = getopt(argc, argv, "6aA:Bbc:D:s:hn:i:j:f:qzr:v:w:K:M:NImO:R:XZt:TVv:x:l:L:o:")) != EOF) {
+	while ((c = getopt(argc, argv, "6aA:BbCc:D:s:hH:n:i:j:J:f:G:qzyY:W:P:r:v:w:K:M:NIkmO:R:XZt:TVv:x:l:L:o:")) != EOF) {
 		switch (c) {
 			case 'h':
 				usage(argv[0]);
@@ -776,7 +1377,41 @@ char		CryptoPAnKey[32];
 				quiet = 1;
 				break;
 			case 'z':
-				compress = 1;
+				compress = LZO_COMPRESSED;
+				break;
+			case 'y':
+				compress = LZ4_COMPRESSED;
+				break;
+			case 'Y': {
+				int level = atoi(optarg);
+				if ( level <= 0 || level > ZSTD_MAX_LEVEL ) {
+					fprintf(stderr, "Option -Y needs a level 1..%d\n", ZSTD_MAX_LEVEL);
+					exit(255);
+				}
+				compress = ZSTD_COMPRESSION(level);
+				} break;
+			case 'C':
+				columnar = 1;
+				break;
+			case 'W':
+				workers = atoi(optarg);
+				if ( workers <= 0 || workers > MAXWORKERS ) {
+					fprintf(stderr, "Option -W needs a number of workers 1..%d\n", MAXWORKERS);
+					exit(255);
+				}
+				break;
+			case 'H':
+				if ( !SetStat_Approximate(optarg) ) {
+					fprintf(stderr, "Option -H needs a number of records or an error 0..100%% e.g. 0.1%%\n");
+					exit(255);
+				}
+				break;
+			case 'P':
+				num_threads = atoi(optarg);
+				if ( num_threads <= 0 || num_threads > MAXWORKERS ) {
+					fprintf(stderr, "Option -P needs a number of threads 1..%d\n", MAXWORKERS);
+					exit(255);
+				}
 				break;
 			case 'c':	
 				limitflows = atoi(optarg);
@@ -825,12 +1460,29 @@ char		CryptoPAnKey[32];
 			case 'm':
 				date_sorted = 1;
 				break;
+			case 'J': {
+				char *end;
+				unsigned long window = strtoul(optarg, &end, 10);
+				if ( end == optarg || *end != '\0' || window > MAX_MERGE_WINDOW ) {
+					fprintf(stderr, "Option -J needs a number of flows 0..%d\n", MAX_MERGE_WINDOW);
+					exit(255);
+				}
+				merge_window = window;
+				reorder		 = 1;
+				} break;
 			case 'M':
 				Mdirs = optarg;
 				break;
 			case 'I':
 				print_stat++;
 				break;
+			case 'k':
+				build_index = 1;
+				break;
+			case 'G':
+				if ( !ParseRollupKeys(optarg, &rollup_keys) ) 
+					exit(255);
+				break;
 			case 'o':	// output mode
 				print_mode = optarg;
 				break;
@@ -888,6 +1540,10 @@ char		CryptoPAnKey[32];
 				exit(0);
 		}
 	}
+
+	if ( columnar )
+		compress |= COLUMNAR_BLOCKS;
+
 	if (argc - optind > 1) {
 		usage(argv[0]);
 		exit(255);
@@ -949,6 +1605,29 @@ char		CryptoPAnKey[32];
 		exit(0);
 	}
 
+	if ( build_index || rollup_keys ) {
+		int failed = 0;
+		if ( !rfile && !Rfile && !Mdirs) {
+			fprintf(stderr, "Expect data file(s).\n");
+			exit(255);
+		}
+
+		ffd = GetNextFile(0, 0, 0, NULL);
+		if ( ffd <= 0 ) {
+			if ( ffd == FILE_ERROR )
+				fprintf(stderr, "Error open file: %s\n", strerror(errno));
+			exit(250);
+		}
+		while ( ffd > 0 ) {
+			if ( build_index && !IndexFile(GetCurrentFilename()) ) 
+				failed = 1;
+			if ( rollup_keys && !RollupFile(GetCurrentFilename(), rollup_keys) ) 
+				failed = 1;
+			ffd = GetNextFile(ffd, 0, 0, NULL);
+		}
+		exit(failed ? 255 : 0);
+	}
+
 	// handle print mode
 	if ( !print_mode ) {
 		// automatically select an appropriate output format for custom aggregation
@@ -1038,6 +1717,18 @@ char		CryptoPAnKey[32];
 		fprintf(stderr, "Command line switch -s overwrites -a\n");
 	}
 
+	if ( print_record == flow_record_to_arrow && !wfile ) {
+		if ( flow_stat || element_stat ) {
+			fprintf(stderr, "Output mode arrow is not available for statistics\n");
+			exit(255);
+		}
+		// no summary - stdout is a binary stream
+		quiet = 1;
+		arrow_writer = OpenArrowStream(stdout, ARROW_BATCH_SIZE);
+		if ( !arrow_writer ) 
+			exit(255);
+	}
+
 	if ( !filter && ffile ) {
 		if ( stat(ffile, &stat_buff) ) {
 			fprintf(stderr, "Can't stat filter file '%s': %s\n", ffile, strerror(errno));
@@ -1093,7 +1784,15 @@ char		CryptoPAnKey[32];
 		exit(255);
 	}
 
-	if ((aggregate || flow_stat || date_sorted)  && !Init_FlowTable() )
+	// flows of files are merged by time without keeping them in memory, if the files are sorted 
+	// by time or -J sets a reorder window. Otherwise the flows are sorted exactly in memory
+	merge_flows = date_sorted && !aggregate && !element_stat && ( rfile || Rfile ) && 
+		( reorder || SortedFileSequence(GetFileSequence(), 0, 0) );
+
+	// files are aggregated by parallel threads into private flow tables
+	parallel = num_threads > 1 && (aggregate || flow_stat || element_stat) && ( rfile || Rfile );
+
+	if ((aggregate || flow_stat || (date_sorted && !merge_flows))  && !Init_FlowTable() )
 			exit(250);
 
 	if (element_stat && !Init_StatTable(HashBits, NumPrealloc) )
@@ -1122,24 +1821,62 @@ char		CryptoPAnKey[32];
 	if (do_anonymize)
 		PAnonymizer_Init((uint8_t *)CryptoPAnKey);
 
+	// -s statistics of all flows are merged from the rollups of the files, where possible
+	use_rollups = element_stat && !flow_stat && !aggregate && !date_sorted && strcmp(filter, "any") == 0;
+	if ( use_rollups ) {
+		memset((void *)&rollup_plan, 0, sizeof(rollup_plan_t));
+		rollup_plan.stat_record.first_seen = 0x7fffffff;
+		rollup_plan.stat_record.msec_first = 999;
+		rollup_plan.twin_start = t_start;
+		rollup_plan.twin_end   = t_end;
+		rollup_plan.first_flow = 0x7fffffff;
+		SetFileFilter(RollupFilter, &rollup_plan);
+	} else {
+		// skip the files, which cannot match the filter according to their address filter
+		SetFileFilter(FileMayMatch, Engine);
+	}
+
 	nfprof_start(&profile_data);
-	sum_stat = process_data(wfile, element_stat, aggregate || flow_stat, date_sorted,
+	if ( merge_flows ) 
+		sum_stat = process_merged(wfile, print_record, t_start, t_end, limitflows, merge_window,
+						do_anonymize, do_tag, compress, workers);
+	else if ( parallel ) 
+		sum_stat = process_parallel(num_threads, element_stat, aggregate || flow_stat, t_start, t_end);
+	else
+		sum_stat = process_data(wfile, element_stat, aggregate || flow_stat, date_sorted,
 						print_header, print_record, t_start, t_end, 
-						limitflows, do_anonymize, do_tag, compress);
+						limitflows, do_anonymize, do_tag, compress, workers);
+
+	// add the files answered by their rollups
+	if ( use_rollups && rollup_plan.num_rollups ) {
+		SumStatRecords(&sum_stat, &rollup_plan.stat_record);
+		if ( rollup_plan.first_flow < t_first_flow )
+			t_first_flow = rollup_plan.first_flow;
+		if ( rollup_plan.last_flow > t_last_flow ) 
+			t_last_flow = rollup_plan.last_flow;
+		total_flows += rollup_plan.stat_record.numflows;
+	}
 	nfprof_end(&profile_data, total_flows);
 
-	if ( total_bytes == 0 )
+	if ( total_bytes == 0 && GetSkippedFiles() == 0 ) {
+		if ( arrow_writer ) 
+			CloseArrowStream(arrow_writer);
 		exit(0);
+	}
 
 
-	if (aggregate || date_sorted) {
+	if (aggregate || (date_sorted && !merge_flows)) {
 		if ( wfile ) {
-			ExportFlowTable(wfile, compress, aggregate, bidir, date_sorted, do_anonymize);
+			ExportFlowTable(wfile, compress, workers, aggregate, bidir, date_sorted, do_anonymize);
 		} else {
 			PrintFlowTable(print_record, limitflows, date_sorted, do_anonymize, do_tag, GuessDir);
 		}
 	}
 
+	// flush the last record batch
+	if ( arrow_writer && !CloseArrowStream(arrow_writer) ) 
+		exit(255);
+
 	if (flow_stat) {
 		PrintFlowStat(record_header, print_record, topN, do_anonymize, do_tag, quiet, csv_output);
 #ifdef DEVEL
@@ -1159,8 +1896,12 @@ char		CryptoPAnKey[32];
 				printf("IP addresses anonymized\n");
 			PrintSummary(&sum_stat, plain_numbers, csv_output);
  			printf("Time window: %s\n", TimeString(t_first_flow, t_last_flow));
-			printf("Total flows processed: %u, Blocks skipped: %u, Bytes read: %llu\n", 
+			printf("Total flows processed: %u, Blocks skipped: %u, Bytes read: %llu", 
 				total_flows, skipped_blocks, (unsigned long long)total_bytes);
+			// bytes of the rollups are no flow file bytes - report them separately
+			if ( use_rollups && rollup_plan.num_rollups ) 
+				printf(", Rollup bytes read: %llu", (unsigned long long)rollup_plan.bytes);
+			printf("\n");
 			nfprof_print(&profile_data, stdout);
 		}
 	}
@@ -58,6 +58,7 @@
 #include "nf_common.h"
 #include "nffile.h"
 #include "nfx.h"
+#include "nfrollup.h"
 #include "nfstat.h"
 #include "nflowcache.h"
 
@@ -232,7 +233,7 @@ int map_id, opt_extensions, num_extensions, new_map_size, opt_align;
 
 } // End of CreateExportExtensionMaps
 
-void ExportFlowTable(char *filename, int compress, int aggregate, int bidir, int date_sorted, int anon) {
+void ExportFlowTable(char *filename, int compress, int workers, int aggregate, int bidir, int date_sorted, int anon) {
 hash_FlowTable *FlowTable;
 FlowTableRecord_t	*r;
 SortElement_t 		*SortList;
@@ -248,7 +249,7 @@ char				*string;
 	stat_record.msec_first = 999;
 
 	// Init nfile handle - open file 
-	if ( !InitExportFile(filename, compress, &nffile) ) 
+	if ( !InitExportFile(filename, compress, &nffile) || !StartBlockWriter(&nffile, workers) ) 
 		return;
 
 	CreateExportExtensionMaps(aggregate, bidir, &nffile);
@@ -266,18 +267,12 @@ char				*string;
 		}
 
 		// preset SortList table - still unsorted
-		for ( i=0; i<FlowTable->IndexMask; i++ ) {
-			r = FlowTable->bucket[i];
-			if ( !r ) 
-				continue;
-
-			// foreach elem in this bucket
-			while ( r ) {
-				SortList[c].count  = 1000LL * r->flowrecord.first + r->flowrecord.msec_first;	// sort according the date
-				SortList[c].record = (void *)r;
-				c++;
-				r = r->next;
-			}
+		r = FlowTable->first;
+		while ( r ) {
+			SortList[c].count  = 1000LL * r->flowrecord.first + r->flowrecord.msec_first;	// sort according the date
+			SortList[c].record = (void *)r;
+			c++;
+			r = r->next;
 		}
 
 		if ( c != maxindex ) {
@@ -329,45 +324,43 @@ char				*string;
 
 	} else {
 		// print them as they came
-		for ( i=0; i<FlowTable->IndexMask; i++ ) {
-			r = FlowTable->bucket[i];
-			while ( r ) {
-				master_record_t	flow_record;
-				common_record_t *raw_record;
-				int map_id;
-
-				raw_record = &(r->flowrecord);
-				map_id = r->map_ref->map_id;
-
-				ExpandRecord_v2( raw_record, extension_map_list.slot[map_id], &flow_record);
-				flow_record.dPkts 		= r->counter[INPACKETS];
-				flow_record.dOctets 	= r->counter[INBYTES];
-				flow_record.out_pkts 	= r->counter[OUTPACKETS];
-				flow_record.out_bytes 	= r->counter[OUTBYTES];
-				flow_record.aggr_flows 	= r->counter[FLOWS];
-
-				// apply IP mask from aggregation, to provide a pretty output
-				if ( FlowTable->has_masks ) {
-					flow_record.v6.srcaddr[0] &= FlowTable->IPmask[0];
-					flow_record.v6.srcaddr[1] &= FlowTable->IPmask[1];
-					flow_record.v6.dstaddr[0] &= FlowTable->IPmask[2];
-					flow_record.v6.dstaddr[1] &= FlowTable->IPmask[3];
-				}
-
-
-				// switch to output extension map
-				flow_record.map_ref = export_maps[map_id];
-				flow_record.ext_map = map_id;
-				PackRecord(&flow_record, &nffile);
+		r = FlowTable->first;
+		while ( r ) {
+			master_record_t	flow_record;
+			common_record_t *raw_record;
+			int map_id;
+
+			raw_record = &(r->flowrecord);
+			map_id = r->map_ref->map_id;
+
+			ExpandRecord_v2( raw_record, extension_map_list.slot[map_id], &flow_record);
+			flow_record.dPkts 		= r->counter[INPACKETS];
+			flow_record.dOctets 	= r->counter[INBYTES];
+			flow_record.out_pkts 	= r->counter[OUTPACKETS];
+			flow_record.out_bytes 	= r->counter[OUTBYTES];
+			flow_record.aggr_flows 	= r->counter[FLOWS];
+
+			// apply IP mask from aggregation, to provide a pretty output
+			if ( FlowTable->has_masks ) {
+				flow_record.v6.srcaddr[0] &= FlowTable->IPmask[0];
+				flow_record.v6.srcaddr[1] &= FlowTable->IPmask[1];
+				flow_record.v6.dstaddr[0] &= FlowTable->IPmask[2];
+				flow_record.v6.dstaddr[1] &= FlowTable->IPmask[3];
+			}
+
+
+			// switch to output extension map
+			flow_record.map_ref = export_maps[map_id];
+			flow_record.ext_map = map_id;
+			PackRecord(&flow_record, &nffile);
 #ifdef DEVEL
-				format_file_block_record((void *)&flow_record, &string, anon, 0);
-				printf("%s\n", string);
+			format_file_block_record((void *)&flow_record, &string, anon, 0);
+			printf("%s\n", string);
 #endif
-				// Update statistics
-				UpdateStat(&stat_record, &flow_record);
+			// Update statistics
+			UpdateStat(&stat_record, &flow_record);
 
-				r = r->next;
-			}
+			r = r->next;
 		}
 
 	}
@@ -378,6 +371,10 @@ char				*string;
         } 
     }
 
+	// all queued blocks must be on disk, before the file is closed
+	if ( !StopBlockWriter(&nffile) ) 
+		fprintf(stderr, "Failed to write output buffer to disk: '%s'" , strerror(errno));
+
 	CloseUpdateFile(nffile.wfd, &stat_record, nffile.file_blocks, GetIdent(), nffile.compress, &string );
 	if ( string != NULL )
 		fprintf(stderr, "%s\n", string);
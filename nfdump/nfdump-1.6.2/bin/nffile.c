@@ -44,15 +44,25 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/param.h>
+#include <sys/mman.h>
 #include <stdio.h>
 #include <errno.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
 #endif
 
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
 #include "minilzo.h"
 #include "nf_common.h"
 #include "nffile.h"
@@ -63,12 +73,14 @@
 char 	*CurrentIdent;
 
 /* local vars */
-static file_header_t	FileHeader;
-static stat_record_t	NetflowStat;
 
-#define file_compressed (FileHeader.flags & FLAG_COMPRESSED)
+// file handle used by the non reentrant functions OpenFile() and ReadBlock()
+static rfile_t	default_rfile;
+
+#define file_compressed(rfile) ((rfile)->file_header.flags & FLAG_COMPRESSION)
 
 // LZO params
+// LZO has the worst case expansion of all codecs, so LZO_BUFFSIZE holds any compressed block
 #define LZO_BUFFSIZE  ((BUFFSIZE + BUFFSIZE / 16 + 64 + 3) + sizeof(data_block_header_t))
 #define HEAP_ALLOC(var,size) \
     lzo_align_t __LZO_MMODEL var [ ((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t) ]
@@ -77,32 +89,114 @@ static HEAP_ALLOC(wrkmem,LZO1X_1_MEM_COMPRESS);
 static void *lzo_buff;
 static int lzo_initialized = 0;
 
+static void *zstd_cctx = NULL;
+
+// columnar block of WriteBlock() without block writer
+static data_block_header_t *column_buff = NULL;
+
+/*
+ * Block writer pipeline
+ * With a writer started, WriteBlock() only queues the full block and swaps nffile->block_header
+ * with the spare buffer of a free slot, so the caller continues with an empty buffer right away.
+ * A pool of workers compresses the queued blocks and a single writer thread writes them in the 
+ * order they were queued. Each slot walks FREE -> QUEUED -> BUSY -> DONE -> FREE.
+ */
+#define SLOT_FREE	0
+#define SLOT_QUEUED	1
+#define SLOT_BUSY	2
+#define SLOT_DONE	3
+
+typedef struct write_slot_s {
+	data_block_header_t	*block;		// queued block or spare buffer, if the slot is free
+	data_block_header_t	*columns;	// columnar block
+	data_block_header_t	*out;		// compressed block
+	data_block_header_t	*data;		// block to write: block, columns or out
+	int					wfd;		// file of the block
+	int					compress;	// codec and level of the file
+	int					state;
+	int					error;		// errno of a failed compression
+} write_slot_t;
+
+typedef struct blockwriter_s {
+	pthread_mutex_t		mutex;
+	pthread_cond_t		cond;		// broadcast on each slot state change
+	pthread_t			writer;
+	pthread_t			*workers;
+	int					num_workers;
+	int					running;	// threads are started
+	int					terminate;
+	int					error;		// errno of the first failed block
+	uint32_t			num_slots;
+	write_slot_t		*slots;
+	uint64_t			queued;		// sequence of the next block to queue
+	uint64_t			compressed;	// sequence of the next block to compress
+	uint64_t			written;	// sequence of the next block to write
+} blockwriter_t;
+
 #define ERR_SIZE 256
 static char	error_string[ERR_SIZE];
 
 static int LZO_initialize(void);
 
+static int LZO_initialize_r(rfile_t *rfile);
+
+static int Compress_initialize(int compress);
+
+static uint32_t CompressionFlag(int compress);
+
+static char *CompressionName(uint32_t flags);
+
+static int CompressionAvailable(uint32_t flags);
+
+static int Uncompress_Block_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err);
+
+static int CompressBlock_r(int compress, data_block_header_t *in_block, data_block_header_t *out_block, 
+	void *wrkmem, void **zstd_ctx, char *error);
+
+static data_block_header_t *PrepareBlock_r(int compress, data_block_header_t *block, data_block_header_t *columns, 
+	data_block_header_t *out, void *wrkmem, void **zstd_ctx, char *error);
+
+static int ExpandBlock_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err);
+
+static int DecodeColumns_r(rfile_t *rfile, data_block_header_t *block_header, void *in, void *out, char **err);
+
+static int QueueBlock(nffile_t *nffile);
+
+static void *CompressWorker(void *arg);
+
+static void *WriteWorker(void *arg);
+
+static void DisposeBlockWriter(blockwriter_t *writer);
+
 extern char *nf_error;
 
 /* function prototypes */
 
-static void ZeroStat(void);
+static void ZeroStat(rfile_t *rfile);
+
+static void MapFile_r(rfile_t *rfile, int fd, off_t size);
+
+static void UnmapFile_r(rfile_t *rfile);
+
+static int ReadMappedBlock_r(rfile_t *rfile, data_block_header_t *block_header, void **buff, char **err);
+
+static void CloseIndex_r(rfile_t *rfile);
+
+static int SkipBlocks_r(rfile_t *rfile, char **err);
 
 static int WriteSTDOUTFileheader(void);
 
 /* function definitions */
 
-static void ZeroStat() {
-
-	FileHeader.NumBlocks 	= 0;
-	strncpy(FileHeader.ident, IdentNone, IdentLen);
+static void ZeroStat(rfile_t *rfile) {
 
-	NetflowStat.first_seen  = 0;
-	NetflowStat.last_seen	= 0;
-	NetflowStat.msec_first	= 0;
-	NetflowStat.msec_last	= 0;
+	rfile->file_header.NumBlocks 	= 0;
+	strncpy(rfile->file_header.ident, IdentNone, IdentLen);
 
-	CurrentIdent			= FileHeader.ident;
+	rfile->stat_record.first_seen  = 0;
+	rfile->stat_record.last_seen	= 0;
+	rfile->stat_record.msec_first	= 0;
+	rfile->stat_record.msec_last	= 0;
 
 } // End of ZeroStat
 
@@ -150,6 +244,13 @@ char *GetIdent(void) {
 
 } // End of GetIdent
 
+// handle of the file opened by the non reentrant OpenFile()
+rfile_t *GetRFile(void) {
+
+	return &default_rfile;
+
+} // End of GetRFile
+
 static int LZO_initialize(void) {
 
 	if (lzo_init() != LZO_E_OK) {
@@ -159,7 +260,7 @@ static int LZO_initialize(void) {
 			error_string[ERR_SIZE-1] = 0;
 			return 0;
 	} 
-	lzo_buff = malloc(BUFFSIZE+ sizeof(data_block_header_t));
+	lzo_buff = malloc(LZO_BUFFSIZE);
 	if ( !lzo_buff ) {
 		snprintf(error_string, ERR_SIZE, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
 		error_string[ERR_SIZE-1] = 0;
@@ -171,110 +272,482 @@ static int LZO_initialize(void) {
 
 } // End of LZO_initialize
 
+static int LZO_initialize_r(rfile_t *rfile) {
 
-int OpenFile(char *filename, stat_record_t **stat_record, char **err){
+	if (lzo_init() != LZO_E_OK) {
+			// this usually indicates a compiler bug - try recompiling 
+			// without optimizations, and enable `-DLZO_DEBUG' for diagnostics
+			snprintf(rfile->error_string, RFILE_ERR_SIZE,"Compression lzo_init() failed.\n");
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			return 0;
+	} 
+	rfile->lzo_buff = malloc(LZO_BUFFSIZE);
+	if ( !rfile->lzo_buff ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		return 0;
+	}
+
+	return 1;
+
+} // End of LZO_initialize_r
+
+static int Compress_initialize(int compress) {
+
+	// the output buffer is shared by all codecs
+	if ( !lzo_initialized && !LZO_initialize() )
+		return 0;
+
+	switch ( COMPRESSION_CODEC(compress) ) {
+		case LZO_COMPRESSED:
+			return 1;
+		case LZ4_COMPRESSED:
+#ifdef HAVE_LIBLZ4
+			return 1;
+#else
+			snprintf(error_string, ERR_SIZE,"LZ4 compression not available. Rebuild nfdump with --enable-lz4\n");
+			error_string[ERR_SIZE-1] = 0;
+			return 0;
+#endif
+		case ZSTD_COMPRESSED:
+#ifdef HAVE_LIBZSTD
+			return 1;
+#else
+			snprintf(error_string, ERR_SIZE,"Zstandard compression not available. Rebuild nfdump with --enable-zstd\n");
+			error_string[ERR_SIZE-1] = 0;
+			return 0;
+#endif
+	}
+
+	snprintf(error_string, ERR_SIZE,"Unknown compression codec: %d\n", COMPRESSION_CODEC(compress));
+	error_string[ERR_SIZE-1] = 0;
+	return 0;
+
+} // End of Compress_initialize
+
+static uint32_t CompressionFlag(int compress) {
+
+	switch ( COMPRESSION_CODEC(compress) ) {
+		case LZO_COMPRESSED:
+			return FLAG_COMPRESSED;
+		case LZ4_COMPRESSED:
+			return FLAG_LZ4_COMPRESSED;
+		case ZSTD_COMPRESSED:
+			return FLAG_ZSTD_COMPRESSED;
+	}
+
+	return 0;
+
+} // End of CompressionFlag
+
+static char *CompressionName(uint32_t flags) {
+
+	switch ( flags & FLAG_COMPRESSION ) {
+		case 0:
+			return "not compressed";
+		case FLAG_COMPRESSED:
+			return "LZO compressed";
+		case FLAG_LZ4_COMPRESSED:
+			return "LZ4 compressed";
+		case FLAG_ZSTD_COMPRESSED:
+			return "Zstandard compressed";
+	}
+
+	return "unknown compression";
+
+} // End of CompressionName
+
+static int CompressionAvailable(uint32_t flags) {
+
+	switch ( flags & FLAG_COMPRESSION ) {
+		case 0:
+		case FLAG_COMPRESSED:
+			return 1;
+#ifdef HAVE_LIBLZ4
+		case FLAG_LZ4_COMPRESSED:
+			return 1;
+#endif
+#ifdef HAVE_LIBZSTD
+		case FLAG_ZSTD_COMPRESSED:
+			return 1;
+#endif
+	}
+
+	return 0;
+
+} // End of CompressionAvailable
+
+rfile_t *NewRFile(void) {
+rfile_t *rfile;
+
+	rfile = (rfile_t *)calloc(1, sizeof(rfile_t));
+	if ( !rfile ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+	rfile->rfd = -1;
+
+	return rfile;
+
+} // End of NewRFile
+
+void DisposeRFile(rfile_t *rfile) {
+
+	if ( !rfile )
+		return;
+
+	CloseFile_r(rfile);
+	if ( rfile->lzo_buff )
+		free(rfile->lzo_buff);
+	if ( rfile->column_buff )
+		free(rfile->column_buff);
+	DisposeColumnReader(rfile->column_reader);
+#ifdef HAVE_LIBZSTD
+	if ( rfile->zstd_ctx )
+		ZSTD_freeDCtx((ZSTD_DCtx *)rfile->zstd_ctx);
+#endif
+	free(rfile);
+
+} // End of DisposeRFile
+
+/*
+ * Map an uncompressed file, so the data blocks can be processed directly
+ * in the page cache without copying them into a read buffer. The mapping
+ * is private and writable, as the readers modify the records in place 
+ * ( extension map ids, v1 conversion ). If mmap fails, the file is read().
+ */
+static void MapFile_r(rfile_t *rfile, int fd, off_t size) {
+void *map;
+
+	if ( size <= 0 || (off_t)(size_t)size != size ) 
+		return;
+
+	map = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if ( map == MAP_FAILED ) 
+		return;
+
+#ifdef MADV_SEQUENTIAL
+	madvise(map, (size_t)size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+	madvise(map, (size_t)size, MADV_WILLNEED);
+#endif
+
+	rfile->map		  = map;
+	rfile->map_size   = (size_t)size;
+	rfile->map_offset = sizeof(file_header_t) + sizeof(stat_record_t);
+
+} // End of MapFile_r
+
+static void UnmapFile_r(rfile_t *rfile) {
+
+	if ( rfile->map ) 
+		munmap(rfile->map, rfile->map_size);
+	rfile->map		  = NULL;
+	rfile->map_size   = 0;
+	rfile->map_offset = 0;
+
+} // End of UnmapFile_r
+
+void CloseFile_r(rfile_t *rfile) {
+
+	UnmapFile_r(rfile);
+	CloseIndex_r(rfile);
+
+	// stdin is not closed
+	if ( rfile->rfd > 0 ) 
+		close(rfile->rfd);
+	rfile->rfd = -1;
+
+} // End of CloseFile_r
+
+static void CloseIndex_r(rfile_t *rfile) {
+
+	if ( rfile->index ) 
+		free(rfile->index);
+	rfile->index		= NULL;
+	rfile->index_blocks = 0;
+	rfile->block		= 0;
+	rfile->twin_start	= 0;
+	rfile->twin_end		= 0;
+
+} // End of CloseIndex_r
+
+/*
+ * Load the block index <filename>.idx of the file just opened with rfile.
+ * Returns 1 if the index is loaded, otherwise 0
+ */
+static int LoadIndex_r(rfile_t *rfile, char *filename) {
+struct stat		stat_buf, index_stat;
+index_header_t	index_header;
+char			path[MAXPATHLEN];
+size_t			size;
+int				fd;
+
+	if ( rfile->index ) 
+		return 1;
+
+	if ( filename == NULL || rfile->rfd <= 0 ) 
+		return 0;
+
+	snprintf(path, MAXPATHLEN, "%s%s", filename, INDEX_SUFFIX);
+	path[MAXPATHLEN-1] = 0;
+
+	// the index is optional
+	fd = open(path, O_RDONLY);
+	if ( fd < 0 ) 
+		return 0;
+
+	// the index must be newer than the data file and match its size
+	if ( fstat(rfile->rfd, &stat_buf) < 0 || fstat(fd, &index_stat) < 0 || 
+		 index_stat.st_mtime < stat_buf.st_mtime ||
+		 read(fd, (void *)&index_header, sizeof(index_header_t)) != sizeof(index_header_t) ||
+		 index_header.magic != INDEX_MAGIC || index_header.version != INDEX_VERSION_1 ||
+		 index_header.file_size != (uint64_t)stat_buf.st_size ) {
+		fprintf(stderr, "Skip stale or corrupt index file '%s'\n", path);
+		close(fd);
+		return 0;
+	}
+
+	if ( index_header.NumBlocks == 0 ) {
+		close(fd);
+		return 0;
+	}
+
+	size = index_header.NumBlocks * sizeof(index_record_t);
+	rfile->index = (index_record_t *)malloc(size);
+	if ( !rfile->index ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		close(fd);
+		return 0;
+	}
+
+	if ( read(fd, (void *)rfile->index, size) != (ssize_t)size ) {
+		fprintf(stderr, "Skip stale or corrupt index file '%s'\n", path);
+		CloseIndex_r(rfile);
+		close(fd);
+		return 0;
+	}
+	close(fd);
+
+	rfile->index_blocks = index_header.NumBlocks;
+	rfile->block		= 0;
+
+	return 1;
+
+} // End of LoadIndex_r
+
+/*
+ * Use the block index <filename>.idx of the file just opened with rfile.
+ * The read functions then skip all blocks without flows in the time window,
+ * which is applied as in nfdump: first >= twin_start and last <= twin_end.
+ * Returns 1 if the index is used, 0 if all blocks are read.
+ */
+int OpenIndex_r(rfile_t *rfile, char *filename, uint32_t twin_start, uint32_t twin_end) {
+
+	if ( twin_start == 0 || !LoadIndex_r(rfile, filename) ) 
+		return 0;
+
+	rfile->twin_start	= twin_start;
+	rfile->twin_end		= twin_end;
+
+	return 1;
+
+} // End of OpenIndex_r
+
+/*
+ * Read only the blocks in the sorted list blocks of the file just opened with rfile,
+ * and the blocks, which are always read. NumBlocks is the number of blocks the list
+ * refers to, which must match the block index. Returns 1 if the selection is used, 
+ * 0 if all blocks are read.
+ */
+int SelectBlocks_r(rfile_t *rfile, char *filename, uint32_t *blocks, uint32_t num_blocks, uint32_t NumBlocks) {
+uint32_t i;
+
+	if ( !LoadIndex_r(rfile, filename) || rfile->index_blocks != NumBlocks ) 
+		return 0;
+
+	for ( i=0; i<rfile->index_blocks; i++ ) 
+		rfile->index[i].flags |= INDEX_SKIP;
+	for ( i=0; i<num_blocks; i++ ) {
+		if ( blocks[i] < rfile->index_blocks ) 
+			rfile->index[blocks[i]].flags &= ~INDEX_SKIP;
+	}
+
+	return 1;
+
+} // End of SelectBlocks_r
+
+/*
+ * Advance to the next block, which may contain flows in the time window of
+ * the index and is selected. Returns 1 if this block is to be read next, NF_EOF if no more
+ * blocks are needed, otherwise an error
+ */
+static int SkipBlocks_r(rfile_t *rfile, char **err) {
+index_record_t	*index_record = NULL;
+uint32_t		block = rfile->block;
+
+	while ( block < rfile->index_blocks ) {
+		index_record = &rfile->index[block];
+		if ( (index_record->flags & INDEX_READ_ALWAYS) || 
+			 ( (index_record->flags & INDEX_SKIP) == 0 && ( rfile->twin_start == 0 || 
+			   (index_record->first_max >= rfile->twin_start && index_record->last_min <= rfile->twin_end) ) ) )
+			break;
+		block++;
+	}
+
+	if ( block == rfile->index_blocks ) 
+		return NF_EOF;
+
+	if ( block != rfile->block ) {
+		if ( rfile->map ) {
+			if ( index_record->offset > rfile->map_size ) {
+				snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt index file: Block offset %llu beyond EOF.\n", 
+					(unsigned long long)index_record->offset);
+				rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+				*err = rfile->error_string;
+				return NF_CORRUPT;
+			}
+			rfile->map_offset = index_record->offset;
+		} else if ( lseek(rfile->rfd, (off_t)index_record->offset, SEEK_SET) < 0 ) 
+			return NF_ERROR;
+	}
+	rfile->block = block + 1;
+
+	return 1;
+
+} // End of SkipBlocks_r
+
+
+int OpenFile_r(rfile_t *rfile, char *filename, stat_record_t **stat_record, char **err){
 struct stat stat_buf;
 int fd, ret;
 
 	*err = NULL;
 	if ( stat_record ) 
-		*stat_record = &NetflowStat;
+		*stat_record = &(rfile->stat_record);
+
+	// release the mapping and index of a previous file, which was closed by close()
+	UnmapFile_r(rfile);
+	CloseIndex_r(rfile);
 
 	if ( filename == NULL ) {
 		// stdin
-		ZeroStat();
+		ZeroStat(rfile);
 		fd = STDIN_FILENO;
 	} else {
 		// regular file
 		if ( stat(filename, &stat_buf) ) {
-			snprintf(error_string, ERR_SIZE, "Can't stat '%s': %s\n", filename, strerror(errno));
-			error_string[ERR_SIZE-1] = 0;
-			*err = error_string;
-			ZeroStat();
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "Can't stat '%s': %s\n", filename, strerror(errno));
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			ZeroStat(rfile);
 			return -1;
 		}
 
 		if (!S_ISREG(stat_buf.st_mode) ) {
-			snprintf(error_string, ERR_SIZE, "'%s' is not a file\n", filename);
-			error_string[ERR_SIZE-1] = 0;
-			*err = error_string;
-			ZeroStat();
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "'%s' is not a file\n", filename);
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			ZeroStat(rfile);
 			return -1;
 		}
 
 		// printf("Statfile %s\n",filename);
 		fd =  open(filename, O_RDONLY);
 		if ( fd < 0 ) {
-			snprintf(error_string, ERR_SIZE, "Error open file: %s\n", strerror(errno));
-			error_string[ERR_SIZE-1] = 0;
-			*err = error_string;
-			ZeroStat();
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "Error open file: %s\n", strerror(errno));
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			ZeroStat(rfile);
 			return fd;
 		}
 
 	}
 
-	ret = read(fd, (void *)&FileHeader, sizeof(FileHeader));
-	if ( FileHeader.magic != MAGIC ) {
-		snprintf(error_string, ERR_SIZE, "Open file '%s': bad magic: 0x%X\n", filename ? filename : "<stdin>", FileHeader.magic );
-		error_string[ERR_SIZE-1] = 0;
-		*err = error_string;
-		ZeroStat();
+	ret = read(fd, (void *)&(rfile->file_header), sizeof(file_header_t));
+	if ( rfile->file_header.magic != MAGIC ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "Open file '%s': bad magic: 0x%X\n", filename ? filename : "<stdin>", rfile->file_header.magic );
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		ZeroStat(rfile);
 		close(fd);
 		return -1;
 	}
-	if ( FileHeader.version != LAYOUT_VERSION_1 ) {
-		snprintf(error_string, ERR_SIZE,"Open file %s: bad version: %u\n", filename, FileHeader.version );
-		error_string[ERR_SIZE-1] = 0;
-		*err = error_string;
-		ZeroStat();
+	if ( rfile->file_header.version != LAYOUT_VERSION_1 ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE,"Open file %s: bad version: %u\n", filename, rfile->file_header.version );
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		ZeroStat(rfile);
+		close(fd);
+		return -1;
+	}
+	if ( !CompressionAvailable(rfile->file_header.flags) ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE,"Open file %s: %s - codec not available in this build\n", 
+			filename ? filename : "<stdin>", CompressionName(rfile->file_header.flags));
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		ZeroStat(rfile);
 		close(fd);
 		return -1;
 	}
-	read(fd, (void *)&NetflowStat, sizeof(NetflowStat));
+	read(fd, (void *)&(rfile->stat_record), sizeof(stat_record_t));
 
 // for debugging:
 /*
-	printf("Magic: 0x%X\n", FileHeader.magic);
-	printf("Version: %i\n", FileHeader.version);
-	printf("Flags: %i\n", FileHeader.flags);
-	printf("NumBlocks: %i\n", FileHeader.NumBlocks);
-	printf("Ident: %s\n\n", FileHeader.ident);
-
-	printf("Flows: %llu\n", NetflowStat.numflows);
-	printf("Flows_tcp: %llu\n", NetflowStat.numflows_tcp);
-	printf("Flows_udp: %llu\n", NetflowStat.numflows_udp);
-	printf("Flows_icmp: %llu\n", NetflowStat.numflows_icmp);
-	printf("Flows_other: %llu\n", NetflowStat.numflows_other);
-	printf("Packets: %llu\n", NetflowStat.numpackets);
-	printf("Packets_tcp: %llu\n", NetflowStat.numpackets_tcp);
-	printf("Packets_udp: %llu\n", NetflowStat.numpackets_udp);
-	printf("Packets_icmp: %llu\n", NetflowStat.numpackets_icmp);
-	printf("Packets_other: %llu\n", NetflowStat.numpackets_other);
-	printf("Bytes: %llu\n", NetflowStat.numbytes);
-	printf("Bytes_tcp: %llu\n", NetflowStat.numbytes_tcp);
-	printf("Bytes_udp: %llu\n", NetflowStat.numbytes_udp);
-	printf("Bytes_icmp: %llu\n", NetflowStat.numbytes_icmp);
-	printf("Bytes_other: %llu\n", NetflowStat.numbytes_other);
-	printf("First: %u\n", NetflowStat.first_seen);
-	printf("Last: %u\n", NetflowStat.last_seen);
-	printf("msec_first: %u\n", NetflowStat.msec_first);
-	printf("msec_last: %u\n", NetflowStat.msec_last);
+	printf("Magic: 0x%X\n", rfile->file_header.magic);
+	printf("Version: %i\n", rfile->file_header.version);
+	printf("Flags: %i\n", rfile->file_header.flags);
+	printf("NumBlocks: %i\n", rfile->file_header.NumBlocks);
+	printf("Ident: %s\n\n", rfile->file_header.ident);
+
+	printf("Flows: %llu\n", rfile->stat_record.numflows);
+	printf("Flows_tcp: %llu\n", rfile->stat_record.numflows_tcp);
+	printf("Flows_udp: %llu\n", rfile->stat_record.numflows_udp);
+	printf("Flows_icmp: %llu\n", rfile->stat_record.numflows_icmp);
+	printf("Flows_other: %llu\n", rfile->stat_record.numflows_other);
+	printf("Packets: %llu\n", rfile->stat_record.numpackets);
+	printf("Packets_tcp: %llu\n", rfile->stat_record.numpackets_tcp);
+	printf("Packets_udp: %llu\n", rfile->stat_record.numpackets_udp);
+	printf("Packets_icmp: %llu\n", rfile->stat_record.numpackets_icmp);
+	printf("Packets_other: %llu\n", rfile->stat_record.numpackets_other);
+	printf("Bytes: %llu\n", rfile->stat_record.numbytes);
+	printf("Bytes_tcp: %llu\n", rfile->stat_record.numbytes_tcp);
+	printf("Bytes_udp: %llu\n", rfile->stat_record.numbytes_udp);
+	printf("Bytes_icmp: %llu\n", rfile->stat_record.numbytes_icmp);
+	printf("Bytes_other: %llu\n", rfile->stat_record.numbytes_other);
+	printf("First: %u\n", rfile->stat_record.first_seen);
+	printf("Last: %u\n", rfile->stat_record.last_seen);
+	printf("msec_first: %u\n", rfile->stat_record.msec_first);
+	printf("msec_last: %u\n", rfile->stat_record.msec_last);
 */
-	CurrentIdent		= FileHeader.ident;
-
-	if ( file_compressed && !lzo_initialized && !LZO_initialize() ) {
-		*err = error_string;
-		ZeroStat();
+	if ( file_compressed(rfile) && !rfile->lzo_buff && !LZO_initialize_r(rfile) ) {
+		*err = rfile->error_string;
+		ZeroStat(rfile);
 		close(fd);
 		return -1;
     }
 
+	if ( filename != NULL && !file_compressed(rfile) ) 
+		MapFile_r(rfile, fd, stat_buf.st_size);
+
+	rfile->rfd = fd;
+	return fd;
+
+} // End of OpenFile_r
+
+int OpenFile(char *filename, stat_record_t **stat_record, char **err){
+int fd;
+
+	fd = OpenFile_r(&default_rfile, filename, stat_record, err);
+	CurrentIdent = default_rfile.file_header.ident;
+
 	return fd;
 
 } // End of OpenFile
 
 int ChangeIdent(char *filename, char *Ident, char **err) {
+file_header_t	file_header;
 struct stat stat_buf;
 int fd, ret;
 
@@ -304,24 +777,24 @@ int fd, ret;
 		return fd;
 	}
 
-	ret = read(fd, (void *)&FileHeader, sizeof(FileHeader));
-	if ( FileHeader.magic != MAGIC ) {
-		snprintf(error_string, ERR_SIZE, "Open file '%s': bad magic: 0x%X\n", filename, FileHeader.magic );
+	ret = read(fd, (void *)&file_header, sizeof(file_header_t));
+	if ( file_header.magic != MAGIC ) {
+		snprintf(error_string, ERR_SIZE, "Open file '%s': bad magic: 0x%X\n", filename, file_header.magic );
 		error_string[ERR_SIZE-1] = 0;
 		*err = error_string;
 		close(fd);
 		return -1;
 	}
-	if ( FileHeader.version != LAYOUT_VERSION_1 ) {
-		snprintf(error_string, ERR_SIZE,"Open file %s: bad version: %u\n", filename, FileHeader.version );
+	if ( file_header.version != LAYOUT_VERSION_1 ) {
+		snprintf(error_string, ERR_SIZE,"Open file %s: bad version: %u\n", filename, file_header.version );
 		error_string[ERR_SIZE-1] = 0;
 		*err = error_string;
 		close(fd);
 		return -1;
 	}
 
-	strncpy(FileHeader.ident, Ident, IdentLen);
-	FileHeader.ident[IdentLen - 1] = 0;
+	strncpy(file_header.ident, Ident, IdentLen);
+	file_header.ident[IdentLen - 1] = 0;
 
 	if ( lseek(fd, 0, SEEK_SET) < 0 ) {
 		snprintf(error_string, ERR_SIZE,"lseek failed: '%s'\n" , strerror(errno));
@@ -331,7 +804,7 @@ int fd, ret;
 		return -1;
 	}
 
-	write(fd, (void *)&FileHeader, sizeof(file_header_t));
+	write(fd, (void *)&file_header, sizeof(file_header_t));
 	if ( close(fd) < 0 ) {
 		snprintf(error_string, ERR_SIZE,"close failed: '%s'" , strerror(errno));
 		error_string[ERR_SIZE-1] = 0;
@@ -347,11 +820,11 @@ int fd, ret;
 void PrintStat(stat_record_t *s) {
 
 	if ( s == NULL )
-		s = &NetflowStat;
+		s = &(default_rfile.stat_record);
 
 	// format info: make compiler happy with conversion to (unsigned long long), 
 	// which does not change the size of the parameter
-	printf("Ident: %s\n", FileHeader.ident);
+	printf("Ident: %s\n", default_rfile.file_header.ident);
 	printf("Flows: %llu\n", (unsigned long long)s->numflows);
 	printf("Flows_tcp: %llu\n", (unsigned long long)s->numflows_tcp);
 	printf("Flows_udp: %llu\n", (unsigned long long)s->numflows_udp);
@@ -383,6 +856,7 @@ char 				*string;
 	nffile->file_blocks  = 0;
 	nffile->compress 	 = compress;
 	nffile->wfd			 = 0;
+	nffile->writer		 = NULL;
 
 	if ( !filename ) 
 		return 0;
@@ -392,6 +866,8 @@ char 				*string;
 			return 0;
 		}
 		nffile->wfd = STDOUT_FILENO;
+		// we do not compress data on stdout
+		nffile->compress = NOT_COMPRESSED;
 
 	} else {
 		nffile->wfd = OpenNewFile(filename, &string, nffile->compress);
@@ -438,15 +914,26 @@ int				nffd;
 	/* magic set, version = 0 => file open for writing */
 	file_header->magic = MAGIC;
 
-	if ( compressed ) {
-		if ( !lzo_initialized && !LZO_initialize() ) {
+	if ( COMPRESSION_CODEC(compressed) ) {
+		if ( !Compress_initialize(compressed) ) {
 				*err = error_string;
 				close(nffd);
 				return -1;
 		}
-		file_header->flags |= FLAG_COMPRESSED;
+		file_header->flags |= CompressionFlag(compressed);
     }
 
+	if ( (compressed & COLUMNAR_BLOCKS) && !column_buff ) {
+		column_buff = (data_block_header_t *)malloc(BUFFSIZE + sizeof(data_block_header_t));
+		if ( !column_buff ) {
+			snprintf(error_string, ERR_SIZE, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			error_string[ERR_SIZE-1] = 0;
+			*err = error_string;
+			close(nffd);
+			return -1;
+		}
+	}
+
 	if ( write(nffd, (void *)file_header, len) < len ) {
 		snprintf(error_string, ERR_SIZE, "Failed to write file header: '%s'" , strerror(errno));
 		error_string[ERR_SIZE-1] = 0;
@@ -466,7 +953,7 @@ file_header_t	file_header;
 
 	file_header.magic 		= MAGIC;
 	file_header.version		= LAYOUT_VERSION_1;
-	file_header.flags		= compressed ? FLAG_COMPRESSED : 0;
+	file_header.flags		= CompressionFlag(compressed) | ((compressed & SORTED_RECORDS) ? FLAG_SORTED : 0);
 	file_header.NumBlocks	= record_count;
 	strncpy(file_header.ident, ident ? ident : "unknown" , IdentLen);
 	file_header.ident[IdentLen - 1] = 0;
@@ -491,70 +978,286 @@ file_header_t	file_header;
 
 } /* End of CloseUpdateFile */
 
-int ReadBlock(int rfd, data_block_header_t *block_header, void *read_buff, char **err) {
-ssize_t ret, read_bytes, buff_bytes, request_size;
-void 	*read_ptr, *buff;
+/*
+ * Return the next data block of a mapped file in buff, without copying it
+ */
+static int ReadMappedBlock_r(rfile_t *rfile, data_block_header_t *block_header, void **buff, char **err) {
+size_t	remaining;
 
-		ret = read(rfd, block_header, sizeof(data_block_header_t));
-		if ( ret == 0 )		// EOF
-			return NF_EOF;
-		
-		if ( ret == -1 )	// ERROR
-			return NF_ERROR;
-		
-		// block header read successfully
-		read_bytes = ret;
+	if ( rfile->index ) {
+		int ret = SkipBlocks_r(rfile, err);
+		if ( ret <= 0 ) 
+			return ret;
+	}
 
-		// Check for sane buffer size
-		if ( block_header->size > BUFFSIZE ) {
-			snprintf(error_string, ERR_SIZE, "Corrupt data file: Requested buffer size %u exceeds max. buffer size.\n", block_header->size);
-			error_string[ERR_SIZE-1] = 0;
-			*err = error_string;
-			// this is most likely a corrupt file
-			return NF_CORRUPT;
-		}
+	remaining = rfile->map_size - rfile->map_offset;
+	if ( remaining == 0 ) 	// EOF
+		return NF_EOF;
 
-		buff = file_compressed ? lzo_buff : read_buff;
+	if ( remaining < sizeof(data_block_header_t) ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Unexpected EOF while reading data block.\n");
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		return NF_CORRUPT;
+	}
 
-		ret = read(rfd, buff, block_header->size);
-		if ( ret == block_header->size ) {
-			lzo_uint new_len;
-			// we have the whole record and are done for now
-			if ( file_compressed ) {
-				int r;
-    			r = lzo1x_decompress(lzo_buff,block_header->size,read_buff,&new_len,NULL);
-    			if (r != LZO_E_OK ) {
-        			/* this should NEVER happen */
-        			printf("internal error - decompression failed: %d\n", r);
-        			return NF_CORRUPT;
-    			}
-				block_header->size = new_len;
-				return read_bytes + new_len;
-			} else
-				return read_bytes + ret;
+	memcpy((void *)block_header, (void *)((pointer_addr_t)rfile->map + rfile->map_offset), sizeof(data_block_header_t));
+	remaining -= sizeof(data_block_header_t);
 
-		} 
-			
-		if ( ret == 0 ) {
-			// EOF not expected here - this should never happen, file may be corrupt
-			snprintf(error_string, ERR_SIZE, "Corrupt data file: Unexpected EOF while reading data block.\n");
-			error_string[ERR_SIZE-1] = 0;
-			*err = error_string;
-			return NF_CORRUPT;
-		}
+	// Check for sane buffer size
+	if ( block_header->size > BUFFSIZE ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Requested buffer size %u exceeds max. buffer size.\n", block_header->size);
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		return NF_CORRUPT;
+	}
 
-		if ( ret == -1 )	// ERROR
-			return NF_ERROR;
+	if ( block_header->size > remaining ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Unexpected EOF. Short read of data block.\n");
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		return NF_CORRUPT;
+	}
 
-		// Ups! - ret is != block_header->size
-		// this was a short read - most likely reading from the stdin pipe
-		// loop until we have requested size
+	*buff = (void *)((pointer_addr_t)rfile->map + rfile->map_offset + sizeof(data_block_header_t));
+	rfile->map_offset += sizeof(data_block_header_t) + block_header->size;
 
-		buff_bytes 	 = ret;								// already in buffer
-		request_size = block_header->size - buff_bytes;	// still to go for this amount of data
+	return sizeof(data_block_header_t) + block_header->size;
 
-		read_ptr 	 = (void *)((pointer_addr_t)buff + buff_bytes);	
-		do {
+} // End of ReadMappedBlock_r
+
+/*
+ * Same as ReadBlock_r, but for mapped files buff is set to the data block 
+ * in the mapping, instead of copying it. Otherwise the block is read into
+ * the buffer *buff points to.
+ */
+int ReadBlockPtr_r(rfile_t *rfile, data_block_header_t *block_header, void **buff, char **err) {
+int ret;
+
+	if ( rfile->map ) {
+		ret = ReadMappedBlock_r(rfile, block_header, buff, err);
+		if ( ret > 0 && block_header->id == DATA_BLOCK_TYPE_3 && !rfile->keep_columns ) {
+			// decode into the column buffer, the mapping stays unchanged
+			ret = DecodeColumns_r(rfile, block_header, *buff, NULL, err);
+			if ( ret < 0 ) 
+				return ret;
+			*buff = rfile->column_buff;
+			ret += sizeof(data_block_header_t);
+		}
+		return ret;
+	}
+
+	return ReadBlock_r(rfile, block_header, *buff, err);
+
+} // End of ReadBlockPtr_r
+
+/*
+ * Decompress the data block in rfile->lzo_buff into read_buff with the codec of the file
+ * Returns the size of the decompressed block or NF_CORRUPT/NF_ERROR
+ */
+static int Uncompress_Block_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err) {
+int r;
+
+	switch ( rfile->file_header.flags & FLAG_COMPRESSION ) {
+		case FLAG_COMPRESSED: {
+			lzo_uint new_len;
+    		r = lzo1x_decompress(rfile->lzo_buff,block_header->size,read_buff,&new_len,NULL);
+    		if (r != LZO_E_OK ) {
+        		/* this should NEVER happen */
+        		printf("internal error - decompression failed: %d\n", r);
+        		return NF_CORRUPT;
+    		}
+			r = new_len;
+			} break;
+#ifdef HAVE_LIBLZ4
+		case FLAG_LZ4_COMPRESSED:
+			r = LZ4_decompress_safe((const char *)rfile->lzo_buff, (char *)read_buff, block_header->size, BUFFSIZE);
+			if ( r < 0 ) {
+				snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: LZ4 decompression failed: %d\n", r);
+				rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+				*err = rfile->error_string;
+				return NF_CORRUPT;
+			}
+			break;
+#endif
+#ifdef HAVE_LIBZSTD
+		case FLAG_ZSTD_COMPRESSED: {
+			size_t new_len;
+			// the context is kept with the handle and reused for all blocks and files
+			if ( !rfile->zstd_ctx ) {
+				rfile->zstd_ctx = ZSTD_createDCtx();
+				if ( !rfile->zstd_ctx ) {
+					snprintf(rfile->error_string, RFILE_ERR_SIZE, "Decompression ZSTD_createDCtx() failed.\n");
+					rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+					*err = rfile->error_string;
+					return NF_ERROR;
+				}
+			}
+			new_len = ZSTD_decompressDCtx((ZSTD_DCtx *)rfile->zstd_ctx, read_buff, BUFFSIZE, rfile->lzo_buff, block_header->size);
+			if ( ZSTD_isError(new_len) ) {
+				snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Zstandard decompression failed: %s\n", 
+					ZSTD_getErrorName(new_len));
+				rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+				*err = rfile->error_string;
+				return NF_CORRUPT;
+			}
+			r = new_len;
+			} break;
+#endif
+		default:
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "Data file is %s - codec not available in this build\n", 
+				CompressionName(rfile->file_header.flags));
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			return NF_CORRUPT;
+	}
+
+	block_header->size = r;
+	return r;
+
+} // End of Uncompress_Block_r
+
+/*
+ * Decode the columnar block in into out, or into rfile->column_buff, if out is NULL
+ * Returns the size of the decoded block or NF_CORRUPT/NF_ERROR
+ */
+static int DecodeColumns_r(rfile_t *rfile, data_block_header_t *block_header, void *in, void *out, char **err) {
+int ret;
+
+	if ( !out ) {
+		if ( !rfile->column_buff ) {
+			rfile->column_buff = malloc(BUFFSIZE);
+			if ( !rfile->column_buff ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				return NF_ERROR;
+			}
+		}
+		out = rfile->column_buff;
+	}
+
+	if ( !rfile->column_reader ) {
+		rfile->column_reader = NewColumnReader();
+		if ( !rfile->column_reader ) 
+			return NF_ERROR;
+	}
+
+	ret = DecodeColumnBlock(rfile->column_reader, block_header, in, out);
+	if ( ret < 0 ) {
+		snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Can't decode columnar data block.\n");
+		rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+		*err = rfile->error_string;
+		return NF_CORRUPT;
+	}
+
+	return ret;
+
+} // End of DecodeColumns_r
+
+/*
+ * The data of the block just read is in rfile->lzo_buff for compressed files, in rfile->column_buff for 
+ * columnar blocks to decode, otherwise in read_buff. Uncompress and decode it into read_buff
+ * Returns the size of the block in read_buff or NF_CORRUPT/NF_ERROR
+ */
+static int ExpandBlock_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err) {
+int ret, decode;
+
+	decode = block_header->id == DATA_BLOCK_TYPE_3 && !rfile->keep_columns;
+	if ( file_compressed(rfile) ) {
+		ret = Uncompress_Block_r(rfile, block_header, decode ? rfile->column_buff : read_buff, err);
+		if ( ret < 0 ) 
+			return ret;
+	} 
+
+	if ( !decode ) 
+		return block_header->size;
+
+	return DecodeColumns_r(rfile, block_header, rfile->column_buff, read_buff, err);
+
+} // End of ExpandBlock_r
+
+int ReadBlock_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err) {
+ssize_t ret, read_bytes, buff_bytes, request_size;
+void 	*read_ptr, *buff;
+int		rfd = rfile->rfd;
+
+		if ( rfile->map ) {
+			ret = ReadMappedBlock_r(rfile, block_header, &buff, err);
+			if ( ret > 0 ) {
+				if ( block_header->id == DATA_BLOCK_TYPE_3 && !rfile->keep_columns ) {
+					ret = DecodeColumns_r(rfile, block_header, buff, read_buff, err);
+					return ret < 0 ? ret : sizeof(data_block_header_t) + ret;
+				}
+				memcpy(read_buff, buff, block_header->size);
+			}
+			return ret;
+		}
+
+		if ( rfile->index ) {
+			ret = SkipBlocks_r(rfile, err);
+			if ( ret <= 0 ) 
+				return ret;
+		}
+
+		ret = read(rfd, block_header, sizeof(data_block_header_t));
+		if ( ret == 0 )		// EOF
+			return NF_EOF;
+		
+		if ( ret == -1 )	// ERROR
+			return NF_ERROR;
+		
+		// block header read successfully
+		read_bytes = ret;
+
+		// Check for sane buffer size
+		if ( block_header->size > (file_compressed(rfile) ? LZO_BUFFSIZE - sizeof(data_block_header_t) : BUFFSIZE) ) {
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Requested buffer size %u exceeds max. buffer size.\n", block_header->size);
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			// this is most likely a corrupt file
+			return NF_CORRUPT;
+		}
+
+		// columnar blocks are decoded from the column buffer into read_buff
+		if ( block_header->id == DATA_BLOCK_TYPE_3 && !rfile->keep_columns && !rfile->column_buff ) {
+			rfile->column_buff = malloc(BUFFSIZE);
+			if ( !rfile->column_buff ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				return NF_ERROR;
+			}
+		}
+
+		if ( file_compressed(rfile) ) 
+			buff = rfile->lzo_buff;
+		else 
+			buff = block_header->id == DATA_BLOCK_TYPE_3 && !rfile->keep_columns ? rfile->column_buff : read_buff;
+
+		ret = read(rfd, buff, block_header->size);
+		if ( ret == block_header->size ) {
+			// we have the whole record and are done for now
+			ret = ExpandBlock_r(rfile, block_header, read_buff, err);
+			return ret < 0 ? ret : read_bytes + ret;
+		} 
+			
+		if ( ret == 0 ) {
+			// EOF not expected here - this should never happen, file may be corrupt
+			snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Unexpected EOF while reading data block.\n");
+			rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+			*err = rfile->error_string;
+			return NF_CORRUPT;
+		}
+
+		if ( ret == -1 )	// ERROR
+			return NF_ERROR;
+
+		// Ups! - ret is != block_header->size
+		// this was a short read - most likely reading from the stdin pipe
+		// loop until we have requested size
+
+		buff_bytes 	 = ret;								// already in buffer
+		request_size = block_header->size - buff_bytes;	// still to go for this amount of data
+
+		read_ptr 	 = (void *)((pointer_addr_t)buff + buff_bytes);	
+		do {
 
 			ret = read(rfd, read_ptr, request_size);
 			if ( ret < 0 ) 
@@ -563,9 +1266,9 @@ void 	*read_ptr, *buff;
 
 			if ( ret == 0 ) {
 				//  0: EOF   - not expected
-				snprintf(error_string, ERR_SIZE, "Corrupt data file: Unexpected EOF. Short read of data block.\n");
-				error_string[ERR_SIZE-1] = 0;
-				*err = error_string;
+				snprintf(rfile->error_string, RFILE_ERR_SIZE, "Corrupt data file: Unexpected EOF. Short read of data block.\n");
+				rfile->error_string[RFILE_ERR_SIZE-1] = 0;
+				*err = rfile->error_string;
 				return NF_CORRUPT;
 			} 
 			
@@ -578,57 +1281,1101 @@ void 	*read_ptr, *buff;
 			}
 		} while ( request_size > 0 );
 
-		if ( file_compressed ) {
-			int r;
-			lzo_uint new_len;
-    		r = lzo1x_decompress(lzo_buff,block_header->size,read_buff,&new_len,NULL);
-    		if (r != LZO_E_OK ) {
-        		/* this should NEVER happen */
-        		printf("internal error - decompression failed: %d\n", r);
-        		return NF_CORRUPT;
-    		}
-			block_header->size = new_len;
-			return read_bytes + new_len;
+		// finally - we are done for now
+		ret = ExpandBlock_r(rfile, block_header, read_buff, err);
+		return ret < 0 ? ret : read_bytes + ret;
+	
+		/* not reached */
+
+} // End of ReadBlock_r
+
+int ReadBlock(int rfd, data_block_header_t *block_header, void *read_buff, char **err) {
+
+	// the mapping and index belong to the file opened by OpenFile()
+	if ( default_rfile.rfd != rfd ) {
+		UnmapFile_r(&default_rfile);
+		CloseIndex_r(&default_rfile);
+	}
+	default_rfile.rfd = rfd;
+	return ReadBlock_r(&default_rfile, block_header, read_buff, err);
+
+} // End of ReadBlock
+
+int ReadBlockPtr(int rfd, data_block_header_t *block_header, void **buff, char **err) {
+
+	if ( default_rfile.rfd != rfd ) {
+		UnmapFile_r(&default_rfile);
+		CloseIndex_r(&default_rfile);
+	}
+	default_rfile.rfd = rfd;
+	return ReadBlockPtr_r(&default_rfile, block_header, buff, err);
+
+} // End of ReadBlockPtr
+
+/*
+ * Compress the data block in_block into out_block with the codec and level of compress.
+ * wrkmem and zstd_ctx hold the state of the calling thread, the Zstandard context is
+ * created on first use. Returns the size of the compressed data or -2 on error.
+ */
+static int CompressBlock_r(int compress, data_block_header_t *in_block, data_block_header_t *out_block, 
+	void *wrkmem, void **zstd_ctx, char *error) {
+int r;
+unsigned char __LZO_MMODEL *in;
+unsigned char __LZO_MMODEL *out;
+lzo_uint in_len;
+lzo_uint out_len;
+
+	*out_block = *in_block;
+
+	in  = (unsigned char __LZO_MMODEL *)((pointer_addr_t)in_block  + sizeof(data_block_header_t));	
+	out = (unsigned char __LZO_MMODEL *)((pointer_addr_t)out_block + sizeof(data_block_header_t));	
+	in_len = in_block->size;
+
+	switch ( COMPRESSION_CODEC(compress) ) {
+		case LZO_COMPRESSED:
+			r = lzo1x_1_compress(in,in_len,out,&out_len,wrkmem);
+			if (r != LZO_E_OK) {
+				snprintf(error, ERR_SIZE,"compression failed: %d" , r);
+				error[ERR_SIZE-1] = 0;
+				return -2;
+			}
+			break;
+#ifdef HAVE_LIBLZ4
+		case LZ4_COMPRESSED:
+			r = LZ4_compress_default((const char *)in, (char *)out, in_len, LZO_BUFFSIZE - sizeof(data_block_header_t));
+			if ( r <= 0 ) {
+				snprintf(error, ERR_SIZE,"LZ4 compression failed: %d" , r);
+				error[ERR_SIZE-1] = 0;
+				return -2;
+			}
+			out_len = r;
+			break;
+#endif
+#ifdef HAVE_LIBZSTD
+		case ZSTD_COMPRESSED: {
+			size_t len;
+			if ( !*zstd_ctx ) {
+				*zstd_ctx = ZSTD_createCCtx();
+				if ( !*zstd_ctx ) {
+					snprintf(error, ERR_SIZE,"Compression ZSTD_createCCtx() failed.");
+					error[ERR_SIZE-1] = 0;
+					return -2;
+				}
+			}
+			len = ZSTD_compressCCtx((ZSTD_CCtx *)*zstd_ctx, out, LZO_BUFFSIZE - sizeof(data_block_header_t), in, in_len, 
+				COMPRESSION_LEVEL(compress));
+			if ( ZSTD_isError(len) ) {
+				snprintf(error, ERR_SIZE,"Zstandard compression failed: %s" , ZSTD_getErrorName(len));
+				error[ERR_SIZE-1] = 0;
+				return -2;
+			}
+			out_len = len;
+			} break;
+#endif
+		default:
+			snprintf(error, ERR_SIZE,"compression codec %d not available" , COMPRESSION_CODEC(compress));
+			error[ERR_SIZE-1] = 0;
+			return -2;
+	}
+
+	out_block->size = out_len;
+	return out_len;
+
+} // End of CompressBlock_r
+
+/*
+ * Columnar blocks - see block type 3 in nffile.h
+ */
+#define ADDR_SIZE(flags)	(((flags) & FLAG_IPV6_ADDR) ? 16 : 4)
+#define PACKETS_SIZE(flags)	(((flags) & FLAG_PKG_64) ? 8 : 4)
+
+static const struct column_desc_s {
+	uint16_t	width;		// size of plain or dictionary encoded values
+	uint16_t	encoding;	// encoding written
+} column_desc[NUM_COLUMNS] = {
+	{ 2, COL_ENC_DICT },	// COL_TYPE
+	{ 2, COL_ENC_DICT },	// COL_SIZE
+	{ 0, COL_ENC_BYTES },	// COL_OTHER
+	{ 1, COL_ENC_DICT },	// COL_FLAGS
+	{ 1, COL_ENC_DICT },	// COL_EXPORTER
+	{ 2, COL_ENC_DICT },	// COL_EXT_MAP
+	{ 0, COL_ENC_VARINT },	// COL_MSEC_FIRST
+	{ 0, COL_ENC_VARINT },	// COL_MSEC_LAST
+	{ 0, COL_ENC_DELTA },	// COL_FIRST
+	{ 0, COL_ENC_DELTA },	// COL_LAST
+	{ 1, COL_ENC_DICT },	// COL_FWD_STATUS
+	{ 1, COL_ENC_DICT },	// COL_TCP_FLAGS
+	{ 1, COL_ENC_DICT },	// COL_PROT
+	{ 1, COL_ENC_DICT },	// COL_TOS
+	{ 2, COL_ENC_DICT },	// COL_SRCPORT
+	{ 2, COL_ENC_DICT },	// COL_DSTPORT
+	{ 0, COL_ENC_BYTES },	// COL_SRCADDR
+	{ 0, COL_ENC_BYTES },	// COL_DSTADDR
+	{ 0, COL_ENC_VARINT },	// COL_PACKETS
+	{ 0, COL_ENC_VARINT },	// COL_BYTES
+	{ 0, COL_ENC_BYTES },	// COL_EXTENSIONS
+};
+
+// value of a record for the column id
+static uint64_t ColumnValue(common_record_t *record, int id) {
+uint8_t		*p;
+uint64_t	value;
+uint32_t	value32;
+
+	switch (id) {
+		case COL_TYPE:
+			return record->type;
+		case COL_SIZE:
+			return record->size;
+		case COL_FLAGS:
+			return record->flags;
+		case COL_EXPORTER:
+			return record->exporter_ref;
+		case COL_EXT_MAP:
+			return record->ext_map;
+		case COL_MSEC_FIRST:
+			return record->msec_first;
+		case COL_MSEC_LAST:
+			return record->msec_last;
+		case COL_FIRST:
+			return record->first;
+		case COL_LAST:
+			return record->last;
+		case COL_FWD_STATUS:
+			return record->fwd_status;
+		case COL_TCP_FLAGS:
+			return record->tcp_flags;
+		case COL_PROT:
+			return record->prot;
+		case COL_TOS:
+			return record->tos;
+		case COL_SRCPORT:
+			return record->srcport;
+		case COL_DSTPORT:
+			return record->dstport;
+		case COL_PACKETS:
+		case COL_BYTES:
+			p = (uint8_t *)record->data + 2 * ADDR_SIZE(record->flags);
+			if ( id == COL_BYTES ) {
+				p += PACKETS_SIZE(record->flags);
+				if ( record->flags & FLAG_BYTES_64 ) {
+					memcpy((void *)&value, p, sizeof(uint64_t));
+					return value;
+				}
+			} else if ( record->flags & FLAG_PKG_64 ) {
+				memcpy((void *)&value, p, sizeof(uint64_t));
+				return value;
+			}
+			memcpy((void *)&value32, p, sizeof(uint32_t));
+			return value32;
+	}
+
+	return 0;
+
+} // End of ColumnValue
+
+// field of a record for a column of type COL_ENC_BYTES
+static uint8_t *ColumnField(common_record_t *record, int id, uint32_t *size) {
+uint8_t		*p = (uint8_t *)record->data;
+uint32_t	addr_size = ADDR_SIZE(record->flags);
+
+	switch (id) {
+		case COL_OTHER:
+			*size = record->size;
+			return (uint8_t *)record;
+		case COL_SRCADDR:
+			*size = addr_size;
+			return p;
+		case COL_DSTADDR:
+			*size = addr_size;
+			return p + addr_size;
+		case COL_EXTENSIONS:
+			*size = record->size - COMMON_RECORD_FIXED_SIZE(record->flags);
+			return (uint8_t *)record + COMMON_RECORD_FIXED_SIZE(record->flags);
+	}
+
+	*size = 0;
+	return p;
+
+} // End of ColumnField
+
+static inline uint8_t *PutVarint(uint8_t *p, uint64_t value) {
+
+	while ( value >= 0x80 ) {
+		*p++ = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	*p++ = value;
+
+	return p;
+
+} // End of PutVarint
+
+static inline void PutValue(uint8_t *p, uint64_t value, uint16_t width) {
+
+	if ( width == 1 ) {
+		*p = value;
+	} else {
+		uint16_t v = value;
+		memcpy(p, (void *)&v, sizeof(uint16_t));
+	}
+
+} // End of PutValue
+
+static inline uint64_t GetValue(uint8_t *p, uint16_t width) {
+uint16_t v;
+
+	if ( width == 1 )
+		return *p;
+
+	memcpy((void *)&v, p, sizeof(uint16_t));
+	return v;
+
+} // End of GetValue
+
+/*
+ * Encode column id of the records of in_block at p. Columns with more than COLUMN_DICT_SIZE distinct
+ * values are stored plain instead of dictionary encoded. Returns the end of the column or NULL,
+ * if the column does not fit before end.
+ */
+static uint8_t *EncodeColumn(data_block_header_t *in_block, int id, column_header_t *column_header, uint8_t *p, uint8_t *end) {
+common_record_t	*record;
+uint64_t		value, previous;
+uint32_t		i, num_values, size;
+uint16_t		width, encoding, dict[COLUMN_DICT_SIZE], lookup[1 << 16];
+uint8_t			*field;
+int				all_records, other_records;
+
+	width	 = column_desc[id].width;
+	encoding = column_desc[id].encoding;
+	all_records	  = id == COL_TYPE || id == COL_SIZE;
+	other_records = id == COL_OTHER;
+
+#define FOR_EACH_RECORD \
+	for ( i=0, record = (common_record_t *)((pointer_addr_t)in_block + sizeof(data_block_header_t)); i < in_block->NumRecords; \
+		i++, record = (common_record_t *)((pointer_addr_t)record + record->size) ) \
+		if ( all_records || (record->type == CommonRecordType) != other_records )
+
+	num_values = 0;
+	if ( encoding == COL_ENC_DICT ) {
+		// lookup holds the dictionary index + 1 of a value
+		memset((void *)lookup, 0, (1 << (8 * width)) * sizeof(uint16_t));
+		FOR_EACH_RECORD {
+			value = ColumnValue(record, id);
+			if ( lookup[value] )
+				continue;
+			if ( num_values == COLUMN_DICT_SIZE ) {
+				encoding = COL_ENC_PLAIN;
+				break;
+			}
+			dict[num_values++] = value;
+			lookup[value] = num_values;
+		}
+	}
+
+	if ( encoding == COL_ENC_DICT ) {
+		uint16_t n = num_values;
+		if ( (end - p) < sizeof(uint16_t) + num_values * width )
+			return NULL;
+		memcpy(p, (void *)&n, sizeof(uint16_t));
+		p += sizeof(uint16_t);
+		for ( i=0; i < num_values; i++ ) {
+			PutValue(p, dict[i], width);
+			p += width;
+		}
+	}
+
+	previous = 0;
+	FOR_EACH_RECORD {
+		switch (encoding) {
+			case COL_ENC_PLAIN:
+				if ( (end - p) < width )
+					return NULL;
+				PutValue(p, ColumnValue(record, id), width);
+				p += width;
+				break;
+			case COL_ENC_DICT:
+				if ( p >= end )
+					return NULL;
+				*p++ = lookup[ColumnValue(record, id)] - 1;
+				break;
+			case COL_ENC_VARINT:
+				if ( (end - p) < 10 )
+					return NULL;
+				p = PutVarint(p, ColumnValue(record, id));
+				break;
+			case COL_ENC_DELTA: {
+				int64_t delta;
+				if ( (end - p) < 10 )
+					return NULL;
+				value = ColumnValue(record, id);
+				delta = (int64_t)value - (int64_t)previous;
+				p = PutVarint(p, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+				previous = value;
+				} break;
+			case COL_ENC_BYTES:
+				field = ColumnField(record, id, &size);
+				if ( (end - p) < size )
+					return NULL;
+				memcpy(p, field, size);
+				p += size;
+				break;
+		}
+	}
+#undef FOR_EACH_RECORD
+
+	column_header->id		= id;
+	column_header->encoding = encoding;
+
+	return p;
+
+} // End of EncodeColumn
+
+/*
+ * Encode the records of the block type 2 in_block into the columnar block type 3 out_block.
+ * out_block needs BUFFSIZE bytes of data. Returns the size of the columnar block or 0, if
+ * the block can not be encoded or the columnar block is not smaller.
+ */
+int EncodeColumnBlock(data_block_header_t *in_block, data_block_header_t *out_block) {
+common_record_t	*record;
+column_header_t	*column_header;
+uint8_t			*in, *out, *end, *p, *column;
+uint32_t		i, num_columns;
+int				id;
+
+	in	= (uint8_t *)((pointer_addr_t)in_block + sizeof(data_block_header_t));
+	out = (uint8_t *)((pointer_addr_t)out_block + sizeof(data_block_header_t));
+	end = out + in_block->size;
+
+	if ( in_block->id != DATA_BLOCK_TYPE_2 || in_block->NumRecords == 0 )
+		return 0;
+
+	// the columns rely on the record sizes - keep blocks with broken records as they are
+	record = (common_record_t *)in;
+	for ( i=0; i < in_block->NumRecords; i++ ) {
+		if ( record->size < sizeof(record_header_t) || ((uint8_t *)record + record->size) > (in + in_block->size) )
+			return 0;
+		if ( record->type == CommonRecordType && record->size < COMMON_RECORD_FIXED_SIZE(record->flags) )
+			return 0;
+		record = (common_record_t *)((pointer_addr_t)record + record->size);
+	}
+
+	num_columns = NUM_COLUMNS;
+	column_header = (column_header_t *)(out + sizeof(uint32_t));
+	p = (uint8_t *)&column_header[num_columns];
+	if ( p > end )
+		return 0;
+	memcpy(out, (void *)&num_columns, sizeof(uint32_t));
+
+	for ( id=0; id < NUM_COLUMNS; id++ ) {
+		column = p;
+		p = EncodeColumn(in_block, id, &column_header[id], p, end);
+		if ( !p )
+			return 0;
+		column_header[id].size = p - column;
+		// columns are 32bit aligned
+		while ( (p - out) & 0x3 ) {
+			if ( p >= end )
+				return 0;
+			*p++ = 0;
+		}
+	}
+
+	if ( p >= end )
+		return 0;
+
+	*out_block		 = *in_block;
+	out_block->id	 = DATA_BLOCK_TYPE_3;
+	out_block->size	 = p - out;
+
+	return out_block->size;
+
+} // End of EncodeColumnBlock
+
+column_reader_t *NewColumnReader(void) {
+column_reader_t *reader;
+
+	reader = (column_reader_t *)calloc(1, sizeof(column_reader_t));
+	if ( !reader ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	return reader;
+
+} // End of NewColumnReader
+
+void DisposeColumnReader(column_reader_t *reader) {
+
+	if ( reader )
+		free(reader);
+
+} // End of DisposeColumnReader
+
+/*
+ * Prepare reader to decode the columns selected by columns of the block type 3 in data.
+ * Returns 1 on success, 0 if the block is corrupt.
+ */
+int OpenColumnBlock(column_reader_t *reader, data_block_header_t *block_header, void *data, uint32_t columns) {
+column_header_t	*column_header;
+column_t		*column;
+uint8_t			*p, *end;
+uint32_t		i, j, num_columns, found, required, pad;
+
+	p	= (uint8_t *)data;
+	end = p + block_header->size;
+
+	if ( block_header->size < sizeof(uint32_t) )
+		return 0;
+	memcpy((void *)&num_columns, p, sizeof(uint32_t));
+	if ( num_columns > (block_header->size - sizeof(uint32_t)) / sizeof(column_header_t) )
+		return 0;
+	column_header = (column_header_t *)(p + sizeof(uint32_t));
+	p = (uint8_t *)&column_header[num_columns];
+
+	found = 0;
+	for ( i=0; i < num_columns; i++ ) {
+		uint16_t id		  = column_header[i].id;
+		uint16_t encoding = column_header[i].encoding;
+		if ( column_header[i].size > (end - p) )
+			return 0;
+
+		// columns unknown to this version are skipped
+		if ( id < NUM_COLUMNS ) {
+			uint16_t width = column_desc[id].width;
+			if ( (encoding == COL_ENC_BYTES) != (column_desc[id].encoding == COL_ENC_BYTES) || encoding > COL_ENC_BYTES ||
+				 ((encoding == COL_ENC_PLAIN || encoding == COL_ENC_DICT) && width == 0) )
+				return 0;
+
+			column = &reader->column[id];
+			column->ptr		 = p;
+			column->end		 = p + column_header[i].size;
+			column->encoding = encoding;
+			column->value	 = 0;
+			if ( encoding == COL_ENC_DICT ) {
+				uint16_t n;
+				if ( column_header[i].size < sizeof(uint16_t) )
+					return 0;
+				memcpy((void *)&n, p, sizeof(uint16_t));
+				if ( n > COLUMN_DICT_SIZE || sizeof(uint16_t) + n * width > column_header[i].size )
+					return 0;
+				for ( j=0; j < n; j++ )
+					column->dict[j] = GetValue(p + sizeof(uint16_t) + j * width, width);
+				column->dict_size = n;
+				column->ptr = p + sizeof(uint16_t) + n * width;
+			}
+			found |= COLUMN(id);
+		}
+
+		pad = (column_header[i].size + 3) & ~0x3;
+		p += pad < (end - p) ? pad : (end - p);
+	}
+
+	required = COLUMN(COL_TYPE) | COLUMN(COL_SIZE) | COLUMN(COL_OTHER) | COLUMN(COL_FLAGS);
+	columns = (columns & COLUMNS_ALL) | required;
+	if ( (found & columns) != columns )
+		return 0;
+
+	reader->NumRecords = block_header->NumRecords;
+	reader->record	   = 0;
+	reader->columns	   = columns;
+	reader->chunk_pos  = 0;
+	reader->chunk_len  = 0;
+	reader->sizes	   = reader->size;
+
+	return 1;
+
+} // End of OpenColumnBlock
+
+// Decode the varint at p into *value - the caller checked, that p < end
+// Returns the end of the varint or NULL, if the varint is corrupt
+static inline uint8_t *GetVarint(uint8_t *p, uint8_t *end, uint64_t *value) {
+uint64_t	v;
+int			shift;
+
+	v = 0;
+	shift = 0;
+	if ( (end - p) >= 10 ) {
+		// no bounds check needed for the longest varint
+		do {
+			uint8_t b = *p++;
+			v |= (uint64_t)(b & 0x7f) << shift;
+			if ( (b & 0x80) == 0 ) {
+				*value = v;
+				return p;
+			}
+			shift += 7;
+		} while ( shift < 70 );
+		return NULL;
+	}
+
+	while ( p < end && shift < 64 ) {
+		uint8_t b = *p++;
+		v |= (uint64_t)(b & 0x7f) << shift;
+		if ( (b & 0x80) == 0 ) {
+			*value = v;
+			return p;
+		}
+		shift += 7;
+	}
+
+	return NULL;
+
+} // End of GetVarint
+
+/*
+ * Decode the next num values of column id into values, an array of num elements of width 1, 2, 4 or 8 bytes.
+ * Values are truncated to width. Returns 1 on success, 0 if the column is corrupt.
+ */
+int DecodeColumn(column_reader_t *reader, int id, void *values, uint32_t width, uint32_t num) {
+column_t	*column = &reader->column[id];
+uint8_t		*p, *end;
+uint64_t	v, previous;
+uint32_t	i;
+
+#define DECODE_VALUES(decode) \
+	switch (width) { \
+		case 1: { uint8_t *out = (uint8_t *)values; \
+			for ( i=0; i < num; i++ ) { decode; out[i] = v; } } break; \
+		case 2: { uint16_t *out = (uint16_t *)values; \
+			for ( i=0; i < num; i++ ) { decode; out[i] = v; } } break; \
+		case 4: { uint32_t *out = (uint32_t *)values; \
+			for ( i=0; i < num; i++ ) { decode; out[i] = v; } } break; \
+		case 8: { uint64_t *out = (uint64_t *)values; \
+			for ( i=0; i < num; i++ ) { decode; out[i] = v; } } break; \
+		default: \
+			return 0; \
+	}
+
+// one byte varints are the common case
+#define DECODE_VARINT \
+	if ( p >= end ) \
+		return 0; \
+	if ( *p < 0x80 ) \
+		v = *p++; \
+	else if ( (p = GetVarint(p, end, &v)) == NULL ) \
+		return 0;
+
+	p	= column->ptr;
+	end = column->end;
+	switch (column->encoding) {
+		case COL_ENC_PLAIN: {
+			uint16_t w = column_desc[id].width;
+			if ( (end - p) < num * w )
+				return 0;
+			DECODE_VALUES(v = GetValue(p, w); p += w);
+			} break;
+		case COL_ENC_DICT: {
+			uint16_t *dict = column->dict;
+			uint16_t dict_size = column->dict_size;
+			if ( (end - p) < num )
+				return 0;
+			DECODE_VALUES(if ( p[i] >= dict_size ) return 0; v = dict[p[i]]);
+			p += num;
+			} break;
+		case COL_ENC_VARINT:
+			DECODE_VALUES(DECODE_VARINT);
+			break;
+		case COL_ENC_DELTA:
+			previous = column->value;
+			DECODE_VALUES(DECODE_VARINT; previous += (v >> 1) ^ (~(v & 1) + 1); v = previous);
+			column->value = previous;
+			break;
+		default:
+			return 0;
+	}
+#undef DECODE_VALUES
+#undef DECODE_VARINT
+
+	column->ptr = p;
+	return 1;
+
+} // End of DecodeColumn
+
+/*
+ * Return the next size bytes of the column id of type COL_ENC_BYTES or NULL, if the column is corrupt
+ */
+void *ColumnBytes(column_reader_t *reader, int id, uint32_t size) {
+column_t	*column = &reader->column[id];
+uint8_t		*p = column->ptr;
+
+	if ( (column->end - p) < size )
+		return NULL;
+	column->ptr += size;
+
+	return (void *)p;
+
+} // End of ColumnBytes
+
+/*
+ * Advance to the next records of the block. If the next record is a common record, the run of consecutive
+ * common records, at most max, is returned and their sizes are in reader->sizes. The caller decodes the
+ * selected columns of the run with DecodeColumn() and ColumnBytes(). Otherwise *record is set to the next
+ * record, which is not a common record, and 1 is returned.
+ * Returns the number of records, 0 at the end of the block or -1 if the block is corrupt.
+ */
+int NextColumnRecords(column_reader_t *reader, uint32_t max, void **record) {
+uint32_t	i, n;
+
+	*record = NULL;
+	if ( reader->record >= reader->NumRecords )
+		return 0;
+
+	if ( reader->chunk_pos == reader->chunk_len ) {
+		n = reader->NumRecords - reader->record;
+		if ( n > COLUMN_CHUNK )
+			n = COLUMN_CHUNK;
+		if ( !DecodeColumn(reader, COL_TYPE, reader->type, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_SIZE, reader->size, sizeof(uint16_t), n) )
+			return -1;
+		reader->chunk_pos = 0;
+		reader->chunk_len = n;
+	}
+
+	i = reader->chunk_pos;
+	if ( reader->size[i] < sizeof(record_header_t) )
+		return -1;
+	reader->sizes = &reader->size[i];
+
+	if ( reader->type[i] != CommonRecordType ) {
+		*record = ColumnBytes(reader, COL_OTHER, reader->size[i]);
+		if ( !*record )
+			return -1;
+		reader->chunk_pos++;
+		reader->record++;
+		return 1;
+	}
+
+	n = 0;
+	while ( (i + n) < reader->chunk_len && n < max && reader->type[i + n] == CommonRecordType )
+		n++;
+
+	reader->chunk_pos += n;
+	reader->record	  += n;
+
+	return n;
+
+} // End of NextColumnRecords
+
+/*
+ * Decode the columnar block type 3 in into the records of a block type 2 in out. out needs BUFFSIZE bytes.
+ * The block header is updated. Returns the size of the decoded block or -1, if the block is corrupt.
+ */
+int DecodeColumnBlock(column_reader_t *reader, data_block_header_t *block_header, void *in, void *out) {
+uint8_t		*p, *end, *src, *dst, *ext;
+void		*record;
+uint32_t	i, n, addr_size, ext_size;
+int			ret;
+uint64_t	packets[COLUMN_CHUNK], bytes[COLUMN_CHUNK];
+uint32_t	first[COLUMN_CHUNK], last[COLUMN_CHUNK];
+uint16_t	ext_map[COLUMN_CHUNK], msec_first[COLUMN_CHUNK], msec_last[COLUMN_CHUNK], srcport[COLUMN_CHUNK], dstport[COLUMN_CHUNK];
+uint8_t		flags[COLUMN_CHUNK], exporter_ref[COLUMN_CHUNK], fwd_status[COLUMN_CHUNK], tcp_flags[COLUMN_CHUNK],
+			prot[COLUMN_CHUNK], tos[COLUMN_CHUNK];
+
+	if ( !OpenColumnBlock(reader, block_header, in, COLUMNS_ALL) )
+		return -1;
+
+	p	= (uint8_t *)out;
+	end = p + BUFFSIZE;
+	while ( (ret = NextColumnRecords(reader, COLUMN_CHUNK, &record)) > 0 ) {
+		if ( record ) {
+			if ( (end - p) < reader->sizes[0] )
+				return -1;
+			memcpy(p, record, reader->sizes[0]);
+			p += reader->sizes[0];
+			continue;
+		}
+
+		n = ret;
+		if ( !DecodeColumn(reader, COL_FLAGS, flags, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_EXPORTER, exporter_ref, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_EXT_MAP, ext_map, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_MSEC_FIRST, msec_first, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_MSEC_LAST, msec_last, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_FIRST, first, sizeof(uint32_t), n) ||
+			 !DecodeColumn(reader, COL_LAST, last, sizeof(uint32_t), n) ||
+			 !DecodeColumn(reader, COL_FWD_STATUS, fwd_status, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_TCP_FLAGS, tcp_flags, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_PROT, prot, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_TOS, tos, sizeof(uint8_t), n) ||
+			 !DecodeColumn(reader, COL_SRCPORT, srcport, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_DSTPORT, dstport, sizeof(uint16_t), n) ||
+			 !DecodeColumn(reader, COL_PACKETS, packets, sizeof(uint64_t), n) ||
+			 !DecodeColumn(reader, COL_BYTES, bytes, sizeof(uint64_t), n) )
+			return -1;
+
+		for ( i=0; i < n; i++ ) {
+			common_record_t *common = (common_record_t *)p;
+			uint16_t size = reader->sizes[i];
+
+			if ( size < COMMON_RECORD_FIXED_SIZE(flags[i]) || (end - p) < size )
+				return -1;
+			addr_size = ADDR_SIZE(flags[i]);
+			ext_size  = size - COMMON_RECORD_FIXED_SIZE(flags[i]);
+			src = ColumnBytes(reader, COL_SRCADDR, addr_size);
+			dst = ColumnBytes(reader, COL_DSTADDR, addr_size);
+			ext = ColumnBytes(reader, COL_EXTENSIONS, ext_size);
+			if ( !src || !dst || !ext )
+				return -1;
+
+			common->type		 = CommonRecordType;
+			common->size		 = size;
+			common->flags		 = flags[i];
+			common->exporter_ref = exporter_ref[i];
+			common->ext_map		 = ext_map[i];
+			common->msec_first	 = msec_first[i];
+			common->msec_last	 = msec_last[i];
+			common->first		 = first[i];
+			common->last		 = last[i];
+			common->fwd_status	 = fwd_status[i];
+			common->tcp_flags	 = tcp_flags[i];
+			common->prot		 = prot[i];
+			common->tos			 = tos[i];
+			common->srcport		 = srcport[i];
+			common->dstport		 = dstport[i];
+			p += COMMON_RECORD_DATA_SIZE;
+
+			memcpy(p, src, addr_size);
+			p += addr_size;
+			memcpy(p, dst, addr_size);
+			p += addr_size;
+
+			if ( flags[i] & FLAG_PKG_64 ) {
+				memcpy(p, (void *)&packets[i], sizeof(uint64_t));
+				p += sizeof(uint64_t);
+			} else {
+				*((uint32_t *)p) = packets[i];
+				p += sizeof(uint32_t);
+			}
+			if ( flags[i] & FLAG_BYTES_64 ) {
+				memcpy(p, (void *)&bytes[i], sizeof(uint64_t));
+				p += sizeof(uint64_t);
+			} else {
+				*((uint32_t *)p) = bytes[i];
+				p += sizeof(uint32_t);
+			}
+
+			memcpy(p, ext, ext_size);
+			p += ext_size;
+		}
+	}
+
+	if ( ret < 0 )
+		return -1;
+
+	block_header->id   = DATA_BLOCK_TYPE_2;
+	block_header->size = p - (uint8_t *)out;
+
+	return block_header->size;
+
+} // End of DecodeColumnBlock
+
+/*
+ * Encode the block as columnar block into columns, if requested and smaller, and compress the result into out.
+ * Returns the block to write, which is one of block, columns or out, or NULL on error.
+ */
+static data_block_header_t *PrepareBlock_r(int compress, data_block_header_t *block, data_block_header_t *columns, 
+	data_block_header_t *out, void *wrkmem, void **zstd_ctx, char *error) {
+
+	if ( (compress & COLUMNAR_BLOCKS) && columns && block->id == DATA_BLOCK_TYPE_2 && 
+		 EncodeColumnBlock(block, columns) > 0 ) 
+		block = columns;
+
+	if ( COMPRESSION_CODEC(compress) ) {
+		if ( CompressBlock_r(compress, block, out, wrkmem, zstd_ctx, error) < 0 )
+			return NULL;
+		block = out;
+	}
+
+	return block;
+
+} // End of PrepareBlock_r
+
+int WriteBlock(nffile_t *nffile) {
+data_block_header_t *block_header;
+
+	if ( nffile->writer )
+		return QueueBlock(nffile);
+
+	block_header = PrepareBlock_r(nffile->compress, nffile->block_header, column_buff, (data_block_header_t *)lzo_buff, 
+		wrkmem, &zstd_cctx, error_string);
+	if ( !block_header )
+		return -2;
+
+	return write(nffile->wfd, (void *)block_header, sizeof(data_block_header_t) + block_header->size);
+
+} // End of WriteBlock
+
+static void *CompressWorker(void *arg) {
+blockwriter_t	*writer = (blockwriter_t *)arg;
+write_slot_t	*slot;
+void			*wrkmem, *zstd_ctx;
+char			error[ERR_SIZE];
+
+	// each worker has its own compression state
+	wrkmem	 = malloc(LZO1X_1_MEM_COMPRESS);
+	zstd_ctx = NULL;
+
+	pthread_mutex_lock(&writer->mutex);
+	while ( 1 ) {
+		while ( writer->compressed == writer->queued && !writer->terminate ) 
+			pthread_cond_wait(&writer->cond, &writer->mutex);
+
+		if ( writer->compressed == writer->queued ) 
+			// terminate and nothing left to compress
+			break;
+
+		slot = &writer->slots[writer->compressed % writer->num_slots];
+		writer->compressed++;
+		slot->state = SLOT_BUSY;
+		pthread_mutex_unlock(&writer->mutex);
+
+		slot->error = 0;
+		if ( (slot->compress & COLUMNAR_BLOCKS) && !slot->columns ) 
+			slot->columns = (data_block_header_t *)malloc(BUFFSIZE + sizeof(data_block_header_t));
+		if ( COMPRESSION_CODEC(slot->compress) && !slot->out ) 
+			slot->out = (data_block_header_t *)malloc(LZO_BUFFSIZE);
+		if ( !wrkmem || ((slot->compress & COLUMNAR_BLOCKS) && !slot->columns) || 
+			 (COMPRESSION_CODEC(slot->compress) && !slot->out) ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			slot->error = ENOMEM;
+		} else {
+			slot->data = PrepareBlock_r(slot->compress, slot->block, slot->columns, slot->out, wrkmem, &zstd_ctx, error);
+			if ( !slot->data ) {
+				fprintf(stderr, "%s\n", error);
+				slot->error = EIO;
+			}
+		}
+
+		pthread_mutex_lock(&writer->mutex);
+		slot->state = SLOT_DONE;
+		pthread_cond_broadcast(&writer->cond);
+	}
+	pthread_mutex_unlock(&writer->mutex);
+
+	if ( wrkmem )
+		free(wrkmem);
+#ifdef HAVE_LIBZSTD
+	if ( zstd_ctx )
+		ZSTD_freeCCtx((ZSTD_CCtx *)zstd_ctx);
+#endif
+
+	return NULL;
+
+} // End of CompressWorker
+
+static void *WriteWorker(void *arg) {
+blockwriter_t		*writer = (blockwriter_t *)arg;
+write_slot_t		*slot;
+data_block_header_t *block;
+ssize_t				len;
+int					error;
+
+	pthread_mutex_lock(&writer->mutex);
+	while ( 1 ) {
+		// blocks are written strictly in the order they were queued
+		slot = &writer->slots[writer->written % writer->num_slots];
+		while ( slot->state != SLOT_DONE && !(writer->terminate && writer->written == writer->queued) ) 
+			pthread_cond_wait(&writer->cond, &writer->mutex);
+
+		if ( slot->state != SLOT_DONE )
+			// terminate and all blocks written
+			break;
+		pthread_mutex_unlock(&writer->mutex);
+
+		error = slot->error;
+		if ( !error ) {
+			block = slot->data;
+			len = sizeof(data_block_header_t) + block->size;
+			if ( write(slot->wfd, (void *)block, len) != len ) 
+				error = errno ? errno : EIO;
+		}
+
+		pthread_mutex_lock(&writer->mutex);
+		if ( error && !writer->error )
+			writer->error = error;
+		slot->state = SLOT_FREE;
+		writer->written++;
+		pthread_cond_broadcast(&writer->cond);
+	}
+	pthread_mutex_unlock(&writer->mutex);
+
+	return NULL;
+
+} // End of WriteWorker
+
+/*
+ * Queue the current block of nffile to the writer and continue with an empty buffer
+ * Returns the size of the queued block or -1, if writing a previous block failed
+ */
+static int QueueBlock(nffile_t *nffile) {
+blockwriter_t		*writer = (blockwriter_t *)nffile->writer;
+write_slot_t		*slot;
+data_block_header_t *spare;
+int					size;
+
+	size = sizeof(data_block_header_t) + nffile->block_header->size;
+
+	pthread_mutex_lock(&writer->mutex);
+	slot = &writer->slots[writer->queued % writer->num_slots];
+	while ( slot->state != SLOT_FREE && !writer->error ) 
+		pthread_cond_wait(&writer->cond, &writer->mutex);
+
+	if ( writer->error ) {
+		errno = writer->error;
+		pthread_mutex_unlock(&writer->mutex);
+		return -1;
+	}
+
+	// swap the block with the spare buffer of the slot
+	spare = slot->block;
+	*spare = *(nffile->block_header);
+	slot->block	   = nffile->block_header;
+	slot->wfd	   = nffile->wfd;
+	slot->compress = nffile->compress;
+	slot->state	   = SLOT_QUEUED;
+	writer->queued++;
+	pthread_cond_broadcast(&writer->cond);
+	pthread_mutex_unlock(&writer->mutex);
+
+	nffile->block_header = spare;
+	nffile->writeto		 = (void *)((pointer_addr_t)spare + sizeof(data_block_header_t));
+
+	return size;
+
+} // End of QueueBlock
+
+int StartBlockWriter(nffile_t *nffile, int num_workers) {
+blockwriter_t	*writer;
+int				i, err;
+
+	if ( num_workers <= 0 )
+		return 1;
+
+	writer = (blockwriter_t *)calloc(1, sizeof(blockwriter_t));
+	if ( !writer ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+
+	// enough slots to keep all workers busy, while the writer writes the previous blocks
+	writer->num_slots = 2 * num_workers + 2;
+	writer->slots	  = (write_slot_t *)calloc(writer->num_slots, sizeof(write_slot_t));
+	writer->workers	  = (pthread_t *)calloc(num_workers, sizeof(pthread_t));
+	if ( !writer->slots || !writer->workers ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		DisposeBlockWriter(writer);
+		return 0;
+	}
+	for ( i=0; i < writer->num_slots; i++ ) {
+		writer->slots[i].block = (data_block_header_t *)malloc(BUFFSIZE + sizeof(data_block_header_t));
+		if ( !writer->slots[i].block ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			DisposeBlockWriter(writer);
+			return 0;
+		}
+	}
+
+	pthread_mutex_init(&writer->mutex, NULL);
+	pthread_cond_init(&writer->cond, NULL);
+
+	err = pthread_create(&writer->writer, NULL, WriteWorker, (void *)writer);
+	if ( err ) {
+		fprintf(stderr, "pthread_create() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(err) );
+		DisposeBlockWriter(writer);
+		return 0;
+	}
+	writer->running = 1;
+
+	for ( i=0; i < num_workers; i++ ) {
+		err = pthread_create(&writer->workers[i], NULL, CompressWorker, (void *)writer);
+		if ( err ) {
+			fprintf(stderr, "pthread_create() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(err) );
+			break;
+		}
+		writer->num_workers++;
+	}
+	if ( writer->num_workers == 0 ) {
+		DisposeBlockWriter(writer);
+		return 0;
+	}
+
+	nffile->writer = (void *)writer;
+	return 1;
+
+} // End of StartBlockWriter
+
+int FlushBlockWriter(nffile_t *nffile) {
+blockwriter_t *writer = (blockwriter_t *)nffile->writer;
+int	error;
+
+	if ( !writer )
+		return 1;
+
+	pthread_mutex_lock(&writer->mutex);
+	while ( writer->written != writer->queued ) 
+		pthread_cond_wait(&writer->cond, &writer->mutex);
+	error = writer->error;
+	// the error is reported once, continue with the next file
+	writer->error = 0;
+	pthread_mutex_unlock(&writer->mutex);
+
+	if ( error ) {
+		errno = error;
+		return 0;
+	}
+
+	return 1;
+
+} // End of FlushBlockWriter
+
+int StopBlockWriter(nffile_t *nffile) {
+int ret;
+
+	if ( !nffile->writer )
+		return 1;
 
-		} else {
-			// finally - we are done for now
-			return read_bytes + buff_bytes;
-		}
-	
-		/* not reached */
+	ret = FlushBlockWriter(nffile);
+	DisposeBlockWriter((blockwriter_t *)nffile->writer);
+	nffile->writer = NULL;
 
-} // End of ReadBlock
+	return ret;
 
-int WriteBlock(nffile_t *nffile) {
-data_block_header_t *out_block_header;
-int r;
-unsigned char __LZO_MMODEL *in;
-unsigned char __LZO_MMODEL *out;
-lzo_uint in_len;
-lzo_uint out_len;
+} // End of StopBlockWriter
 
-	if ( !nffile->compress ) {
-		return write(nffile->wfd, (void *)nffile->block_header, sizeof(data_block_header_t) + nffile->block_header->size);
-	} 
+static void DisposeBlockWriter(blockwriter_t *writer) {
+int i;
 
-	out_block_header = (data_block_header_t *)lzo_buff;
-	*out_block_header = *(nffile->block_header);
+	if ( writer->running ) {
+		pthread_mutex_lock(&writer->mutex);
+		writer->terminate = 1;
+		pthread_cond_broadcast(&writer->cond);
+		pthread_mutex_unlock(&writer->mutex);
 
-	in  = (unsigned char __LZO_MMODEL *)((pointer_addr_t)nffile->block_header     + sizeof(data_block_header_t));	
-	out = (unsigned char __LZO_MMODEL *)((pointer_addr_t)out_block_header + sizeof(data_block_header_t));	
-	in_len = nffile->block_header->size;
-	r = lzo1x_1_compress(in,in_len,out,&out_len,wrkmem);
+		for ( i=0; i < writer->num_workers; i++ ) 
+			pthread_join(writer->workers[i], NULL);
+		pthread_join(writer->writer, NULL);
 
-	if (r != LZO_E_OK) {
-		snprintf(error_string, ERR_SIZE,"compression failed: %d" , r);
-		error_string[ERR_SIZE-1] = 0;
-		return -2;
+		pthread_mutex_destroy(&writer->mutex);
+		pthread_cond_destroy(&writer->cond);
 	}
 
-	out_block_header->size = out_len;
-	return write(nffile->wfd, (void *)out_block_header, sizeof(data_block_header_t) + out_block_header->size);
+	if ( writer->slots ) {
+		for ( i=0; i < writer->num_slots; i++ ) {
+			if ( writer->slots[i].block )
+				free(writer->slots[i].block);
+			if ( writer->slots[i].columns )
+				free(writer->slots[i].columns);
+			if ( writer->slots[i].out )
+				free(writer->slots[i].out);
+		}
+		free(writer->slots);
+	}
+	if ( writer->workers )
+		free(writer->workers);
+	free(writer);
 
-} // End of WriteBlock
+} // End of DisposeBlockWriter
 
 
 inline void ExpandRecord_v1(common_record_t *input_record, master_record_t *output_record ) {
@@ -717,7 +2464,8 @@ void			*buff_ptr;
 
 	buff_ptr	 = (void *)((pointer_addr_t)nffile.block_header + sizeof(data_block_header_t));
 
-	nffile.compress = file_compressed ? 0 : 1;
+	nffile.compress = file_compressed(&default_rfile) ? 0 : 1;
+	nffile.writer	= NULL;
 
 	nffile.wfd = OpenNewFile(outfile, &string, nffile.compress);
 	if ( nffile.wfd < 0 ) {
@@ -730,7 +2478,7 @@ void			*buff_ptr;
 	else
 		printf("Uncompress file .. \n");
 
-	for ( i=0; i < FileHeader.NumBlocks; i++ ) {
+	for ( i=0; i < default_rfile.file_header.NumBlocks; i++ ) {
 		ret = ReadBlock(rfd, nffile.block_header, buff_ptr, &string);
 		if ( ret < 0 ) {
 			fprintf(stderr, "Error while reading data block. Abort.\n");
@@ -749,7 +2497,7 @@ void			*buff_ptr;
 	}
 
 	close(rfd);
-	CloseUpdateFile(nffile.wfd, stat_ptr, FileHeader.NumBlocks, GetIdent(), nffile.compress, &string );
+	CloseUpdateFile(nffile.wfd, stat_ptr, default_rfile.file_header.NumBlocks, GetIdent(), nffile.compress, &string );
 	if ( string != NULL ) {
 		fprintf(stderr, "%s\n", string);
 		close(nffile.wfd);
@@ -768,7 +2516,7 @@ int i, fd;
 stat_record_t *stat_ptr;
 data_block_header_t block_header;
 char	*string;
-uint32_t num_records, type1, type2;
+uint32_t num_records, type1, type2, type3;
 ssize_t	ret;
 
 	fd = OpenFile(filename, &stat_ptr, &string);
@@ -780,10 +2528,11 @@ ssize_t	ret;
 	num_records = 0;
 	type1 = 0;
 	type2 = 0;
+	type3 = 0;
 	printf("File    : %s\n", filename);
-	printf("Version : %u - %s\n", FileHeader.version, file_compressed ? "compressed" : "not compressed");
-	printf("Blocks  : %u\n", FileHeader.NumBlocks);
-	for ( i=0; i < FileHeader.NumBlocks; i++ ) {
+	printf("Version : %u - %s\n", default_rfile.file_header.version, CompressionName(default_rfile.file_header.flags));
+	printf("Blocks  : %u\n", default_rfile.file_header.NumBlocks);
+	for ( i=0; i < default_rfile.file_header.NumBlocks; i++ ) {
 		ret = read(fd, (void *)&block_header, sizeof(data_block_header_t));
 		if ( ret < 0 ) {
 			fprintf(stderr, "Error reading block %i: %s\n", i, strerror(errno));
@@ -797,6 +2546,9 @@ ssize_t	ret;
 			case DATA_BLOCK_TYPE_2:
 				type2++;
 				break;
+			case DATA_BLOCK_TYPE_3:
+				type3++;
+				break;
 			default:
 				printf("block %i has unknown type %u\n", i, block_header.id);
 		}
@@ -808,12 +2560,840 @@ ssize_t	ret;
 	}
 	printf(" Type 1 : %u\n", type1);
 	printf(" Type 2 : %u\n", type2);
+	printf(" Type 3 : %u\n", type3);
 	printf("Records : %u\n", num_records);
 
 	close(fd);
 
 } // End of QueryFile
 
+/*
+ * Bloom filter of the addresses in a file. A key is the hash of an address word 
+ * of the master record and its offset, as compared by the filter engine.
+ */
+#define BLOOM_HASHES		7
+#define BLOOM_BITS_PER_KEY	10
+#define BLOOM_MIN_BITS		1024
+
+/* set of the distinct keys of a file, used to size the bloom filter */
+typedef struct keyset_s {
+	uint64_t	*keys;
+	uint64_t	size;
+	uint64_t	num_keys;
+} keyset_t;
+
+static inline uint64_t BloomHash(uint32_t offset, uint64_t value) {
+uint64_t h = value ^ ((uint64_t)(offset + 1) * 0x9E3779B97F4A7C15ULL);
+
+	// splitmix64 finalizer
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+
+	// 0 marks an empty slot in the key set
+	return h ? h : 1;
+
+} // End of BloomHash
+
+static int AddKey(keyset_t *keyset, uint64_t key) {
+uint64_t i, mask;
+
+	// keep the key set at most half full
+	if ( (keyset->num_keys << 1) >= keyset->size ) {
+		uint64_t *keys, size;
+		size = keyset->size ? keyset->size << 1 : 4096;
+		keys = (uint64_t *)calloc(size, sizeof(uint64_t));
+		if ( !keys ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return 0;
+		}
+		mask = size - 1;
+		for ( i=0; i<keyset->size; i++ ) {
+			uint64_t j;
+			if ( keyset->keys[i] == 0 ) 
+				continue;
+			j = keyset->keys[i] & mask;
+			while ( keys[j] ) 
+				j = (j + 1) & mask;
+			keys[j] = keyset->keys[i];
+		}
+		free(keyset->keys);
+		keyset->keys = keys;
+		keyset->size = size;
+	}
+
+	mask = keyset->size - 1;
+	i = key & mask;
+	while ( keyset->keys[i] ) {
+		if ( keyset->keys[i] == key ) 
+			return 1;
+		i = (i + 1) & mask;
+	}
+	keyset->keys[i] = key;
+	keyset->num_keys++;
+
+	return 1;
+
+} // End of AddKey
+
+static inline void BloomSet(uint64_t *bits, uint64_t num_bits, uint32_t num_hashes, uint64_t h) {
+uint64_t h1, h2, bit;
+uint32_t i;
+
+	h1 = h & 0xffffffffULL;
+	h2 = (h >> 32) | 1;
+	for ( i=0; i<num_hashes; i++ ) {
+		bit = (h1 + i * h2) & (num_bits - 1);
+		bits[bit >> 6] |= 1ULL << (bit & 0x3f);
+	}
+
+} // End of BloomSet
+
+int BloomCheck(bloom_t *bloom, uint32_t offset, uint64_t value) {
+uint64_t h, h1, h2, bit;
+uint32_t i;
+
+	h  = BloomHash(offset, value);
+	h1 = h & 0xffffffffULL;
+	h2 = (h >> 32) | 1;
+	for ( i=0; i<bloom->num_hashes; i++ ) {
+		bit = (h1 + i * h2) & (bloom->num_bits - 1);
+		if ( (bloom->bits[bit >> 6] & (1ULL << (bit & 0x3f))) == 0 ) 
+			return 0;
+	}
+
+	return 1;
+
+} // End of BloomCheck
+
+/*
+ * Write the keys as bloom filter <filename>.bloom. Returns 1 on success, otherwise 0
+ */
+static int WriteBloom(char *filename, keyset_t *keyset, uint64_t file_size) {
+bloom_header_t	bloom_header;
+uint64_t		*bits, num_bits, i;
+char			path[MAXPATHLEN], tmp_path[MAXPATHLEN];
+size_t			size;
+int				fd;
+
+	num_bits = BLOOM_MIN_BITS;
+	while ( num_bits < keyset->num_keys * BLOOM_BITS_PER_KEY ) 
+		num_bits <<= 1;
+
+	size = num_bits >> 3;
+	bits = (uint64_t *)calloc(1, size);
+	if ( !bits ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	for ( i=0; i<keyset->size; i++ ) {
+		if ( keyset->keys[i] ) 
+			BloomSet(bits, num_bits, BLOOM_HASHES, keyset->keys[i]);
+	}
+
+	bloom_header.magic		= BLOOM_MAGIC;
+	bloom_header.version	= BLOOM_VERSION_1;
+	bloom_header.num_hashes	= BLOOM_HASHES;
+	bloom_header.num_bits	= num_bits;
+	bloom_header.file_size	= file_size;
+
+	if ( snprintf(path, MAXPATHLEN, "%s%s", filename, BLOOM_SUFFIX) >= MAXPATHLEN ||
+		 snprintf(tmp_path, MAXPATHLEN, "%s-tmp", path) >= MAXPATHLEN ) {
+		fprintf(stderr, "Path of address filter file too long: %s%s\n" , filename, BLOOM_SUFFIX);
+		free(bits);
+		return 0;
+	}
+
+	fd = open(tmp_path, O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+	if ( fd < 0 ) {
+		fprintf(stderr, "Failed to open file %s: '%s'\n" , tmp_path, strerror(errno));
+		free(bits);
+		return 0;
+	}
+
+	if ( write(fd, (void *)&bloom_header, sizeof(bloom_header_t)) != sizeof(bloom_header_t) ||
+		 write(fd, (void *)bits, size) != (ssize_t)size ||
+		 close(fd) < 0 || rename(tmp_path, path) < 0 ) {
+		fprintf(stderr, "Failed to write address filter file %s: '%s'\n" , path, strerror(errno));
+		unlink(tmp_path);
+		free(bits);
+		return 0;
+	}
+	free(bits);
+
+	return 1;
+
+} // End of WriteBloom
+
+/*
+ * Map the bloom filter <filename>.bloom of a file. Returns NULL, if the file 
+ * has no valid bloom filter
+ */
+bloom_t *OpenBloom(char *filename) {
+struct stat		stat_buf, bloom_stat;
+bloom_header_t	*bloom_header;
+bloom_t			*bloom;
+char			path[MAXPATHLEN];
+void			*map;
+int				fd;
+
+	snprintf(path, MAXPATHLEN, "%s%s", filename, BLOOM_SUFFIX);
+	path[MAXPATHLEN-1] = 0;
+
+	// the bloom filter is optional
+	fd = open(path, O_RDONLY);
+	if ( fd < 0 ) 
+		return NULL;
+
+	// the bloom filter must be newer than the data file
+	if ( stat(filename, &stat_buf) < 0 || fstat(fd, &bloom_stat) < 0 || 
+		 bloom_stat.st_mtime < stat_buf.st_mtime || bloom_stat.st_size < (off_t)sizeof(bloom_header_t) ) {
+		fprintf(stderr, "Skip stale or corrupt address filter file '%s'\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, bloom_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if ( map == MAP_FAILED ) {
+		fprintf(stderr, "mmap() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	bloom_header = (bloom_header_t *)map;
+	if ( bloom_header->magic != BLOOM_MAGIC || bloom_header->version != BLOOM_VERSION_1 ||
+		 bloom_header->file_size != (uint64_t)stat_buf.st_size || bloom_header->num_hashes == 0 ||
+		 bloom_header->num_bits < 64 || (bloom_header->num_bits & (bloom_header->num_bits - 1)) ||
+		 (uint64_t)bloom_stat.st_size != sizeof(bloom_header_t) + (bloom_header->num_bits >> 3) ) {
+		fprintf(stderr, "Skip stale or corrupt address filter file '%s'\n", path);
+		munmap(map, bloom_stat.st_size);
+		return NULL;
+	}
+
+	bloom = (bloom_t *)malloc(sizeof(bloom_t));
+	if ( !bloom ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		munmap(map, bloom_stat.st_size);
+		return NULL;
+	}
+	bloom->map		  = map;
+	bloom->map_size	  = bloom_stat.st_size;
+	bloom->bits		  = (uint64_t *)((pointer_addr_t)map + sizeof(bloom_header_t));
+	bloom->num_bits	  = bloom_header->num_bits;
+	bloom->num_hashes = bloom_header->num_hashes;
+
+	return bloom;
+
+} // End of OpenBloom
+
+void CloseBloom(bloom_t *bloom) {
+
+	if ( !bloom ) 
+		return;
+	munmap(bloom->map, bloom->map_size);
+	free(bloom);
+
+} // End of CloseBloom
+
+/*
+ * Address index of a data directory
+ */
+
+/* postings { key, block } of the file being indexed */
+typedef struct postings_s {
+	ipindex_entry_t	*entries;
+	uint64_t		num_entries;
+	uint64_t		max_entries;
+} postings_t;
+
+// the buckets are selected by the top 8 bits of a key
+#define IPIndexBucket(key) ((uint32_t)((key) >> 56) % IPINDEX_BUCKETS)
+
+uint64_t IPIndexKey(uint32_t offset, uint64_t mask, uint64_t value) {
+
+	// fold the mask into the offset, so host and network keys differ
+	return BloomHash(offset ^ (uint32_t)(mask >> 32) ^ (uint32_t)mask, value & mask);
+
+} // End of IPIndexKey
+
+static int AddPosting(postings_t *postings, uint64_t key, uint32_t file_id, uint32_t block) {
+ipindex_entry_t *entry;
+
+	if ( postings->num_entries == postings->max_entries ) {
+		uint64_t max_entries = postings->max_entries ? postings->max_entries << 1 : 65536;
+		entry = (ipindex_entry_t *)realloc(postings->entries, max_entries * sizeof(ipindex_entry_t));
+		if ( !entry ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return 0;
+		}
+		postings->entries	  = entry;
+		postings->max_entries = max_entries;
+	}
+
+	entry = &postings->entries[postings->num_entries++];
+	entry->key	   = key;
+	entry->file_id = file_id;
+	entry->block   = block;
+
+	return 1;
+
+} // End of AddPosting
+
+static int CompareKey(const void *p1, const void *p2) {
+uint64_t k1 = *(const uint64_t *)p1;
+uint64_t k2 = *(const uint64_t *)p2;
+
+	return k1 == k2 ? 0 : ( k1 < k2 ? -1 : 1 );
+
+} // End of CompareKey
+
+static int CompareKeys(const void *p1, const void *p2) {
+const ipindex_entry_t *e1 = (const ipindex_entry_t *)p1;
+const ipindex_entry_t *e2 = (const ipindex_entry_t *)p2;
+
+	if ( e1->key != e2->key ) 
+		return e1->key < e2->key ? -1 : 1;
+	if ( e1->block != e2->block ) 
+		return e1->block < e2->block ? -1 : 1;
+	return 0;
+
+} // End of CompareKeys
+
+static int CompareBlocks(const void *p1, const void *p2) {
+const ipindex_entry_t *e1 = (const ipindex_entry_t *)p1;
+const ipindex_entry_t *e2 = (const ipindex_entry_t *)p2;
+
+	if ( e1->file_id != e2->file_id ) 
+		return e1->file_id < e2->file_id ? -1 : 1;
+	if ( e1->block != e2->block ) 
+		return e1->block < e2->block ? -1 : 1;
+	if ( e1->key != e2->key ) 
+		return e1->key < e2->key ? -1 : 1;
+	return 0;
+
+} // End of CompareBlocks
+
+/*
+ * Sort the postings from entry first on and remove the duplicates
+ */
+static void UniquePostings(postings_t *postings, uint64_t first) {
+ipindex_entry_t *entries = postings->entries;
+uint64_t		i, j;
+
+	if ( postings->num_entries - first < 2 ) 
+		return;
+
+	qsort(&entries[first], postings->num_entries - first, sizeof(ipindex_entry_t), CompareKeys);
+	j = first;
+	for ( i=first+1; i<postings->num_entries; i++ ) {
+		if ( entries[i].key != entries[j].key || entries[i].block != entries[j].block ) 
+			entries[++j] = entries[i];
+	}
+	postings->num_entries = j + 1;
+
+} // End of UniquePostings
+
+/*
+ * Find the address index for filename in its directory or a parent directory.
+ * Copies the directory into root and returns the offset of the file name relative
+ * to root in filename, or -1 if no index exists. Directories too long for the 
+ * path of a bucket file are skipped
+ */
+int FindIPIndex(char *filename, char *root, size_t len) {
+struct stat	stat_buf;
+char		path[MAXPATHLEN], *p;
+
+	strncpy(root, filename, len);
+	root[len-1] = 0;
+	while ( (p = strrchr(root, '/')) != NULL ) {
+		*p = 0;
+		if ( (p - root) + IPINDEX_PATH_SIZE >= MAXPATHLEN ) 
+			continue;
+		snprintf(path, MAXPATHLEN, "%s/%s", root, IPINDEX_DIR);
+		path[MAXPATHLEN-1] = 0;
+		if ( stat(path, &stat_buf) == 0 && S_ISDIR(stat_buf.st_mode) ) 
+			return (p - root) + 1;
+	}
+
+	// relative file name below the current directory
+	if ( filename[0] != '/' && stat(IPINDEX_DIR, &stat_buf) == 0 && S_ISDIR(stat_buf.st_mode) ) {
+		strncpy(root, ".", len);
+		return 0;
+	}
+
+	return -1;
+
+} // End of FindIPIndex
+
+static int LockIPIndex(int fd, short type) {
+struct flock fl;
+
+	fl.l_type   = type;
+	fl.l_whence = SEEK_SET;
+	fl.l_start  = 0;
+	fl.l_len    = 0;
+	fl.l_pid    = getpid();
+
+	return fcntl(fd, type == F_UNLCK ? F_SETLK : F_SETLKW, &fl);
+
+} // End of LockIPIndex
+
+/*
+ * Append the postings of file name, sorted by key, to the address index in root.
+ * The file record is marked complete after all postings are written, so readers
+ * ignore the postings of an interrupted update. Returns 1 on success, otherwise 0
+ */
+static int AppendIPIndex(char *root, char *name, struct stat *file_stat, uint32_t NumBlocks, postings_t *postings) {
+ipindex_file_t	file_record;
+ipindex_entry_t	*entries = postings->entries;
+struct stat		stat_buf;
+char			path[MAXPATHLEN];
+uint64_t		i, j;
+uint32_t		file_id, bucket;
+off_t			offset;
+ssize_t			size;
+int				fd, bfd, ok;
+
+	if ( strlen(name) >= IPINDEX_NAME_SIZE ) {
+		fprintf(stderr, "File name '%s' too long for the address index\n", name);
+		return 0;
+	}
+
+	if ( strlen(root) + IPINDEX_PATH_SIZE >= MAXPATHLEN ||
+		 snprintf(path, MAXPATHLEN, "%s/%s/%s", root, IPINDEX_DIR, IPINDEX_FILES) >= MAXPATHLEN ) {
+		fprintf(stderr, "Path of address index too long: %s/%s\n", root, IPINDEX_DIR);
+		return 0;
+	}
+	fd = open(path, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+	if ( fd < 0 ) {
+		fprintf(stderr, "Failed to open file %s: '%s'\n" , path, strerror(errno));
+		return 0;
+	}
+
+	// nfcapd and nfdump -k may update the same index
+	if ( LockIPIndex(fd, F_WRLCK) < 0 || fstat(fd, &stat_buf) < 0 ) {
+		fprintf(stderr, "Failed to lock file %s: '%s'\n" , path, strerror(errno));
+		close(fd);
+		return 0;
+	}
+
+	// a partial record of an interrupted update is overwritten
+	file_id = stat_buf.st_size / sizeof(ipindex_file_t);
+	offset	= (off_t)file_id * sizeof(ipindex_file_t);
+
+	memset((void *)&file_record, 0, sizeof(ipindex_file_t));
+	strncpy(file_record.name, name, IPINDEX_NAME_SIZE-1);
+	file_record.file_size = file_stat->st_size;
+	file_record.mtime	  = file_stat->st_mtime;
+	file_record.NumBlocks = NumBlocks;
+	file_record.flags	  = 0;
+	ok = pwrite(fd, (void *)&file_record, sizeof(ipindex_file_t), offset) == sizeof(ipindex_file_t);
+
+	// the entries of a bucket are a contiguous range of the sorted postings
+	for ( i=0; ok && i<postings->num_entries; i=j ) {
+		bucket = IPIndexBucket(entries[i].key);
+		for ( j=i; j<postings->num_entries && IPIndexBucket(entries[j].key) == bucket; j++ ) 
+			entries[j].file_id = file_id;
+
+		// root was checked above - the bucket path fits
+		bfd = -1;
+		if ( snprintf(path, MAXPATHLEN, "%s/%s/%s.%03u", root, IPINDEX_DIR, IPINDEX_BUCKET, bucket) < MAXPATHLEN ) 
+			bfd = open(path, O_CREAT | O_WRONLY | O_APPEND, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+		if ( bfd < 0 || fstat(bfd, &stat_buf) < 0 ) {
+			ok = 0;
+		} else {
+			// cut a partial entry of an interrupted update
+			if ( stat_buf.st_size % sizeof(ipindex_entry_t) ) 
+				ok = ftruncate(bfd, stat_buf.st_size - stat_buf.st_size % sizeof(ipindex_entry_t)) == 0;
+			size = (j - i) * sizeof(ipindex_entry_t);
+			ok = ok && write(bfd, (void *)&entries[i], size) == size;
+		}
+		if ( bfd >= 0 ) 
+			close(bfd);
+	}
+
+	if ( ok ) {
+		file_record.flags = IPINDEX_COMPLETE;
+		ok = pwrite(fd, (void *)&file_record, sizeof(ipindex_file_t), offset) == sizeof(ipindex_file_t);
+	}
+	if ( !ok ) 
+		fprintf(stderr, "Failed to update address index %s/%s: '%s'\n" , root, IPINDEX_DIR, strerror(errno));
+
+	LockIPIndex(fd, F_UNLCK);
+	close(fd);
+
+	return ok;
+
+} // End of AppendIPIndex
+
+/*
+ * Read the table of indexed files of the address index in root.
+ * Returns NULL if the table cannot be read
+ */
+ipindex_file_t *ReadIPIndexFiles(char *root, uint32_t *num_files) {
+ipindex_file_t	*files;
+struct stat		stat_buf;
+char			path[MAXPATHLEN];
+ssize_t			size;
+int				fd;
+
+	*num_files = 0;
+	snprintf(path, MAXPATHLEN, "%s/%s/%s", root, IPINDEX_DIR, IPINDEX_FILES);
+	path[MAXPATHLEN-1] = 0;
+	fd = open(path, O_RDONLY);
+	if ( fd < 0 ) 
+		return NULL;
+
+	if ( fstat(fd, &stat_buf) < 0 ) {
+		close(fd);
+		return NULL;
+	}
+
+	size  = (stat_buf.st_size / sizeof(ipindex_file_t)) * sizeof(ipindex_file_t);
+	files = (ipindex_file_t *)malloc(size ? size : sizeof(ipindex_file_t));
+	if ( !files ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		close(fd);
+		return NULL;
+	}
+
+	if ( read(fd, (void *)files, size) != size ) {
+		fprintf(stderr, "Failed to read address index %s: '%s'\n" , path, strerror(errno));
+		free(files);
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+
+	*num_files = size / sizeof(ipindex_file_t);
+	return files;
+
+} // End of ReadIPIndexFiles
+
+/*
+ * Look up the sorted keys in the address index in root. Returns the postings
+ * sorted by file id, block and key, or NULL on error
+ */
+ipindex_entry_t *LookupIPIndex(char *root, uint64_t *keys, uint32_t num_keys, uint64_t *num_entries) {
+postings_t		postings;
+ipindex_entry_t	*buff;
+char			path[MAXPATHLEN];
+uint32_t		i, j, bucket;
+ssize_t			size, k;
+int				fd, ok;
+
+#define LOOKUP_ENTRIES 4096
+	*num_entries = 0;
+	memset((void *)&postings, 0, sizeof(postings_t));
+	buff = (ipindex_entry_t *)malloc(LOOKUP_ENTRIES * sizeof(ipindex_entry_t));
+	if ( !buff ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	// the keys of a bucket are a contiguous range of the sorted keys
+	ok = 1;
+	for ( i=0; ok && i<num_keys; i=j ) {
+		bucket = IPIndexBucket(keys[i]);
+		for ( j=i; j<num_keys && IPIndexBucket(keys[j]) == bucket; j++ ) 
+			;
+
+		snprintf(path, MAXPATHLEN, "%s/%s/%s.%03u", root, IPINDEX_DIR, IPINDEX_BUCKET, bucket);
+		path[MAXPATHLEN-1] = 0;
+		fd = open(path, O_RDONLY);
+		if ( fd < 0 ) {
+			// no address of this bucket indexed yet
+			if ( errno == ENOENT ) 
+				continue;
+			fprintf(stderr, "Failed to open file %s: '%s'\n" , path, strerror(errno));
+			ok = 0;
+			break;
+		}
+
+		while ( ok && (size = read(fd, (void *)buff, LOOKUP_ENTRIES * sizeof(ipindex_entry_t))) > 0 ) {
+			for ( k=0; ok && k < size / (ssize_t)sizeof(ipindex_entry_t); k++ ) {
+				if ( bsearch(&buff[k].key, &keys[i], j - i, sizeof(uint64_t), CompareKey) ) 
+					ok = AddPosting(&postings, buff[k].key, buff[k].file_id, buff[k].block);
+			}
+		}
+		if ( size < 0 ) {
+			fprintf(stderr, "Failed to read address index %s: '%s'\n" , path, strerror(errno));
+			ok = 0;
+		}
+		close(fd);
+	}
+	free(buff);
+
+	if ( !ok ) {
+		free(postings.entries);
+		return NULL;
+	}
+
+	// empty result
+	if ( !postings.entries ) {
+		postings.entries = (ipindex_entry_t *)malloc(sizeof(ipindex_entry_t));
+		if ( !postings.entries ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return NULL;
+		}
+	}
+
+	qsort(postings.entries, postings.num_entries, sizeof(ipindex_entry_t), CompareBlocks);
+	*num_entries = postings.num_entries;
+
+	return postings.entries;
+
+} // End of LookupIPIndex
+
+/*
+ * Add the address words of a flow record to the key set and the postings
+ * of block, if postings is not NULL
+ */
+static int AddAddressKeys(keyset_t *keyset, postings_t *postings, common_record_t *record, uint32_t block) {
+master_record_t	master_record;
+uint64_t		*words = (uint64_t *)&master_record;
+uint32_t		offset;
+
+	// fill the addresses as ExpandRecord_v2 does
+	if ( (record->flags & FLAG_IPV6_ADDR) != 0 ) {
+		memcpy((void *)master_record.v6.srcaddr, (void *)record->data, 4 * sizeof(uint64_t));
+	} else {
+		uint32_t *u = (uint32_t *)record->data;
+		master_record.v6.srcaddr[0] = 0;
+		master_record.v6.srcaddr[1] = 0;
+		master_record.v4.srcaddr	= u[0];
+
+		master_record.v6.dstaddr[0] = 0;
+		master_record.v6.dstaddr[1] = 0;
+		master_record.v4.dstaddr	= u[1];
+	}
+
+	if ( !AddKey(keyset, BloomHash(OffsetSrcIPv6a, words[OffsetSrcIPv6a])) ||
+		 !AddKey(keyset, BloomHash(OffsetSrcIPv6b, words[OffsetSrcIPv6b])) ||
+		 !AddKey(keyset, BloomHash(OffsetDstIPv6a, words[OffsetDstIPv6a])) ||
+		 !AddKey(keyset, BloomHash(OffsetDstIPv6b, words[OffsetDstIPv6b])) ) 
+		return 0;
+
+	if ( !postings ) 
+		return 1;
+
+	for ( offset=OffsetSrcIPv6a; offset<=OffsetDstIPv6b; offset++ ) {
+		uint64_t word = words[offset];
+		if ( offset == OffsetSrcIPv6a || offset == OffsetDstIPv6a ) {
+			// the upper word of all IPv4 addresses is 0 - not worth a posting
+			if ( word && !AddPosting(postings, IPIndexKey(offset, MaskIPv6, word), 0, block) ) 
+				return 0;
+		} else {
+			if ( !AddPosting(postings, IPIndexKey(offset, MaskIPv6, word), 0, block) ) 
+				return 0;
+			// the /24 network of IPv4 addresses. The filter compares the whole word, so the
+			// network key is added for IPv6 addresses as well
+			if ( !AddPosting(postings, IPIndexKey(offset, IPINDEX_MASK24, word), 0, block) ) 
+				return 0;
+		}
+	}
+
+	return 1;
+
+} // End of AddAddressKeys
+
+/*
+ * Create the block index <filename>.idx of a file: offset, number of records
+ * and time range of each data block, and the bloom filter <filename>.bloom 
+ * of its addresses. If the file is below a directory with an address index,
+ * the addresses of each block are appended to this index.
+ * Returns 1 on success, otherwise 0
+ */
+int IndexFile(char *filename) {
+rfile_t				*rfile;
+index_header_t		index_header;
+index_record_t		*index, *index_record;
+data_block_header_t	block_header;
+struct stat			stat_buf;
+common_record_t		*record;
+keyset_t			keyset;
+postings_t			postings, *block_postings;
+void				*buff, *block, *block_end;
+char				*err, path[MAXPATHLEN], tmp_path[MAXPATHLEN], root[MAXPATHLEN];
+uint32_t			num_blocks, max_blocks, i;
+off_t				offset;
+uint64_t			block_start;
+int					fd, ret, addr_valid, done, rel_name;
+
+	memset((void *)&keyset, 0, sizeof(keyset_t));
+	memset((void *)&postings, 0, sizeof(postings_t));
+	rel_name = FindIPIndex(filename, root, MAXPATHLEN);
+	block_postings = rel_name >= 0 ? &postings : NULL;
+	rfile = NewRFile();
+	buff  = malloc(BUFFSIZE);
+	max_blocks = 64;
+	index = (index_record_t *)malloc(max_blocks * sizeof(index_record_t));
+	if ( !rfile || !buff || !index ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		DisposeRFile(rfile);
+		free(buff);
+		free(index);
+		return 0;
+	}
+
+	fd = OpenFile_r(rfile, filename, NULL, &err);
+	if ( fd < 0 || fstat(fd, &stat_buf) < 0 ) {
+		if ( err ) 
+			fprintf(stderr, "%s\n", err);
+		DisposeRFile(rfile);
+		free(buff);
+		free(index);
+		return 0;
+	}
+
+	// the address filter covers all flows or is not written
+	addr_valid = 1;
+	num_blocks = 0;
+	done = 0;
+	while ( !done ) {
+		offset = rfile->map ? (off_t)rfile->map_offset : lseek(fd, 0, SEEK_CUR);
+		block  = buff;
+		ret = ReadBlockPtr_r(rfile, &block_header, &block, &err);
+		if ( ret == NF_EOF ) 
+			break;
+
+		if ( ret < 0 || offset < 0 ) {
+			if ( ret == NF_CORRUPT ) 
+				fprintf(stderr, "Skip corrupt data file '%s': '%s'\n", filename, err);
+			else
+				fprintf(stderr, "Read error in file '%s': %s\n", filename, strerror(errno));
+			break;
+		}
+
+		if ( num_blocks == max_blocks ) {
+			index_record_t *p;
+			max_blocks <<= 1;
+			p = (index_record_t *)realloc(index, max_blocks * sizeof(index_record_t));
+			if ( !p ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				break;
+			}
+			index = p;
+		}
+
+		index_record = &index[num_blocks++];
+		index_record->offset	 = offset;
+		index_record->NumRecords = block_header.NumRecords;
+		index_record->flags		 = 0;
+		index_record->first_min	 = 0xffffffff;
+		index_record->first_max	 = 0;
+		index_record->last_min	 = 0xffffffff;
+		index_record->last_max	 = 0;
+
+		// v1 blocks are converted by the readers - always read them
+		if ( block_header.id != DATA_BLOCK_TYPE_2 ) {
+			index_record->flags |= INDEX_READ_ALWAYS;
+			addr_valid = 0;
+			continue;
+		}
+
+		record		= (common_record_t *)block;
+		block_end	= (void *)((pointer_addr_t)block + block_header.size);
+		block_start = postings.num_entries;
+		for ( i=0; i < block_header.NumRecords; i++ ) {
+			if ( record->size == 0 || (void *)((pointer_addr_t)record + record->size) > block_end ) {
+				// corrupt block - let the readers deal with it
+				index_record->flags |= INDEX_READ_ALWAYS;
+				addr_valid = 0;
+				break;
+			}
+			if ( record->type == CommonRecordType ) {
+				if ( record->first < index_record->first_min ) 
+					index_record->first_min = record->first;
+				if ( record->first > index_record->first_max ) 
+					index_record->first_max = record->first;
+				if ( record->last < index_record->last_min ) 
+					index_record->last_min = record->last;
+				if ( record->last > index_record->last_max ) 
+					index_record->last_max = record->last;
+				if ( addr_valid && !AddAddressKeys(&keyset, block_postings, record, num_blocks - 1) ) {
+					done = 1;
+					break;
+				}
+			} else if ( record->type == ExtensionMapType ) {
+				// later blocks depend on the maps
+				index_record->flags |= INDEX_READ_ALWAYS;
+			}
+			record = (common_record_t *)((pointer_addr_t)record + record->size);
+		}
+		UniquePostings(&postings, block_start);
+	}
+	DisposeRFile(rfile);
+	free(buff);
+
+	// error while reading the file
+	if ( ret != NF_EOF ) {
+		free(index);
+		free(keyset.keys);
+		free(postings.entries);
+		return 0;
+	}
+
+	index_header.magic		= INDEX_MAGIC;
+	index_header.version	= INDEX_VERSION_1;
+	index_header.NumBlocks	= num_blocks;
+	index_header.file_size	= stat_buf.st_size;
+
+	// write a temporary file and rename it, so readers never see a partial index
+	if ( snprintf(path, MAXPATHLEN, "%s%s", filename, INDEX_SUFFIX) >= MAXPATHLEN ||
+		 snprintf(tmp_path, MAXPATHLEN, "%s-tmp", path) >= MAXPATHLEN ) {
+		fprintf(stderr, "Path of index file too long: %s%s\n" , filename, INDEX_SUFFIX);
+		free(index);
+		free(keyset.keys);
+		free(postings.entries);
+		return 0;
+	}
+
+	fd = open(tmp_path, O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+	if ( fd < 0 ) {
+		fprintf(stderr, "Failed to open file %s: '%s'\n" , tmp_path, strerror(errno));
+		free(index);
+		free(keyset.keys);
+		free(postings.entries);
+		return 0;
+	}
+
+	if ( write(fd, (void *)&index_header, sizeof(index_header_t)) != sizeof(index_header_t) ||
+		 write(fd, (void *)index, num_blocks * sizeof(index_record_t)) != (ssize_t)(num_blocks * sizeof(index_record_t)) ||
+		 close(fd) < 0 || rename(tmp_path, path) < 0 ) {
+		fprintf(stderr, "Failed to write index file %s: '%s'\n" , path, strerror(errno));
+		unlink(tmp_path);
+		free(index);
+		free(keyset.keys);
+		free(postings.entries);
+		return 0;
+	}
+	free(index);
+
+	if ( addr_valid ) {
+		ret = WriteBloom(filename, &keyset, stat_buf.st_size);
+	} else {
+		// remove an old filter, which no longer matches the file
+		snprintf(path, MAXPATHLEN, "%s%s", filename, BLOOM_SUFFIX);
+		path[MAXPATHLEN-1] = 0;
+		unlink(path);
+		ret = 1;
+	}
+	free(keyset.keys);
+
+	// only files with all addresses indexed are resolved through the address index
+	if ( ret && addr_valid && block_postings ) {
+		qsort(postings.entries, postings.num_entries, sizeof(ipindex_entry_t), CompareKeys);
+		ret = AppendIPIndex(root, filename + rel_name, &stat_buf, num_blocks, &postings);
+	}
+	free(postings.entries);
+
+	return ret;
+
+} // End of IndexFile
+
 static int WriteSTDOUTFileheader(void) {
 file_header_t	*file_header;
 size_t			len;
@@ -72,11 +72,19 @@ typedef struct file_header_s {
 #define LAYOUT_VERSION_1	1
 
 	uint32_t	flags;				
-#define NUM_FLAGS		2
+#define NUM_FLAGS		5
 #define FLAG_COMPRESSED 	0x1
 #define FLAG_EXTENDED_STATS 0x2
+#define FLAG_LZ4_COMPRESSED 0x10
+#define FLAG_ZSTD_COMPRESSED 0x20
+#define FLAG_SORTED			0x40
+#define FLAG_COMPRESSION	(FLAG_COMPRESSED | FLAG_LZ4_COMPRESSED | FLAG_ZSTD_COMPRESSED)
 									/*
-										0x1 File is compressed with LZO1X-1 compression
+										0x1  File is compressed with LZO1X-1 compression
+										0x10 File is compressed with LZ4 compression
+										0x20 File is compressed with Zstandard compression
+										At most one compression flag is set.
+										0x40 Records are sorted by their start time ( nfcompact )
 									 */
 	uint32_t	NumBlocks;			// number of data blocks in file
 	char		ident[IdentLen];	// string identifier for this file
@@ -152,6 +160,213 @@ typedef struct data_block_header_s {
 // compat nfdump 1.5.x v1 type
 #define DATA_BLOCK_TYPE_1	1
 #define DATA_BLOCK_TYPE_2	2
+#define DATA_BLOCK_TYPE_3	3
+
+/*
+ * Block type 3:
+ * =============
+ * Columnar data block, written by nfcapd/sfcapd/nfdump -C. It holds the same records as a block type 2, but each 
+ * field of the common records is stored in its own column, which compresses much better and allows to decode only 
+ * the fields needed. NumRecords counts all records of the block as in block type 2. The data starts with the column
+ * directory, followed by the data of the columns in the order of the directory, each padded to 32bit:
+ *
+ *   +-------------+------------------------------+----------+----------+-----+----------+
+ *   | num_columns | column_header[num_columns]   | column 1 | column 2 | ... | column n |
+ *   +-------------+------------------------------+----------+----------+-----+----------+
+ *
+ * COL_TYPE and COL_SIZE have a value for each record. Other records, such as extension maps, are stored unchanged 
+ * in COL_OTHER. All other columns have a value for each common record. Values are in host byte order:
+ *   COL_ENC_PLAIN   fixed size values
+ *   COL_ENC_DICT    uint16_t number of values n, n fixed size values, followed by a uint8_t index for each record
+ *   COL_ENC_VARINT  unsigned LEB128 varints
+ *   COL_ENC_DELTA   zigzag varints of the difference to the previous value
+ *   COL_ENC_BYTES   concatenated fields, the size of each field follows from the record flags and size
+ * The address columns hold 4 or 16 byte addresses according to the record flags. COL_EXTENSIONS holds the optional 
+ * extensions of each record.
+ * ReadBlock_r() and ReadBlockPtr_r() return block type 3 decoded as block type 2, unless rfile->keep_columns is set.
+ */
+typedef struct column_header_s {
+	uint16_t	id;				// COL_*
+	uint16_t	encoding;		// COL_ENC_*
+	uint32_t	size;			// size of the column data without padding
+} column_header_t;
+
+#define COL_ENC_PLAIN	0
+#define COL_ENC_DICT	1
+#define COL_ENC_VARINT	2
+#define COL_ENC_DELTA	3
+#define COL_ENC_BYTES	4
+
+#define COL_TYPE		0
+#define COL_SIZE		1
+#define COL_OTHER		2
+#define COL_FLAGS		3
+#define COL_EXPORTER	4
+#define COL_EXT_MAP		5
+#define COL_MSEC_FIRST	6
+#define COL_MSEC_LAST	7
+#define COL_FIRST		8
+#define COL_LAST		9
+#define COL_FWD_STATUS	10
+#define COL_TCP_FLAGS	11
+#define COL_PROT		12
+#define COL_TOS			13
+#define COL_SRCPORT		14
+#define COL_DSTPORT		15
+#define COL_SRCADDR		16
+#define COL_DSTADDR		17
+#define COL_PACKETS		18
+#define COL_BYTES		19
+#define COL_EXTENSIONS	20
+#define NUM_COLUMNS		21
+
+// column selection of OpenColumnBlock(). COL_TYPE, COL_SIZE, COL_OTHER and COL_FLAGS are always selected
+#define COLUMN(id)			(1 << (id))
+#define COLUMNS_COMMON		(COLUMN(COL_EXPORTER) | COLUMN(COL_EXT_MAP) | COLUMN(COL_MSEC_FIRST) | COLUMN(COL_MSEC_LAST) | \
+							 COLUMN(COL_FIRST) | COLUMN(COL_LAST) | COLUMN(COL_FWD_STATUS) | COLUMN(COL_TCP_FLAGS) | \
+							 COLUMN(COL_PROT) | COLUMN(COL_TOS) | COLUMN(COL_SRCPORT) | COLUMN(COL_DSTPORT))
+#define COLUMNS_ADDR		(COLUMN(COL_SRCADDR) | COLUMN(COL_DSTADDR))
+#define COLUMNS_COUNTERS	(COLUMN(COL_PACKETS) | COLUMN(COL_BYTES))
+#define COLUMNS_ALL			((1 << NUM_COLUMNS) - 1)
+
+// max number of values in a dictionary encoded column
+#define COLUMN_DICT_SIZE	256
+// max number of records returned by NextColumnRecords()
+#define COLUMN_CHUNK		256
+
+/*
+ * Reader of a columnar block. The records are read in runs of common records with NextColumnRecords(),
+ * and the selected columns of each run are decoded one after the other with DecodeColumn() and ColumnBytes().
+ */
+typedef struct column_s {
+	uint8_t		*ptr;			// next value
+	uint8_t		*end;			// end of the column data
+	uint16_t	encoding;
+	uint16_t	dict_size;
+	uint64_t	value;			// previous value of a delta encoded column
+	uint16_t	dict[COLUMN_DICT_SIZE];	// values of a dictionary encoded column
+} column_t;
+
+typedef struct column_reader_s {
+	uint32_t	NumRecords;		// number of records in the block
+	uint32_t	record;			// number of the next record
+	uint32_t	columns;		// COLUMN() bits selected
+	uint32_t	chunk_pos;		// next record in type and size
+	uint32_t	chunk_len;
+	uint16_t	type[COLUMN_CHUNK];	// type and size of the next records
+	uint16_t	size[COLUMN_CHUNK];
+	uint16_t	*sizes;			// sizes of the records returned by NextColumnRecords()
+	column_t	column[NUM_COLUMNS];
+} column_reader_t;
+
+/*
+ * Block index:
+ * ============
+ * The optional sidecar file <file>.idx, created by nfdump -r <file> -k or nfcapd -k, holds an index record for each data 
+ * block of the file. Readers with a time window skip the blocks without flows in the window and seek 
+ * directly to the next relevant block.
+ *
+ *   +-------------+---------------+---------------+-----+---------------+
+ *   |index header | index block 1 | index block 2 | ... | index block n |
+ *   +-------------+---------------+---------------+-----+---------------+
+ */
+#define INDEX_SUFFIX ".idx"
+
+typedef struct index_header_s {
+	uint16_t	magic;				// magic to recognize the index file
+#define INDEX_MAGIC 0xA50D
+	uint16_t	version;			// version of the index layout
+#define INDEX_VERSION_1	1
+	uint32_t	NumBlocks;			// number of index records
+	uint64_t	file_size;			// size of the indexed file, to detect a stale index
+} index_header_t;
+
+typedef struct index_record_s {
+	uint64_t	offset;				// file offset of the data block header
+	uint32_t	NumRecords;			// number of records in the data block
+	uint32_t	flags;
+#define INDEX_READ_ALWAYS	0x1		// block contains extension maps or is not of type 2 - never skipped
+#define INDEX_SKIP			0x2		// in memory: block not selected by SelectBlocks_r
+	uint32_t	first_min;			// time range of the flows in the block
+	uint32_t	first_max;
+	uint32_t	last_min;
+	uint32_t	last_max;
+} index_record_t;
+
+/*
+ * Address filter:
+ * ===============
+ * The optional sidecar file <file>.bloom, created together with the block index, holds a Bloom filter
+ * of the src and dst addresses of all flows in the file. A filter, which requires an address not 
+ * in the Bloom filter, cannot match any flow of the file, so the file is skipped. The keys are the
+ * address words of the master record ( OffsetSrcIPv6a .. OffsetDstIPv6b ) as compared by the filter.
+ *
+ *   +--------------+-----------------------------+
+ *   | bloom header | num_bits / 64 bit words     |
+ *   +--------------+-----------------------------+
+ */
+#define BLOOM_SUFFIX ".bloom"
+
+typedef struct bloom_header_s {
+	uint16_t	magic;				// magic to recognize the bloom file
+#define BLOOM_MAGIC 0xA50E
+	uint16_t	version;			// version of the bloom layout
+#define BLOOM_VERSION_1	1
+	uint32_t	num_hashes;			// number of bits set per key
+	uint64_t	num_bits;			// size of the filter in bits - power of 2
+	uint64_t	file_size;			// size of the filtered file, to detect a stale filter
+} bloom_header_t;
+
+/* handle of a mapped bloom file */
+typedef struct bloom_s {
+	void		*map;
+	size_t		map_size;
+	uint64_t	*bits;
+	uint64_t	num_bits;
+	uint32_t	num_hashes;
+} bloom_t;
+
+/*
+ * Address index:
+ * ==============
+ * The optional directory IPINDEX_DIR in a data directory holds an append-only inverted index of the
+ * addresses of all indexed files below this directory. It is updated by nfcapd -k after each rotation
+ * and by nfdump -k, if the directory exists. A filter on addresses is resolved through the index into
+ * the list of files and data blocks, which may contain matching flows. The block offsets are taken from
+ * the block index <file>.idx. Files not in the index, or changed since, are read as usual.
+ *
+ * IPINDEX_FILES is the table of indexed files. The record number is the file id. A file indexed again
+ * gets a new record - the latest complete record of a file name is valid.
+ *
+ * The postings { key, file id, block } are appended to one of IPINDEX_BUCKETS bucket files selected by
+ * the top bits of the key, so a lookup reads only the buckets of the requested keys. The keys are the
+ * hashes of the address words of the master record ( OffsetSrcIPv6a .. OffsetDstIPv6b ) and of the 
+ * IPv4 /24 networks. An IPv6 /64 network is its upper address word.
+ */
+#define IPINDEX_DIR		".nfindex"
+#define IPINDEX_FILES	"files"
+#define IPINDEX_BUCKET	"bucket"
+#define IPINDEX_BUCKETS	256
+#define IPINDEX_MASK24	0xffffffffffffff00LL	// IPv4 /24 network in the lower address word
+
+#define IPINDEX_NAME_SIZE	128
+// max length of the index paths appended to a data directory: '/.nfindex/bucket.255'
+#define IPINDEX_PATH_SIZE	(1 + sizeof(IPINDEX_DIR) + sizeof(IPINDEX_BUCKET) + 4)
+
+typedef struct ipindex_file_s {
+	char		name[IPINDEX_NAME_SIZE];	// file name relative to the data directory
+	uint64_t	file_size;					// size and modification time of the indexed file,
+	uint64_t	mtime;						// to detect a changed file
+	uint32_t	NumBlocks;					// number of blocks in the block index
+	uint32_t	flags;
+#define IPINDEX_COMPLETE	0x1				// all postings of the file are written
+} ipindex_file_t;
+
+typedef struct ipindex_entry_s {
+	uint64_t	key;
+	uint32_t	file_id;
+	uint32_t	block;
+} ipindex_entry_t;
 
  /*
  * Generic fle handle for writing files
@@ -160,10 +375,59 @@ typedef struct nffile_s {
 	data_block_header_t	*block_header;	// output buffer
 	void				*writeto;		// pointer into buffer for next availabe memory
 	uint32_t			file_blocks;	// number of blocks in file
-	int					compress;		// data compressed flag
+	int					compress;		// compression codec and level, see below
 	int					wfd;			// file id
+	void				*writer;		// block writer pipeline or NULL
 } nffile_t;
 
+/*
+ * Block compression codecs for the compress argument of OpenNewFile(), InitExportFile() and
+ * CloseUpdateFile(). The Zstandard level is kept in the upper bits: ZSTD_COMPRESSION(level).
+ * LZ4 and Zstandard are only available, if nfdump was built with --enable-lz4/--enable-zstd.
+ */
+#define NOT_COMPRESSED		0
+#define LZO_COMPRESSED		1
+#define LZ4_COMPRESSED		2
+#define ZSTD_COMPRESSED		3
+#define ZSTD_COMPRESSION(level)	(ZSTD_COMPRESSED | ((level) << 8))
+#define COMPRESSION_CODEC(compress)	((compress) & 0xff)
+#define COMPRESSION_LEVEL(compress)	(((compress) >> 8) & 0xff)
+// or'ed to the codec: write columnar data blocks of type 3
+#define COLUMNAR_BLOCKS		(1 << 16)
+// or'ed to the codec of CloseUpdateFile(): the records are sorted by time, sets FLAG_SORTED
+#define SORTED_RECORDS		(1 << 17)
+#define ZSTD_DEFAULT_LEVEL	3
+#define ZSTD_MAX_LEVEL		19
+
+// max number of compression workers of a block writer, see StartBlockWriter()
+#define MAXWORKERS			64
+
+ /*
+ * Generic file handle for reading files
+ * All states of a file opened for reading are kept in this handle, such that
+ * several files may be read at the same time, each one with its own handle.
+ */
+typedef struct rfile_s {
+	file_header_t		file_header;	// header of the current file
+	stat_record_t		stat_record;	// stat record of the current file
+	void				*lzo_buff;		// decompression buffer
+	void				*zstd_ctx;		// Zstandard decompression context or NULL
+	void				*column_buff;	// decoding buffer of columnar blocks or NULL
+	column_reader_t		*column_reader;	// reader of columnar blocks or NULL
+	int					keep_columns;	// return columnar blocks undecoded
+	int					rfd;			// file id
+	void				*map;			// mapping of an uncompressed file or NULL
+	size_t				map_size;		// size of the mapping
+	size_t				map_offset;		// offset of the next data block in the mapping
+	index_record_t		*index;			// block index of the file or NULL
+	uint32_t			index_blocks;	// number of blocks in the index
+	uint32_t			block;			// number of the next data block
+	uint32_t			twin_start;		// time window of the index
+	uint32_t			twin_end;
+#define RFILE_ERR_SIZE 256
+	char				error_string[RFILE_ERR_SIZE];
+} rfile_t;
+
 /* 
  * The new block type 2 introduces a changed common record and multiple extension records. This allows a more flexible data
  * storage of netflow v9 records and 3rd party extension to nfdump.
@@ -278,6 +542,10 @@ typedef struct common_record_s {
 } common_record_t;
 #define COMMON_RECORD_DATA_SIZE (sizeof(common_record_t) - sizeof(uint32_t) )
 
+// size of a common record without the optional extensions
+#define COMMON_RECORD_FIXED_SIZE(flags) (COMMON_RECORD_DATA_SIZE + (((flags) & FLAG_IPV6_ADDR) ? 32 : 8) + \
+	(((flags) & FLAG_PKG_64) ? 8 : 4) + (((flags) & FLAG_BYTES_64) ? 8 : 4))
+
  /* 
  * Required extensions:
  * --------------------
@@ -1366,12 +1634,70 @@ void CloseUpdateFile(int fd, stat_record_t *stat_record, uint32_t record_count,
 
 int ReadBlock(int rfd, data_block_header_t *block_header, void *read_buff, char **err);
 
+int ReadBlockPtr(int rfd, data_block_header_t *block_header, void **buff, char **err);
+
+rfile_t *NewRFile(void);
+
+void DisposeRFile(rfile_t *rfile);
+
+int OpenFile_r(rfile_t *rfile, char *filename, stat_record_t **stat_record, char **err);
+
+int ReadBlock_r(rfile_t *rfile, data_block_header_t *block_header, void *read_buff, char **err);
+
+int ReadBlockPtr_r(rfile_t *rfile, data_block_header_t *block_header, void **buff, char **err);
+
+void CloseFile_r(rfile_t *rfile);
+
+int OpenIndex_r(rfile_t *rfile, char *filename, uint32_t twin_start, uint32_t twin_end);
+
+int SelectBlocks_r(rfile_t *rfile, char *filename, uint32_t *blocks, uint32_t num_blocks, uint32_t NumBlocks);
+
+int IndexFile(char *filename);
+
+bloom_t *OpenBloom(char *filename);
+
+int BloomCheck(bloom_t *bloom, uint32_t offset, uint64_t value);
+
+void CloseBloom(bloom_t *bloom);
+
+uint64_t IPIndexKey(uint32_t offset, uint64_t mask, uint64_t value);
+
+int FindIPIndex(char *filename, char *root, size_t len);
+
+ipindex_file_t *ReadIPIndexFiles(char *root, uint32_t *num_files);
+
+ipindex_entry_t *LookupIPIndex(char *root, uint64_t *keys, uint32_t num_keys, uint64_t *num_entries);
+
 int WriteBlock(nffile_t *nffile);
 
+int EncodeColumnBlock(data_block_header_t *in_block, data_block_header_t *out_block);
+
+column_reader_t *NewColumnReader(void);
+
+void DisposeColumnReader(column_reader_t *reader);
+
+int OpenColumnBlock(column_reader_t *reader, data_block_header_t *block_header, void *data, uint32_t columns);
+
+int NextColumnRecords(column_reader_t *reader, uint32_t max, void **record);
+
+int DecodeColumn(column_reader_t *reader, int id, void *values, uint32_t width, uint32_t num);
+
+void *ColumnBytes(column_reader_t *reader, int id, uint32_t size);
+
+int DecodeColumnBlock(column_reader_t *reader, data_block_header_t *block_header, void *in, void *out);
+
+int StartBlockWriter(nffile_t *nffile, int num_workers);
+
+int FlushBlockWriter(nffile_t *nffile);
+
+int StopBlockWriter(nffile_t *nffile);
+
 void UnCompressFile(char * filename);
 
 char *GetIdent(void);
 
+rfile_t *GetRFile(void);
+
 int InitExportFile(char *filename, int compress, nffile_t *nffile );
 
 void ExpandRecord_v1(common_record_t *input_record,master_record_t *output_record );
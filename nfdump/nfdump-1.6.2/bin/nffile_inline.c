@@ -48,7 +48,7 @@ static inline void AppendToBuffer(nffile_t *nffile, void *record, size_t require
 
 static inline void ExpandRecord_v2(common_record_t *input_record, extension_info_t *extension_info, master_record_t *output_record );
 
-static void PackRecord(master_record_t *master_record, nffile_t *nffile);
+static inline void PackRecord(master_record_t *master_record, nffile_t *nffile);
 
 static inline int CheckBufferSpace(nffile_t *nffile, size_t required) {
 
@@ -314,7 +314,7 @@ void		*p = (void *)input_record;
 	
 } // End of ExpandRecord_v2
 
-static void PackRecord(master_record_t *master_record, nffile_t *nffile) {
+static inline void PackRecord(master_record_t *master_record, nffile_t *nffile) {
 extension_map_t *extension_map = master_record->map_ref;
 uint32_t required =  COMMON_RECORD_DATA_SIZE + extension_map->extension_size;
 size_t	 size;
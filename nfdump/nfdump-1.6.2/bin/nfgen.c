@@ -186,6 +186,7 @@ void				*records;
 	nffile.file_blocks 	= 0;
 	nffile.compress 	= 0;
 	nffile.wfd			= 0;
+	nffile.writer		= NULL;
 
 	while ((c = getopt(argc, argv, "h")) != EOF) {
 		switch(c) {
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+/*
+ * nflibtest reads a file with each access method of libnfdump and checks that 
+ * all of them return the same records: get_next_record(), get_next_records() 
+ * with and without a projection, and process_parallel(). The records matching
+ * the filter are summed up and printed as the summary line of nfdump, such 
+ * that test.sh can compare them with nfdump -N.
+ *
+ * usage: nflibtest <file> <filter>
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "libnfdump.h"
+
+#define BATCH_SIZE	7
+#define NUM_WORKERS	3
+
+typedef struct record_sum_s {
+	uint64_t	flows;
+	uint64_t	packets;
+	uint64_t	bytes;
+	uint64_t	check;
+} record_sum_t;
+
+static void SumRecord(record_sum_t *sum, master_record_t *r) {
+
+	sum->flows++;
+	sum->packets += r->dPkts;
+	sum->bytes	 += r->dOctets;
+	sum->check	 += r->srcport ^ ((uint64_t)r->dstport << 16) ^ r->v6.srcaddr[0] ^ r->v6.srcaddr[1] ^ 
+					r->v6.dstaddr[0] ^ r->v6.dstaddr[1];
+
+} // End of SumRecord
+
+static int SameSum(record_sum_t *a, record_sum_t *b, char *method) {
+
+	if ( memcmp((void *)a, (void *)b, sizeof(record_sum_t)) == 0 ) 
+		return 1;
+
+	fprintf(stderr, "%s: %llu flows, %llu packets, %llu bytes - expected %llu flows, %llu packets, %llu bytes\n", method,
+		(unsigned long long)b->flows, (unsigned long long)b->packets, (unsigned long long)b->bytes,
+		(unsigned long long)a->flows, (unsigned long long)a->packets, (unsigned long long)a->bytes);
+	return 0;
+
+} // End of SameSum
+
+static int ReadBatches(char *file, char *filter, uint32_t projection, record_sum_t *sum) {
+libnfstates_t	*states;
+master_record_t	*records;
+int				i, num_records;
+
+	memset((void *)sum, 0, sizeof(record_sum_t));
+	states = initlib(NULL, file, NULL);
+	if ( !states ) 
+		return 0;
+
+	if ( filter && !set_filter(states, filter) ) {
+		libcleanup(states);
+		return 0;
+	}
+	set_projection(states, projection);
+
+	records = (master_record_t *)calloc(BATCH_SIZE, sizeof(master_record_t));
+	if ( !records ) {
+		perror("Memory allocation error");
+		exit(255);
+	}
+
+	while ( (num_records = get_next_records(states, records, BATCH_SIZE)) > 0 ) {
+		for ( i=0; i<num_records; i++ ) 
+			SumRecord(sum, &records[i]);
+	}
+
+	free(records);
+	libcleanup(states);
+
+	return 1;
+
+} // End of ReadBatches
+
+static pthread_mutex_t sum_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void SumRecords(master_record_t *records, int num_records, int thread_id, void *data) {
+record_sum_t *sum = (record_sum_t *)data;
+int i;
+
+	pthread_mutex_lock(&sum_lock);
+	for ( i=0; i<num_records; i++ ) 
+		SumRecord(sum, &records[i]);
+	pthread_mutex_unlock(&sum_lock);
+
+} // End of SumRecords
+
+int main(int argc, char *argv[]) {
+libnfstates_t	*states;
+master_record_t	*r;
+record_sum_t	all, filtered, sum;
+int				ok;
+
+	if ( argc != 3 ) {
+		fprintf(stderr, "usage %s <file> <filter>\n", argv[0]);
+		exit(255);
+	}
+
+	// records one by one as reference
+	memset((void *)&all, 0, sizeof(record_sum_t));
+	states = initlib(NULL, argv[1], NULL);
+	if ( !states ) {
+		fprintf(stderr, "Failed to initialize library\n");
+		exit(255);
+	}
+	while ( (r = get_next_record(states)) != NULL ) 
+		SumRecord(&all, r);
+	libcleanup(states);
+
+	ok = 1;
+	if ( !ReadBatches(argv[1], NULL, LIBNF_FIELD_ALL, &sum) ) 
+		exit(255);
+	ok &= SameSum(&all, &sum, "get_next_records");
+
+	if ( !ReadBatches(argv[1], NULL, LIBNF_FIELD_ADDR | LIBNF_FIELD_COUNTERS, &sum) ) 
+		exit(255);
+	ok &= SameSum(&all, &sum, "set_projection");
+
+	if ( !ReadBatches(argv[1], argv[2], LIBNF_FIELD_ALL, &filtered) ) 
+		exit(255);
+
+	memset((void *)&sum, 0, sizeof(record_sum_t));
+	if ( process_parallel(NULL, argv[1], NULL, argv[2], NUM_WORKERS, SumRecords, (void *)&sum) < 0 ) 
+		exit(255);
+	ok &= SameSum(&filtered, &sum, "process_parallel");
+
+	if ( !ok ) 
+		exit(255);
+
+	printf("Summary: total flows: %llu, total bytes: %llu, total packets: %llu\n", (unsigned long long)filtered.flows,
+		(unsigned long long)filtered.bytes, (unsigned long long)filtered.packets);
+
+	return 0;
+
+} // End of main
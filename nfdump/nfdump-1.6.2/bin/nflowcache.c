@@ -53,6 +53,7 @@
 #endif
 
 #include "nffile.h"
+#include "nfx.h"
 #include "nflowcache.h"
 
 #ifndef DEVEL
@@ -74,7 +75,11 @@ static int MemoryHandle_init(MemoryHandle_t *handle);
 
 static inline void *MemoryHandle_get(MemoryHandle_t *handle, uint32_t size);
 
-static inline FlowTableRecord_t *hash_insert_FlowTable(uint32_t index_cache, void *flowkey, common_record_t *flow_record);
+static inline FlowTableRecord_t *hash_insert_FlowTable(hash_FlowTable *table, uint32_t index_cache, void *flowkey, common_record_t *flow_record);
+
+static inline void slot_insert_FlowTable(FlowTableSlot_t *slot, uint32_t mask, uint32_t hash, FlowTableRecord_t *record);
+
+static void grow_FlowTable(hash_FlowTable *table);
 
 static inline int TimeMsec_CMP(time_t t1, uint16_t offset1, time_t t2, uint16_t offset2 );
 
@@ -82,6 +87,8 @@ static inline uint32_t SuperFastHash (const char * data, int len);
 
 static inline void New_Hash_Key(void *keymem, master_record_t *flow_record, int swap_flow);
 
+static void Merge_FlowRecord(FlowTableRecord_t *r, extension_map_t *map);
+
 /* locals */
 static hash_FlowTable FlowTable;
 static int	initialised = 0;
@@ -272,31 +279,60 @@ hash_FlowTable *GetFlowTable(void) {
 	return &FlowTable;
 } // End of GetFlowTable
 
-int Init_FlowTable(void) {
+static int init_FlowTable(hash_FlowTable *table) {
 uint32_t maxindex;
 
 	maxindex = (1 << HashBits);
-	FlowTable.IndexMask   = maxindex -1;
-	FlowTable.NumBits	  = HashBits;
-	FlowTable.NumRecords  = 0;
-	FlowTable.bucket	  = (FlowTableRecord_t **)calloc(maxindex, sizeof(FlowTableRecord_t *));
-	FlowTable.bucketcache = (FlowTableRecord_t **)calloc(maxindex, sizeof(FlowTableRecord_t *));
-	if ( !FlowTable.bucket || !FlowTable.bucketcache ) {
+	table->IndexMask   = maxindex -1;
+	table->NumBits	   = HashBits;
+	table->NumRecords  = 0;
+	table->MaxRecords  = maxindex - (maxindex >> 2);
+	table->first	   = NULL;
+	table->last		   = NULL;
+	table->keymem	   = NULL;
+	table->bidirkeymem = NULL;
+	table->slot		   = (FlowTableSlot_t *)calloc(maxindex, sizeof(FlowTableSlot_t));
+	if ( !table->slot ) {
 		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror (errno));
 		return 0;
 	}
 
-	FlowTable.keysize = aggregate_key_len;
+	table->keysize = aggregate_key_len;
 
 	// keylen = number of uint64_t 
- 	FlowTable.keylen  = aggregate_key_len >> 3;	// aggregate_key_len / 8
+ 	table->keylen  = aggregate_key_len >> 3;	// aggregate_key_len / 8
 	if ( (aggregate_key_len & 0x7 ) != 0 )
-		FlowTable.keylen++;
+		table->keylen++;
+
+	dbg_printf("FlowTable.keysize %i bytes\n", table->keysize);
+	dbg_printf("FlowTable.keylen %i uint64_t\n", table->keylen);
+
+	if ( !MemoryHandle_init(&table->mem) ) {
+		free((void *)table->slot);
+		table->slot = NULL;
+		return 0;
+	}
+
+	return 1;
+
+} // End of init_FlowTable
+
+static void free_FlowTable(hash_FlowTable *table) {
+
+	free((void *)table->slot);
+	MemoryHandle_free(&table->mem);
+	table->NumRecords  	= 0;
+	table->slot	 		= NULL;
+	table->first 		= NULL;
+	table->last	 		= NULL;
+	table->keymem		= NULL;
+	table->bidirkeymem	= NULL;
 
-	dbg_printf("FlowTable.keysize %i bytes\n", FlowTable.keysize);
-	dbg_printf("FlowTable.keylen %i uint64_t\n", FlowTable.keylen);
+} // End of free_FlowTable
 
-	if ( !MemoryHandle_init(&FlowTable.mem) ) 
+int Init_FlowTable(void) {
+
+	if ( !init_FlowTable(&FlowTable) ) 
 		return 0;
 
 	initialised = 1;
@@ -309,99 +345,202 @@ void Dispose_FlowTable(void) {
 
 	if ( !initialised )
 		return;
-	free((void *)FlowTable.bucket);
-	free((void *)FlowTable.bucketcache);
-	MemoryHandle_free(&FlowTable.mem);
-	FlowTable.NumRecords  	= 0;
-	FlowTable.bucket 		= NULL;
-	FlowTable.bucketcache 	= NULL;
+	free_FlowTable(&FlowTable);
 
 } // End of Dispose_FlowTable
 
+// returns a private table of a worker thread, which aggregates as the global table
+hash_FlowTable *New_FlowTable(void) {
+hash_FlowTable *table;
 
-static inline FlowTableRecord_t *hash_lookup_FlowTable(uint32_t *index_cache, void *flowkey, master_record_t *flow_record) {
-uint32_t			index;
-int bsize;
-FlowTableRecord_t	*record;
+	table = (hash_FlowTable *)calloc(1, sizeof(hash_FlowTable));
+	if ( !table ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror (errno));
+		return NULL;
+	}
 
-	*index_cache = SuperFastHash((char *)flowkey, FlowTable.keysize);
-	index = *index_cache & FlowTable.IndexMask;
+	// the aggregation masks are set by ParseAggregateMask for the global table
+	memcpy((void *)table->IPmask, (void *)FlowTable.IPmask, sizeof(FlowTable.IPmask));
+	table->has_masks	 = FlowTable.has_masks;
+	table->apply_netbits = FlowTable.apply_netbits;
 
-	if ( FlowTable.bucket[index] == NULL ) {
-		hash_hit++;
+	if ( !init_FlowTable(table) ) {
+		free((void *)table);
 		return NULL;
 	}
 
-	record = FlowTable.bucket[index];
+	return table;
 
-	// skip records with different hash value ( full 32bit )
-	while ( record )
-		if ( record->hash != *index_cache ) {
-			hash_skip++;
-			record = record->next;
-		} else
-			break;
+} // End of New_FlowTable
 
-	bsize = 0;
-	while ( record ) {
-		uint64_t	*k1 = (uint64_t *)flowkey;
-		uint64_t	*k2 = (uint64_t *)record->hash_key;
-		int i;
-		
-		// compare key and break as soon as keys do not match
-		i = 0;
-		while ( i < FlowTable.keylen ) {
-			if ( k1[i] == k2[i] )
-				i++;
-			else
-				break;
+void Dispose_FlowTable_r(hash_FlowTable *table) {
+
+	if ( !table ) 
+		return;
+	free_FlowTable(table);
+	free((void *)table);
+
+} // End of Dispose_FlowTable_r
+
+/*
+ * Robin Hood probing: a record is stored at the first free slot after its home slot, but takes 
+ * the slot of a record closer to its own home slot, which then moves on. So the distances of 
+ * all records to their home slots stay short and a lookup stops at the first record closer to 
+ * its home slot than the key would be.
+ */
+static inline void slot_insert_FlowTable(FlowTableSlot_t *slot, uint32_t mask, uint32_t hash, FlowTableRecord_t *record) {
+uint32_t index, dist, slot_dist;
+
+	index = hash & mask;
+	dist  = 0;
+	while ( slot[index].record ) {
+		slot_dist = (index - slot[index].hash) & mask;
+		if ( slot_dist < dist ) {
+			// take the slot and continue with the displaced record
+			FlowTableSlot_t tmp = slot[index];
+			slot[index].hash   = hash;
+			slot[index].record = record;
+			hash   = tmp.hash;
+			record = tmp.record;
+			dist   = slot_dist;
 		}
-		loopcnt += i;
+		index = (index + 1) & mask;
+		dist++;
+	}
+	slot[index].hash   = hash;
+	slot[index].record = record;
 
-		if ( i == FlowTable.keylen ) {
-			// hit - record found
-		
-			// some stats for debugging
-			if ( bsize == 0 )
-				hash_hit++;
-			else
-				hash_miss++;
-			return record;
+} // End of slot_insert_FlowTable
+
+// double the index. The records are moved by their stored hash, the keys are not hashed again
+static void grow_FlowTable(hash_FlowTable *table) {
+FlowTableSlot_t *slot;
+uint32_t i, maxindex, mask;
+
+	if ( table->NumBits >= MaxHashBits ) {
+		// keep the index - the probes get longer, but the records still fit
+		table->MaxRecords = table->IndexMask;
+		return;
+	}
+
+	maxindex = (table->IndexMask + 1) << 1;
+	mask	 = maxindex - 1;
+	slot = (FlowTableSlot_t *)calloc(maxindex, sizeof(FlowTableSlot_t));
+	if ( !slot ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror (errno));
+		exit(255);
+	}
+
+	for ( i=0; i <= table->IndexMask; i++ ) {
+		if ( table->slot[i].record ) 
+			slot_insert_FlowTable(slot, mask, table->slot[i].hash, table->slot[i].record);
+	}
+	free((void *)table->slot);
+
+	dbg_printf("Grow FlowTable index to %u slots\n", maxindex);
+	table->slot		  = slot;
+	table->IndexMask  = mask;
+	table->NumBits++;
+	table->MaxRecords = maxindex - (maxindex >> 2);
+
+} // End of grow_FlowTable
+
+static inline FlowTableRecord_t *hash_lookup_FlowTable(hash_FlowTable *table, uint32_t hash, void *flowkey) {
+uint32_t			index, dist;
+FlowTableSlot_t		*slot;
+
+	index = hash & table->IndexMask;
+
+	dist = 0;
+	while ( 1 ) {
+		slot = &table->slot[index];
+
+		// an empty slot or a record closer to its home slot ends the search
+		if ( slot->record == NULL || ((index - slot->hash) & table->IndexMask) < dist ) {
+			hash_hit++;
+			return NULL;
 		}
 
-		record = record->next;
-		bsize++;
+		if ( slot->hash == hash ) {
+			uint64_t	*k1 = (uint64_t *)flowkey;
+			uint64_t	*k2 = (uint64_t *)slot->record->hash_key;
+			int i;
+		
+			// compare key and break as soon as keys do not match
+			i = 0;
+			while ( i < table->keylen ) {
+				if ( k1[i] == k2[i] )
+					i++;
+				else
+					break;
+			}
+			loopcnt += i;
+
+			if ( i == table->keylen ) {
+				// hit - record found
+		
+				// some stats for debugging
+				if ( dist == 0 )
+					hash_hit++;
+				else
+					hash_miss++;
+				return slot->record;
+			}
+		} else
+			hash_skip++;
+
+		index = (index + 1) & table->IndexMask;
+		dist++;
 	}
-	return NULL;
+
+	/* not reached */
 
 } // End of hash_lookup_FlowTable
 
 
-inline static FlowTableRecord_t *hash_insert_FlowTable(uint32_t index_cache, void *flowkey, common_record_t *raw_record) {
+inline static FlowTableRecord_t *hash_insert_FlowTable(hash_FlowTable *table, uint32_t index_cache, void *flowkey, common_record_t *raw_record) {
 FlowTableRecord_t	*record;
-uint32_t index = index_cache & FlowTable.IndexMask;
+
+	if ( table->NumRecords >= table->MaxRecords ) 
+		grow_FlowTable(table);
 
 	// allocate enough memory for the new flow including all additional information in FlowTableRecord_t
 	// MemoryHandle_get always succeeds. If no memory, MemoryHandle_get already exists cleanly
-	record = MemoryHandle_get(&FlowTable.mem, sizeof(FlowTableRecord_t) - sizeof(common_record_t) + raw_record->size);
+	record = MemoryHandle_get(&table->mem, sizeof(FlowTableRecord_t) - sizeof(common_record_t) + raw_record->size);
 
 	record->next 	 = NULL;
 	record->hash 	 = index_cache;
 	record->hash_key = flowkey;
 
 	memcpy((void *)&record->flowrecord, (void *)raw_record, raw_record->size);
-	if ( FlowTable.bucket[index] == NULL ) 
-		FlowTable.bucket[index] = record;
+	if ( table->first == NULL ) 
+		table->first = record;
 	else 
-		FlowTable.bucketcache[index]->next = record;
+		table->last->next = record;
+	table->last = record;
 
-	FlowTable.bucketcache[index] = record;
-  	FlowTable.NumRecords++;
+	slot_insert_FlowTable(table->slot, table->IndexMask, index_cache, record);
+  	table->NumRecords++;
 
 	return record;
 
 } // End of hash_insert_FlowTable
 
+// allocates the memory for the next key in table
+static inline void *new_key_FlowTable(hash_FlowTable *table) {
+void *keymem;
+
+	keymem = MemoryHandle_get(&table->mem, table->keysize);
+	// the last aligned word may not be fully used. set it to 0 to guarantee
+	// a proper comarison
+
+	// for 64 bit arch int == 8 bytes otherwise 4
+	((int *)keymem)[table->keylen-1] = 0;
+
+	return keymem;
+
+} // End of new_key_FlowTable
+
 void InsertFlow(common_record_t *raw_record, master_record_t *flow_record) {
 FlowTableRecord_t	*record;
 
@@ -413,13 +552,13 @@ FlowTableRecord_t	*record;
 	record->hash 	 = 0;
 	record->hash_key = NULL;
 
+	// the records are not looked up - append them to the list only
 	memcpy((void *)&record->flowrecord, (void *)raw_record, raw_record->size);
-	if ( FlowTable.bucket[0] == NULL ) 
-		FlowTable.bucket[0] = record;
+	if ( FlowTable.first == NULL ) 
+		FlowTable.first = record;
 	else 
-		FlowTable.bucketcache[0]->next = record;
-
-	FlowTable.bucketcache[0] = record;
+		FlowTable.last->next = record;
+	FlowTable.last = record;
 	
 	// safe the extension map reference
 	record->map_ref = flow_record->map_ref;
@@ -436,24 +575,23 @@ FlowTableRecord_t	*record;
 
 
 void AddFlow(common_record_t *raw_record, master_record_t *flow_record ) {
-static void			*keymem = NULL, *bidirkeymem = NULL;
-FlowTableRecord_t	*FlowTableRecord;
-uint32_t			index_cache; 
 
-	if ( keymem == NULL ) {
-		keymem = MemoryHandle_get(&FlowTable.mem ,FlowTable.keysize );
-		// the last aligned word may not be fully used. set it to 0 to guarantee
-		// a proper comarison
+	AddFlow_r(&FlowTable, raw_record, flow_record);
 
-		// for 64 bit arch int == 8 bytes otherwise 4
-		((int *)keymem)[FlowTable.keylen-1] = 0;
+} // End of AddFlow
 
-	}
+void AddFlow_r(hash_FlowTable *table, common_record_t *raw_record, master_record_t *flow_record ) {
+FlowTableRecord_t	*FlowTableRecord;
+uint32_t			index_cache; 
+
+	if ( table->keymem == NULL ) 
+		table->keymem = new_key_FlowTable(table);
 
-	New_Hash_Key(keymem, flow_record, 0);
+	New_Hash_Key(table->keymem, flow_record, 0);
 
 	// Update netflow statistics
-	FlowTableRecord = hash_lookup_FlowTable(&index_cache, keymem, flow_record);
+	index_cache = SuperFastHash((char *)table->keymem, table->keysize);
+	FlowTableRecord = hash_lookup_FlowTable(table, index_cache, table->keymem);
 	if ( FlowTableRecord ) {
 		// flow record found - best case! update all fields
 		FlowTableRecord->counter[INBYTES]    += flow_record->dOctets;
@@ -477,7 +615,7 @@ uint32_t			index_cache;
 
 	} else if ( !bidir_flows || ( flow_record->prot != IPPROTO_TCP && flow_record->prot != IPPROTO_UDP) ) {
 		// no flow record found and no TCP/UDP bidir flows. Insert flow record into hash
-		FlowTableRecord = hash_insert_FlowTable(index_cache, keymem, raw_record);
+		FlowTableRecord = hash_insert_FlowTable(table, index_cache, table->keymem, raw_record);
 
 		FlowTableRecord->counter[INBYTES]	 = flow_record->dOctets;
 		FlowTableRecord->counter[INPACKETS]  = flow_record->dPkts;
@@ -486,27 +624,24 @@ uint32_t			index_cache;
 		FlowTableRecord->counter[FLOWS]   	 = flow_record->aggr_flows ? flow_record->aggr_flows : 1;
 
 		FlowTableRecord->map_ref  	 		 = flow_record->map_ref;
+		FlowTableRecord->file				 = table->file;
+		FlowTableRecord->first_flows		 = FlowTableRecord->counter[FLOWS];
 
 		// keymen got part of the cache
-		keymem = NULL;
+		table->keymem = NULL;
 	} else {
 		// for bidir flows do
 		uint32_t	bidir_index_cache; 
 
 		// use tmp memory for bidir hash key to search for bidir flow
 		// we need it only to lookup 
-		if ( bidirkeymem == NULL ) {
-			bidirkeymem = MemoryHandle_get(&FlowTable.mem ,FlowTable.keysize );
-			// the last aligned word may not be fully used. set it to 0 to guarantee
-			// a proper comarison
-
-			// for 64 bit arch int == 8 bytes otherwise 4
-			((int *)bidirkeymem)[FlowTable.keylen-1] = 0;
-		}
+		if ( table->bidirkeymem == NULL ) 
+			table->bidirkeymem = new_key_FlowTable(table);
 
 		// generate the hash key for reverse record (bidir)
-		New_Hash_Key(bidirkeymem, flow_record, 1);
-		FlowTableRecord = hash_lookup_FlowTable(&bidir_index_cache, bidirkeymem, flow_record);
+		New_Hash_Key(table->bidirkeymem, flow_record, 1);
+		bidir_index_cache = SuperFastHash((char *)table->bidirkeymem, table->keysize);
+		FlowTableRecord = hash_lookup_FlowTable(table, bidir_index_cache, table->bidirkeymem);
 		if ( FlowTableRecord ) {
 			// we found a corresponding flow - so update all fields in reverse direction
 			FlowTableRecord->counter[OUTBYTES]   += flow_record->dOctets;
@@ -530,7 +665,7 @@ uint32_t			index_cache;
 		} else {
 			// no bidir flow found 
 			// insert original flow into the cache
-			FlowTableRecord = hash_insert_FlowTable(index_cache, keymem, raw_record);
+			FlowTableRecord = hash_insert_FlowTable(table, index_cache, table->keymem, raw_record);
 	
 			FlowTableRecord->counter[INBYTES]	 = flow_record->dOctets;
 			FlowTableRecord->counter[INPACKETS]  = flow_record->dPkts;
@@ -538,13 +673,147 @@ uint32_t			index_cache;
 			FlowTableRecord->counter[OUTPACKETS] = flow_record->out_pkts;
 			FlowTableRecord->counter[FLOWS]   	 = flow_record->aggr_flows ? flow_record->aggr_flows : 1;
 			FlowTableRecord->map_ref  	 		 = flow_record->map_ref;
+			FlowTableRecord->file				 = table->file;
+			FlowTableRecord->first_flows		 = FlowTableRecord->counter[FLOWS];
 
-			keymem = NULL;
+			table->keymem = NULL;
 		}
 
 	} 
 
-} // End of AddFlow
+} // End of AddFlow_r
+
+/*
+ * Merge the worker record r with the extension map map of the global list into the global table.
+ * The records of the files are merged in the order of the file sequence, so the first record of
+ * a flow in the global table is the same as if the files were read sequentially.
+ */
+static void Merge_FlowRecord(FlowTableRecord_t *r, extension_map_t *map) {
+FlowTableRecord_t	*FlowTableRecord;
+void				*keymem;
+uint32_t			hash;
+int					reverse;
+
+	FlowTableRecord = hash_lookup_FlowTable(&FlowTable, r->hash, r->hash_key);
+	reverse = 0;
+	if ( !FlowTableRecord && bidir_flows && 
+		 ( r->flowrecord.prot == IPPROTO_TCP || r->flowrecord.prot == IPPROTO_UDP ) ) {
+		Default_key_t *key = (Default_key_t *)r->hash_key;
+		Default_key_t *bidir_key;
+
+		if ( FlowTable.bidirkeymem == NULL ) 
+			FlowTable.bidirkeymem = new_key_FlowTable(&FlowTable);
+
+		// reverse key of the flow
+		memcpy(FlowTable.bidirkeymem, r->hash_key, FlowTable.keylen << 3);
+		bidir_key = (Default_key_t *)FlowTable.bidirkeymem;
+		bidir_key->srcaddr[0] = key->dstaddr[0];
+		bidir_key->srcaddr[1] = key->dstaddr[1];
+		bidir_key->dstaddr[0] = key->srcaddr[0];
+		bidir_key->dstaddr[1] = key->srcaddr[1];
+		bidir_key->srcport	  = key->dstport;
+		bidir_key->dstport	  = key->srcport;
+
+		hash = SuperFastHash((char *)FlowTable.bidirkeymem, FlowTable.keysize);
+		FlowTableRecord = hash_lookup_FlowTable(&FlowTable, hash, FlowTable.bidirkeymem);
+		reverse = 1;
+	}
+
+	if ( FlowTableRecord ) {
+		if ( reverse ) {
+			FlowTableRecord->counter[OUTBYTES]   += r->counter[INBYTES];
+			FlowTableRecord->counter[OUTPACKETS] += r->counter[INPACKETS];
+			FlowTableRecord->counter[INBYTES]    += r->counter[OUTBYTES];
+			FlowTableRecord->counter[INPACKETS]  += r->counter[OUTPACKETS];
+		} else {
+			FlowTableRecord->counter[INBYTES]    += r->counter[INBYTES];
+			FlowTableRecord->counter[INPACKETS]  += r->counter[INPACKETS];
+			FlowTableRecord->counter[OUTBYTES]   += r->counter[OUTBYTES];
+			FlowTableRecord->counter[OUTPACKETS] += r->counter[OUTPACKETS];
+		}
+
+		if ( TimeMsec_CMP(r->flowrecord.first, r->flowrecord.msec_first, 
+				FlowTableRecord->flowrecord.first, FlowTableRecord->flowrecord.msec_first) == 2) {
+			FlowTableRecord->flowrecord.first = r->flowrecord.first;
+			FlowTableRecord->flowrecord.msec_first = r->flowrecord.msec_first;
+		}
+		if ( TimeMsec_CMP(r->flowrecord.last, r->flowrecord.msec_last, 
+				FlowTableRecord->flowrecord.last, FlowTableRecord->flowrecord.msec_last) == 1) {
+			FlowTableRecord->flowrecord.last = r->flowrecord.last;
+			FlowTableRecord->flowrecord.msec_last = r->flowrecord.msec_last;
+		}
+
+		// the first record of r is no longer the first of the flow - AddFlow counts it as 1
+		FlowTableRecord->counter[FLOWS] += r->counter[FLOWS] - r->first_flows + 1;
+		FlowTableRecord->flowrecord.tcp_flags |= r->flowrecord.tcp_flags;
+	} else {
+		// new flow - copy the record and its key into the global table
+		keymem = MemoryHandle_get(&FlowTable.mem, FlowTable.keysize);
+		memcpy(keymem, r->hash_key, FlowTable.keylen << 3);
+
+		FlowTableRecord = hash_insert_FlowTable(&FlowTable, r->hash, keymem, &r->flowrecord);
+		memcpy((void *)FlowTableRecord->counter, (void *)r->counter, sizeof(r->counter));
+		FlowTableRecord->map_ref	 = map;
+		FlowTableRecord->file		 = r->file;
+		FlowTableRecord->first_flows = r->first_flows;
+	}
+
+} // End of Merge_FlowRecord
+
+/*
+ * Merge the records of the num_tables worker tables into the global table. Records with the same
+ * key are combined as AddFlow combines them. Each worker reads whole files in the order of the file
+ * sequence, so the records of the tables are merged file by file in the order of the sequence. The
+ * global table then holds the same flows in the same order as if the files were read by one thread.
+ * For bidirectional flows the records of both directions are combined, the direction of the record 
+ * already in the global table is kept.
+ * The extension maps of the worker records are replaced by the maps of extension_map_list.
+ */
+void Merge_FlowTables(hash_FlowTable **tables, int num_tables, extension_map_list_t *extension_map_list) {
+FlowTableRecord_t	**next, *r;
+extension_map_t		*worker_map, *map;
+uint32_t			file;
+int					i, t;
+
+	next = (FlowTableRecord_t **)calloc(num_tables, sizeof(FlowTableRecord_t *));
+	if ( !next ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		exit(250);
+	}
+	for ( i=0; i < num_tables; i++ ) 
+		next[i] = tables[i] ? tables[i]->first : NULL;
+
+	worker_map = NULL;
+	map		   = NULL;
+	while ( 1 ) {
+		// the table with the earliest file of the remaining records
+		t = -1;
+		for ( i=0; i < num_tables; i++ ) {
+			if ( next[i] && ( t < 0 || next[i]->file < next[t]->file ) ) 
+				t = i;
+		}
+		if ( t < 0 ) 
+			break;
+
+		// merge the records of this file
+		file = next[t]->file;
+		for ( r = next[t]; r && r->file == file; r = r->next ) {
+			// get the map of the same content in the global map list
+			if ( r->map_ref != worker_map ) {
+				worker_map = r->map_ref;
+				Insert_Extension_Map(extension_map_list, worker_map);
+				map = extension_map_list->slot[worker_map->map_id]->map;
+			}
+			// the map is still in its slot, until the next map is inserted
+			extension_map_list->slot[map->map_id]->ref_count++;
+
+			Merge_FlowRecord(r, map);
+		}
+		next[t] = r;
+	}
+	free(next);
+
+} // End of Merge_FlowTables
 
 
 #undef get16bits
@@ -43,12 +43,15 @@
 /*
  * Flow Table
  * In order to aggregate flows or to generate any flow statistics, the flows passed the filter
- * are stored into an internal hash table.
+ * are stored into an internal hash table. The records are found through an open addressing
+ * index with Robin Hood linear probing. Each slot holds the full 32bit hash of its record, so
+ * a probe only touches a record, if the hash matches. The index grows, when it is 3/4 full.
+ * Worker threads aggregate into private tables, which are merged into the global table at the end.
  */
 
 /* Element of the Flow Table ( cache ) */
 typedef struct FlowTableRecord {
-	// record chain - points to next record with same hash in case of a hash collision
+	// record chain - points to the next record in insertion order
 	struct FlowTableRecord *next;	
 
 	// Hash papameters
@@ -59,6 +62,11 @@ typedef struct FlowTableRecord {
 	uint64_t	counter[5];
 
 	extension_map_t	*map_ref;
+
+	// sequence number of the file and flows of the first record - merge of worker tables
+	uint32_t	file;
+	uint64_t	first_flows;
+
 	// flow record follows
 	// flow data size may vary depending on the number of extensions
 	// common_record_t already contains a pointer to more data ( extensions ) at the end
@@ -67,6 +75,12 @@ typedef struct FlowTableRecord {
 	// no further vars beyond this point! The flow record above has additional data.
 } FlowTableRecord_t;
 
+/* Slot of the index of the Flow Table */
+typedef struct FlowTableSlot_s {
+	uint32_t			hash;		// full 32bit hash of the record
+	FlowTableRecord_t	*record;	// NULL for an empty slot
+} FlowTableSlot_t;
+
 typedef struct MemoryHandle_s {
 	/* 
 	 * to speedup aggregation/record statistics, the internal hash tables use their own memory management.
@@ -93,10 +107,11 @@ typedef struct MemoryHandle_s {
 # 	define ALIGN_MASK 0xFFFFFFFC
 #endif
 
-// number of bits for hash width for floe table
-// Size: 0 < HashBits < 32
-// typically 20 - tradeoff memory/speed
-#define HashBits 20
+// number of bits of the initial index of the flow table
+// Size: 0 < HashBits < MaxHashBits
+// the index doubles, when more than 3/4 of the slots are used
+#define HashBits 16
+#define MaxHashBits 31
 
 // Each pre-allocated memory block is 10M
 #define MemBlockSize 10*1024*1024
@@ -108,14 +123,19 @@ typedef struct hash_FlowTable {
 	uint16_t 			NumBits;		/* width of the hash table */
 	uint32_t			IndexMask;		/* Mask which corresponds to NumBits */
 	uint32_t			NumRecords;		/* number of records in table */
-	FlowTableRecord_t 	**bucket;		/* Hash entry point: points to elements in the flow block */
-	FlowTableRecord_t 	**bucketcache;	/* in case of index collisions, this array points to the last element with that index */
+	uint32_t			MaxRecords;		/* number of records, before the index grows */
+	FlowTableSlot_t		*slot;			/* index: IndexMask + 1 slots */
+	FlowTableRecord_t 	*first;			/* all records in insertion order, linked by next */
+	FlowTableRecord_t 	*last;			/* last inserted record */
 
+	uint32_t			file;			/* sequence number of the file read into the table */
 	uint32_t			keylen;			/* key length of hash key as number of 4byte ints */
 	uint32_t			keysize;		/* size of key in bytes */
 
 	/* use a MemoryHandle for the table */
 	MemoryHandle_t		mem;
+	void				*keymem;		/* key of the next lookup - becomes part of the table on insert */
+	void				*bidirkeymem;	/* key of the reverse flow lookup */
 
 	/* src/dst IP aggr masks - use to properly maks the IP before printing */
 	uint64_t			IPmask[4];		// 0-1 srcIP, 2-3 dstIP
@@ -140,6 +160,14 @@ void InsertFlow(common_record_t *raw_record, master_record_t *flow_record);
 
 void AddFlow(common_record_t *raw_record, master_record_t *flow_record );
 
+hash_FlowTable *New_FlowTable(void);
+
+void Dispose_FlowTable_r(hash_FlowTable *table);
+
+void AddFlow_r(hash_FlowTable *table, common_record_t *raw_record, master_record_t *flow_record );
+
+void Merge_FlowTables(hash_FlowTable **tables, int num_tables, extension_map_list_t *extension_map_list);
+
 int SetBidirAggregation( void );
 
 int ParseAggregateMask( char *arg, char **aggr_fmt  );
@@ -0,0 +1,791 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+/*
+ * k-way merge of nfcapd files by flow start time. Each file is a source
+ * with its current data block and extension maps. The sources are opened in
+ * the order of their first flow and kept in a binary min heap ordered by the 
+ * time of their next flow record. Optionally the records pass a reorder 
+ * window, a second heap of record copies, before they are returned.
+ */
+
+#include "config.h"
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "nf_common.h"
+#include "nffile.h"
+#include "nfx.h"
+#include "util.h"
+#include "flist.h"
+#include "nfmerge.h"
+
+#if ( SIZEOF_VOID_P == 8 )
+typedef uint64_t	pointer_addr_t;
+#else
+typedef uint32_t	pointer_addr_t;
+#endif
+
+typedef struct merge_source_s {
+	merge_reader_t		*reader;
+	rfile_t				*rfile;			// handle of the open file or NULL
+	char				*filename;
+	uint32_t			index;			// position of the file in the list
+	uint64_t			first;			// time of the first flow in msec according to the stat record
+	void				*buff;			// read buffer of compressed files
+	data_block_header_t	block_header;	// current data block
+	uint8_t				*next;			// next record in the block
+	uint8_t				*end;			// end of the block
+	uint32_t			i;				// number of records read from the block
+	common_record_t		*record;		// current flow record
+	uint64_t			time;			// RECORD_TIME of the current record
+	extension_info_t	**maps;			// extension maps of the file by map id
+	uint32_t			num_maps;		// size of maps
+	stat_record_t		stat_record;	// stat record and ident of the file
+	char				ident[IdentLen];
+	uint32_t			errors;			// read errors and skipped records
+} merge_source_t;
+
+// copy of a record in the reorder window
+typedef struct merge_slot_s {
+	uint64_t			time;
+	uint64_t			seq;			// keeps the merge order of records with the same time
+	common_record_t		*record;
+	uint32_t			size;			// size of the record buffer
+	uint32_t			file;
+	extension_info_t	*extension_info;
+} merge_slot_t;
+
+#define SLOT_LESS(a, b)	((a)->time < (b)->time || ((a)->time == (b)->time && (a)->seq < (b)->seq))
+
+struct merge_reader_s {
+	merge_source_t		*source;		// sources in the order of the file list
+	uint32_t			num_sources;
+	merge_source_t		**pending;		// sources by time of their first flow
+	uint32_t			next_pending;	// next source to open
+	merge_source_t		**heap;			// open sources with records left
+	uint32_t			heap_size;
+	merge_source_t		*current;		// source of the record last read or NULL
+	time_t				twin_start;		// time window of the block index
+	time_t				twin_end;
+	int					own_names;		// file names are allocated by the reader
+	extension_info_t	**retired;		// replaced maps, still used by records in the window
+	uint32_t			num_retired;
+	uint32_t			window;			// size of the reorder window
+	merge_slot_t		**slots;		// heap of the records in the window
+	uint32_t			num_slots;
+	merge_slot_t		**free_slots;	// unused slots
+	uint32_t			num_free;
+	merge_slot_t		*out;			// slot of the record last returned or NULL
+	uint64_t			seq;
+	uint64_t			last_time;		// time of the record last returned
+	uint64_t			late;			// records returned out of order
+};
+
+static merge_reader_t *NewMergeReader(uint32_t num_files);
+
+static int ComparePending(const void *p1, const void *p2);
+
+static int OpenSource(merge_reader_t *reader, merge_source_t *source);
+
+static void CloseSource(merge_source_t *source);
+
+static int InsertMap(merge_reader_t *reader, merge_source_t *source, extension_map_t *map);
+
+static int NextSourceRecord(merge_source_t *source);
+
+static void SiftDown(merge_reader_t *reader, uint32_t i);
+
+static void SiftUp(merge_reader_t *reader, uint32_t i);
+
+static common_record_t *NextFileRecord(merge_reader_t *reader, extension_info_t **extension_info, uint32_t *file);
+
+static void SiftDownSlot(merge_reader_t *reader, uint32_t i);
+
+static void SiftUpSlot(merge_reader_t *reader, uint32_t i);
+
+static merge_reader_t *NewMergeReader(uint32_t num_files) {
+merge_reader_t *reader;
+
+	reader = calloc(1, sizeof(merge_reader_t));
+	if ( !reader ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+	if ( num_files == 0 ) 
+		return reader;
+
+	reader->source	= calloc(num_files, sizeof(merge_source_t));
+	reader->pending = calloc(num_files, sizeof(merge_source_t *));
+	reader->heap	= calloc(num_files, sizeof(merge_source_t *));
+	if ( !reader->source || !reader->pending || !reader->heap ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		CloseMergeReader(reader);
+		return NULL;
+	}
+
+	return reader;
+
+} // End of NewMergeReader
+
+static int ComparePending(const void *p1, const void *p2) {
+const merge_source_t *s1 = *(const merge_source_t **)p1;
+const merge_source_t *s2 = *(const merge_source_t **)p2;
+
+	if ( s1->first != s2->first ) 
+		return s1->first < s2->first ? -1 : 1;
+
+	return s1->index < s2->index ? -1 : ( s1->index > s2->index ? 1 : 0 );
+
+} // End of ComparePending
+
+/*
+ * Open the file of the source and read its first record. Returns 1 if the source 
+ * has records, 0 if not or on errors. Returns -1 if out of memory.
+ */
+static int OpenSource(merge_reader_t *reader, merge_source_t *source) {
+stat_record_t *stat_record;
+char *err;
+
+	source->rfile = NewRFile();
+	if ( !source->rfile ) 
+		return -1;
+
+	if ( OpenFile_r(source->rfile, source->filename, &stat_record, &err) < 0 ) {
+		fprintf(stderr, "Skip file '%s': %s", source->filename, err ? err : strerror(errno));
+		source->errors++;
+		CloseSource(source);
+		return 0;
+	}
+	source->stat_record = *stat_record;
+	strncpy(source->ident, source->rfile->file_header.ident, IdentLen);
+	source->ident[IdentLen-1] = '\0';
+
+	// skip the blocks outside the time window, if the file is indexed
+	if ( reader->twin_start ) 
+		OpenIndex_r(source->rfile, source->filename, reader->twin_start, reader->twin_end);
+
+	// mapped files are read in place
+	if ( !source->rfile->map ) {
+		source->buff = malloc(BUFFSIZE);
+		if ( !source->buff ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			CloseSource(source);
+			return -1;
+		}
+	}
+
+	if ( NextSourceRecord(source) ) 
+		return 1;
+
+	CloseSource(source);
+	return 0;
+
+} // End of OpenSource
+
+// Close the file of a source at its end. The maps are kept for the records in the window
+static void CloseSource(merge_source_t *source) {
+
+	DisposeRFile(source->rfile);
+	source->rfile = NULL;
+	if ( source->buff ) 
+		free(source->buff);
+	source->buff = NULL;
+
+} // End of CloseSource
+
+/*
+ * Add or replace the extension map of the source. Returns 1 on success, 0 on errors.
+ */
+static int InsertMap(merge_reader_t *reader, merge_source_t *source, extension_map_t *map) {
+extension_info_t *info;
+uint32_t map_id;
+
+	map_id = map->map_id == INIT_ID ? 0 : map->map_id & EXTENSION_MAP_MASK;
+	if ( map_id >= source->num_maps ) {
+		uint32_t num_maps = map_id + 16;
+		extension_info_t **maps = realloc(source->maps, num_maps * sizeof(extension_info_t *));
+		if ( !maps ) {
+			fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return 0;
+		}
+		memset((void *)&maps[source->num_maps], 0, (num_maps - source->num_maps) * sizeof(extension_info_t *));
+		source->maps	 = maps;
+		source->num_maps = num_maps;
+	}
+
+	info = source->maps[map_id];
+	if ( info ) {
+		extension_info_t **retired;
+
+		// same map again - nothing to do
+		if ( info->map->size == map->size && 
+			 memcmp((void *)info->map->ex_id, (void *)map->ex_id, map->size - sizeof(extension_map_t)) == 0 ) 
+			return 1;
+
+		// records in the window may still refer to the replaced map
+		retired = realloc(reader->retired, (reader->num_retired + 1) * sizeof(extension_info_t *));
+		if ( !retired ) {
+			fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return 0;
+		}
+		reader->retired = retired;
+		reader->retired[reader->num_retired++] = info;
+		source->maps[map_id] = NULL;
+	}
+
+	// a new map gets a new pointer, which tells users of the map about the change
+	info = calloc(1, sizeof(extension_info_t));
+	if ( !info ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	info->map = malloc(map->size);
+	if ( !info->map ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		free(info);
+		return 0;
+	}
+	memcpy((void *)info->map, (void *)map, map->size);
+	info->map->map_id = map_id;
+	source->maps[map_id] = info;
+
+	return 1;
+
+} // End of InsertMap
+
+/*
+ * Advance the source to its next flow record. Extension maps are processed on the way.
+ * Returns 1 if a record is available, 0 at the end of the file or on errors.
+ */
+static int NextSourceRecord(merge_source_t *source) {
+record_header_t *record;
+char *err;
+int ret;
+
+	while ( 1 ) {
+		if ( source->i >= source->block_header.NumRecords ) {
+			void *data = source->buff;
+			ret = ReadBlockPtr_r(source->rfile, &(source->block_header), &data, &err);
+			switch (ret) {
+				case NF_EOF:
+					return 0;
+				case NF_ERROR:
+					fprintf(stderr, "Read error in file '%s': %s\n", source->filename, strerror(errno) );
+					source->errors++;
+					return 0;
+				case NF_CORRUPT:
+					fprintf(stderr, "Skip corrupt data file '%s': '%s'\n", source->filename, err ? err : "");
+					source->errors++;
+					return 0;
+			}
+			source->i = 0;
+			if ( source->block_header.id != DATA_BLOCK_TYPE_2 ) {
+				fprintf(stderr, "Can't process block type %u. Skip block.\n", source->block_header.id);
+				source->block_header.NumRecords = 0;
+				source->errors++;
+				continue;
+			}
+			source->next = (uint8_t *)data;
+			source->end	 = source->next + source->block_header.size;
+		}
+
+		record = (record_header_t *)source->next;
+		if ( (source->end - source->next) < sizeof(record_header_t) || record->size < sizeof(record_header_t) ||
+			 record->size > (source->end - source->next) ) {
+			fprintf(stderr, "Corrupt data file '%s': Skip rest of block\n", source->filename);
+			source->i = source->block_header.NumRecords;
+			source->errors++;
+			continue;
+		}
+		source->next += record->size;
+		source->i++;
+
+		switch (record->type) {
+			case CommonRecordType: {
+				common_record_t *flow_record = (common_record_t *)record;
+				if ( flow_record->ext_map >= source->num_maps || source->maps[flow_record->ext_map] == NULL ) {
+					fprintf(stderr, "Corrupt data file! No such extension map id: %u. Skip record\n", flow_record->ext_map);
+					source->errors++;
+					continue;
+				}
+				source->record = flow_record;
+				source->time   = RECORD_TIME(flow_record);
+				return 1;
+				} break;
+			case ExtensionMapType:
+				if ( record->size <= sizeof(extension_map_t) || 
+					 !InsertMap(source->reader, source, (extension_map_t *)record) ) {
+					fprintf(stderr, "Corrupt data file '%s': Skip extension map\n", source->filename);
+					source->errors++;
+				}
+				break;
+			default:
+				fprintf(stderr, "Skip unknown record type %i\n", record->type);
+				source->errors++;
+		}
+	}
+
+	// not reached
+	return 0;
+
+} // End of NextSourceRecord
+
+static void SiftDown(merge_reader_t *reader, uint32_t i) {
+merge_source_t **heap = reader->heap;
+merge_source_t *source = heap[i];
+uint32_t child;
+
+	while ( (child = 2 * i + 1) < reader->heap_size ) {
+		if ( (child + 1) < reader->heap_size && heap[child + 1]->time < heap[child]->time )
+			child++;
+		if ( source->time <= heap[child]->time )
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = source;
+
+} // End of SiftDown
+
+static void SiftUp(merge_reader_t *reader, uint32_t i) {
+merge_source_t **heap = reader->heap;
+merge_source_t *source = heap[i];
+
+	while ( i > 0 && source->time < heap[(i - 1) / 2]->time ) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = source;
+
+} // End of SiftUp
+
+static void SiftDownSlot(merge_reader_t *reader, uint32_t i) {
+merge_slot_t **heap = reader->slots;
+merge_slot_t *slot = heap[i];
+uint32_t child;
+
+	while ( (child = 2 * i + 1) < reader->num_slots ) {
+		if ( (child + 1) < reader->num_slots && SLOT_LESS(heap[child + 1], heap[child]) )
+			child++;
+		if ( !SLOT_LESS(heap[child], slot) )
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = slot;
+
+} // End of SiftDownSlot
+
+static void SiftUpSlot(merge_reader_t *reader, uint32_t i) {
+merge_slot_t **heap = reader->slots;
+merge_slot_t *slot = heap[i];
+
+	while ( i > 0 && SLOT_LESS(slot, heap[(i - 1) / 2]) ) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = slot;
+
+} // End of SiftUpSlot
+
+/*
+ * Open the files for a merge by time. Returns the reader or NULL on errors.
+ * Files which can not be opened are reported and skipped. The files are 
+ * opened at once, so the file list should be short.
+ */
+merge_reader_t *OpenMergeReader(char **files, uint32_t num_files) {
+merge_reader_t *reader;
+uint32_t i;
+
+	reader = NewMergeReader(num_files);
+	if ( !reader ) 
+		return NULL;
+
+	for ( i=0; i < num_files; i++ ) {
+		merge_source_t *source = &reader->source[i];
+		source->reader	 = reader;
+		source->filename = files[i];
+		source->index	 = i;
+		reader->pending[i] = source;
+	}
+	reader->num_sources = num_files;
+
+	return reader;
+
+} // End of OpenMergeReader
+
+/*
+ * Open the files of the sequence flist, which match the time window and the file
+ * filter of flist, for a merge by time. The files are only checked now and opened
+ * by NextMergeRecord, when their flows are due. Returns the reader or NULL on errors.
+ */
+merge_reader_t *OpenMergeSequence(flist_t *flist, time_t twin_start, time_t twin_end) {
+merge_reader_t *reader;
+stringlist_t files;
+stat_record_t *stat_record;
+rfile_t *rfile;
+uint64_t *first;
+uint32_t i;
+int fd;
+
+	rfile = NewRFile();
+	if ( !rfile ) 
+		return NULL;
+
+	InitStringlist(&files, 256);
+	first = NULL;
+	while ( (fd = GetNextFile_r(flist, rfile, twin_start, twin_end, &stat_record)) >= 0 ) {
+		if ( fd == STDIN_FILENO ) {
+			fprintf(stderr, "Can't merge data from stdin. Skip stdin.\n");
+			continue;
+		}
+		if ( (files.num_strings % 256) == 0 ) {
+			uint64_t *f = realloc(first, (files.num_strings + 256) * sizeof(uint64_t));
+			if ( !f ) {
+				fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				exit(255);
+			}
+			first = f;
+		}
+		// files without flows have no valid time and are opened first
+		first[files.num_strings] = stat_record->first_seen && stat_record->first_seen != 0x7fffffff ? 
+			(uint64_t)stat_record->first_seen * 1000 + stat_record->msec_first : 0;
+		InsertString(&files, GetCurrentFilename_r(flist));
+	}
+	DisposeRFile(rfile);
+
+	reader = NewMergeReader(files.num_strings);
+	if ( reader ) {
+		reader->twin_start = twin_start;
+		reader->twin_end   = twin_end;
+		reader->own_names  = 1;
+		for ( i=0; i < files.num_strings; i++ ) {
+			merge_source_t *source = &reader->source[i];
+			source->reader	 = reader;
+			source->filename = files.list[i];
+			source->index	 = i;
+			source->first	 = first[i];
+			reader->pending[i] = source;
+		}
+		reader->num_sources = files.num_strings;
+		qsort((void *)reader->pending, reader->num_sources, sizeof(merge_source_t *), ComparePending);
+	} else {
+		for ( i=0; i < files.num_strings; i++ ) 
+			free(files.list[i]);
+	}
+	if ( files.list ) 
+		free(files.list);
+	if ( first ) 
+		free(first);
+
+	return reader;
+
+} // End of OpenMergeSequence
+
+/*
+ * Check the files of the sequence flist, which match the time window and the file filter 
+ * of flist, and rewind flist. Returns 1, if all files are sorted by time ( FLAG_SORTED ),
+ * so they are merged exactly without reorder window, 0 otherwise.
+ */
+int SortedFileSequence(flist_t *flist, time_t twin_start, time_t twin_end) {
+rfile_t *rfile;
+int fd, sorted;
+
+	rfile = NewRFile();
+	if ( !rfile ) 
+		return 0;
+
+	sorted = 1;
+	while ( sorted && (fd = GetNextFile_r(flist, rfile, twin_start, twin_end, NULL)) >= 0 ) {
+		if ( fd == STDIN_FILENO || (rfile->file_header.flags & FLAG_SORTED) == 0 ) 
+			sorted = 0;
+	}
+	DisposeRFile(rfile);
+	RewindFileSequence_r(flist);
+
+	return sorted;
+
+} // End of SortedFileSequence
+
+/*
+ * Set the size of the reorder window in records. The records are returned in time order,
+ * unless a record of a file is preceded by more than window records with a later start time.
+ * 0 disables the window. Must be set before the first record is read. Returns 1 on success.
+ */
+int SetMergeWindow(merge_reader_t *reader, uint32_t window) {
+
+	if ( reader->current || reader->num_slots || reader->out ) 
+		return 0;
+
+	reader->slots	   = window ? calloc(window, sizeof(merge_slot_t *)) : NULL;
+	reader->free_slots = window ? calloc(window + 1, sizeof(merge_slot_t *)) : NULL;
+	if ( window && (!reader->slots || !reader->free_slots) ) {
+		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	reader->window = window;
+
+	return 1;
+
+} // End of SetMergeWindow
+
+/*
+ * Return the flow record with the earliest start time of the open files and open the
+ * files, which are due. Returns NULL at the end.
+ */
+static common_record_t *NextFileRecord(merge_reader_t *reader, extension_info_t **extension_info, uint32_t *file) {
+merge_source_t *source;
+
+	// advance the source of the previous record
+	if ( reader->current ) {
+		if ( !NextSourceRecord(reader->current) ) {
+			CloseSource(reader->current);
+			reader->heap_size--;
+			reader->heap[0] = reader->heap[reader->heap_size];
+		}
+		reader->current = NULL;
+		if ( reader->heap_size ) 
+			SiftDown(reader, 0);
+	}
+
+	// open the files, whose first flow is not later than the next record
+	while ( reader->next_pending < reader->num_sources &&
+			( reader->heap_size == 0 || reader->pending[reader->next_pending]->first <= reader->heap[0]->time ) ) {
+		source = reader->pending[reader->next_pending++];
+		switch ( OpenSource(reader, source) ) {
+			case 1:
+				reader->heap[reader->heap_size] = source;
+				SiftUp(reader, reader->heap_size);
+				reader->heap_size++;
+				break;
+			case -1:
+				exit(255);
+		}
+	}
+
+	if ( reader->heap_size == 0 )
+		return NULL;
+
+	source = reader->heap[0];
+	reader->current = source;
+	*extension_info = source->maps[source->record->ext_map];
+	*file = source->index;
+
+	return source->record;
+
+} // End of NextFileRecord
+
+/*
+ * Return the next flow record by start time, its extension info and the index of its file.
+ * The record is valid until the next call. Returns NULL at the end.
+ */
+common_record_t *NextMergeRecord(merge_reader_t *reader, extension_info_t **extension_info, uint32_t *file) {
+common_record_t *record;
+merge_slot_t *slot;
+uint32_t index;
+
+	if ( reader->window == 0 ) {
+		record = NextFileRecord(reader, extension_info, &index);
+		if ( record ) {
+			if ( RECORD_TIME(record) < reader->last_time ) 
+				reader->late++;
+			else 
+				reader->last_time = RECORD_TIME(record);
+			if ( file ) 
+				*file = index;
+		}
+		return record;
+	}
+
+	if ( reader->out ) {
+		reader->free_slots[reader->num_free++] = reader->out;
+		reader->out = NULL;
+	}
+
+	// fill the window
+	while ( reader->num_slots < reader->window && 
+			(record = NextFileRecord(reader, extension_info, &index)) != NULL ) {
+		if ( reader->num_free ) {
+			slot = reader->free_slots[--reader->num_free];
+		} else {
+			slot = calloc(1, sizeof(merge_slot_t));
+			if ( !slot ) {
+				fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				exit(255);
+			}
+		}
+		if ( slot->size < record->size ) {
+			// most records fit into the smallest slot
+			uint32_t size = record->size < 128 ? 128 : record->size;
+			void *p = realloc(slot->record, size);
+			if ( !p ) {
+				fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				exit(255);
+			}
+			slot->record = (common_record_t *)p;
+			slot->size	 = size;
+		}
+		memcpy((void *)slot->record, (void *)record, record->size);
+		slot->time			 = RECORD_TIME(record);
+		slot->seq			 = reader->seq++;
+		slot->file			 = index;
+		slot->extension_info = *extension_info;
+
+		reader->slots[reader->num_slots] = slot;
+		SiftUpSlot(reader, reader->num_slots);
+		reader->num_slots++;
+	}
+
+	if ( reader->num_slots == 0 ) 
+		return NULL;
+
+	slot = reader->slots[0];
+	reader->num_slots--;
+	if ( reader->num_slots ) {
+		reader->slots[0] = reader->slots[reader->num_slots];
+		SiftDownSlot(reader, 0);
+	}
+	reader->out = slot;
+
+	if ( slot->time < reader->last_time ) 
+		reader->late++;
+	else 
+		reader->last_time = slot->time;
+
+	*extension_info = slot->extension_info;
+	if ( file ) 
+		*file = slot->file;
+
+	return slot->record;
+
+} // End of NextMergeRecord
+
+uint32_t MergeNumFiles(merge_reader_t *reader) {
+
+	return reader->num_sources;
+
+} // End of MergeNumFiles
+
+// Stat record of a file. Valid after the first record of the file was returned
+stat_record_t *MergeStatRecord(merge_reader_t *reader, uint32_t file) {
+
+	return &(reader->source[file].stat_record);
+
+} // End of MergeStatRecord
+
+char *MergeIdent(merge_reader_t *reader, uint32_t file) {
+
+	return reader->source[file].ident;
+
+} // End of MergeIdent
+
+char *MergeFilename(merge_reader_t *reader, uint32_t file) {
+
+	return reader->source[file].filename;
+
+} // End of MergeFilename
+
+// Number of read errors and skipped records of all files so far
+uint32_t MergeErrors(merge_reader_t *reader) {
+uint32_t i, errors = 0;
+
+	for ( i=0; i < reader->num_sources; i++ ) 
+		errors += reader->source[i].errors;
+
+	return errors;
+
+} // End of MergeErrors
+
+// Number of records returned with an earlier start time than a record before
+uint64_t MergeLateRecords(merge_reader_t *reader) {
+
+	return reader->late;
+
+} // End of MergeLateRecords
+
+void CloseMergeReader(merge_reader_t *reader) {
+uint32_t i, j;
+
+	if ( !reader )
+		return;
+
+	for ( i=0; i < reader->num_sources; i++ ) {
+		merge_source_t *source = &reader->source[i];
+		CloseSource(source);
+		for ( j=0; j < source->num_maps; j++ ) {
+			if ( source->maps[j] ) {
+				free(source->maps[j]->map);
+				free(source->maps[j]);
+			}
+		}
+		if ( source->maps ) 
+			free(source->maps);
+		if ( reader->own_names ) 
+			free(source->filename);
+	}
+	for ( i=0; i < reader->num_retired; i++ ) {
+		free(reader->retired[i]->map);
+		free(reader->retired[i]);
+	}
+	if ( reader->retired ) 
+		free(reader->retired);
+
+	if ( reader->out ) 
+		reader->free_slots[reader->num_free++] = reader->out;
+	for ( i=0; i < reader->num_slots; i++ ) 
+		reader->free_slots[reader->num_free++] = reader->slots[i];
+	for ( i=0; i < reader->num_free; i++ ) {
+		free(reader->free_slots[i]->record);
+		free(reader->free_slots[i]);
+	}
+	if ( reader->slots ) 
+		free(reader->slots);
+	if ( reader->free_slots ) 
+		free(reader->free_slots);
+
+	if ( reader->source ) 
+		free(reader->source);
+	if ( reader->pending ) 
+		free(reader->pending);
+	if ( reader->heap ) 
+		free(reader->heap);
+	free(reader);
+
+} // End of CloseMergeReader
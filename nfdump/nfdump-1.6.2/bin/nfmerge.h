@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+
+#ifndef _NFMERGE_H
+#define _NFMERGE_H 1
+
+/*
+ * A merge reader returns the flow records of several files in the order of
+ * their start time first/msec_first. Each file is read block by block and a
+ * heap selects the file with the earliest next record. A file is opened not
+ * before the merge reaches the first flow of its stat record, so only the 
+ * files overlapping in time are open at once and memory is bounded by one 
+ * data block per open file. Files sorted by time themselves, such as the files
+ * written by nfcompact, are merged exactly. Roughly sorted files, such as the
+ * files of nfcapd, are sorted by a reorder window of the given number of 
+ * records ( see SetMergeWindow ). Extension maps are resolved per file, the
+ * record is returned with the extension info of its file.
+ */
+typedef struct merge_reader_s merge_reader_t;
+
+// time of a flow record in msec, the sort key of the merge
+#define RECORD_TIME(r)	((uint64_t)(r)->first * 1000 + (r)->msec_first)
+
+// default reorder window of libnfdump in records
+#define MERGE_WINDOW	100000
+
+// max reorder window of nfdump -J in records
+#define MAX_MERGE_WINDOW	10000000
+
+merge_reader_t *OpenMergeReader(char **files, uint32_t num_files);
+
+merge_reader_t *OpenMergeSequence(flist_t *flist, time_t twin_start, time_t twin_end);
+
+int SortedFileSequence(flist_t *flist, time_t twin_start, time_t twin_end);
+
+int SetMergeWindow(merge_reader_t *reader, uint32_t window);
+
+common_record_t *NextMergeRecord(merge_reader_t *reader, extension_info_t **extension_info, uint32_t *file);
+
+uint32_t MergeNumFiles(merge_reader_t *reader);
+
+stat_record_t *MergeStatRecord(merge_reader_t *reader, uint32_t file);
+
+char *MergeIdent(merge_reader_t *reader, uint32_t file);
+
+char *MergeFilename(merge_reader_t *reader, uint32_t file);
+
+uint32_t MergeErrors(merge_reader_t *reader);
+
+uint64_t MergeLateRecords(merge_reader_t *reader);
+
+void CloseMergeReader(merge_reader_t *reader);
+
+#endif //_NFMERGE_H
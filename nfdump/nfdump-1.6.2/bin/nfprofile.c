@@ -61,6 +61,7 @@
 #include "nfdump.h"
 #include "nffile.h"
 #include "nfx.h"
+#include "nfrollup.h"
 #include "nfstat.h"
 #include "nfstatfile.h"
 #include "ipconv.h"
@@ -103,6 +104,7 @@ static void usage(char *name) {
 					"-Z\t\tCheck filter syntax and exit.\n"
 					"-S subdir\tSub directory format. see nfcapd(1) for format\n"
 					"-z\t\tCompress flows in output file.\n"
+					"-G keys\t\tCreate rollup of the ',' separated -s keys of each channel file or all.\n"
 					"-t <time>\ttime for RRD update\n", name);
 } /* usage */
 
@@ -459,6 +461,7 @@ profile_param_info_t **list = &profile_list;
 
 int main( int argc, char **argv ) {
 unsigned int		num_channels, compress;
+uint32_t			rollup_keys;
 struct stat stat_buf;
 profile_param_info_t *profile_list;
 char *rfile, *ffile, *filename, *Mdirs, *tstring;
@@ -473,6 +476,7 @@ time_t tslot;
 	tslot 			= 0;
 	syntax_only	    = 0;
 	compress		= 0;
+	rollup_keys		= 0;
 	subdir_index	= 0;
 	profile_list	= NULL;
 	nameserver		= NULL;
@@ -481,7 +485,7 @@ time_t tslot;
 	// default file names
 	ffile = "filter.txt";
 	rfile = NULL;
-	while ((c = getopt(argc, argv, "D:IL:p:P:hf:r:n:M:S:t:VzZ")) != EOF) {
+	while ((c = getopt(argc, argv, "D:G:IL:p:P:hf:r:n:M:S:t:VzZ")) != EOF) {
 		switch (c) {
 			case 'h':
 				usage(argv[0]);
@@ -531,6 +535,10 @@ time_t tslot;
 			case 'z':
 				compress = 1;
 				break;
+			case 'G':
+				if ( !ParseRollupKeys(optarg, &rollup_keys) ) 
+					exit(255);
+				break;
 			default:
 				usage(argv[0]);
 				exit(0);
@@ -608,7 +616,7 @@ time_t tslot;
 
 	process_data(GetChannelInfoList(), num_channels, tslot);
 
-	CloseChannels(tslot, compress);
+	CloseChannels(tslot, compress, rollup_keys);
 
 	return 0;
 }
@@ -0,0 +1,643 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+
+/*
+ * Rollups of data files: the flows of a file aggregated for a set of -s statistic 
+ * keys. See nfrollup.h for the file layout.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+#include <sys/mman.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "nf_common.h"
+#include "nffile.h"
+#include "nfx.h"
+#include "nfrollup.h"
+#include "nfstat.h"
+
+#if ( SIZEOF_VOID_P == 8 )
+typedef uint64_t	pointer_addr_t;
+#else
+typedef uint32_t	pointer_addr_t;
+#endif
+
+/*
+ * The keys of a rollup. The elements are taken from the master record, as AddStat() does
+ * for the -s statistic of the same name.
+ */
+static struct rollup_key_s {
+	char		*name;			// name of the -s statistic
+	struct rollup_element_s {
+		uint32_t	offset0;
+		uint32_t	offset1;
+		uint64_t	mask;
+		uint32_t	shift;
+	} element[2];				// src and dst element of two sided keys
+	uint32_t	num_elem;
+} RollupKeys[] = {
+	{ "srcip",	 { {OffsetSrcIPv6a, OffsetSrcIPv6b, MaskIPv6, 0},	{0,0,0,0} }, 1 },
+	{ "dstip",	 { {OffsetDstIPv6a, OffsetDstIPv6b, MaskIPv6, 0},	{0,0,0,0} }, 1 },
+	{ "ip",		 { {OffsetSrcIPv6a, OffsetSrcIPv6b, MaskIPv6, 0},	{OffsetDstIPv6a, OffsetDstIPv6b, MaskIPv6, 0} }, 2 },
+	{ "nhip",	 { {OffsetNexthopv6a, OffsetNexthopv6b, MaskIPv6, 0},	{0,0,0,0} }, 1 },
+	{ "router",	 { {OffsetRouterv6a, OffsetRouterv6b, MaskIPv6, 0},	{0,0,0,0} }, 1 },
+	{ "srcport", { {0, OffsetPort, MaskSrcPort, ShiftSrcPort},		{0,0,0,0} }, 1 },
+	{ "dstport", { {0, OffsetPort, MaskDstPort, ShiftDstPort},		{0,0,0,0} }, 1 },
+	{ "port",	 { {0, OffsetPort, MaskSrcPort, ShiftSrcPort},		{0, OffsetPort, MaskDstPort, ShiftDstPort} }, 2 },
+	{ "proto",	 { {0, OffsetProto, MaskProto, ShiftProto},			{0,0,0,0} }, 1 },
+	{ "tos",	 { {0, OffsetTos, MaskTos, ShiftTos},				{0,0,0,0} }, 1 },
+	{ "srcas",	 { {0, OffsetAS, MaskSrcAS, ShiftSrcAS},			{0,0,0,0} }, 1 },
+	{ "dstas",	 { {0, OffsetAS, MaskDstAS, ShiftDstAS},			{0,0,0,0} }, 1 },
+	{ "as",		 { {0, OffsetAS, MaskSrcAS, ShiftSrcAS},			{0, OffsetAS, MaskDstAS, ShiftDstAS} }, 2 },
+	{ "inif",	 { {0, OffsetInOut, MaskInput, ShiftInput},			{0,0,0,0} }, 1 },
+	{ "outif",	 { {0, OffsetInOut, MaskOutput, ShiftOutput},		{0,0,0,0} }, 1 },
+	{ "if",		 { {0, OffsetInOut, MaskInput, ShiftInput},			{0, OffsetInOut, MaskOutput, ShiftOutput} }, 2 },
+	{ NULL,		 { {0,0,0,0},	{0,0,0,0} }, 0 }
+};
+
+// hash table of the values of a key
+typedef struct rollup_table_s {
+	StatRecord_t	**bucket;
+	uint32_t		IndexMask;
+	uint32_t		NumRecords;
+	StatRecord_t	**memblock;		// the stat records in blocks of ROLLUP_BLOCK records
+	uint32_t		NumBlocks;
+	uint32_t		MaxBlocks;
+	uint32_t		NextElem;		// next free record in the last block
+} rollup_table_t;
+
+#define ROLLUP_BLOCK	4096
+#define ROLLUP_BITS		12
+
+/* function prototypes */
+static int InitRollupTable(rollup_table_t *table);
+
+static void FreeRollupTable(rollup_table_t *table);
+
+static int GrowRollupTable(rollup_table_t *table);
+
+static inline uint32_t RollupHash(uint64_t *value, uint8_t prot);
+
+static inline int AddRollupValue(rollup_table_t *table, uint64_t *value, master_record_t *master_record);
+
+static int CompareBytes(const void *p1, const void *p2);
+
+static int WriteRollup(char *filename, uint32_t key_bits, rollup_table_t *table, stat_record_t *stat_record, uint64_t file_size);
+
+/* Functions */
+
+#include "nffile_inline.c"
+#include "nfdump_inline.c"
+
+/*
+ * Parse a comma separated list of key names or 'all' into the bits of RollupKeys.
+ * Returns 1 on success, otherwise 0
+ */
+int ParseRollupKeys(char *keys, uint32_t *key_bits) {
+char *s, *p, *q;
+int	 i;
+
+	*key_bits = 0;
+	s = strdup(keys);
+	if ( !s ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+
+	p = s;
+	while ( p ) {
+		q = strchr(p, ',');
+		if ( q ) 
+			*q++ = '\0';
+
+		if ( strcasecmp(p, "all") == 0 ) {
+			for ( i=0; RollupKeys[i].name; i++ ) 
+				*key_bits |= 1 << i;
+		} else {
+			for ( i=0; RollupKeys[i].name; i++ ) {
+				if ( strcasecmp(p, RollupKeys[i].name) == 0 ) 
+					break;
+			}
+			if ( !RollupKeys[i].name ) {
+				fprintf(stderr, "Unknown rollup key '%s'\n", p);
+				free(s);
+				return 0;
+			}
+			*key_bits |= 1 << i;
+		}
+		p = q;
+	}
+	free(s);
+
+	return *key_bits != 0;
+
+} // End of ParseRollupKeys
+
+static int InitRollupTable(rollup_table_t *table) {
+
+	memset((void *)table, 0, sizeof(rollup_table_t));
+	table->IndexMask = (1 << ROLLUP_BITS) - 1;
+	table->bucket	 = (StatRecord_t **)calloc(table->IndexMask + 1, sizeof(StatRecord_t *));
+	table->MaxBlocks = 64;
+	table->memblock	 = (StatRecord_t **)calloc(table->MaxBlocks, sizeof(StatRecord_t *));
+	if ( !table->bucket || !table->memblock ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	// the first record goes into a new block
+	table->NextElem = ROLLUP_BLOCK;
+
+	return 1;
+
+} // End of InitRollupTable
+
+static void FreeRollupTable(rollup_table_t *table) {
+uint32_t i;
+
+	for ( i=0; i<table->NumBlocks; i++ ) 
+		free((void *)table->memblock[i]);
+	free((void *)table->memblock);
+	free((void *)table->bucket);
+	memset((void *)table, 0, sizeof(rollup_table_t));
+
+} // End of FreeRollupTable
+
+static inline uint32_t RollupHash(uint64_t *value, uint8_t prot) {
+uint64_t h;
+
+	h = ( value[1] ^ ( value[0] * 0x9E3779B97F4A7C15LL ) ^ prot ) * 0x9E3779B97F4A7C15LL;
+	return (uint32_t)(h >> 32);
+
+} // End of RollupHash
+
+/*
+ * Double the number of buckets, when the table holds more records than buckets
+ */
+static int GrowRollupTable(rollup_table_t *table) {
+StatRecord_t **bucket, *r, *next;
+uint32_t	 i, index, mask;
+
+	mask   = ( table->IndexMask << 1 ) | 1;
+	bucket = (StatRecord_t **)calloc(mask + 1, sizeof(StatRecord_t *));
+	if ( !bucket ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	for ( i=0; i <= table->IndexMask; i++ ) {
+		r = table->bucket[i];
+		while ( r ) {
+			next = r->next;
+			index = RollupHash(r->stat_key, r->prot) & mask;
+			r->next = bucket[index];
+			bucket[index] = r;
+			r = next;
+		}
+	}
+	free((void *)table->bucket);
+	table->bucket	 = bucket;
+	table->IndexMask = mask;
+
+	return 1;
+
+} // End of GrowRollupTable
+
+static inline int AddRollupValue(rollup_table_t *table, uint64_t *value, master_record_t *master_record) {
+StatRecord_t *r;
+uint32_t	 index;
+
+	index = RollupHash(value, master_record->prot) & table->IndexMask;
+	r = table->bucket[index];
+	while ( r && ( r->stat_key[1] != value[1] || r->stat_key[0] != value[0] || r->prot != master_record->prot ) ) 
+		r = r->next;
+
+	if ( r ) {
+		r->counter[1] += master_record->dPkts;
+		r->counter[2] += master_record->dOctets;
+		r->counter[0]++;
+		if ( master_record->first < r->first || 
+			 ( master_record->first == r->first && master_record->msec_first < r->msec_first ) ) {
+			r->first	  = master_record->first;
+			r->msec_first = master_record->msec_first;
+		}
+		if ( master_record->last > r->last || 
+			 ( master_record->last == r->last && master_record->msec_last > r->msec_last ) ) {
+			r->last		 = master_record->last;
+			r->msec_last = master_record->msec_last;
+		}
+		return 1;
+	}
+
+	if ( table->NextElem == ROLLUP_BLOCK ) {
+		if ( table->NumBlocks == table->MaxBlocks ) {
+			StatRecord_t **p;
+			table->MaxBlocks <<= 1;
+			p = (StatRecord_t **)realloc(table->memblock, table->MaxBlocks * sizeof(StatRecord_t *));
+			if ( !p ) {
+				fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				return 0;
+			}
+			table->memblock = p;
+		}
+		table->memblock[table->NumBlocks] = (StatRecord_t *)malloc(ROLLUP_BLOCK * sizeof(StatRecord_t));
+		if ( !table->memblock[table->NumBlocks] ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return 0;
+		}
+		table->NumBlocks++;
+		table->NextElem = 0;
+	}
+
+	r = &table->memblock[table->NumBlocks-1][table->NextElem++];
+	r->stat_key[0]	= value[0];
+	r->stat_key[1]	= value[1];
+	r->prot			= master_record->prot;
+	r->record_flags	= master_record->flags & 0x1;
+	r->counter[0]	= 1;
+	r->counter[1]	= master_record->dPkts;
+	r->counter[2]	= master_record->dOctets;
+	r->first		= master_record->first;
+	r->msec_first	= master_record->msec_first;
+	r->last			= master_record->last;
+	r->msec_last	= master_record->msec_last;
+	r->next			= table->bucket[index];
+	table->bucket[index] = r;
+
+	table->NumRecords++;
+	if ( table->NumRecords > table->IndexMask ) 
+		return GrowRollupTable(table);
+
+	return 1;
+
+} // End of AddRollupValue
+
+static int CompareBytes(const void *p1, const void *p2) {
+const rollup_record_t *r1 = (const rollup_record_t *)p1;
+const rollup_record_t *r2 = (const rollup_record_t *)p2;
+
+	if ( r1->counter[2] != r2->counter[2] ) 
+		return r1->counter[2] > r2->counter[2] ? -1 : 1;
+	return 0;
+
+} // End of CompareBytes
+
+/*
+ * Aggregate the flows of a file for the keys in key_bits and write the rollup 
+ * <filename>.rollup. Returns 1 on success, otherwise 0
+ */
+int RollupFile(char *filename, uint32_t key_bits) {
+rfile_t				 *rfile;
+data_block_header_t	 block_header;
+extension_map_list_t *extension_map_list;
+rollup_table_t		 table[32];
+stat_record_t		 stat_record;
+struct stat			 stat_buf;
+common_record_t		 *record;
+master_record_t		 *master_record;
+uint64_t			 value[2];
+void				 *buff, *block;
+char				 *err;
+uint32_t			 i, j, k;
+int					 fd, ret, ok;
+
+	memset((void *)table, 0, sizeof(table));
+	rfile = NewRFile();
+	buff  = malloc(BUFFSIZE);
+	extension_map_list = (extension_map_list_t *)malloc(sizeof(extension_map_list_t));
+	if ( !rfile || !buff || !extension_map_list ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		DisposeRFile(rfile);
+		free(buff);
+		free(extension_map_list);
+		return 0;
+	}
+	InitExtensionMaps(extension_map_list);
+
+	ok = 1;
+	for ( k=0; RollupKeys[k].name && ok; k++ ) {
+		if ( key_bits & (1 << k) ) 
+			ok = InitRollupTable(&table[k]);
+	}
+
+	memset((void *)&stat_record, 0, sizeof(stat_record_t));
+	stat_record.first_seen = 0x7fffffff;
+	stat_record.msec_first = 999;
+
+	fd = ok ? OpenFile_r(rfile, filename, NULL, &err) : -1;
+	if ( fd < 0 || fstat(fd, &stat_buf) < 0 ) {
+		if ( ok && err ) 
+			fprintf(stderr, "%s\n", err);
+		ok = 0;
+	}
+
+	ret = NF_EOF;
+	while ( ok ) {
+		block = buff;
+		ret = ReadBlockPtr_r(rfile, &block_header, &block, &err);
+		if ( ret == NF_EOF ) 
+			break;
+
+		if ( ret < 0 ) {
+			if ( ret == NF_CORRUPT ) 
+				fprintf(stderr, "Skip corrupt data file '%s': '%s'\n", filename, err);
+			else
+				fprintf(stderr, "Read error in file '%s': %s\n", filename, strerror(errno));
+			ok = 0;
+			break;
+		}
+
+		// v1 blocks are not converted here - leave the file to the readers
+		if ( block_header.id != DATA_BLOCK_TYPE_2 ) {
+			fprintf(stderr, "Can't rollup block type %u in file '%s'\n", block_header.id, filename);
+			ok = 0;
+			break;
+		}
+
+		record = (common_record_t *)block;
+		for ( i=0; i < block_header.NumRecords && ok; i++ ) {
+			if ( record->type == CommonRecordType ) {
+				if ( extension_map_list->slot[record->ext_map] == NULL ) {
+					fprintf(stderr, "Corrupt data file '%s'. Missing extension map %u\n", filename, record->ext_map);
+					ok = 0;
+					break;
+				}
+				master_record = &(extension_map_list->slot[record->ext_map]->master_record);
+				ExpandRecord_v2(record, extension_map_list->slot[record->ext_map], master_record);
+				UpdateStat(&stat_record, master_record);
+
+				for ( k=0; RollupKeys[k].name && ok; k++ ) {
+					if ( (key_bits & (1 << k)) == 0 ) 
+						continue;
+					for ( j=0; j<RollupKeys[k].num_elem && ok; j++ ) {
+						struct rollup_element_s *e = &RollupKeys[k].element[j];
+						value[1] = (((uint64_t *)master_record)[e->offset1] & e->mask) >> e->shift;
+						value[0] = e->offset0 ? ((uint64_t *)master_record)[e->offset0] : 0;
+						ok = AddRollupValue(&table[k], value, master_record);
+					}
+				}
+			} else if ( record->type == ExtensionMapType ) {
+				Insert_Extension_Map(extension_map_list, (extension_map_t *)record);
+			}
+			record = (common_record_t *)((pointer_addr_t)record + record->size);
+		}
+	}
+	DisposeRFile(rfile);
+	free(buff);
+	FreeExtensionMaps(extension_map_list);
+	free(extension_map_list);
+
+	if ( ok ) 
+		ok = WriteRollup(filename, key_bits, table, &stat_record, stat_buf.st_size);
+
+	for ( k=0; RollupKeys[k].name; k++ ) {
+		if ( key_bits & (1 << k) ) 
+			FreeRollupTable(&table[k]);
+	}
+
+	return ok;
+
+} // End of RollupFile
+
+static int WriteRollup(char *filename, uint32_t key_bits, rollup_table_t *table, stat_record_t *stat_record, uint64_t file_size) {
+rollup_header_t		rollup_header;
+rollup_section_t	section;
+rollup_record_t		*records;
+StatRecord_t		*r;
+char				path[MAXPATHLEN], tmp_path[MAXPATHLEN];
+uint32_t			i, k, n;
+ssize_t				size;
+int					fd, ok;
+
+	rollup_header.magic		  = ROLLUP_MAGIC;
+	rollup_header.version	  = ROLLUP_VERSION_1;
+	rollup_header.NumSections = 0;
+	rollup_header.file_size	  = file_size;
+	for ( k=0; RollupKeys[k].name; k++ ) {
+		if ( key_bits & (1 << k) ) 
+			rollup_header.NumSections++;
+	}
+
+	// write a temporary file and rename it, so readers never see a partial rollup
+	if ( snprintf(path, MAXPATHLEN, "%s%s", filename, ROLLUP_SUFFIX) >= MAXPATHLEN ||
+		 snprintf(tmp_path, MAXPATHLEN, "%s-tmp", path) >= MAXPATHLEN ) {
+		fprintf(stderr, "Path of rollup file too long: %s%s\n" , filename, ROLLUP_SUFFIX);
+		return 0;
+	}
+
+	fd = open(tmp_path, O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+	if ( fd < 0 ) {
+		fprintf(stderr, "Failed to open file %s: '%s'\n" , tmp_path, strerror(errno));
+		return 0;
+	}
+
+	ok = write(fd, (void *)&rollup_header, sizeof(rollup_header_t)) == sizeof(rollup_header_t) &&
+		 write(fd, (void *)stat_record, sizeof(stat_record_t)) == sizeof(stat_record_t);
+
+	for ( k=0; RollupKeys[k].name && ok; k++ ) {
+		if ( (key_bits & (1 << k)) == 0 ) 
+			continue;
+
+		records = (rollup_record_t *)calloc(table[k].NumRecords ? table[k].NumRecords : 1, sizeof(rollup_record_t));
+		if ( !records ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			close(fd);
+			unlink(tmp_path);
+			return 0;
+		}
+
+		n = 0;
+		for ( i=0; i <= table[k].IndexMask; i++ ) {
+			for ( r = table[k].bucket[i]; r; r = r->next ) {
+				records[n].stat_key[0]	= r->stat_key[0];
+				records[n].stat_key[1]	= r->stat_key[1];
+				records[n].counter[0]	= r->counter[0];
+				records[n].counter[1]	= r->counter[1];
+				records[n].counter[2]	= r->counter[2];
+				records[n].first		= r->first;
+				records[n].last			= r->last;
+				records[n].msec_first	= r->msec_first;
+				records[n].msec_last	= r->msec_last;
+				records[n].prot			= r->prot;
+				records[n].record_flags	= r->record_flags;
+				n++;
+			}
+		}
+		// top talkers first
+		qsort(records, n, sizeof(rollup_record_t), CompareBytes);
+
+		memset((void *)&section, 0, sizeof(rollup_section_t));
+		strncpy(section.name, RollupKeys[k].name, ROLLUP_NAME_SIZE-1);
+		section.NumRecords = n;
+
+		size = n * sizeof(rollup_record_t);
+		ok = write(fd, (void *)&section, sizeof(rollup_section_t)) == sizeof(rollup_section_t) &&
+			 write(fd, (void *)records, size) == size;
+		free(records);
+	}
+
+	if ( !ok || close(fd) < 0 || rename(tmp_path, path) < 0 ) {
+		fprintf(stderr, "Failed to write rollup file %s: '%s'\n" , path, strerror(errno));
+		if ( !ok ) 
+			close(fd);
+		unlink(tmp_path);
+		return 0;
+	}
+
+	return 1;
+
+} // End of WriteRollup
+
+/*
+ * Map the rollup <filename>.rollup of a file. Returns NULL, if the file 
+ * has no valid rollup
+ */
+rollup_t *OpenRollup(char *filename) {
+struct stat			stat_buf, rollup_stat;
+rollup_header_t		*rollup_header;
+rollup_section_t	*section;
+rollup_t			*rollup;
+char				path[MAXPATHLEN];
+pointer_addr_t		p, end;
+void				*map;
+uint32_t			i;
+int					fd;
+
+	snprintf(path, MAXPATHLEN, "%s%s", filename, ROLLUP_SUFFIX);
+	path[MAXPATHLEN-1] = 0;
+
+	// the rollup is optional
+	fd = open(path, O_RDONLY);
+	if ( fd < 0 ) 
+		return NULL;
+
+	// the rollup must be newer than the data file
+	if ( stat(filename, &stat_buf) < 0 || fstat(fd, &rollup_stat) < 0 || 
+		 rollup_stat.st_mtime < stat_buf.st_mtime || 
+		 rollup_stat.st_size < (off_t)(sizeof(rollup_header_t) + sizeof(stat_record_t)) ) {
+		fprintf(stderr, "Skip stale or corrupt rollup file '%s'\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, rollup_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if ( map == MAP_FAILED ) {
+		fprintf(stderr, "mmap() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	rollup = (rollup_t *)calloc(1, sizeof(rollup_t));
+	if ( !rollup ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		munmap(map, rollup_stat.st_size);
+		return NULL;
+	}
+	rollup->map		 = map;
+	rollup->map_size = rollup_stat.st_size;
+
+	rollup_header = (rollup_header_t *)map;
+	if ( rollup_header->magic != ROLLUP_MAGIC || rollup_header->version != ROLLUP_VERSION_1 ||
+		 rollup_header->file_size != (uint64_t)stat_buf.st_size || rollup_header->NumSections > 32 ) {
+		fprintf(stderr, "Skip stale or corrupt rollup file '%s'\n", path);
+		CloseRollup(rollup);
+		return NULL;
+	}
+	rollup->stat_record = (stat_record_t *)((pointer_addr_t)map + sizeof(rollup_header_t));
+
+	rollup->section = (rollup_section_t **)calloc(rollup_header->NumSections + 1, sizeof(rollup_section_t *));
+	if ( !rollup->section ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		CloseRollup(rollup);
+		return NULL;
+	}
+
+	// check the sections against the size of the file
+	p	= (pointer_addr_t)rollup->stat_record + sizeof(stat_record_t);
+	end = (pointer_addr_t)map + rollup_stat.st_size;
+	for ( i=0; i<rollup_header->NumSections; i++ ) {
+		section = (rollup_section_t *)p;
+		if ( p + sizeof(rollup_section_t) > end || 
+			 (uint64_t)(end - p - sizeof(rollup_section_t)) / sizeof(rollup_record_t) < section->NumRecords ) {
+			fprintf(stderr, "Skip stale or corrupt rollup file '%s'\n", path);
+			CloseRollup(rollup);
+			return NULL;
+		}
+		rollup->section[i] = section;
+		p += sizeof(rollup_section_t) + section->NumRecords * sizeof(rollup_record_t);
+	}
+	rollup->num_sections = rollup_header->NumSections;
+
+	return rollup;
+
+} // End of OpenRollup
+
+/*
+ * Return the records of the section of key name and their number in num_records
+ * or NULL, if the rollup has no such section
+ */
+rollup_record_t *RollupSection(rollup_t *rollup, char *name, uint32_t *num_records) {
+uint32_t i;
+
+	for ( i=0; i<rollup->num_sections; i++ ) {
+		if ( strncasecmp(rollup->section[i]->name, name, ROLLUP_NAME_SIZE) == 0 ) {
+			*num_records = rollup->section[i]->NumRecords;
+			return (rollup_record_t *)((pointer_addr_t)rollup->section[i] + sizeof(rollup_section_t));
+		}
+	}
+
+	return NULL;
+
+} // End of RollupSection
+
+void CloseRollup(rollup_t *rollup) {
+
+	if ( !rollup ) 
+		return;
+	munmap(rollup->map, rollup->map_size);
+	free(rollup->section);
+	free(rollup);
+
+} // End of CloseRollup
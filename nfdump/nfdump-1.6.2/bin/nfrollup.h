@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+
+#ifndef _NFROLLUP_H
+#define _NFROLLUP_H 1
+
+/*
+ * Rollup:
+ * =======
+ * The optional sidecar file <file>.rollup, created by nfcapd -G, sfcapd -G, nfprofile -G or 
+ * nfdump -G, holds the flows of a file aggregated for a set of -s statistic keys, such as 
+ * srcip or dstport. Each section holds the counters of all values of one key, as they are
+ * accumulated by AddStat() for nfdump -s, ordered by bytes. The first records of a section
+ * are therefore the top talkers of the time slot. nfdump -s merges the sections of the 
+ * rollups instead of aggregating the flows of the files again.
+ *
+ *   +---------------+-------------+------------------+---------+------------------+---------+-----+
+ *   | rollup header | stat record | section header 1 | records | section header 2 | records | ... |
+ *   +---------------+-------------+------------------+---------+------------------+---------+-----+
+ *
+ * The values are aggregated per protocol, so a section answers statistics with and without
+ * the protocol ( -s srcport:p ) alike. The stat record sums up all flows of the file.
+ */
+#define ROLLUP_SUFFIX ".rollup"
+
+typedef struct rollup_header_s {
+	uint16_t	magic;				// magic to recognize the rollup file
+#define ROLLUP_MAGIC 0xA50F
+	uint16_t	version;			// version of the rollup layout
+#define ROLLUP_VERSION_1	1
+	uint32_t	NumSections;		// number of keys
+	uint64_t	file_size;			// size of the aggregated file, to detect a stale rollup
+} rollup_header_t;
+
+#define ROLLUP_NAME_SIZE	16
+typedef struct rollup_section_s {
+	char		name[ROLLUP_NAME_SIZE];	// name of the key as in nfdump -s
+	uint32_t	NumRecords;			// number of rollup records following
+	uint32_t	flags;
+} rollup_section_t;
+
+// the counters of a StatRecord_t
+typedef struct rollup_record_s {
+	uint64_t	stat_key[2];
+	uint64_t	counter[3];			// flows, packets and bytes
+	uint32_t	first;
+	uint32_t	last;
+	uint16_t	msec_first;
+	uint16_t	msec_last;
+	uint8_t		prot;
+	uint8_t		record_flags;
+	uint16_t	fill;
+} rollup_record_t;
+
+/* handle of a mapped rollup file */
+typedef struct rollup_s {
+	void				*map;
+	size_t				map_size;
+	stat_record_t		*stat_record;
+	rollup_section_t	**section;
+	uint32_t			num_sections;
+} rollup_t;
+
+int ParseRollupKeys(char *keys, uint32_t *key_bits);
+
+int RollupFile(char *filename, uint32_t key_bits);
+
+rollup_t *OpenRollup(char *filename);
+
+rollup_record_t *RollupSection(rollup_t *rollup, char *name, uint32_t *num_records);
+
+void CloseRollup(rollup_t *rollup);
+
+#endif //_NFROLLUP_H
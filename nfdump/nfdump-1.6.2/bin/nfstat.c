@@ -46,6 +46,7 @@
 #include <arpa/inet.h>
 #include <time.h>
 #include <string.h>
+#include <strings.h>
 #include <ctype.h>
 
 #ifdef HAVE_STDINT_H
@@ -64,6 +65,7 @@
 #include "util.h"
 #include "panonymizer.h"
 #include "nflowcache.h"
+#include "nfrollup.h"
 #include "nfstat.h"
 
 extern int hash_hit;
@@ -280,10 +282,12 @@ static const uint32_t NumOrders = 6;	// Number of Stats in enum StatTypes
 enum CntIndices { FLOWS = 0, INPACKETS, INBYTES, OUTPACKETS, OUTBYTES };
 
 #define MaxStats 16
+#define MaxApproxEntries (1 << 28)
 struct StatRequest_s {
 	uint16_t	order_bits;		// bits 0: flows 1: packets 2: bytes 3: pps 4: bps, 5 bpp
 	int16_t		StatType;		// value out of enum StatTypes
 	uint8_t		order_proto;	// protocol separated statistics
+	uint8_t		weight;			// counter, which weights the records of approximate stats
 } StatRequest[MaxStats];		// This number should do it for a single run
 
 uint32_t	flow_stat_order;
@@ -326,17 +330,33 @@ enum { NONE = 0, LESS, MORE };
 /* function prototypes */
 static int ParseStatString(char *str, int16_t	*StatType, uint16_t *order_bits, int *flow_record_stat, uint16_t *order_proto);
 
-static inline StatRecord_t *stat_hash_lookup(uint64_t *value, uint8_t prot, int hash_num);
+static inline StatRecord_t *stat_hash_lookup(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num);
 
-static inline StatRecord_t *stat_hash_insert(uint64_t *value, uint8_t prot, int hash_num);
+static inline StatRecord_t *stat_hash_insert(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num);
 
-static void Expand_StatTable_Blocks(int hash_num);
+static inline void stat_hash_link(hash_StatTable *table, StatRecord_t *record, int hash_num);
 
-static void PrintStatLine(stat_record_t	*stat, StatRecord_t *StatData, int type, int anon, int order_proto, int tag);
+static inline void stat_hash_unlink(hash_StatTable *table, StatRecord_t *record, int hash_num);
 
-static void PrintPipeStatLine(StatRecord_t *StatData, int type, int anon, int order_proto, int tag);
+static inline StatRecord_t *ss_insert(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num);
 
-static void PrintCvsStatLine(stat_record_t	*stat, StatRecord_t *StatData, int type, int anon, int order_proto, int tag);
+static inline uint64_t ss_weight(hash_StatTable *t, int hash_num, uint32_t idx);
+
+static void ss_heap_fix(hash_StatTable *table, int hash_num, StatRecord_t *record);
+
+static uint64_t ss_error(int hash_num, StatRecord_t *record);
+
+static void Expand_StatTable_Blocks(hash_StatTable *table, int hash_num);
+
+static hash_StatTable *new_StatTables(void);
+
+static void free_StatTables(hash_StatTable *table);
+
+static void PrintStatLine(stat_record_t	*stat, StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag);
+
+static void PrintPipeStatLine(StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag);
+
+static void PrintCvsStatLine(stat_record_t	*stat, StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag);
 
 static void Create_topN_FlowStat(SortElement_t **topN_lists, int order, int topN, uint32_t *count );
 
@@ -344,13 +364,14 @@ static inline int TimeMsec_CMP(time_t t1, uint16_t offset1, time_t t2, uint16_t
 
 static SortElement_t *StatTopN(int topN, uint32_t *count, int hash_num, int order );
 
-static inline void RankValue(FlowTableRecord_t *r, uint64_t val, int topN, SortElement_t *topN_list);
-
 static void SwapFlow(master_record_t *flow_record);
 
 /* locals */
 static hash_StatTable *StatTable;
 static int initialised = 0;
+static uint16_t StatBits;
+static uint32_t StatPrealloc;
+static uint32_t ApproxEntries = 0;	// > 0: approximate stats with max ApproxEntries records each
 
 static int	NumStats = 0, DefaultOrder;
 
@@ -549,74 +570,145 @@ uint32_t	len,scale;
 
 } // End of SetLimits
 
-int Init_StatTable(uint16_t NumBits, uint32_t Prealloc) {
+// allocates the stat tables of all requested -s stats
+static hash_StatTable *new_StatTables(void) {
+hash_StatTable *table;
 uint32_t maxindex;
 int		 hash_num;
 
-	if ( NumBits == 0 || NumBits > 31 ) {
-		fprintf(stderr, "Numbits outside 1..31\n");
-		exit(255);
-	}
-
-	maxindex = (1 << NumBits);
+	maxindex = (1 << StatBits);
 
-	StatTable = (hash_StatTable *)calloc(NumStats, sizeof(hash_StatTable));
-	if ( !StatTable ) {
+	table = (hash_StatTable *)calloc(NumStats, sizeof(hash_StatTable));
+	if ( !table ) {
 		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
-		return 0;
+		return NULL;
 	}
 
 	for ( hash_num=0; hash_num<NumStats; hash_num++ ) {
-		StatTable[hash_num].IndexMask   = maxindex -1;
-		StatTable[hash_num].NumBits     = NumBits;
-		StatTable[hash_num].Prealloc    = Prealloc;
-		StatTable[hash_num].bucket	  	= (StatRecord_t **)calloc(maxindex, sizeof(StatRecord_t *));
-		StatTable[hash_num].bucketcache = (StatRecord_t **)calloc(maxindex, sizeof(StatRecord_t *));
-		if ( !StatTable[hash_num].bucket || !StatTable[hash_num].bucketcache ) {
+		table[hash_num].IndexMask   = maxindex -1;
+		table[hash_num].NumBits     = StatBits;
+		table[hash_num].Prealloc    = StatPrealloc;
+		table[hash_num].bucket	  	= (StatRecord_t **)calloc(maxindex, sizeof(StatRecord_t *));
+		table[hash_num].bucketcache = (StatRecord_t **)calloc(maxindex, sizeof(StatRecord_t *));
+		table[hash_num].memblock	= (StatRecord_t **)calloc(MaxMemBlocks, sizeof(StatRecord_t *));
+		if ( !table[hash_num].bucket || !table[hash_num].bucketcache || !table[hash_num].memblock ) {
 			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
-			return 0;
+			free_StatTables(table);
+			return NULL;
 		}
-		StatTable[hash_num].memblock = (StatRecord_t **)calloc(MaxMemBlocks, sizeof(StatRecord_t *));
-		if ( !StatTable[hash_num].memblock ) {
+		table[hash_num].memblock[0] = (StatRecord_t *)calloc(StatPrealloc, sizeof(StatRecord_t));
+		if ( !table[hash_num].memblock[0] ) {
 			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
-			return 0;
-		}
-		StatTable[hash_num].memblock[0] = (StatRecord_t *)calloc(Prealloc, sizeof(StatRecord_t));
-		if ( !StatTable[hash_num].memblock[0] ) {
-			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
-			return 0;
+			free_StatTables(table);
+			return NULL;
 		}
 	
-		StatTable[hash_num].NumBlocks = 1;
-		StatTable[hash_num].MaxBlocks = MaxMemBlocks;
-		StatTable[hash_num].NextBlock = 0;
-		StatTable[hash_num].NextElem  = 0;
+		table[hash_num].NumBlocks = 1;
+		table[hash_num].MaxBlocks = MaxMemBlocks;
+		table[hash_num].NextBlock = 0;
+		table[hash_num].NextElem  = 0;
+
+		if ( ApproxEntries ) {
+			// all records live in the single stat block of StatPrealloc == ApproxEntries records
+			table[hash_num].Capacity = ApproxEntries;
+			table[hash_num].HeapSize = 0;
+			table[hash_num].heap	 = (uint32_t *)malloc(ApproxEntries * sizeof(uint32_t));
+			table[hash_num].heap_pos = (uint32_t *)malloc(ApproxEntries * sizeof(uint32_t));
+			table[hash_num].error	 = (uint64_t *)malloc(ApproxEntries * sizeof(uint64_t));
+			if ( !table[hash_num].heap || !table[hash_num].heap_pos || !table[hash_num].error ) {
+				fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+				free_StatTables(table);
+				return NULL;
+			}
+		}
+	}
+
+	return table;
+
+} // End of new_StatTables
+
+static void free_StatTables(hash_StatTable *table) {
+unsigned int i, hash_num;
+
+	for ( hash_num=0; hash_num<NumStats; hash_num++ ) {
+		free((void *)table[hash_num].bucket);
+		free((void *)table[hash_num].bucketcache);
+		for ( i=0; i<table[hash_num].NumBlocks; i++ ) 
+			free((void *)table[hash_num].memblock[i]);
+		free((void *)table[hash_num].memblock);
+		free((void *)table[hash_num].heap);
+		free((void *)table[hash_num].heap_pos);
+		free((void *)table[hash_num].error);
+	}
+	free((void *)table);
+
+} // End of free_StatTables
+
+int Init_StatTable(uint16_t NumBits, uint32_t Prealloc) {
+int		 hash_num;
+
+	if ( NumBits == 0 || NumBits > 31 ) {
+		fprintf(stderr, "Numbits outside 1..31\n");
+		exit(255);
+	}
+
+	StatBits	 = NumBits;
+	StatPrealloc = Prealloc;
+	if ( ApproxEntries ) {
+		// the table never holds more than ApproxEntries records
+		StatBits = 1;
+		while ( StatBits < 31 && (1U << StatBits) < ApproxEntries ) 
+			StatBits++;
+		StatPrealloc = ApproxEntries;
+	}
 
+	for ( hash_num=0; hash_num<NumStats; hash_num++ ) {
+		uint16_t order_bits;
 		if ( StatRequest[hash_num].order_bits == 0 ) {
 			StatRequest[hash_num].order_bits = DefaultOrder;
 		}
+		// approximate stats are weighted by the first counter order: flows, packets or bytes
+		order_bits = StatRequest[hash_num].order_bits & 0x7;
+		StatRequest[hash_num].weight = order_bits ? ffs(order_bits) - 1 : FLOWS;
 	}
 
+	StatTable	 = new_StatTables();
+	if ( !StatTable ) 
+		return 0;
+
 	initialised = 1;
 	return 1;
 
 } // End of Init_StatTable
 
 void Dispose_StatTable() {
-unsigned int i, hash_num;
 
 	if ( !initialised ) 
 		return;
 
-	for ( hash_num=0; hash_num<NumStats; hash_num++ ) {
-		free((void *)StatTable[hash_num].bucket);
-		for ( i=0; i<StatTable[hash_num].NumBlocks; i++ ) 
-			free((void *)StatTable[hash_num].memblock[i]);
-		free((void *)StatTable[hash_num].memblock);
-	}
+	free_StatTables(StatTable);
+	StatTable	= NULL;
+	initialised = 0;
 
 } // End of Dispose_Tables
 
+// returns private stat tables of a worker thread for all requested -s stats
+hash_StatTable *New_StatTable(void) {
+
+	if ( !initialised ) 
+		return NULL;
+
+	return new_StatTables();
+
+} // End of New_StatTable
+
+void Dispose_StatTable_r(hash_StatTable *table) {
+
+	if ( table ) 
+		free_StatTables(table);
+
+} // End of Dispose_StatTable_r
+
 int SetStat(char *str, int *element_stat, int *flow_stat) {
 int			flow_record_stat = 0;
 int16_t 	StatType    = 0;
@@ -743,16 +835,50 @@ int order_index;
 
 } // End of SetStat_DefaultOrder
 
-static inline StatRecord_t *stat_hash_lookup(uint64_t *value, uint8_t prot, int hash_num) {
+/*
+ * Approximate -s stats: each stat keeps at most a fixed number of records. If the table is full,
+ * a new element replaces the record with the smallest weight and inherits its weight as error.
+ * str is either the number of records or the max error in % of the total weight e.g. '0.1%',
+ * which must be within (0,100].
+ * Must be called before Init_StatTable(). Returns 0 for an invalid str.
+ */
+int SetStat_Approximate(char *str) {
+char	*end;
+double	val;
+
+	val = strtod(str, &end);
+	if ( end == str || val <= 0 ) 
+		return 0;
+
+	if ( *end == '%' && end[1] == '\0' ) {
+		if ( val > 100 ) 
+			return 0;
+		// Space-Saving guarantees an error <= total weight / number of records
+		val = 100.0 / val;
+		if ( val != (double)(uint64_t)val ) 
+			val = (double)((uint64_t)val + 1);
+	} else if ( *end != '\0' || val != (double)(uint64_t)val ) {
+		return 0;
+	}
+
+	if ( val < 1 || val > MaxApproxEntries ) 
+		return 0;
+
+	ApproxEntries = (uint32_t)val;
+	return 1;
+
+} // End of SetStat_Approximate
+
+static inline StatRecord_t *stat_hash_lookup(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num) {
 uint32_t		index;
 StatRecord_t	*record;
 
-	index = value[1] & StatTable[hash_num].IndexMask;
+	index = value[1] & table[hash_num].IndexMask;
 
-	if ( StatTable[hash_num].bucket[index] == NULL )
+	if ( table[hash_num].bucket[index] == NULL )
 		return NULL;
 
-	record = StatTable[hash_num].bucket[index];
+	record = table[hash_num].bucket[index];
 	if ( StatRequest[hash_num].order_proto ) {
 		while ( record && ( record->stat_key[1] != value[1] || record->stat_key[0] != value[0] || prot != record->prot ) ) {
 			record = record->next;
@@ -766,55 +892,176 @@ StatRecord_t	*record;
 
 } // End of stat_hash_lookup
 
-static void Expand_StatTable_Blocks(int hash_num) {
+static void Expand_StatTable_Blocks(hash_StatTable *table, int hash_num) {
 
-	if ( StatTable[hash_num].NumBlocks >= StatTable[hash_num].MaxBlocks ) {
-		StatTable[hash_num].MaxBlocks += MaxMemBlocks;
-		StatTable[hash_num].memblock = (StatRecord_t **)realloc(StatTable[hash_num].memblock,
-						StatTable[hash_num].MaxBlocks * sizeof(StatRecord_t *));
-		if ( !StatTable[hash_num].memblock ) {
+	if ( table[hash_num].NumBlocks >= table[hash_num].MaxBlocks ) {
+		table[hash_num].MaxBlocks += MaxMemBlocks;
+		table[hash_num].memblock = (StatRecord_t **)realloc(table[hash_num].memblock,
+						table[hash_num].MaxBlocks * sizeof(StatRecord_t *));
+		if ( !table[hash_num].memblock ) {
 			fprintf(stderr, "realloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror (errno));
 			exit(250);
 		}
 	}
-	StatTable[hash_num].memblock[StatTable[hash_num].NumBlocks] = 
-			(StatRecord_t *)calloc(StatTable[hash_num].Prealloc, sizeof(StatRecord_t));
+	table[hash_num].memblock[table[hash_num].NumBlocks] = 
+			(StatRecord_t *)calloc(table[hash_num].Prealloc, sizeof(StatRecord_t));
 
-	if ( !StatTable[hash_num].memblock[StatTable[hash_num].NumBlocks] ) {
+	if ( !table[hash_num].memblock[table[hash_num].NumBlocks] ) {
 		fprintf(stderr, "calloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror (errno));
 		exit(250);
 	}
-	StatTable[hash_num].NextBlock = StatTable[hash_num].NumBlocks++;
-	StatTable[hash_num].NextElem  = 0;
+	table[hash_num].NextBlock = table[hash_num].NumBlocks++;
+	table[hash_num].NextElem  = 0;
 
 } // End of Expand_StatTable_Blocks
 
-static inline StatRecord_t *stat_hash_insert(uint64_t *value, uint8_t prot, int hash_num) {
-uint32_t		index;
+static inline StatRecord_t *stat_hash_insert(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num) {
 StatRecord_t	*record;
 
-	if ( StatTable[hash_num].NextElem >= StatTable[hash_num].Prealloc )
-		Expand_StatTable_Blocks(hash_num);
+	if ( table[hash_num].NextElem >= table[hash_num].Prealloc )
+		Expand_StatTable_Blocks(table, hash_num);
 
-	record = &(StatTable[hash_num].memblock[StatTable[hash_num].NextBlock][StatTable[hash_num].NextElem]);
-	StatTable[hash_num].NextElem++;
-	record->next     	= NULL;
+	record = &(table[hash_num].memblock[table[hash_num].NextBlock][table[hash_num].NextElem]);
+	table[hash_num].NextElem++;
 	record->stat_key[0] = value[0];
 	record->stat_key[1] = value[1];
 	record->prot		= prot;
-
-	index = value[1] & StatTable[hash_num].IndexMask;
-	if ( StatTable[hash_num].bucket[index] == NULL ) 
-		StatTable[hash_num].bucket[index] = record;
-	else
-		StatTable[hash_num].bucketcache[index]->next = record;
-	StatTable[hash_num].bucketcache[index] = record;
+	stat_hash_link(table, record, hash_num);
 	
 	return record;
 
 } // End of stat_hash_insert
 
+// appends record to the end of the chain of its index
+static inline void stat_hash_link(hash_StatTable *table, StatRecord_t *record, int hash_num) {
+uint32_t		index;
+
+	record->next = NULL;
+	index = record->stat_key[1] & table[hash_num].IndexMask;
+	if ( table[hash_num].bucket[index] == NULL ) 
+		table[hash_num].bucket[index] = record;
+	else
+		table[hash_num].bucketcache[index]->next = record;
+	table[hash_num].bucketcache[index] = record;
+
+} // End of stat_hash_link
+
+static inline void stat_hash_unlink(hash_StatTable *table, StatRecord_t *record, int hash_num) {
+uint32_t		index;
+StatRecord_t	*r, *prev;
+
+	index = record->stat_key[1] & table[hash_num].IndexMask;
+	prev  = NULL;
+	r	  = table[hash_num].bucket[index];
+	while ( r != record ) {
+		prev = r;
+		r	 = r->next;
+	}
+
+	if ( prev )
+		prev->next = record->next;
+	else
+		table[hash_num].bucket[index] = record->next;
+	if ( table[hash_num].bucketcache[index] == record ) 
+		table[hash_num].bucketcache[index] = prev;
+
+} // End of stat_hash_unlink
+
+/*
+ * Space-Saving insert of a new element into an approximate stat table. As long as the table is not full, 
+ * a new record is added, otherwise the record with the smallest weight is replaced. The new element
+ * may have been counted up to this weight before, which becomes the error of the new record.
+ * The caller sets the counters of the record and calls ss_heap_fix() afterwards.
+ */
+static inline StatRecord_t *ss_insert(hash_StatTable *table, uint64_t *value, uint8_t prot, int hash_num) {
+hash_StatTable	*t = &table[hash_num];
+StatRecord_t	*record;
+uint32_t		idx;
+
+	if ( t->HeapSize < t->Capacity ) {
+		record = stat_hash_insert(table, value, prot, hash_num);
+		idx	   = record - t->memblock[0];
+		t->error[idx] 		  = 0;
+		t->heap[t->HeapSize]  = idx;
+		t->heap_pos[idx] 	  = t->HeapSize++;
+		return record;
+	}
+
+	// the root of the min heap holds the smallest weight
+	idx	   = t->heap[0];
+	record = &t->memblock[0][idx];
+	t->error[idx] = ss_weight(t, hash_num, idx);
+
+	stat_hash_unlink(table, record, hash_num);
+	record->stat_key[0] = value[0];
+	record->stat_key[1] = value[1];
+	record->prot		= prot;
+	stat_hash_link(table, record, hash_num);
+
+	return record;
+
+} // End of ss_insert
+
+static inline uint64_t ss_weight(hash_StatTable *t, int hash_num, uint32_t idx) {
+
+	return t->memblock[0][idx].counter[StatRequest[hash_num].weight] + t->error[idx];
+
+} // End of ss_weight
+
+// restore the heap order of record after its weight changed
+static void ss_heap_fix(hash_StatTable *table, int hash_num, StatRecord_t *record) {
+hash_StatTable	*t = &table[hash_num];
+uint32_t		idx, pos, parent, child;
+uint64_t		weight;
+
+	idx	   = record - t->memblock[0];
+	pos	   = t->heap_pos[idx];
+	weight = ss_weight(t, hash_num, idx);
+
+	// sift up
+	while ( pos > 0 ) {
+		parent = (pos - 1) >> 1;
+		if ( ss_weight(t, hash_num, t->heap[parent]) <= weight ) 
+			break;
+		t->heap[pos] = t->heap[parent];
+		t->heap_pos[t->heap[pos]] = pos;
+		pos = parent;
+	}
+
+	// sift down
+	while ( (child = 2*pos + 1) < t->HeapSize ) {
+		if ( child + 1 < t->HeapSize && 
+			 ss_weight(t, hash_num, t->heap[child+1]) < ss_weight(t, hash_num, t->heap[child]) )
+			child++;
+		if ( weight <= ss_weight(t, hash_num, t->heap[child]) ) 
+			break;
+		t->heap[pos] = t->heap[child];
+		t->heap_pos[t->heap[pos]] = pos;
+		pos = child;
+	}
+
+	t->heap[pos]	  = idx;
+	t->heap_pos[idx] = pos;
+
+} // End of ss_heap_fix
+
+// returns the error of a record of the global stat table hash_num
+static uint64_t ss_error(int hash_num, StatRecord_t *record) {
+
+	if ( !StatTable[hash_num].Capacity )
+		return 0;
+
+	return StatTable[hash_num].error[record - StatTable[hash_num].memblock[0]];
+
+} // End of ss_error
+
 void AddStat(common_record_t *raw_record, master_record_t *flow_record ) {
+
+	AddStat_r(StatTable, raw_record, flow_record);
+
+} // End of AddStat
+
+void AddStat_r(hash_StatTable *table, common_record_t *raw_record, master_record_t *flow_record ) {
 StatRecord_t		*stat_record;
 uint64_t			value[2];
 int	j, i;
@@ -832,7 +1079,7 @@ int	j, i;
 			offset = StatParameters[stat].element[i].offset0;
 			value[0] = offset ? ((uint64_t *)flow_record)[offset] : 0;
 
-			stat_record = stat_hash_lookup(value, flow_record->prot, j);
+			stat_record = stat_hash_lookup(table, value, flow_record->prot, j);
 			if ( stat_record ) {
 				stat_record->counter[INBYTES] 	+= flow_record->dOctets;
 				stat_record->counter[INPACKETS] += flow_record->dPkts;
@@ -848,7 +1095,9 @@ int	j, i;
 				stat_record->counter[FLOWS]++;
 		
 			} else {
-				stat_record = stat_hash_insert(value, flow_record->prot, j);
+				stat_record = table[j].Capacity ? 
+					ss_insert(table, value, flow_record->prot, j) : 
+					stat_hash_insert(table, value, flow_record->prot, j);
 		
 				stat_record->counter[INBYTES]   = flow_record->dOctets;
 				stat_record->counter[INPACKETS]	= flow_record->dPkts;
@@ -859,13 +1108,141 @@ int	j, i;
 				stat_record->record_flags		= flow_record->flags & 0x1;
 				stat_record->counter[FLOWS] 	= 1;
 			}
+			if ( table[j].Capacity ) 
+				ss_heap_fix(table, j, stat_record);
 		} // for the number of elements in this stat type
 	} // for every requested -s stat
 
-} // End of AddStat
+} // End of AddStat_r
+
+/*
+ * Check, if the rollup holds the aggregates of all requested -s stats
+ */
+int RollupHasStats(rollup_t *rollup) {
+uint32_t num_records;
+int	j;
+
+	for ( j=0; j<NumStats; j++ ) {
+		int stat = StatRequest[j].StatType;
+		if ( !RollupSection(rollup, StatParameters[stat].statname, &num_records) ) 
+			return 0;
+	}
+	return 1;
+
+} // End of RollupHasStats
+
+/*
+ * Merge the aggregates of a rollup into the stat tables, as if the flows of its file 
+ * were added by AddStat(). The rollup must hold all requested stats - see RollupHasStats()
+ */
+void AddRollupStat(rollup_t *rollup) {
+StatRecord_t	*stat_record;
+rollup_record_t	*records, *r;
+uint32_t		num_records, i;
+int	j;
+
+	// for every requested -s stat do
+	for ( j=0; j<NumStats; j++ ) {
+		int stat = StatRequest[j].StatType;
+		records = RollupSection(rollup, StatParameters[stat].statname, &num_records);
+		if ( !records ) 
+			continue;
+
+		for ( i=0; i<num_records; i++ ) {
+			r = &records[i];
+			stat_record = stat_hash_lookup(StatTable, r->stat_key, r->prot, j);
+			if ( stat_record ) {
+				stat_record->counter[FLOWS]		+= r->counter[FLOWS];
+				stat_record->counter[INPACKETS]	+= r->counter[INPACKETS];
+				stat_record->counter[INBYTES]	+= r->counter[INBYTES];
+
+				if ( TimeMsec_CMP(r->first, r->msec_first, stat_record->first, stat_record->msec_first) == 2) {
+					stat_record->first 		= r->first;
+					stat_record->msec_first = r->msec_first;
+				}
+				if ( TimeMsec_CMP(r->last, r->msec_last, stat_record->last, stat_record->msec_last) == 1) {
+					stat_record->last 		= r->last;
+					stat_record->msec_last 	= r->msec_last;
+				}
+			} else {
+				stat_record = StatTable[j].Capacity ? 
+					ss_insert(StatTable, r->stat_key, r->prot, j) : 
+					stat_hash_insert(StatTable, r->stat_key, r->prot, j);
+
+				stat_record->counter[FLOWS]		= r->counter[FLOWS];
+				stat_record->counter[INPACKETS]	= r->counter[INPACKETS];
+				stat_record->counter[INBYTES]	= r->counter[INBYTES];
+				stat_record->first				= r->first;
+				stat_record->msec_first			= r->msec_first;
+				stat_record->last				= r->last;
+				stat_record->msec_last			= r->msec_last;
+				stat_record->record_flags		= r->record_flags;
+			}
+			if ( StatTable[j].Capacity ) 
+				ss_heap_fix(StatTable, j, stat_record);
+		}
+	} // for every requested -s stat
+
+} // End of AddRollupStat
+
+/*
+ * Merge the stat records of the worker tables table into the global stat tables, 
+ * as if the flows of the worker were added by AddStat(). The errors of approximate
+ * worker tables add up to the errors of the global records.
+ */
+void Merge_StatTable(hash_StatTable *table) {
+StatRecord_t	*stat_record, *r;
+uint32_t		block, num_elem, i;
+int	j;
+
+	// for every requested -s stat do
+	for ( j=0; j<NumStats; j++ ) {
+		// the records are stored in sequence in the memory blocks
+		for ( block=0; block <= table[j].NextBlock; block++ ) {
+			num_elem = block == table[j].NextBlock ? table[j].NextElem : table[j].Prealloc;
+			for ( i=0; i<num_elem; i++ ) {
+				r = &table[j].memblock[block][i];
+				stat_record = stat_hash_lookup(StatTable, r->stat_key, r->prot, j);
+				if ( stat_record ) {
+					stat_record->counter[FLOWS]		+= r->counter[FLOWS];
+					stat_record->counter[INPACKETS]	+= r->counter[INPACKETS];
+					stat_record->counter[INBYTES]	+= r->counter[INBYTES];
+
+					if ( TimeMsec_CMP(r->first, r->msec_first, stat_record->first, stat_record->msec_first) == 2) {
+						stat_record->first 		= r->first;
+						stat_record->msec_first = r->msec_first;
+					}
+					if ( TimeMsec_CMP(r->last, r->msec_last, stat_record->last, stat_record->msec_last) == 1) {
+						stat_record->last 		= r->last;
+						stat_record->msec_last 	= r->msec_last;
+					}
+				} else {
+					stat_record = StatTable[j].Capacity ? 
+						ss_insert(StatTable, r->stat_key, r->prot, j) : 
+						stat_hash_insert(StatTable, r->stat_key, r->prot, j);
+
+					stat_record->counter[FLOWS]		= r->counter[FLOWS];
+					stat_record->counter[INPACKETS]	= r->counter[INPACKETS];
+					stat_record->counter[INBYTES]	= r->counter[INBYTES];
+					stat_record->first				= r->first;
+					stat_record->msec_first			= r->msec_first;
+					stat_record->last				= r->last;
+					stat_record->msec_last			= r->msec_last;
+					stat_record->record_flags		= r->record_flags;
+				}
+				if ( StatTable[j].Capacity ) {
+					// approximate tables have a single stat block - i is the record index
+					StatTable[j].error[stat_record - StatTable[j].memblock[0]] += table[j].error[i];
+					ss_heap_fix(StatTable, j, stat_record);
+				}
+			}
+		}
+	} // for every requested -s stat
+
+} // End of Merge_StatTable
 
-static void PrintStatLine(stat_record_t	*stat, StatRecord_t *StatData, int type, int anon, int order_proto, int tag) {
-char		proto[16], valstr[40], datestr[64], flows_str[32], byte_str[32], packets_str[32], pps_str[32], bps_str[32];
+static void PrintStatLine(stat_record_t	*stat, StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag) {
+char		proto[16], valstr[40], datestr[64], flows_str[32], byte_str[32], packets_str[32], pps_str[32], bps_str[32], error_str[32];
 char tag_string[2];
 double		duration, flows_percent, packets_percent, bytes_percent;
 uint32_t	pps, bps, bpp;
@@ -949,6 +1326,7 @@ struct tm	*tbuff;
 
 	format_number(pps, pps_str, FIXED_WIDTH);
 	format_number(bps, bps_str, FIXED_WIDTH);
+	format_number(error, error_str, FIXED_WIDTH);
 
 	first = StatData->first;
 	tbuff = localtime(&first);
@@ -966,17 +1344,22 @@ struct tm	*tbuff;
 	}
 
 	if ( Getv6Mode() && ( type == IS_IPADDR ) )
-		printf("%s.%03u %9.3f %s %s%39s %8s(%4.1f) %8s(%4.1f) %8s(%4.1f) %8s %8s %5u\n", 
+		printf("%s.%03u %9.3f %s %s%39s %8s(%4.1f) %8s(%4.1f) %8s(%4.1f) %8s %8s %5u", 
 				datestr, StatData->msec_first, duration, proto, tag_string, valstr, 
 				flows_str, flows_percent, packets_str, packets_percent, byte_str, bytes_percent, pps_str, bps_str, bpp );
 	else
-		printf("%s.%03u %9.3f %s %s%17s %8s(%4.1f) %8s(%4.1f) %8s(%4.1f) %8s %8s %5u\n", 
+		printf("%s.%03u %9.3f %s %s%17s %8s(%4.1f) %8s(%4.1f) %8s(%4.1f) %8s %8s %5u", 
 				datestr, StatData->msec_first, duration, proto, tag_string, valstr, 
 				flows_str, flows_percent, packets_str, packets_percent, byte_str, bytes_percent, pps_str, bps_str, bpp );
 
+	if ( ApproxEntries ) 
+		printf(" %8s\n", error_str);
+	else
+		printf("\n");
+
 } // End of PrintStatLine
 
-static void PrintPipeStatLine(StatRecord_t *StatData, int type, int anon, int order_proto, int tag) {
+static void PrintPipeStatLine(StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag) {
 double		duration;
 uint32_t	pps, bps, bpp;
 uint32_t	sa[4];
@@ -1029,21 +1412,26 @@ int			af;
 	}
 
 	if ( type == IS_IPADDR )
-		printf("%i|%u|%u|%u|%u|%u|%u|%u|%u|%u|%llu|%llu|%llu|%u|%u|%u\n",
+		printf("%i|%u|%u|%u|%u|%u|%u|%u|%u|%u|%llu|%llu|%llu|%u|%u|%u",
 				af, StatData->first, StatData->msec_first ,StatData->last, StatData->msec_last, StatData->prot, 
 				sa[0], sa[1], sa[2], sa[3], (long long unsigned)StatData->counter[FLOWS], 
 				(long long unsigned)StatData->counter[INPACKETS], (long long unsigned)StatData->counter[INBYTES], 
 				pps, bps, bpp);
 	else
-		printf("%i|%u|%u|%u|%u|%u|%llu|%llu|%llu|%llu|%u|%u|%u\n",
+		printf("%i|%u|%u|%u|%u|%u|%llu|%llu|%llu|%llu|%u|%u|%u",
 				af, StatData->first, StatData->msec_first ,StatData->last, StatData->msec_last, StatData->prot, 
 				(long long unsigned)StatData->stat_key[1], (long long unsigned)StatData->counter[FLOWS], 
 				(long long unsigned)StatData->counter[INPACKETS], (long long unsigned)StatData->counter[INBYTES], 
 				pps, bps, bpp);
 
+	if ( ApproxEntries ) 
+		printf("|%llu\n", (long long unsigned)error);
+	else
+		printf("\n");
+
 } // End of PrintPipeStatLine
 
-static void PrintCvsStatLine(stat_record_t	*stat, StatRecord_t *StatData, int type, int anon, int order_proto, int tag) {
+static void PrintCvsStatLine(stat_record_t	*stat, StatRecord_t *StatData, uint64_t error, int type, int anon, int order_proto, int tag) {
 char		proto[16], valstr[40], datestr1[64], datestr2[64];
 char tag_string[2];
 double		duration, flows_percent, packets_percent, bytes_percent;
@@ -1150,7 +1538,7 @@ struct tm	*tbuff;
 		i++;
 	}
 
-	printf("%s,%s,%.3f,%s,%s,%llu,%.1f,%llu,%.1f,%llu,%.1f,%u,%u,%u\n", 
+	printf("%s,%s,%.3f,%s,%s,%llu,%.1f,%llu,%.1f,%llu,%.1f,%u,%u,%u", 
 		datestr1, datestr2, duration, proto, valstr, 
 		(long long unsigned)StatData->counter[FLOWS], flows_percent, 
 		(long long unsigned)StatData->counter[INPACKETS], packets_percent,
@@ -1158,6 +1546,11 @@ struct tm	*tbuff;
 		pps,bps,bpp
 	);
 
+	if ( ApproxEntries ) 
+		printf(",%llu\n", (long long unsigned)error);
+	else
+		printf("\n");
+
 } // End of PrintCvsStatLine
 
 void PrintFlowTable(printer_t print_record, uint32_t limitflows, int date_sorted, int anon, int tag, int GuessDir) {
@@ -1181,34 +1574,28 @@ char				*string;
 		}
 
 		// preset SortList table - still unsorted
-		for ( i=0; i<FlowTable->IndexMask; i++ ) {
-			r = FlowTable->bucket[i];
-			if ( !r ) 
-				continue;
-
-			// foreach elem in this bucket
-			while ( r ) {
-				// we want to sort only those flows which pass the packet or byte limits
-				if ( byte_limit ) {
-					if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
-						( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
-						r = r->next;
-						continue;
-					}
+		r = FlowTable->first;
+		while ( r ) {
+			// we want to sort only those flows which pass the packet or byte limits
+			if ( byte_limit ) {
+				if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
+					( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
+					r = r->next;
+					continue;
 				}
-				if ( packet_limit ) {
-					if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
-						( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
-						r = r->next;
-						continue;
-					}
+			}
+			if ( packet_limit ) {
+				if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
+					( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
+					r = r->next;
+					continue;
 				}
-				
-				SortList[c].count  = 1000LL * r->flowrecord.first + r->flowrecord.msec_first;	// sort according the date
-				SortList[c].record = (void *)r;
-				c++;
-				r = r->next;
 			}
+			
+			SortList[c].count  = 1000LL * r->flowrecord.first + r->flowrecord.msec_first;	// sort according the date
+			SortList[c].record = (void *)r;
+			c++;
+			r = r->next;
 		}
 
 		maxindex = c;
@@ -1245,65 +1632,65 @@ char				*string;
 			if ( GuessDir && ( flow_record.srcport < 1024 && flow_record.dstport > 1024 ) )
 				SwapFlow(&flow_record);
 			print_record((void *)&flow_record, &string, anon, tag);
-			printf("%s\n", string);
+			if ( string )
+				printf("%s\n", string);
 		}
 
 	} else {
 		// print them as they came
 		c = 0;
-		for ( i=0; i<FlowTable->IndexMask; i++ ) {
-			r = FlowTable->bucket[i];
-			while ( r ) {
-				master_record_t	*flow_record;
-				common_record_t *raw_record;
-				int map_id;
+		r = FlowTable->first;
+		while ( r ) {
+			master_record_t	*flow_record;
+			common_record_t *raw_record;
+			int map_id;
 
-				if ( limitflows && c >= limitflows )
-					return;
+			if ( limitflows && c >= limitflows )
+				return;
 
-				// we want to print only those flows which pass the packet or byte limits
-				if ( byte_limit ) {
-					if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
-						( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
-						r = r->next;
-						continue;
-					}
+			// we want to print only those flows which pass the packet or byte limits
+			if ( byte_limit ) {
+				if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
+					( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
+					r = r->next;
+					continue;
 				}
-				if ( packet_limit ) {
-					if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
-						( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
-						r = r->next;
-						continue;
-					}
+			}
+			if ( packet_limit ) {
+				if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
+					( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
+					r = r->next;
+					continue;
 				}
+			}
 
-				raw_record = &(r->flowrecord);
-				map_id = r->map_ref->map_id;
+			raw_record = &(r->flowrecord);
+			map_id = r->map_ref->map_id;
 
-				flow_record = &(extension_map_list.slot[map_id]->master_record);
-				ExpandRecord_v2( raw_record, extension_map_list.slot[map_id], flow_record);
-				flow_record->dPkts 		= r->counter[INPACKETS];
-				flow_record->dOctets 	= r->counter[INBYTES];
-				flow_record->out_pkts 	= r->counter[OUTPACKETS];
-				flow_record->out_bytes 	= r->counter[OUTBYTES];
-				flow_record->aggr_flows 	= r->counter[FLOWS];
+			flow_record = &(extension_map_list.slot[map_id]->master_record);
+			ExpandRecord_v2( raw_record, extension_map_list.slot[map_id], flow_record);
+			flow_record->dPkts 		= r->counter[INPACKETS];
+			flow_record->dOctets 	= r->counter[INBYTES];
+			flow_record->out_pkts 	= r->counter[OUTPACKETS];
+			flow_record->out_bytes 	= r->counter[OUTBYTES];
+			flow_record->aggr_flows 	= r->counter[FLOWS];
 
-				// apply IP mask from aggregation, to provide a pretty output
-				if ( FlowTable->has_masks ) {
-					flow_record->v6.srcaddr[0] &= FlowTable->IPmask[0];
-					flow_record->v6.srcaddr[1] &= FlowTable->IPmask[1];
-					flow_record->v6.dstaddr[0] &= FlowTable->IPmask[2];
-					flow_record->v6.dstaddr[1] &= FlowTable->IPmask[3];
-				}
+			// apply IP mask from aggregation, to provide a pretty output
+			if ( FlowTable->has_masks ) {
+				flow_record->v6.srcaddr[0] &= FlowTable->IPmask[0];
+				flow_record->v6.srcaddr[1] &= FlowTable->IPmask[1];
+				flow_record->v6.dstaddr[0] &= FlowTable->IPmask[2];
+				flow_record->v6.dstaddr[1] &= FlowTable->IPmask[3];
+			}
 
-				if ( GuessDir && ( flow_record->srcport < 1024 && flow_record->dstport > 1024 ) )
-					SwapFlow(flow_record);
-				print_record((void *)flow_record, &string, anon, tag);
+			if ( GuessDir && ( flow_record->srcport < 1024 && flow_record->dstport > 1024 ) )
+				SwapFlow(flow_record);
+			print_record((void *)flow_record, &string, anon, tag);
+			if ( string )
 				printf("%s\n", string);
 
-				c++;
-				r = r->next;
-			}
+			c++;
+			r = r->next;
 		}
 	}
 
@@ -1384,6 +1771,7 @@ char			*string;
 
 void PrintElementStat(stat_record_t	*sum_stat, char *record_header, printer_t print_record, int topN, int anon, int tag, int quiet, int pipe_output, int cvs_output) {
 SortElement_t	*topN_element_list;
+StatRecord_t	*r;
 uint32_t		numflows, maxindex;
 int32_t 		i, j, hash_num, order_index, order_bit;
 
@@ -1402,17 +1790,24 @@ int32_t 		i, j, hash_num, order_index, order_bit;
 				if ( !pipe_output && !cvs_output && !quiet  ) {
 					printf("Top %i %s ordered by %s:\n", 
 						topN, StatParameters[stat].HeaderInfo, order_mode[order_index].string);
+					if ( ApproxEntries ) {
+						// the smallest weight bounds the error of all records
+						hash_StatTable *t = &StatTable[hash_num];
+						uint64_t max_error = t->HeapSize == t->Capacity ? ss_weight(t, hash_num, t->heap[0]) : 0;
+						printf("Approximate: %u records, Err: %s missed before the element was counted, max %llu\n",
+							t->Capacity, order_mode[StatRequest[hash_num].weight].string, (long long unsigned)max_error);
+					}
 					//      2005-07-26 20:08:59.197 1553.730      ss    65255   203435   52.2 M      130   281636   268
 					if ( Getv6Mode() && (type == IS_IPADDR )) 
-						printf("Date first seen          Duration Proto %39s    Flows(%%)     Packets(%%)       Bytes(%%)         pps      bps   bpp\n",
-							StatParameters[stat].HeaderInfo);
+						printf("Date first seen          Duration Proto %39s    Flows(%%)     Packets(%%)       Bytes(%%)         pps      bps   bpp%s\n",
+							StatParameters[stat].HeaderInfo, ApproxEntries ? "      Err" : "");
 					else
-						printf("Date first seen          Duration Proto %17s    Flows(%%)     Packets(%%)       Bytes(%%)         pps      bps   bpp\n",
-							StatParameters[stat].HeaderInfo);
+						printf("Date first seen          Duration Proto %17s    Flows(%%)     Packets(%%)       Bytes(%%)         pps      bps   bpp%s\n",
+							StatParameters[stat].HeaderInfo, ApproxEntries ? "      Err" : "");
 				}
 
 				if ( cvs_output ) {
-					printf("ts,te,td,pr,val,fl,flP,ipkt,ipktP,ibyt,ibytP,pps,pbs,bpp\n");
+					printf("ts,te,td,pr,val,fl,flP,ipkt,ipktP,ibyt,ibytP,pps,pbs,bpp%s\n", ApproxEntries ? ",err" : "");
 				}
 
 				maxindex = ( StatTable[hash_num].NextBlock * StatTable[hash_num].Prealloc ) + StatTable[hash_num].NextElem;
@@ -1425,14 +1820,15 @@ int32_t 		i, j, hash_num, order_index, order_bit;
 						break;
 
 					// Again - ugly output formating - needs to be cleand up
+					r = (StatRecord_t *)topN_element_list[i].record;
 					if ( pipe_output ) 
-						PrintPipeStatLine((StatRecord_t *)topN_element_list[i].record, type, 
+						PrintPipeStatLine(r, ss_error(hash_num, r), type, 
 							anon, StatRequest[hash_num].order_proto, tag);
 					else if ( cvs_output ) 
-						PrintCvsStatLine(sum_stat, (StatRecord_t *)topN_element_list[i].record, type, 
+						PrintCvsStatLine(sum_stat, r, ss_error(hash_num, r), type, 
 							anon, StatRequest[hash_num].order_proto, tag);
 					else
-						PrintStatLine(sum_stat, (StatRecord_t *)topN_element_list[i].record, 
+						PrintStatLine(sum_stat, r, ss_error(hash_num, r), 
 							type, anon, StatRequest[hash_num].order_proto, tag);
 				}
 				free((void *)topN_element_list);
@@ -1443,77 +1839,95 @@ int32_t 		i, j, hash_num, order_index, order_bit;
 } // End of PrintElementStat
 
 /*
- * Generate the top N lists for packets and bytes in one run
+ * Generate the top N lists for packets and bytes in one run. Each list of topN elements
+ * is sorted ascending, the largest element last. Unused elements at the start are 0
  */
 static void Create_topN_FlowStat(SortElement_t **topN_lists, int order, int topN, uint32_t *count ) {
 hash_FlowTable *FlowTable;
 FlowTableRecord_t	*r;
-unsigned int		i;
 int					order_bit, order_index;
+uint32_t			num[NumOrders];
 uint64_t	   		c, value;
 
 	FlowTable = GetFlowTable();
+	memset((void *)num, 0, sizeof(num));
 	c = 0;
-	// Iterate through all buckets
-	for ( i=0; i <= FlowTable->IndexMask; i++ ) {
-		r = FlowTable->bucket[i];
-		// foreach elem in this bucket
-		while ( r ) {
+	// Iterate through all records
+	r = FlowTable->first;
+	while ( r ) {
 
-			// we want to sort only those flows which pass the packet or byte limits
-			if ( byte_limit ) {
-				if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
-					( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
-					r = r->next;
-					continue;
-				}
+		// we want to sort only those flows which pass the packet or byte limits
+		if ( byte_limit ) {
+			if (( byte_mode == LESS && r->counter[INBYTES] >= byte_limit ) ||
+				( byte_mode == MORE && r->counter[INBYTES]  <= byte_limit ) ) {
+				r = r->next;
+				continue;
 			}
-			if ( packet_limit ) {
-				if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
-					( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
-					r = r->next;
-					continue;
-				}
+		}
+		if ( packet_limit ) {
+			if (( packet_mode == LESS && r->counter[INPACKETS] >= packet_limit ) ||
+				( packet_mode == MORE && r->counter[INPACKETS]  <= packet_limit ) ) {
+				r = r->next;
+				continue;
 			}
+		}
 
-			c++;
-			for ( order_index=0; order_index<NumOrders; order_index++ ) {
-				order_bit = 1 << order_index;
-				/* if we have some different sort orders, which are not directly available in the FlowTableRecord_t
-				 * we need to calculate this value first - such as bpp, bps etc.
-				 */
-				if ( order & order_bit ) {
-					if ( order_mode[order_index].record_function ) 
-						value  = order_mode[order_index].record_function(r);
-					else
-						value  = r->counter[order_index];
-					RankValue(r, value, topN, topN_lists[order_index]);
-				}
+		c++;
+		for ( order_index=0; order_index<NumOrders; order_index++ ) {
+			order_bit = 1 << order_index;
+			/* if we have some different sort orders, which are not directly available in the FlowTableRecord_t
+			 * we need to calculate this value first - such as bpp, bps etc.
+			 */
+			if ( order & order_bit ) {
+				if ( order_mode[order_index].record_function ) 
+					value  = order_mode[order_index].record_function(r);
+				else
+					value  = r->counter[order_index];
+				num[order_index] = topNInsert(topN_lists[order_index], num[order_index], topN, (void *)r, value);
 			}
+		}
 
-			// next elem in bucket
-			r = r->next;
-		} // foreach element
-	}
+		// next record
+		r = r->next;
+	} // foreach record
 	*count = c;
 
+	// sort the heaps and move the elements to the end of the lists
+	for ( order_index=0; order_index<NumOrders; order_index++ ) {
+		SortElement_t *topN_list = topN_lists[order_index];
+		uint32_t n = num[order_index];
+
+		if ( n >= 2 )
+ 			heapSort(topN_list, n, 0);
+		if ( n && n < topN ) {
+			memmove((void *)&topN_list[topN - n], (void *)topN_list, n * sizeof(SortElement_t));
+			memset((void *)topN_list, 0, (topN - n) * sizeof(SortElement_t));
+		}
+	}
+
 } // End of Create_topN_FlowStat
 
+/*
+ * Select the top N elements of stat hash_num ordered by order. Only N elements are kept in a 
+ * min heap while iterating the elements, so memory is O(N). For topN == 0 all elements are sorted.
+ * Returns the *count selected elements sorted ascending, the largest element last.
+ */
 static SortElement_t *StatTopN(int topN, uint32_t *count, int hash_num, int order ) {
 SortElement_t 		*topN_list;
 StatRecord_t		*r;
 unsigned int		i;
-uint32_t	   		c, maxindex;
+uint32_t	   		c, maxindex, size;
+uint64_t			value;
 
 	maxindex  = ( StatTable[hash_num].NextBlock * StatTable[hash_num].Prealloc ) + StatTable[hash_num].NextElem;
-	topN_list = (SortElement_t *)calloc(maxindex, sizeof(SortElement_t));
+	size	  = topN && topN < maxindex ? topN : maxindex;
+	topN_list = (SortElement_t *)calloc(size ? size : 1, sizeof(SortElement_t));
 
 	if ( !topN_list ) {
 		perror("Can't allocate Top N lists: \n");
 		return NULL;
 	}
 
-	// preset topN_list table - still unsorted
 	c = 0;
 	// Iterate through all buckets
 	for ( i=0; i <= StatTable[hash_num].IndexMask; i++ ) {
@@ -1539,60 +1953,25 @@ uint32_t	   		c, maxindex;
 			}
 
 			if ( order_mode[order].element_function ) 
-				topN_list[c].count  = order_mode[order].element_function(r);
+				value = order_mode[order].element_function(r);
 			else
-				topN_list[c].count  = r->counter[order];
+				value = r->counter[order];
 
-			topN_list[c].record = (void *)r;
+			c = topNInsert(topN_list, c, size, (void *)r, value);
 			r = r->next;
-			c++;
 		} // foreach element
 	}
 	*count = c;
-	// printf ("Sort %u flows\n", c);
-	
-	/*
-	for ( i = 0; i < maxindex; i++ ) 
-		printf("%i, %llu %llu\n", i, topN_list[i].count, topN_list[i].record);
-	*/
 
 	// Sorting makes only sense, when 2 or more flows are left
 	if ( c >= 2 )
- 		heapSort(topN_list, c, topN);
-
-	/*
-	for ( i = 0; i < maxindex; i++ ) 
-		printf("%i, %llu %llu\n", i, topN_list[i].count, topN_list[i].record);
-	*/
+ 		heapSort(topN_list, c, 0);
 
 	return topN_list;
 	
 } // End of StatTopN
 
 
-static inline void RankValue(FlowTableRecord_t *r, uint64_t val, int topN, SortElement_t *topN_list) {
-FlowTableRecord_t	*r1, *r2;
-uint64_t	   		c1, c2;
-int					j;
-
-
-	if ( val >= (topN_list)[0].count ) {
-		/* element value is bigger than smallest value in topN */
-		c1 = val;
-		r1 = r;
-		for (j=topN-1; j>=0; j-- ) {
-			if ( c1 >= topN_list[j].count ) {
-				c2 = topN_list[j].count;
-				r2 = topN_list[j].record;
-				topN_list[j].count 	= c1;
-				topN_list[j].record	= r1;
-				c1 = c2; r1 = r2;
-			}
-		}
-	} 
-
-} // End of RankValue
-
 static void SwapFlow(master_record_t *flow_record) {
 uint64_t _tmp_ip[2];
 uint64_t _tmp_l;
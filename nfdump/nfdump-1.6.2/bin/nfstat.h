@@ -44,7 +44,10 @@
 /*
  * Stat Table
  * In order to generate any flow element statistics, the flows passed the filter
- * are stored into an internal hash table.
+ * are stored into an internal hash table. There is one table for each requested -s stat.
+ * Worker threads count into private tables, which are merged into the global tables.
+ * Approximate stats keep a fixed number of records per table and replace the record 
+ * with the smallest weight - the Space-Saving algorithm. See SetStat_Approximate()
  */
 
 typedef struct StatRecord {
@@ -80,6 +83,13 @@ typedef struct hash_StatTable {
 	uint32_t 			Prealloc;		/* Number of stat records in each stat block */
 	uint32_t			NextBlock;		/* This stat block contains the next free slot for a stat recorrd */
 	uint32_t			NextElem;		/* This element in the current stat block is the next free slot */
+
+	/* approximate stat - Space-Saving heavy hitters in a fixed number of stat records */
+	uint32_t			Capacity;		/* max number of stat records in the single stat block. 0: exact stat */
+	uint32_t			HeapSize;		/* number of records in the heap */
+	uint32_t			*heap;			/* min heap of record indices ordered by the weight counter + error */
+	uint32_t			*heap_pos;		/* heap position of each record */
+	uint64_t			*error;			/* max weight each record may have missed before it was tracked */
 } hash_StatTable;
 
 typedef struct SortElement {
@@ -98,10 +108,24 @@ int SetStat(char *str, int *element_stat, int *flow_stat);
 
 int SetStat_DefaultOrder(char *order);
 
+int SetStat_Approximate(char *str);
+
 void InsertFlow(common_record_t *raw_record, master_record_t *flow_record);
 
 void AddStat(common_record_t *raw_record, master_record_t *flow_record );
 
+hash_StatTable *New_StatTable(void);
+
+void Dispose_StatTable_r(hash_StatTable *table);
+
+void AddStat_r(hash_StatTable *table, common_record_t *raw_record, master_record_t *flow_record );
+
+void Merge_StatTable(hash_StatTable *table);
+
+int RollupHasStats(rollup_t *rollup);
+
+void AddRollupStat(rollup_t *rollup);
+
 void PrintFlowTable(printer_t print_record, uint32_t limitflows, int date_sorted, int anon, int tag, int GuessDir);
 
 void PrintFlowStat(char *record_header, printer_t print_record, int topN, int anon, int tag, int quiet, int cvs_output);
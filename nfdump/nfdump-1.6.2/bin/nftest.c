@@ -171,6 +171,7 @@ double wall[2];
 	outfile[MAXPATHLEN-1] = '\0';
 
 	nffile.block_header = malloc(BUFFSIZE + sizeof(data_block_header_t));
+	nffile.writer		= NULL;
 	if ( !nffile.block_header ) {
 		fprintf(stderr, "Buffer allocation error: %s", strerror(errno));
 		close(rfd);
@@ -40,6 +40,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
 #include <string.h>
 #include <errno.h>
 
@@ -77,6 +79,8 @@ static char		**IdentList;
 
 static void UpdateList(uint32_t a, uint32_t b);
 
+static void FreeFilterTree(FilterBlock_t *filter, uint32_t numblocks, char **identlist, uint32_t numidents);
+
 /* flow processing functions */
 static inline uint64_t pps_function(uint64_t *data);
 static inline uint64_t bps_function(uint64_t *data);
@@ -185,11 +189,15 @@ int	ret;
 	InitTree();
 	lex_init(FilterSyntax);
 	ret = yyparse();
+	lex_cleanup();
+	free(IPstack);
+	IPstack = NULL;
 	if ( ret != 0 ) {
+		FreeFilterTree(FilterTree, NumBlocks, IdentList, NumIdents);
+		FilterTree = NULL;
+		IdentList  = NULL;
 		return NULL;
 	}
-	lex_cleanup();
-	free(IPstack);
 
 	engine = malloc(sizeof(FilterEngine_data_t));
 	if ( !engine ) {
@@ -197,10 +205,14 @@ int	ret;
 		exit(255);
 	}
 	engine->nfrecord  = NULL;
+	engine->ident	  = NULL;
 	engine->StartNode = StartNode;
 	engine->Extended  = Extended;
 	engine->IdentList = IdentList;
+	engine->numidents = NumIdents;
 	engine->filter 	  = FilterTree;
+	engine->numblocks = NumBlocks;
+	engine->ipindex	  = NULL;
 	if ( Extended ) 
 		engine->FilterEngine = RunExtendedFilter;
 	else
@@ -369,6 +381,7 @@ static void UpdateList(uint32_t a, uint32_t b) {
 	FilterTree[b].numblocks = 0;
 	if ( FilterTree[b].blocklist ) 
 		free(FilterTree[b].blocklist);
+	FilterTree[b].blocklist = NULL;
 
 } /* End of UpdateList */
 
@@ -422,6 +435,7 @@ void DumpList(FilterEngine_data_t *args) {
 
 /* fast filter engine */
 int RunFilter(FilterEngine_data_t *args) {
+const FilterBlock_t	*filter = args->filter;	// shared by the copies of the engine
 uint32_t	index, offset;
 int	evaluate, invert;
 
@@ -429,10 +443,10 @@ int	evaluate, invert;
 	evaluate = 0;
 	invert = 0;
 	while ( index ) {
-		offset   = args->filter[index].offset;
-		invert   = args->filter[index].invert;
-		evaluate = ( args->nfrecord[offset] & args->filter[index].mask ) == args->filter[index].value;
-		index    = evaluate ?  args->filter[index].OnTrue : args->filter[index].OnFalse;
+		offset   = filter[index].offset;
+		invert   = filter[index].invert;
+		evaluate = ( args->nfrecord[offset] & filter[index].mask ) == filter[index].value;
+		index    = evaluate ?  filter[index].OnTrue : filter[index].OnFalse;
 	}
 	return invert ? !evaluate : evaluate;
 
@@ -440,6 +454,7 @@ int	evaluate, invert;
 
 /* extended filter engine */
 int RunExtendedFilter(FilterEngine_data_t *args) {
+const FilterBlock_t	*filter = args->filter;	// shared by the copies of the engine
 uint32_t	index, offset; 
 uint64_t	value;
 int	evaluate, invert;
@@ -448,33 +463,33 @@ int	evaluate, invert;
 	evaluate = 0;
 	invert = 0;
 	while ( index ) {
-		offset   = args->filter[index].offset;
-		invert   = args->filter[index].invert;
+		offset   = filter[index].offset;
+		invert   = filter[index].invert;
 
-		if (args->filter[index].function == NULL)
-			value = args->nfrecord[offset] & args->filter[index].mask;
+		if (filter[index].function == NULL)
+			value = args->nfrecord[offset] & filter[index].mask;
 		else
-			value = args->filter[index].function(args->nfrecord);
+			value = filter[index].function(args->nfrecord);
 
-		switch (args->filter[index].comp) {
+		switch (filter[index].comp) {
 			case CMP_EQ:
-				evaluate = value == args->filter[index].value;
+				evaluate = value == filter[index].value;
 				break;
 			case CMP_GT:
-				evaluate = value > args->filter[index].value;
+				evaluate = value > filter[index].value;
 				break;
 			case CMP_LT:
-				evaluate = value < args->filter[index].value;
+				evaluate = value < filter[index].value;
 				break;
 			case CMP_IDENT:
-				value = args->filter[index].value;
-				evaluate = strncmp(CurrentIdent, args->IdentList[value], IdentLen) == 0 ;
+				value = filter[index].value;
+				evaluate = strncmp(args->ident ? args->ident : CurrentIdent, args->IdentList[value], IdentLen) == 0 ;
 				break;
 			case CMP_FLAGS:
 				if ( invert )
 					evaluate = value > 0;
 				else
-					evaluate = value == args->filter[index].value;
+					evaluate = value == filter[index].value;
 				break;
 			case CMP_IPLIST: {
 				struct IPListNode find;
@@ -482,21 +497,576 @@ int	evaluate, invert;
 				find.ip[1] = args->nfrecord[offset+1];
 				find.mask[0] = 0xffffffffffffffffLL;
 				find.mask[1] = 0xffffffffffffffffLL;
-				evaluate = RB_FIND(IPtree, args->filter[index].data, &find) != NULL; }
+				evaluate = RB_FIND(IPtree, filter[index].data, &find) != NULL; }
 				break;
 			case CMP_ULLIST: {
 				struct ULongListNode find;
 				find.value = value;
-				evaluate = RB_FIND(ULongtree, args->filter[index].data, &find ) != NULL; }
+				evaluate = RB_FIND(ULongtree, filter[index].data, &find ) != NULL; }
 				break;
 		}
 
-		index = evaluate ? args->filter[index].OnTrue : args->filter[index].OnFalse;
+		index = evaluate ? filter[index].OnTrue : filter[index].OnFalse;
 	}
 	return invert ? !evaluate : evaluate;
 
 } /* End of RunExtendedFilter */
 
+/*
+ * Skip files and blocks with the address filters of the files:
+ * An address block of the filter can only be true, if the address is in the
+ * bloom filter of the file, or in the address index for a block of the file. 
+ * All other blocks may be true or false. The filter may match, if any path 
+ * through the tree ends with a positive result.
+ */
+typedef struct maymatch_s {
+	FilterEngine_data_t	*engine;
+	// returns 0, if the address test cannot be true
+	int					(*check)(struct maymatch_s *args, uint32_t offset, uint64_t mask, uint64_t value);
+	char				*filename;
+	bloom_t				*bloom;
+	int					no_bloom;
+	uint64_t			*keys;		// sorted keys of the address index found in a block
+	uint32_t			num_keys;
+	uint8_t				*result;	// per block: 0 unknown, 1 no match, 2 may match
+} maymatch_t;
+
+/* lookup result of the address index of a data directory */
+typedef struct ipindex_select_s {
+	struct ipindex_select_s	*next;
+	char					root[MAXPATHLEN];
+	ipindex_file_t			*files;		// table of indexed files
+	uint32_t				num_files;
+	ipindex_file_t			**names;	// valid files, sorted by name
+	uint32_t				num_names;
+	uint32_t				*first;		// per file id: first selected block in blocks
+	uint32_t				*blocks;	// selected blocks of all files
+} ipindex_select_t;
+
+/* address index state of a filter engine */
+typedef struct ipindex_cache_s {
+	int					resolvable;	// 0: not yet checked, 1: filter is resolved by the index, -1: not
+	uint64_t			*keys;		// sorted keys of all address tests of the filter
+	uint32_t			num_keys;
+	char				dir[MAXPATHLEN];	// directory of the last file
+	ipindex_select_t	*dir_select;		// its index lookup
+	int					dir_rel;			// offset of the file name relative to the index
+	ipindex_select_t	*list;
+} ipindex_cache_t;
+
+#define MAXADDRESSKEYS 256
+
+/*
+ * Keys of the address index for the test ( nfrecord[offset] & mask ) == value. Returns
+ * the number of keys, any of which must be present for the test to be true, or -1 if
+ * the test is not covered by the index
+ */
+static int AddressKeys(uint32_t offset, uint64_t mask, uint64_t value, uint64_t *keys) {
+int bits, i;
+
+	if ( offset < OffsetSrcIPv6a || offset > OffsetDstIPv6b ) 
+		return -1;
+
+	if ( mask == MaskIPv6 ) {
+		// the upper word of IPv4 addresses is not indexed
+		if ( value == 0 && ( offset == OffsetSrcIPv6a || offset == OffsetDstIPv6a ) ) 
+			return -1;
+		keys[0] = IPIndexKey(offset, mask, value);
+		return 1;
+	}
+
+	if ( offset == OffsetSrcIPv6a || offset == OffsetDstIPv6a ) 
+		return -1;
+
+	// IPv4 networks /16 .. /24 are covered by their /24 networks
+	for ( bits=8; bits<=16; bits++ ) {
+		if ( mask == (MaskIPv6 << bits) ) 
+			break;
+	}
+	if ( bits > 16 ) 
+		return -1;
+
+	for ( i=0; i < (1 << (bits - 8)); i++ ) 
+		keys[i] = IPIndexKey(offset, IPINDEX_MASK24, (value & mask) + ((uint64_t)i << 8));
+
+	return i;
+
+} // End of AddressKeys
+
+static int BloomMayBeTrue(maymatch_t *args, uint32_t offset, uint64_t mask, uint64_t value) {
+
+	if ( mask != MaskIPv6 || offset < OffsetSrcIPv6a || offset > OffsetDstIPv6b ) 
+		return 1;
+
+	// map the bloom filter on demand
+	if ( !args->bloom && !args->no_bloom ) {
+		args->bloom = OpenBloom(args->filename);
+		args->no_bloom = args->bloom == NULL;
+	}
+	return args->no_bloom || BloomCheck(args->bloom, offset, value);
+
+} // End of BloomMayBeTrue
+
+static int CompareKey(const void *p1, const void *p2) {
+uint64_t k1 = *(const uint64_t *)p1;
+uint64_t k2 = *(const uint64_t *)p2;
+
+	return k1 == k2 ? 0 : ( k1 < k2 ? -1 : 1 );
+
+} // End of CompareKey
+
+static int IndexMayBeTrue(maymatch_t *args, uint32_t offset, uint64_t mask, uint64_t value) {
+uint64_t	keys[MAXADDRESSKEYS];
+int			i, num_keys;
+
+	num_keys = AddressKeys(offset, mask, value, keys);
+	if ( num_keys < 0 ) 
+		return 1;
+
+	for ( i=0; i<num_keys; i++ ) {
+		if ( bsearch(&keys[i], args->keys, args->num_keys, sizeof(uint64_t), CompareKey) ) 
+			return 1;
+	}
+
+	return 0;
+
+} // End of IndexMayBeTrue
+
+static int BlockMayBeTrue(maymatch_t *args, FilterBlock_t *block) {
+uint32_t offset = block->offset;
+
+	if ( block->function != NULL ) 
+		return 1;
+
+	if ( block->comp == CMP_EQ ) 
+		return args->check(args, offset, block->mask, block->value);
+
+	if ( block->comp == CMP_IPLIST && ( offset == OffsetSrcIPv6a || offset == OffsetDstIPv6a ) ) {
+		struct IPListNode *node;
+		RB_FOREACH(node, IPtree, (IPlist_t *)block->data) {
+			if ( args->check(args, offset, node->mask[0], node->ip[0]) && 
+				 args->check(args, offset+1, node->mask[1], node->ip[1]) ) 
+				return 1;
+		}
+		return 0;
+	}
+
+	return 1;
+
+} // End of BlockMayBeTrue
+
+static int BlockMayMatch(maymatch_t *args, uint32_t index) {
+FilterBlock_t	*block = &args->engine->filter[index];
+uint32_t		next;
+int				evaluate, result;
+
+	if ( args->result[index] ) 
+		return args->result[index] - 1;
+
+	// follow the false and the true branch of the block
+	result = 0;
+	for ( evaluate = 0; evaluate <= 1 && !result; evaluate++ ) {
+		if ( evaluate && !BlockMayBeTrue(args, block) ) 
+			break;
+		next = evaluate ? block->OnTrue : block->OnFalse;
+		if ( next == 0 ) 
+			result = block->invert ? !evaluate : evaluate;
+		else
+			result = BlockMayMatch(args, next);
+	}
+	args->result[index] = result + 1;
+
+	return result;
+
+} // End of BlockMayMatch
+
+static int FilterMayMatch(maymatch_t *args) {
+
+	memset((void *)args->result, 0, args->engine->numblocks);
+	return BlockMayMatch(args, args->engine->StartNode);
+
+} // End of FilterMayMatch
+
+/*
+ * Collect the sorted keys of all address tests of the filter. Returns 0 if
+ * any address test is not covered by the address index, otherwise 1
+ */
+static int AddAddressKeys(ipindex_cache_t *cache, uint32_t offset, uint64_t mask, uint64_t value) {
+uint64_t	*keys;
+int			num_keys;
+
+	keys = (uint64_t *)realloc(cache->keys, (cache->num_keys + MAXADDRESSKEYS) * sizeof(uint64_t));
+	if ( !keys ) {
+		fprintf(stderr, "Memory allocation error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 0;
+	}
+	cache->keys = keys;
+
+	num_keys = AddressKeys(offset, mask, value, &cache->keys[cache->num_keys]);
+	if ( num_keys > 0 ) 
+		cache->num_keys += num_keys;
+
+	return 1;
+
+} // End of AddAddressKeys
+
+static int CollectAddressKeys(FilterEngine_data_t *engine, ipindex_cache_t *cache) {
+FilterBlock_t	*block;
+uint32_t		i, j;
+
+	for ( i=1; i<engine->numblocks; i++ ) {
+		block = &engine->filter[i];
+		if ( block->function != NULL ) 
+			continue;
+		if ( block->comp == CMP_EQ && !AddAddressKeys(cache, block->offset, block->mask, block->value) ) 
+			return 0;
+		if ( block->comp == CMP_IPLIST && ( block->offset == OffsetSrcIPv6a || block->offset == OffsetDstIPv6a ) ) {
+			struct IPListNode *node;
+			RB_FOREACH(node, IPtree, (IPlist_t *)block->data) {
+				if ( !AddAddressKeys(cache, block->offset, node->mask[0], node->ip[0]) ||
+					 !AddAddressKeys(cache, block->offset+1, node->mask[1], node->ip[1]) ) 
+					return 0;
+			}
+		}
+	}
+
+	if ( cache->num_keys == 0 ) 
+		return 1;
+
+	qsort(cache->keys, cache->num_keys, sizeof(uint64_t), CompareKey);
+	j = 0;
+	for ( i=1; i<cache->num_keys; i++ ) {
+		if ( cache->keys[i] != cache->keys[j] ) 
+			cache->keys[++j] = cache->keys[i];
+	}
+	cache->num_keys = j + 1;
+
+	return 1;
+
+} // End of CollectAddressKeys
+
+static int CompareNames(const void *p1, const void *p2) {
+const ipindex_file_t *f1 = *(ipindex_file_t * const *)p1;
+const ipindex_file_t *f2 = *(ipindex_file_t * const *)p2;
+int	cmp;
+
+	cmp = strncmp(f1->name, f2->name, IPINDEX_NAME_SIZE);
+	if ( cmp ) 
+		return cmp;
+
+	// records of the same file in the order of the updates
+	return f1 == f2 ? 0 : ( f1 < f2 ? -1 : 1 );
+
+} // End of CompareNames
+
+static int CompareName(const void *p1, const void *p2) {
+const ipindex_file_t *f1 = *(ipindex_file_t * const *)p1;
+const ipindex_file_t *f2 = *(ipindex_file_t * const *)p2;
+
+	return strncmp(f1->name, f2->name, IPINDEX_NAME_SIZE);
+
+} // End of CompareName
+
+/*
+ * Look up the address keys of the filter in the address index in root, and select
+ * the blocks of the indexed files, which may contain matching flows. The result is
+ * added to the cache - without files, if the index cannot be used
+ */
+static ipindex_select_t *SelectIPIndex(FilterEngine_data_t *engine, ipindex_cache_t *cache, char *root) {
+ipindex_select_t	*select;
+ipindex_entry_t		*entries;
+maymatch_t			args;
+uint64_t			num_entries, i, j;
+uint32_t			id, num_blocks;
+
+	select = (ipindex_select_t *)calloc(1, sizeof(ipindex_select_t));
+	if ( !select ) {
+		fprintf(stderr, "Memory allocation error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+	// root comes from FindIPIndex() and fits, but never copy a truncated path
+	if ( strlen(root) >= MAXPATHLEN ) {
+		free(select);
+		return NULL;
+	}
+	strcpy(select->root, root);
+	select->next = cache->list;
+	cache->list	 = select;
+
+	select->files = ReadIPIndexFiles(root, &select->num_files);
+	if ( !select->files ) 
+		return select;
+
+	entries = LookupIPIndex(root, cache->keys, cache->num_keys, &num_entries);
+	memset((void *)&args, 0, sizeof(maymatch_t));
+	args.engine = engine;
+	args.check	= IndexMayBeTrue;
+	args.result = (uint8_t *)malloc(engine->numblocks);
+	args.keys	= (uint64_t *)malloc((cache->num_keys + 1) * sizeof(uint64_t));
+	select->names  = (ipindex_file_t **)malloc((select->num_files + 1) * sizeof(ipindex_file_t *));
+	select->first  = (uint32_t *)calloc(select->num_files + 1, sizeof(uint32_t));
+	select->blocks = (uint32_t *)malloc((num_entries + 1) * sizeof(uint32_t));
+	if ( !entries || !args.result || !args.keys || !select->names || !select->first || !select->blocks ) {
+		if ( entries ) 
+			fprintf(stderr, "Memory allocation error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		free(entries);
+		free(args.result);
+		free(args.keys);
+		free(select->files);
+		select->files = NULL;
+		return select;
+	}
+	
+	// the latest complete record of each file name is valid
+	select->num_names = 0;
+	for ( id=0; id<select->num_files; id++ ) {
+		if ( select->files[id].flags & IPINDEX_COMPLETE ) {
+			select->files[id].name[IPINDEX_NAME_SIZE-1] = 0;
+			select->names[select->num_names++] = &select->files[id];
+		}
+	}
+	qsort(select->names, select->num_names, sizeof(ipindex_file_t *), CompareNames);
+	j = 0;
+	for ( i=0; i<select->num_names; i++ ) {
+		if ( j && CompareName(&select->names[j-1], &select->names[i]) == 0 ) 
+			select->names[j-1] = select->names[i];
+		else
+			select->names[j++] = select->names[i];
+	}
+	select->num_names = j;
+
+	// the postings are sorted by file and block - evaluate the filter for each block
+	num_blocks = 0;
+	for ( i=0; i<num_entries; i=j ) {
+		id = entries[i].file_id;
+		args.num_keys = 0;
+		for ( j=i; j<num_entries && entries[j].file_id == id && entries[j].block == entries[i].block; j++ ) 
+			args.keys[args.num_keys++] = entries[j].key;
+		if ( id >= select->num_files || !(select->files[id].flags & IPINDEX_COMPLETE) ) 
+			continue;
+		if ( FilterMayMatch(&args) ) {
+			select->blocks[num_blocks++] = entries[i].block;
+			select->first[id+1]++;
+		}
+	}
+	for ( id=1; id<=select->num_files; id++ ) 
+		select->first[id] += select->first[id-1];
+
+	free(entries);
+	free(args.result);
+	free(args.keys);
+
+	return select;
+
+} // End of SelectIPIndex
+
+/*
+ * Resolve the filter through the address index of the data directory of filename.
+ * Returns 0 if no flow of the file can match, 1 if the file is read - only the selected
+ * blocks, if rfile is not NULL - and -1 if the file is not covered by the index
+ */
+static int IPIndexMayMatch(FilterEngine_data_t *engine, char *filename, rfile_t *rfile) {
+ipindex_cache_t		*cache = (ipindex_cache_t *)engine->ipindex;
+ipindex_select_t	*select;
+ipindex_file_t		key, *key_ptr, **name, *file;
+struct stat			stat_buf;
+char				root[MAXPATHLEN], *p;
+uint32_t			id, num_blocks;
+size_t				len;
+
+	if ( !cache ) {
+		cache = (ipindex_cache_t *)calloc(1, sizeof(ipindex_cache_t));
+		if ( !cache ) {
+			fprintf(stderr, "Memory allocation error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			return -1;
+		}
+		engine->ipindex = cache;
+	}
+
+	if ( cache->resolvable == 0 ) {
+		maymatch_t args;
+		memset((void *)&args, 0, sizeof(maymatch_t));
+		args.engine = engine;
+		args.check	= IndexMayBeTrue;
+		args.result = (uint8_t *)malloc(engine->numblocks);
+		// the index resolves the filter, if no flow without an indexed address can match
+		cache->resolvable = args.result && CollectAddressKeys(engine, cache) && !FilterMayMatch(&args) ? 1 : -1;
+		free(args.result);
+	}
+	if ( cache->resolvable < 0 ) 
+		return -1;
+
+	// the files of a directory share the index
+	p	= strrchr(filename, '/');
+	len = p ? (size_t)(p - filename) : 0;
+	if ( len >= MAXPATHLEN ) 
+		return -1;
+	if ( !cache->dir_select || strlen(cache->dir) != len || strncmp(cache->dir, filename, len) != 0 ) {
+		strncpy(cache->dir, filename, len);
+		cache->dir[len]	  = 0;
+		cache->dir_select = NULL;
+		cache->dir_rel	  = FindIPIndex(filename, root, MAXPATHLEN);
+		if ( cache->dir_rel < 0 ) 
+			return -1;
+		for ( select=cache->list; select && strcmp(select->root, root) != 0; select=select->next )
+			;
+		cache->dir_select = select ? select : SelectIPIndex(engine, cache, root);
+	}
+	select = cache->dir_select;
+	if ( !select || !select->files ) 
+		return -1;
+
+	strncpy(key.name, filename + cache->dir_rel, IPINDEX_NAME_SIZE-1);
+	key.name[IPINDEX_NAME_SIZE-1] = 0;
+	key_ptr = &key;
+	name = (ipindex_file_t **)bsearch(&key_ptr, select->names, select->num_names, sizeof(ipindex_file_t *), CompareName);
+	if ( !name ) 
+		return -1;
+
+	// the file must not have changed since it was indexed
+	file = *name;
+	if ( stat(filename, &stat_buf) < 0 || (uint64_t)stat_buf.st_size != file->file_size || 
+		 (uint64_t)stat_buf.st_mtime != file->mtime ) 
+		return -1;
+
+	id = file - select->files;
+	num_blocks = select->first[id+1] - select->first[id];
+	if ( num_blocks == 0 ) 
+		return 0;
+
+	// without a valid block index the whole file is read
+	if ( rfile ) 
+		SelectBlocks_r(rfile, filename, &select->blocks[select->first[id]], num_blocks, file->NumBlocks);
+
+	return 1;
+
+} // End of IPIndexMayMatch
+
+/* 
+ * Returns 0, if the filter engine cannot match any flow of file filename according
+ * to the address index of its directory or its address filter <filename>.bloom, 
+ * otherwise 1. If rfile is not NULL, only the blocks selected by the address index
+ * are read from the file just opened.
+ */
+int FileMayMatch(char *filename, rfile_t *rfile, void *engine) {
+maymatch_t	args;
+int			result;
+
+	result = IPIndexMayMatch((FilterEngine_data_t *)engine, filename, rfile);
+	if ( result >= 0 ) 
+		return result;
+
+	memset((void *)&args, 0, sizeof(maymatch_t));
+	args.engine   = (FilterEngine_data_t *)engine;
+	args.check	  = BloomMayBeTrue;
+	args.filename = filename;
+	args.result	  = (uint8_t *)malloc(args.engine->numblocks);
+	if ( !args.result ) {
+		fprintf(stderr, "Memory allocation error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return 1;
+	}
+
+	result = FilterMayMatch(&args);
+
+	CloseBloom(args.bloom);
+	free(args.result);
+
+	return result;
+
+} // End of FileMayMatch
+
+/*
+ * Free a filter engine returned by CompileFilter and its address index lookups
+ */
+void DisposeFilterEngine(FilterEngine_data_t *engine) {
+ipindex_cache_t		*cache;
+ipindex_select_t	*select;
+
+	if ( !engine ) 
+		return;
+
+	cache = (ipindex_cache_t *)engine->ipindex;
+	if ( cache ) {
+		while ( cache->list ) {
+			select = cache->list;
+			cache->list = select->next;
+			free(select->files);
+			free(select->names);
+			free(select->first);
+			free(select->blocks);
+			free(select);
+		}
+		free(cache->keys);
+		free(cache);
+	}
+	FreeFilterTree(engine->filter, engine->numblocks, engine->IdentList, engine->numidents);
+	free(engine);
+
+} // End of DisposeFilterEngine
+
+/*
+ * Initialise copy as a copy of engine for an other thread. The copy shares the read only filter
+ * tree and ident list of engine, so engine must not be disposed, while the copy is used. The
+ * copy itself is not disposed. The address index lookups of FileMayMatch() are not copied, they
+ * stay with engine and are only used with the lock of the file sequence.
+ */
+void CopyFilterEngine(FilterEngine_data_t *copy, FilterEngine_data_t *engine) {
+
+	*copy = *engine;
+	copy->nfrecord = NULL;
+	copy->ident	   = NULL;
+	copy->ipindex  = NULL;
+
+} // End of CopyFilterEngine
+
+/*
+ * Free the blocks of a filter tree with their block lists and IP or number lists
+ * as well as the ident list. Both blocks of a src/dst IP list share the same list
+ */
+static void FreeFilterTree(FilterBlock_t *filter, uint32_t numblocks, char **identlist, uint32_t numidents) {
+uint32_t	i, j;
+
+	if ( filter ) {
+		for ( i=1; i<numblocks; i++ ) {
+			free(filter[i].blocklist);
+			if ( !filter[i].data ) 
+				continue;
+
+			for ( j=1; j<i; j++ ) {
+				if ( filter[j].data == filter[i].data ) 
+					break;
+			}
+			if ( j < i ) 
+				continue;
+
+			if ( filter[i].comp == CMP_IPLIST ) {
+				IPlist_t *root = (IPlist_t *)filter[i].data;
+				struct IPListNode *node;
+				while ( (node = RB_MIN(IPtree, root)) != NULL ) {
+					RB_REMOVE(IPtree, root, node);
+					free(node);
+				}
+			} else if ( filter[i].comp == CMP_ULLIST ) {
+				ULongtree_t *root = (ULongtree_t *)filter[i].data;
+				struct ULongListNode *node;
+				while ( (node = RB_MIN(ULongtree, root)) != NULL ) {
+					RB_REMOVE(ULongtree, root, node);
+					free(node);
+				}
+			}
+			free(filter[i].data);
+		}
+		free(filter);
+	}
+
+	if ( identlist ) {
+		for ( i=0; i<numidents; i++ ) 
+			free(identlist[i]);
+		free(identlist);
+	}
+
+} // End of FreeFilterTree
+
 uint32_t AddIdent(char *Ident) {
 uint32_t	num;
 
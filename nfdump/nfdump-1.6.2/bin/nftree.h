@@ -63,12 +63,21 @@ typedef struct FilterBlock {
 	void		*data;				/* any additional data for this block */
 } FilterBlock_t;
 
+/*
+ * The filter tree and the ident list are built by CompileFilter() and only read by the filter
+ * engine, so threads may share them through CopyFilterEngine(). nfrecord and ident are the 
+ * state of the thread, which runs the engine.
+ */
 typedef struct FilterEngine_data_s {
-	FilterBlock_t	*filter;
+	FilterBlock_t	*filter;	// read only after CompileFilter()
 	uint32_t		StartNode;
 	uint32_t 		Extended;
-	char			**IdentList;
+	char			**IdentList;	// read only after CompileFilter()
+	uint32_t		numidents;	// number of idents in IdentList
 	uint64_t		*nfrecord;
+	char			*ident;		// ident of the current file - CurrentIdent if NULL
+	uint32_t		numblocks;	// number of blocks in filter
+	void			*ipindex;	// address index lookups of FileMayMatch - not shared by copies
 	int (*FilterEngine)(struct FilterEngine_data_s *);
 } FilterEngine_data_t;
 
@@ -118,6 +127,16 @@ struct ULongListNode {
  */
 int RunFilter(FilterEngine_data_t *args);
 int RunExtendedFilter(FilterEngine_data_t *args);
+
+/*
+ * Check the address index and filter of a file - returns 0 if no flow can match
+ */
+struct rfile_s;
+int FileMayMatch(char *filename, struct rfile_s *rfile, void *engine);
+
+void DisposeFilterEngine(FilterEngine_data_t *engine);
+
+void CopyFilterEngine(FilterEngine_data_t *copy, FilterEngine_data_t *engine);
 /*
  * For testing purpose only
  */
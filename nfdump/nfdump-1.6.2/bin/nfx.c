@@ -104,9 +104,94 @@ extension_descriptor_t extension_descriptor[] = {
 
 uint32_t Max_num_extensions;
 
+/*
+ * The registry links the maps of slot and page by the hash of their content, so a map
+ * known from a previous file is found without comparing all maps of the extension page.
+ * The expansion plans of a map stay with the map, when it is moved between page and slot.
+ */
+
+// FNV-1a hash of the size and the extension ids of a map
+static uint32_t MapHash(extension_map_t *map) {
+uint32_t hash = 2166136261U;
+int i;
+
+	for ( i=0; map->ex_id[i]; i++ ) {
+		hash ^= map->ex_id[i];
+		hash *= 16777619U;
+	}
+	hash ^= map->size;
+	hash *= 16777619U;
+
+	return hash;
+
+} // End of MapHash
+
+static int SameMap(extension_map_t *map1, extension_map_t *map2) {
+int i;
+
+	if ( map1->size != map2->size )
+		return 0;
+
+	i = 0;
+	while ( map1->ex_id[i] && (map1->ex_id[i] == map2->ex_id[i]) ) 
+		i++;
+
+	return map1->ex_id[i] == map2->ex_id[i];
+
+} // End of SameMap
+
+static void RegisterMap(extension_map_list_t *extension_map_list, extension_info_t *extension_info) {
+uint32_t index = extension_info->hash & EXTENSION_HASH_MASK;
+
+	extension_info->next = extension_map_list->registry[index];
+	extension_map_list->registry[index] = extension_info;
+
+} // End of RegisterMap
+
+static void UnregisterMap(extension_map_list_t *extension_map_list, extension_info_t *extension_info) {
+extension_info_t **p = &extension_map_list->registry[extension_info->hash & EXTENSION_HASH_MASK];
+
+	while ( *p && *p != extension_info ) 
+		p = &(*p)->next;
+	if ( *p ) 
+		*p = extension_info->next;
+
+} // End of UnregisterMap
+
+// returns the page slot of the map with the same content or -1, if the map is not in the page
+static int FindPagedMap(extension_map_list_t *extension_map_list, extension_map_t *map, uint32_t hash) {
+extension_info_t *extension_info;
+
+	extension_info = extension_map_list->registry[hash & EXTENSION_HASH_MASK];
+	while ( extension_info ) {
+		if ( extension_info->hash == hash && 
+			 extension_map_list->page[extension_info->map->map_id] == extension_info && 
+			 SameMap(extension_info->map, map) ) 
+			return extension_info->map->map_id;
+		extension_info = extension_info->next;
+	}
+
+	return -1;
+
+} // End of FindPagedMap
+
+static void FreeExtensionInfo(extension_info_t *extension_info) {
+int i;
+
+	for ( i=0; i<MAX_EXTENSION_PLANS; i++ ) {
+		if ( extension_info->plan[i] ) 
+			free(extension_info->plan[i]);
+	}
+	if ( extension_info->map ) 
+		free(extension_info->map);
+	free(extension_info);
+
+} // End of FreeExtensionInfo
+
 void InitExtensionMaps(extension_map_list_t *extension_map_list ) {
 	memset((void *)extension_map_list->slot, 0, MAX_EXTENSION_MAPS * sizeof(extension_info_t *));
 	memset((void *)extension_map_list->page, 0, MAX_EXTENSION_MAPS * sizeof(extension_info_t *));
+	memset((void *)extension_map_list->registry, 0, EXTENSION_HASH_SIZE * sizeof(extension_info_t *));
 
 	extension_map_list->next_free = 0;
 	extension_map_list->max_used  = -1;
@@ -122,11 +207,7 @@ int	i;
 	// free all maps
 	for ( i=0; i <= extension_map_list->max_used; i++ ) {
 		if ( extension_map_list->slot[i] ) {
-			if ( extension_map_list->slot[i]->map ) {
-				free(extension_map_list->slot[i]->map);
-				extension_map_list->slot[i]->map = NULL;
-			}
-			free(extension_map_list->slot[i]);
+			FreeExtensionInfo(extension_map_list->slot[i]);
 			extension_map_list->slot[i] = NULL;
 		}
 		
@@ -135,11 +216,7 @@ int	i;
 	// free all paged maps
 	for ( i=0; i < extension_map_list->next_free; i++ ) {
 		if ( extension_map_list->page[i] ) {
-			if ( extension_map_list->page[i]->map ) {
-				free(extension_map_list->page[i]->map);
-				extension_map_list->page[i]->map = NULL;
-			}
-			free(extension_map_list->page[i]);
+			FreeExtensionInfo(extension_map_list->page[i]);
 			extension_map_list->page[i] = NULL;
 		}
 	}
@@ -150,52 +227,30 @@ int	i;
 
 int Insert_Extension_Map(extension_map_list_t *extension_map_list, extension_map_t *map) {
 uint32_t next_free = extension_map_list->next_free;
+uint32_t hash;
 uint16_t map_id;
 
 	map_id = map->map_id == INIT_ID ? 0 : map->map_id & EXTENSION_MAP_MASK;
 	map->map_id = map_id;
+	hash = MapHash(map);
 	dbg_printf("Insert Extension Map:\n");
 #ifdef DEVEL
 	PrintExtensionMap(map);
 #endif
 	// is this slot free
 	if ( extension_map_list->slot[map_id] ) {
-		int i, map_found;
+		int map_found;
 		dbg_printf("Map %d already exists\n", map_id);
 		// no - check if same map already in slot
-		if ( extension_map_list->slot[map_id]->map->size == map->size ) {
-			// existing map and new map have the same size 
-			dbg_printf("New map same size:\n");
-
-			// we must compare the maps
-			i = 0;
-			while ( extension_map_list->slot[map_id]->map->ex_id[i] && (extension_map_list->slot[map_id]->map->ex_id[i] == map->ex_id[i]) ) 
-				i++;
-
-			// if last entry == 0 => last map entry => maps are the same
-			if ( extension_map_list->slot[map_id]->map->ex_id[i] == 0 ) {
-				dbg_printf("Same map => nothing to do\n");
-				// same map
-				return 0;
-			} 
-			dbg_printf("Different map => continue\n");
+		if ( extension_map_list->slot[map_id]->hash == hash && SameMap(extension_map_list->slot[map_id]->map, map) ) {
+			dbg_printf("Same map => nothing to do\n");
+			// same map
+			return 0;
 		}
 
 		dbg_printf("Search for map in extension page\n");
-		map_found = -1;
 		// new map is different but has same id - search for map in page list
-		for ( i = 0 ; i < next_free; i++ ) {
-			int j;
-			j = 0;
-			if ( extension_map_list->page[i]->map->size == map->size ) {
-				while ( extension_map_list->page[i]->map->ex_id[j] && (extension_map_list->page[i]->map->ex_id[j] == map->ex_id[j]) ) 
-					j++;
-			}
-			if ( extension_map_list->page[i]->map->ex_id[j] == 0 ) {
-				dbg_printf("Map found in page slot %i\n", i);
-				map_found = i;
-			}
-		}
+		map_found = FindPagedMap(extension_map_list, map, hash);
 		if ( map_found >= 0 ) {
 			extension_info_t *tmp;
 			dbg_printf("Move map from page slot %i to slot %i\n", map_found ,map_id);
@@ -239,6 +294,8 @@ uint16_t map_id;
 	memcpy((void *)extension_map_list->slot[map->map_id]->map, (void *)map, map->size);
 
 	extension_map_list->slot[map_id]->ref_count = 0;
+	extension_map_list->slot[map_id]->hash		= hash;
+	RegisterMap(extension_map_list, extension_map_list->slot[map_id]);
 
 	if ( map_id > extension_map_list->max_used ) {
 		extension_map_list->max_used = map_id;
@@ -267,8 +324,8 @@ int i, free_slot;
 		dbg_printf("Check slot: %i, ref: %u\n", i, extension_map_list->slot[i] ? extension_map_list->slot[i]->ref_count : 0);
 		if ( extension_map_list->slot[i] != NULL && extension_map_list->slot[i]->ref_count == 0 ) {
 			// Destroy slot, if no flows referenced this map
-			free(extension_map_list->slot[i]->map);
-			free(extension_map_list->slot[i]);
+			UnregisterMap(extension_map_list, extension_map_list->slot[i]);
+			FreeExtensionInfo(extension_map_list->slot[i]);
 			extension_map_list->slot[i] = NULL;
 			dbg_printf("Free slot: %i\n", i);
 		}
@@ -352,6 +409,24 @@ int i, free_slot;
 
 } // End of PackExtensionMapList
 
+// drops the expansion plan plan of all maps, e.g. if the plans depend on changed settings
+void FreeExtensionPlans(extension_map_list_t *extension_map_list, int plan) {
+extension_info_t *extension_info;
+int i;
+
+	for ( i=0; i<EXTENSION_HASH_SIZE; i++ ) {
+		extension_info = extension_map_list->registry[i];
+		while ( extension_info ) {
+			if ( extension_info->plan[plan] ) {
+				free(extension_info->plan[plan]);
+				extension_info->plan[plan] = NULL;
+			}
+			extension_info = extension_info->next;
+		}
+	}
+
+} // End of FreeExtensionPlans
+
 void SetupExtensionDescriptors(char *options) {
 int i, *mask;
 char *p, *q, *s;
@@ -42,6 +42,13 @@
 #define MAX_EXTENSION_MAPS	65536
 #define EXTENSION_MAP_MASK (MAX_EXTENSION_MAPS-1)
 
+// buckets of the map registry, which finds the maps by content. Must be a power of 2
+#define EXTENSION_HASH_SIZE	4096
+#define EXTENSION_HASH_MASK (EXTENSION_HASH_SIZE-1)
+
+// expansion plans cached per map, such as the projected decoders of libnfdump
+#define MAX_EXTENSION_PLANS	2
+
 typedef struct extension_descriptor_s {
 	uint16_t	id;			// id number
 	uint16_t	size;		// number of bytes
@@ -53,6 +60,9 @@ typedef struct extension_descriptor_s {
 typedef struct extension_info_s {
 	extension_map_t	*map;
 	uint32_t		ref_count;
+	uint32_t		hash;						// content hash of the map
+	struct extension_info_s	*next;				// next map in the same registry bucket
+	void			*plan[MAX_EXTENSION_PLANS];	// malloc'ed expansion plans, freed with the map
 	master_record_t	master_record;
 } extension_info_t;
 
@@ -60,6 +70,7 @@ typedef struct extension_info_s {
 typedef struct extension_map_list_s {
 	extension_info_t	*slot[MAX_EXTENSION_MAPS];
 	extension_info_t	*page[MAX_EXTENSION_MAPS];
+	extension_info_t	*registry[EXTENSION_HASH_SIZE];	// all maps of slot and page by content hash
 	uint32_t		next_free;	// next free index in extension page
 	int32_t			max_used;	// max used slot index, -1 if empty
 } extension_map_list_t;
@@ -72,6 +83,8 @@ void PackExtensionMapList(extension_map_list_t *extension_map_list);
 
 int Insert_Extension_Map(extension_map_list_t *extension_map_list, extension_map_t *map);
 
+void FreeExtensionPlans(extension_map_list_t *extension_map_list, int plan);
+
 void SetupExtensionDescriptors(char *options);
 
 void PrintExtensionMap(extension_map_t *map);
@@ -61,6 +61,7 @@
 #include "nfdump.h"
 #include "nffile.h"
 #include "nfstatfile.h"
+#include "nfrollup.h"
 #include "flist.h"
 #include "util.h"
 #include "nftree.h"
@@ -349,7 +350,7 @@ nffile_t nffile;
 
 } // End of SetupProfileChannels
 
-void CloseChannels (time_t tslot, int compress) {
+void CloseChannels (time_t tslot, int compress, uint32_t rollup_keys) {
 dirstat_t	*dirstat;
 struct stat fstat;
 unsigned int num;
@@ -375,10 +376,14 @@ int ret, update_ok;
 			if ( rename(profile_channels[num].ofile, profile_channels[num].wfile) < 0 ) {
 				LogError("Failed to rename file %s to %s: %s\n", 
 					profile_channels[num].ofile, profile_channels[num].wfile, strerror(errno) );
-			} else if ( dirstat && tslot > dirstat->last ) {
-				dirstat->filesize += 512 * fstat.st_blocks;
-				dirstat->numfiles++;
-				dirstat->last = tslot;
+			} else {
+				if ( dirstat && tslot > dirstat->last ) {
+					dirstat->filesize += 512 * fstat.st_blocks;
+					dirstat->numfiles++;
+					dirstat->last = tslot;
+				}
+				if ( rollup_keys && !RollupFile(profile_channels[num].wfile, rollup_keys) ) 
+					LogError("Failed to rollup file %s\n", profile_channels[num].wfile);
 			}
 
 			if ( dirstat ) {
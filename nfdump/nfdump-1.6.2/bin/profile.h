@@ -69,7 +69,7 @@ unsigned int InitChannels(char *profile_datadir, char *profile_statdir, profile_
 
 profile_channel_info_t	*GetChannelInfoList(void);
 
-void CloseChannels (time_t tslot, int compress);
+void CloseChannels (time_t tslot, int compress, uint32_t rollup_keys);
 
 void UpdateRRD( time_t tslot, profile_channel_info_t *channel );
 
@@ -0,0 +1,270 @@
+/*
+ *  Copyright (c) 2026, the libnfdump contributors
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *   * Redistributions of source code must retain the above copyright notice, 
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright notice, 
+ *     this list of conditions and the following disclaimer in the documentation 
+ *     and/or other materials provided with the distribution.
+ *   * Neither the name of the copyright holders nor the names of its contributors 
+ *     may be used to endorse or promote products derived from this software without 
+ *     specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  
+ */
+
+/*
+ * Read ahead of data blocks: For each opened file a reader thread reads and
+ * decompresses the following blocks into a bounded ring of buffers, so
+ * disk I/O and LZO decompression overlap with the processing of the
+ * current block. Mapped files are read directly by ReadBlockPtr_r, as 
+ * the kernel already reads ahead the mapping.
+ */
+
+#include "config.h"
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include "nf_common.h"
+#include "nffile.h"
+#include "readahead.h"
+
+typedef struct readahead_slot_s {
+	data_block_header_t	block_header;
+	void				*buff;		// data block
+	int					ret;		// return value of ReadBlock_r
+	int					err_no;		// errno of the reader thread
+	char				*err;		// error string of ReadBlock_r
+} readahead_slot_t;
+
+struct readahead_s {
+	rfile_t				*rfile;		// file currently read
+	readahead_slot_t	*slot;		// ring of blocks
+	int					num_blocks;	// number of slots
+	int					head;		// next slot filled by the reader
+	int					tail;		// next slot returned to the caller
+	int					count;		// number of filled slots
+	int					in_use;		// slot currently processed by the caller or -1
+	int					done;		// reader thread finished the file
+	int					stop;		// request the reader thread to stop
+	int					running;	// reader thread started
+	pthread_t			tid;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+};
+
+/* function prototypes */
+static void *ReaderThread(void *arg);
+
+/* function definitions */
+
+readahead_t *NewReadAhead(int num_blocks) {
+readahead_t *readahead;
+int i;
+
+	if ( num_blocks < 2 ) 
+		num_blocks = 2;
+
+	readahead = (readahead_t *)calloc(1, sizeof(readahead_t));
+	if ( !readahead ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		return NULL;
+	}
+
+	readahead->slot = (readahead_slot_t *)calloc(num_blocks, sizeof(readahead_slot_t));
+	if ( !readahead->slot ) {
+		fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		free(readahead);
+		return NULL;
+	}
+	readahead->num_blocks = num_blocks;
+
+	for ( i=0; i<num_blocks; i++ ) {
+		readahead->slot[i].buff = malloc(BUFFSIZE);
+		if ( !readahead->slot[i].buff ) {
+			fprintf(stderr, "malloc() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+			DisposeReadAhead(readahead);
+			return NULL;
+		}
+	}
+
+	readahead->in_use = -1;
+	pthread_mutex_init(&readahead->lock, NULL);
+	pthread_cond_init(&readahead->cond, NULL);
+
+	return readahead;
+
+} // End of NewReadAhead
+
+void DisposeReadAhead(readahead_t *readahead) {
+int i;
+
+	if ( !readahead ) 
+		return;
+
+	StopReadAhead(readahead);
+
+	for ( i=0; i<readahead->num_blocks; i++ ) {
+		if ( readahead->slot[i].buff ) 
+			free(readahead->slot[i].buff);
+	}
+	free(readahead->slot);
+	pthread_mutex_destroy(&readahead->lock);
+	pthread_cond_destroy(&readahead->cond);
+	free(readahead);
+
+} // End of DisposeReadAhead
+
+static void *ReaderThread(void *arg) {
+readahead_t			*readahead = (readahead_t *)arg;
+readahead_slot_t	*slot;
+int ret;
+
+	do {
+		pthread_mutex_lock(&readahead->lock);
+		// wait for a free slot - the slot processed by the caller is not free
+		while ( !readahead->stop && 
+				(readahead->count + (readahead->in_use >= 0)) >= readahead->num_blocks ) 
+			pthread_cond_wait(&readahead->cond, &readahead->lock);
+		if ( readahead->stop ) {
+			pthread_mutex_unlock(&readahead->lock);
+			break;
+		}
+		slot = &readahead->slot[readahead->head];
+		pthread_mutex_unlock(&readahead->lock);
+
+		slot->err = NULL;
+		ret = ReadBlock_r(readahead->rfile, &slot->block_header, slot->buff, &slot->err);
+		slot->ret	 = ret;
+		slot->err_no = errno;
+
+		pthread_mutex_lock(&readahead->lock);
+		readahead->head = (readahead->head + 1) % readahead->num_blocks;
+		readahead->count++;
+		// EOF or errors end the file
+		if ( ret <= 0 ) 
+			readahead->done = 1;
+		pthread_cond_broadcast(&readahead->cond);
+		pthread_mutex_unlock(&readahead->lock);
+
+	} while ( ret > 0 );
+
+	return NULL;
+
+} // End of ReaderThread
+
+/*
+ * Start reading ahead the file opened in rfile. Files which are mapped 
+ * or not open are read synchronously.
+ */
+int StartReadAhead(readahead_t *readahead, rfile_t *rfile) {
+
+	StopReadAhead(readahead);
+
+	readahead->rfile = rfile;
+	if ( rfile->map || rfile->rfd < 0 ) 
+		return 1;
+
+	if ( pthread_create(&readahead->tid, NULL, ReaderThread, (void *)readahead) != 0 ) {
+		fprintf(stderr, "pthread_create() error in %s line %d: %s\n", __FILE__, __LINE__, strerror(errno) );
+		// continue without reader thread
+		return 0;
+	}
+	readahead->running = 1;
+
+	return 1;
+
+} // End of StartReadAhead
+
+/*
+ * Stop the reader thread. Must be called before the file is closed.
+ */
+void StopReadAhead(readahead_t *readahead) {
+
+	if ( readahead->running ) {
+		pthread_mutex_lock(&readahead->lock);
+		readahead->stop = 1;
+		pthread_cond_broadcast(&readahead->cond);
+		pthread_mutex_unlock(&readahead->lock);
+
+		pthread_join(readahead->tid, NULL);
+	}
+
+	readahead->rfile	= NULL;
+	readahead->head		= 0;
+	readahead->tail		= 0;
+	readahead->count	= 0;
+	readahead->in_use	= -1;
+	readahead->done		= 0;
+	readahead->stop		= 0;
+	readahead->running	= 0;
+
+} // End of StopReadAhead
+
+/*
+ * Same as ReadBlockPtr_r: buff is set to the next data block, which stays
+ * valid until the next call. Returns the same values as ReadBlock_r
+ */
+int ReadAheadBlock(readahead_t *readahead, data_block_header_t *block_header, void **buff, char **err) {
+readahead_slot_t *slot;
+
+	if ( !readahead->running ) {
+		if ( !readahead->rfile ) 
+			return NF_EOF;
+		return ReadBlockPtr_r(readahead->rfile, block_header, buff, err);
+	}
+
+	pthread_mutex_lock(&readahead->lock);
+	// the previous block is processed - release its slot
+	if ( readahead->in_use >= 0 ) {
+		readahead->in_use = -1;
+		pthread_cond_broadcast(&readahead->cond);
+	}
+	while ( readahead->count == 0 && !readahead->done ) 
+		pthread_cond_wait(&readahead->cond, &readahead->lock);
+
+	if ( readahead->count == 0 ) {
+		// all blocks incl. EOF or error already returned
+		pthread_mutex_unlock(&readahead->lock);
+		return NF_EOF;
+	}
+
+	slot = &readahead->slot[readahead->tail];
+	readahead->in_use = readahead->tail;
+	readahead->tail   = (readahead->tail + 1) % readahead->num_blocks;
+	readahead->count--;
+	pthread_mutex_unlock(&readahead->lock);
+
+	*block_header = slot->block_header;
+	*buff		  = slot->buff;
+	*err		  = slot->err;
+	errno		  = slot->err_no;
+
+	return slot->ret;
+
+} // End of ReadAheadBlock
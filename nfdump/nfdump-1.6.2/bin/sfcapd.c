@@ -93,6 +93,7 @@
 #endif
 
 #include "expire.h"
+#include "nfrollup.h"
 
 #include "sflow.h"
 
@@ -127,7 +128,7 @@ static void daemonize(void);
 
 static void SetPriv(char *userid, char *groupid );
 
-static void run(packet_function_t receive_packet, int socket, send_peer_t peer, time_t twin, time_t t_begin, int report_seq, char *datadir, int use_subdirs, int compress);
+static void run(packet_function_t receive_packet, int socket, send_peer_t peer, time_t twin, time_t t_begin, int report_seq, char *datadir, int use_subdirs, int compress, int workers);
 
 /* Functions */
 static void usage(char *name) {
@@ -147,9 +148,15 @@ static void usage(char *name) {
 					"-P pidfile\tset the PID file\n"
 					"-R IP[/port]\tRepeat incoming packets to IP address/port\n"
 					"-x process\tlaunch process after a new file becomes available\n"
-					"-z\t\tCompress flows in output file.\n"
+					"-z\t\tCompress flows in output file with LZO1X-1.\n"
+					"-y\t\tCompress flows in output file with LZ4.\n"
+					"-Y level\tCompress flows in output file with Zstandard at level 1..19.\n"
+					"-W num\t\tCompress and write data blocks in background using num worker threads.\n"
+					"-C\t\tWrite columnar data blocks.\n"
 					"-B bufflen\tSet socket buffer to bufflen bytes\n"
 					"-e\t\tExpire data at each cycle.\n"
+					"-k\t\tCreate block index and address filter of each new file.\n"
+					"-G keys\t\tCreate rollup of the ',' separated -s keys of each new file: srcip, dstip, port, as ... or all.\n"
 					"-D\t\tFork to background\n"
 					"-E\t\tPrint extended format of sflow data. for debugging purpose only.\n"
 					"-4\t\tListen on IPv4 (default).\n"
@@ -332,7 +339,7 @@ int		err;
 #include "nffile_inline.c"
 #include "collector_inline.c"
 
-static void run(packet_function_t receive_packet, int socket, send_peer_t peer, time_t twin, time_t t_begin, int report_seq, char *datadir, int use_subdirs, int compress) {
+static void run(packet_function_t receive_packet, int socket, send_peer_t peer, time_t twin, time_t t_begin, int report_seq, char *datadir, int use_subdirs, int compress, int workers) {
 FlowSource_t			*fs;
 struct sockaddr_storage sf_sender;
 socklen_t 	sf_sender_size = sizeof(sf_sender);
@@ -375,6 +382,12 @@ srecord_t	*commbuff;
 			return;
 		}
 
+		// compress and write the data blocks in the background
+		if ( !StartBlockWriter(&fs->nffile, workers) ) {
+			syslog(LOG_ERR, "Ident: %s, failed to start block writer", fs->Ident);
+			return;
+		}
+
 		// init stat vars
 		memset((void *)&fs->stat_record, 0, sizeof(stat_record_t));
 		fs->bad_packets		= 0;
@@ -495,6 +508,10 @@ sleep(2);
 				fs->stat_record.last_seen 	= fs->last_seen/1000;
 				fs->stat_record.msec_last	= fs->last_seen - fs->stat_record.last_seen*1000;
 	
+				// all queued blocks must be on disk, before the file is closed
+				if ( !FlushBlockWriter(&fs->nffile) ) 
+					syslog(LOG_ERR, "Ident: %s, failed to write output buffer to disk: '%s'" , fs->Ident, strerror(errno));
+
 				// Write Stat record and close file
 				CloseUpdateFile(fs->nffile.wfd, &fs->stat_record, fs->nffile.file_blocks, fs->Ident, fs->nffile.compress, &string );
 				if ( string != NULL ) {
@@ -666,6 +683,7 @@ sleep(2);
 
 	fs = FlowSource;
 	while ( fs ) {
+		StopBlockWriter(&fs->nffile);
 		free((void *)fs->nffile.block_header);
 		fs = fs->next;
 	}
@@ -685,8 +703,9 @@ FlowSource_t *fs;
 struct sigaction act;
 int		family, bufflen;
 time_t 	twin, t_start;
-int		sock, err, synctime, do_daemonize, expire, report_sequence;
-int		subdir_index, compress;
+int		sock, err, synctime, do_daemonize, expire, build_index, report_sequence;
+uint32_t	rollup_keys;
+int		subdir_index, compress, workers, columnar;
 int	c;
 
 	receive_packet 	= recvfrom;
@@ -707,7 +726,11 @@ int	c;
 	datadir	 		= NULL;
 	subdir_index	= 0;
 	expire			= 0;
+	build_index		= 0;
+	rollup_keys		= 0;
 	compress		= 0;
+	workers			= 0;
+	columnar		= 0;
 	memset((void *)&peer, 0, sizeof(send_peer_t));
 	peer.family		= AF_UNSPEC;
 	Ident			= "none";
@@ -715,7 +738,7 @@ int	c;
 	extension_tags	= DefaultExtensions;
 	pcap_file		= NULL;
 
-	while ((c = getopt(argc, argv, "46ewhEVI:DB:b:f:j:l:n:p:P:R:S:T:t:x:ru:g:z")) != EOF) {
+	while ((c = getopt(argc, argv, "46ewhEVI:DB:b:f:j:l:n:p:P:R:S:T:t:x:ru:g:G:zkyY:W:C")) != EOF) {
 		switch (c) {
 			case 'h':
 				usage(argv[0]);
@@ -730,6 +753,13 @@ int	c;
 			case 'e':
 				expire = 1;
 				break;
+			case 'k':
+				build_index = 1;
+				break;
+			case 'G':
+				if ( !ParseRollupKeys(optarg, &rollup_keys) ) 
+					exit(255);
+				break;
 			case 'E':
 				verbose = 1;
 				break;
@@ -764,8 +794,29 @@ int	c;
 				synctime = 1;
 				break;
 			case 'z':
-				compress = 1;
+				compress = LZO_COMPRESSED;
+				break;
+			case 'C':
+				columnar = 1;
 				break;
+			case 'W':
+				workers = strtol(optarg, &checkptr, 10);
+				if ( (checkptr != NULL && *checkptr == 0) && workers > 0 && workers <= MAXWORKERS )
+					break;
+				fprintf(stderr,"Argument error for -W. Number of workers 1..%d expected\n", MAXWORKERS);
+				exit(255);
+			case 'y':
+				compress = LZ4_COMPRESSED;
+				break;
+			case 'Y': {
+				long level = strtol(optarg, &checkptr, 10);
+				if ( (checkptr != NULL && *checkptr == 0) && level > 0 && level <= ZSTD_MAX_LEVEL ) {
+					compress = ZSTD_COMPRESSION(level);
+					break;
+				}
+				fprintf(stderr,"Argument error for -Y. Level 1..%d expected\n", ZSTD_MAX_LEVEL);
+				exit(255);
+				}
 			case 'B':
 				bufflen = strtol(optarg, &checkptr, 10);
 				if ( (checkptr != NULL && *checkptr == 0) && bufflen > 0 )
@@ -868,6 +919,9 @@ int	c;
 		}
 	}
 
+	if ( columnar )
+		compress |= COLUMNAR_BLOCKS;
+
 	SetupExtensionDescriptors(strdup(extension_tags));
 
 	if ( FlowSource == NULL && datadir == NULL ) {
@@ -990,7 +1044,7 @@ int	c;
 	}
 
 	done = 0;
-	if ( launch_process || expire ) {
+	if ( launch_process || expire || build_index || rollup_keys ) {
 		// for efficiency reason, the process collecting the data
 		// and the process launching processes, when a new file becomes
 		// available are separated. Communication is done using signals
@@ -1010,7 +1064,7 @@ int	c;
 			case 0:
 				// child
 				close(sock);
-				launcher((char *)shmem, FlowSource, launch_process, expire);
+				launcher((char *)shmem, FlowSource, launch_process, expire, build_index, rollup_keys);
 				exit(0);
 				break;
 			case -1:
@@ -1073,7 +1127,7 @@ int	c;
 	sigaction(SIGCHLD, &act, NULL);
 
 	syslog(LOG_INFO, "Startup.");
-	run(receive_packet, sock, peer, twin, t_start, report_sequence, datadir, subdir_index, compress);
+	run(receive_packet, sock, peer, twin, t_start, report_sequence, datadir, subdir_index, compress, workers);
 	close(sock);
 	kill_launcher(launcher_pid);
 
@@ -49,6 +49,38 @@ diff -u test1.out nfdump.test.out
 ./nfdump -q -r test.flows -o raw > test2.out
 diff -u test2.out nfdump.test.out
 
+# LZ4 and Zstandard compressed flow tests, if nfdump was built with them
+if grep -q "define HAVE_LIBLZ4 1" ../config.h; then
+	rm -f test.flows test2.out
+	./nfgen | ./nfdump -y -q -w  test.flows
+	./nfdump -q -r test.flows -o raw > test2.out
+	diff -u test2.out nfdump.test.out
+fi
+
+if grep -q "define HAVE_LIBZSTD 1" ../config.h; then
+	rm -f test.flows test2.out
+	./nfgen | ./nfdump -Y 3 -q -w  test.flows
+	./nfdump -q -r test.flows -o raw > test2.out
+	diff -u test2.out nfdump.test.out
+fi
+
+# compressed flow test with 2 background block writers
+rm -f test.flows test2.out
+./nfgen | ./nfdump -z -W 2 -q -w  test.flows
+./nfdump -q -r test.flows -o raw > test2.out
+diff -u test2.out nfdump.test.out
+
+# columnar flow tests, uncompressed and compressed
+rm -f test.flows test2.out
+./nfgen | ./nfdump -C -q -w  test.flows
+./nfdump -q -r test.flows -o raw > test2.out
+diff -u test2.out nfdump.test.out
+
+rm -f test.flows test2.out
+./nfgen | ./nfdump -z -C -q -w  test.flows
+./nfdump -q -r test.flows -o raw > test2.out
+diff -u test2.out nfdump.test.out
+
 # uncompressed flow test
 rm -f test.flows test2.out
 ./nfgen | ./nfdump -q -w  test.flows
@@ -91,4 +123,129 @@ diff -u test3.out nfdump.test.out
 rm test.flows tmp/nfcapd.* test3.out
 rmdir tmp
 
+# libnfdump: batches, projection, filter and parallel reader return the same records
+if [ -x ./nflibtest ]; then
+	./nfgen | ./nfdump -z -q -w  test.flows
+	./nflibtest test.flows 'proto tcp' > test1.out
+	./nfdump -N -r test.flows 'proto tcp' | grep Summary | cut -d, -f1-3 > test2.out
+	diff -u test1.out test2.out
+	rm test.flows test1.out test2.out
+fi
+
+# data directory with the test flows split into three files
+rm -rf testdir scandir
+mkdir testdir scandir
+./nfgen | ./nfdump -q -w testdir/nfcapd.200407111030 'proto tcp and net 172.16.0.0/16'
+./nfgen | ./nfdump -q -w testdir/nfcapd.200407111035 'proto tcp and not net 172.16.0.0/16'
+./nfgen | ./nfdump -q -w testdir/nfcapd.200407111040 'not proto tcp'
+cp testdir/nfcapd.* scandir
+
+# block index: time window seeks return the same flows as a full read
+./nfdump -q -R testdir -k
+./nfdump -q -R scandir -t 2004/07/11.10:31:00-2004/07/11.10:35:00 -o raw > test1.out
+./nfdump -q -R testdir -t 2004/07/11.10:31:00-2004/07/11.10:35:00 -o raw > test2.out
+diff -u test1.out test2.out
+
+# address Bloom filter: host searches return the same flows as a full read
+for filter in 'ip 172.16.1.66' 'ip 172.160.160.166' 'src ip 192.168.170.103' 'not ip 172.16.1.66' 'ip 10.0.0.1'; do
+	./nfdump -q -R scandir -o raw "$filter" > test1.out
+	./nfdump -q -R testdir -o raw "$filter" > test2.out
+	diff -u test1.out test2.out
+done
+
+# address index: the indexed blocks return the same flows as a full read
+mkdir testdir/.nfindex
+./nfdump -q -R testdir -k
+rm testdir/*.bloom
+for filter in 'ip 172.16.1.66' 'src ip 192.168.170.103' 'net 172.16.1.0/24' 'ip 172.16.1.66 or proto udp' 'ip 10.0.0.1'; do
+	./nfdump -q -R scandir -o raw "$filter" > test1.out
+	./nfdump -q -R testdir -o raw "$filter" > test2.out
+	diff -u test1.out test2.out
+done
+
+# nfcompact: the compacted file holds the same flows in time order
+rm -rf compactdir
+mkdir compactdir
+cp scandir/nfcapd.* compactdir
+./nfcompact -l compactdir > /dev/null
+./nfdump -q -r compactdir/nfcapd.200407111000 -o raw > test1.out
+diff -u test1.out nfdump.test.out
+
+# nfdump -m: merged files are time sorted, with or without a reorder window
+./nfdump -q -R scandir -w test.flows
+for opts in "-R scandir" "-R scandir -J 0" "-R scandir -J 5" "-r test.flows" "-r test.flows -J 30" "-R compactdir"; do
+	./nfdump -q $opts -m -o raw > test1.out
+	diff -u test1.out nfdump.test.out
+done
+rm test.flows
+if ./nfdump -q -R scandir -m -J abc > /dev/null 2>&1; then
+	echo nfdump accepts -J abc
+	exit 255
+fi
+
+# rollups: -s statistics from the rollups equal those of the flows, stale rollups are ignored
+./nfdump -q -R testdir -G srcip,dstport,proto
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -n 100 > test1.out
+./nfdump -q -R testdir -s srcip -s dstport/bytes -s proto -n 100 > test2.out
+diff -u test1.out test2.out
+for dir in testdir scandir; do
+	./nfgen | ./nfdump -q -w $dir/nfcapd.200407111040 'proto udp'
+done
+touch -t 200001010000 testdir/nfcapd.200407111040.rollup
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -n 100 > test1.out
+./nfdump -q -R testdir -s srcip -s dstport/bytes -s proto -n 100 > test2.out 2> /dev/null
+diff -u test1.out test2.out
+for dir in testdir scandir; do
+	./nfgen | ./nfdump -q -w $dir/nfcapd.200407111040 'not proto tcp'
+done
+./nfdump -q -r testdir/nfcapd.200407111040 -G srcip,dstport,proto
+
+# rollup plan: files with and without rollups, inside and at the edges of the time window
+rm testdir/nfcapd.200407111035.rollup
+for window in 2004/07/11.10:00:00-2004/07/11.11:00:00 2004/07/11.10:31:00-2004/07/11.10:35:00; do
+	./nfdump -q -R scandir -t $window -s srcip -s dstport/bytes -s proto -n 100 > test1.out
+	./nfdump -q -R testdir -t $window -s srcip -s dstport/bytes -s proto -n 100 > test2.out
+	diff -u test1.out test2.out
+done
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -n 100 > test1.out
+./nfdump -q -R testdir -s srcip -s dstport/bytes -s proto -n 100 > test2.out
+diff -u test1.out test2.out
+
+# parallel aggregation: -P 3 aggregates the same flows as a single thread
+for opts in "-a" "-A srcip" "-A proto,dstport" "-b" "-B"; do
+	./nfdump -q -R scandir $opts -o raw > test1.out
+	./nfdump -q -R scandir -P 3 $opts -o raw > test2.out
+	diff -u test1.out test2.out
+done
+./nfdump -q -R scandir -a -o raw 'proto tcp' > test1.out
+./nfdump -q -R scandir -P 3 -a -o raw 'proto tcp' > test2.out
+diff -u test1.out test2.out
+./nfdump -q -R scandir -s record/bytes -n 100 > test1.out
+./nfdump -q -R scandir -P 3 -s record/bytes -n 100 > test2.out
+diff -u test1.out test2.out
+
+# parallel statistics: -P 3 counts the same -s statistics as a single thread
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -s record/flows -n 100 > test1.out
+./nfdump -q -R scandir -P 3 -s srcip -s dstport/bytes -s proto -s record/flows -n 100 > test2.out
+diff -u test1.out test2.out
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -n 100 > test1.out
+./nfdump -q -R testdir -P 3 -s srcip -s dstport/bytes -s proto -n 100 > test2.out
+diff -u test1.out test2.out
+
+# approximate statistics: with room for all elements, -H counts as the exact statistic
+./nfdump -q -R scandir -s srcip -s dstport/bytes -s proto -n 100 | sort > test1.out
+for opts in "-R scandir" "-R scandir -P 3" "-R testdir"; do
+	./nfdump -q $opts -H 1000 -s srcip -s dstport/bytes -s proto -n 100 | sed 's/ *[0-9][0-9]*$//' | sort > test2.out
+	diff -u test1.out test2.out
+done
+for err in 0 0% 101% abc; do
+	if ./nfdump -q -R scandir -H $err -s proto > /dev/null 2>&1; then
+		echo nfdump accepts -H $err
+		exit 255
+	fi
+done
+./nfdump -q -R scandir -H 100% -s proto > /dev/null
+
+rm -r testdir scandir compactdir test1.out test2.out
+
 echo All tests successful.
@@ -52,7 +52,7 @@ int main(int argc, char *argv[])
     libnfstates_t* (*initlib)(char*, char*, char*);
     master_record_t* (*get_next_record)(libnfstates_t* states);
     void (*print_record)(master_record_t*);
-    void (*libcleanup)(void);
+    void (*libcleanup)(libnfstates_t*);
     int x;
     char *error;  
     master_record_t* rec;
@@ -131,7 +131,7 @@ int main(int argc, char *argv[])
         }
      }while (rec);
 
-    (*libcleanup)();
+    (*libcleanup)(states);
 
 
    dlclose(lib_handle);